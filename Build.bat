@@ -150,7 +150,7 @@ PUSHD "%~dp0"
 	SET "COMPILER_OPTIONS_NT_X64=/D WCE_TARGET=\"NT-x64\""
 	
 	REM Statically link with the required libraries. Note that we tell the linker not to use any default libraries.
-	SET "LIBRARIES=Kernel32.lib Advapi32.lib Shell32.lib Shlwapi.lib Version.lib"
+	SET "LIBRARIES=Kernel32.lib Advapi32.lib Shell32.lib Shlwapi.lib"
 	SET "LIBRARIES_RELEASE=LIBCMT.lib LIBCPMT.lib"
 	SET "LIBRARIES_DEBUG=LIBCMTD.lib LIBCPMTD.lib"
 	SET "LIBRARIES_X86=%ZLIB_LIB_FILENAME_X86% %BROTLI_LIB_FILENAME_X86%"
@@ -719,6 +719,24 @@ bool format_time64_t_date_time(__time64_t date_time, TCHAR* formatted_string)
 	return success;
 }
 
+// Converts a FILETIME value (the number of 100-nanosecond intervals since 1601-01-01) to a __time64_t one (the number of seconds
+// since 1970-01-01). Used to compare the date times stored in different cache formats.
+//
+// @Parameters:
+// 1. value - The FILETIME value to convert. If this value is zero, the result will also be zero.
+//
+// @Returns: The converted __time64_t value.
+__time64_t convert_filetime_to_time64_t(u64 value)
+{
+	if(value == 0) return 0;
+
+	const u64 NUM_FILETIME_INTERVALS_PER_SECOND = 10000000;
+	// There are 134774 days between 1601-01-01 and 1970-01-01.
+	const s64 NUM_SECONDS_BETWEEN_EPOCHS = (s64) 134774 * 24 * 60 * 60;
+	
+	return (__time64_t) (value / NUM_FILETIME_INTERVALS_PER_SECOND) - NUM_SECONDS_BETWEEN_EPOCHS;
+}
+
 /*
 	>>>>>>>>>>>>>>>>>>>>
 	>>>>>>>>>>>>>>>>>>>>
@@ -2361,6 +2379,401 @@ bool paths_refer_to_same_object(const TCHAR* path_1, const TCHAR* path_2)
 	return result;
 }
 
+// A file or directory in the filesystem snapshot. The objects in each directory are stored in a singly linked list.
+// See: take_filesystem_snapshot().
+struct Snapshot_Object
+{
+	TCHAR* name;
+
+	u64 size;
+	bool is_directory;
+	// Whether this directory's contents were left out of the snapshot (e.g. the exporter's temporary directory or a reparse
+	// point). Any queries inside it are answered by the filesystem itself.
+	bool is_excluded;
+
+	FILETIME creation_time;
+	FILETIME last_access_time;
+	FILETIME last_write_time;
+
+	Snapshot_Object* first_child;
+	Snapshot_Object* next_sibling;
+};
+
+const int MAX_SNAPSHOT_ROOTS = 8;
+const int MAX_SNAPSHOT_EXCLUDED_PATHS = 4;
+
+// The directories whose contents were enumerated by take_filesystem_snapshot(). Only one snapshot may exist at a time.
+struct Filesystem_Snapshot
+{
+	bool is_active;
+	int num_objects;
+
+	int num_roots;
+	TCHAR root_paths[MAX_SNAPSHOT_ROOTS][MAX_PATH_CHARS];
+	Snapshot_Object* root_objects[MAX_SNAPSHOT_ROOTS];
+
+	int num_excluded_paths;
+	TCHAR excluded_paths[MAX_SNAPSHOT_EXCLUDED_PATHS][MAX_PATH_CHARS];
+};
+
+static Filesystem_Snapshot GLOBAL_FILESYSTEM_SNAPSHOT = {};
+
+// Checks if a path is the same as or located inside a given directory. Both paths should be absolute and not end in a backslash.
+//
+// @Parameters:
+// 1. path - The path to check.
+// 2. directory_path - The directory path.
+//
+// @Returns: True if the path is inside the directory. Otherwise, false.
+static bool path_is_inside_directory(const TCHAR* path, const TCHAR* directory_path)
+{
+	size_t num_directory_chars = string_length(directory_path);
+	if(num_directory_chars == 0 || !string_begins_with(path, directory_path, true)) return false;
+	TCHAR next_char = path[num_directory_chars];
+	return next_char == T('\0') || next_char == T('\\') || next_char == T('/');
+}
+
+// Checks if a memory arena has enough space to store a snapshot object and its name.
+//
+// @Parameters:
+// 1. arena - The memory arena.
+// 2. name_size - The size of the object's name in bytes, including the null terminator.
+//
+// @Returns: True if there's enough space. Otherwise, false.
+static bool snapshot_arena_has_space(Arena* arena, size_t name_size)
+{
+	// Leave some room for the alignment.
+	const size_t ALIGNMENT_MARGIN = 64;
+	size_t remaining_size = arena->total_size - arena->used_size;
+	return remaining_size >= ALIGNMENT_MARGIN && sizeof(Snapshot_Object) + name_size <= remaining_size - ALIGNMENT_MARGIN;
+}
+
+// Pushes a filesystem snapshot object and its name to a memory arena, if there's enough space.
+//
+// @Parameters:
+// 1. arena - The memory arena where the object is stored.
+// 2. find_data - The object's information.
+//
+// @Returns: The snapshot object, or NULL if the memory arena ran out of space.
+static Snapshot_Object* push_snapshot_object(Arena* arena, const WIN32_FIND_DATA* find_data)
+{
+	size_t name_size = (string_length(find_data->cFileName) + 1) * sizeof(TCHAR);
+	if(!snapshot_arena_has_space(arena, name_size)) return NULL;
+
+	Snapshot_Object* object = push_arena(arena, sizeof(Snapshot_Object), Snapshot_Object);
+	object->name = push_string_to_arena(arena, find_data->cFileName);
+
+	object->size = combine_high_and_low_u32s_into_u64(find_data->nFileSizeHigh, find_data->nFileSizeLow);
+	object->is_directory = (find_data->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+	// Reparse points are left to the filesystem since they may point back to one of their parent directories.
+	object->is_excluded = object->is_directory && (find_data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+
+	object->creation_time = find_data->ftCreationTime;
+	object->last_access_time = find_data->ftLastAccessTime;
+	object->last_write_time = find_data->ftLastWriteTime;
+
+	object->first_child = NULL;
+	object->next_sibling = NULL;
+
+	return object;
+}
+
+// Enumerates the contents of a directory and its subdirectories into the filesystem snapshot.
+//
+// @Parameters:
+// 1. arena - The memory arena where the objects are stored.
+// 2. directory_path - The path to the directory.
+// 3. directory - The snapshot object that represents this directory.
+//
+// @Returns: True if every object was stored. Otherwise, false if the memory arena ran out of space.
+static bool snapshot_directory_objects(Arena* arena, const TCHAR* directory_path, Snapshot_Object* directory)
+{
+	TCHAR search_path[MAX_PATH_CHARS] = T("");
+	PathCombine(search_path, directory_path, ALL_OBJECTS_SEARCH_QUERY);
+
+	WIN32_FIND_DATA find_data = {};
+	HANDLE search_handle = FindFirstFile(search_path, &find_data);
+	
+	bool success = true;
+	Snapshot_Object* last_child = NULL;
+
+	bool found_object = (search_handle != INVALID_HANDLE_VALUE);
+	while(found_object)
+	{
+		TCHAR* filename = find_data.cFileName;
+		if(!strings_are_equal(filename, T(".")) && !strings_are_equal(filename, T("..")))
+		{
+			Snapshot_Object* object = push_snapshot_object(arena, &find_data);
+			if(object == NULL)
+			{
+				success = false;
+				break;
+			}
+
+			if(last_child == NULL) directory->first_child = object;
+			else last_child->next_sibling = object;
+			last_child = object;
+
+			++(GLOBAL_FILESYSTEM_SNAPSHOT.num_objects);
+		}
+
+		found_object = FindNextFile(search_handle, &find_data) != FALSE;
+	}
+
+	safe_find_close(&search_handle);
+
+	for(Snapshot_Object* object = directory->first_child; success && object != NULL; object = object->next_sibling)
+	{
+		if(!object->is_directory) continue;
+
+		TCHAR subdirectory_path[MAX_PATH_CHARS] = T("");
+		PathCombine(subdirectory_path, directory_path, object->name);
+
+		for(int i = 0; i < GLOBAL_FILESYSTEM_SNAPSHOT.num_excluded_paths && !object->is_excluded; ++i)
+		{
+			object->is_excluded = path_is_inside_directory(subdirectory_path, GLOBAL_FILESYSTEM_SNAPSHOT.excluded_paths[i]);
+		}
+
+		if(!object->is_excluded)
+		{
+			success = snapshot_directory_objects(arena, subdirectory_path, object);
+		}
+	}
+
+	return success;
+}
+
+// Enumerates the files and directories in a set of root directories once so that any following calls to does_file_exist(),
+// does_directory_exist(), traverse_directory_objects(), traverse_directory_objects_with_rules(), and find_objects_in_directory()
+// on paths inside them are answered from memory. This avoids listing the same directories multiple times when every cache
+// type is exported, which is especially slow on network shares.
+//
+// The snapshot is not updated when the filesystem changes. Any directories that are written to while exporting (e.g. the
+// exporter's temporary directory and the output directory) must be excluded so they're always queried directly. Unlike
+// FindFirstFile(), the search queries are only matched against long filenames.
+//
+// @Parameters:
+// 1. arena - The memory arena where the snapshot is stored. This memory must be kept until discard_filesystem_snapshot() is called.
+// 2. root_paths - The absolute paths to the directories to enumerate. Empty paths, missing directories, and any directories inside
+// another root are skipped.
+// 3. num_root_paths - The number of root paths.
+// 4. excluded_paths - The absolute paths to the directories that are excluded from the snapshot. This parameter may be NULL.
+// 5. num_excluded_paths - The number of excluded paths.
+//
+// @Returns: True if the snapshot was taken. Otherwise, false if the memory arena ran out of space, in which case every query
+// is answered by the filesystem itself.
+bool take_filesystem_snapshot(Arena* arena, const TCHAR** root_paths, int num_root_paths, const TCHAR** excluded_paths, int num_excluded_paths)
+{
+	discard_filesystem_snapshot();
+
+	Filesystem_Snapshot* snapshot = &GLOBAL_FILESYSTEM_SNAPSHOT;
+
+	for(int i = 0; i < num_excluded_paths && snapshot->num_excluded_paths < MAX_SNAPSHOT_EXCLUDED_PATHS; ++i)
+	{
+		TCHAR* excluded_path = snapshot->excluded_paths[snapshot->num_excluded_paths];
+		if(string_is_empty(excluded_paths[i]) || !get_full_path_name(excluded_paths[i], excluded_path)) continue;
+		PathRemoveBackslash(excluded_path);
+		++(snapshot->num_excluded_paths);
+	}
+
+	for(int i = 0; i < num_root_paths && snapshot->num_roots < MAX_SNAPSHOT_ROOTS; ++i)
+	{
+		TCHAR root_path[MAX_PATH_CHARS] = T("");
+		if(string_is_empty(root_paths[i]) || !get_full_path_name(root_paths[i], root_path)) continue;
+		PathRemoveBackslash(root_path);
+		if(!does_directory_exist(root_path)) continue;
+
+		bool is_nested = false;
+		for(int j = 0; j < num_root_paths && !is_nested; ++j)
+		{
+			TCHAR other_root_path[MAX_PATH_CHARS] = T("");
+			if(i == j || string_is_empty(root_paths[j]) || !get_full_path_name(root_paths[j], other_root_path)) continue;
+			PathRemoveBackslash(other_root_path);
+
+			// Keep the outermost directory, and only the first one if the same path appears more than once.
+			bool is_same_path = strings_are_equal(root_path, other_root_path, true);
+			is_nested = (is_same_path && j < i) || (!is_same_path && path_is_inside_directory(root_path, other_root_path));
+		}
+
+		for(int j = 0; j < snapshot->num_excluded_paths && !is_nested; ++j)
+		{
+			is_nested = path_is_inside_directory(root_path, snapshot->excluded_paths[j]);
+		}
+
+		if(is_nested) continue;
+
+		Snapshot_Object* root_object = NULL;
+		if(snapshot_arena_has_space(arena, 0))
+		{
+			root_object = push_arena(arena, sizeof(Snapshot_Object), Snapshot_Object);
+			ZeroMemory(root_object, sizeof(Snapshot_Object));
+			root_object->is_directory = true;
+		}
+
+		if(root_object == NULL || !snapshot_directory_objects(arena, root_path, root_object))
+		{
+			log_warning("Take Filesystem Snapshot: Ran out of memory after storing %d objects while enumerating '%s'. The filesystem will be queried directly instead.", snapshot->num_objects, root_path);
+			discard_filesystem_snapshot();
+			return false;
+		}
+
+		StringCchCopy(snapshot->root_paths[snapshot->num_roots], MAX_PATH_CHARS, root_path);
+		snapshot->root_objects[snapshot->num_roots] = root_object;
+		++(snapshot->num_roots);
+	}
+
+	snapshot->is_active = true;
+	log_info("Take Filesystem Snapshot: Stored %d objects from %d root directories.", snapshot->num_objects, snapshot->num_roots);
+
+	return true;
+}
+
+// Discards the current filesystem snapshot so that every query is answered by the filesystem itself. The memory where it was stored
+// may be cleared after calling this function. See: take_filesystem_snapshot().
+//
+// @Returns: Nothing.
+void discard_filesystem_snapshot(void)
+{
+	ZeroMemory(&GLOBAL_FILESYSTEM_SNAPSHOT, sizeof(GLOBAL_FILESYSTEM_SNAPSHOT));
+}
+
+// Finds an object in the filesystem snapshot given its path.
+//
+// @Parameters:
+// 1. path - The path to the file or directory.
+// 2. result_object - The address of the snapshot object that receives the object, or NULL if it doesn't exist.
+//
+// @Returns: True if the snapshot covers this path, meaning the result is valid even if the object doesn't exist. Otherwise, false
+// if the path must be queried directly. This function always returns false if the snapshot is inactive.
+static bool find_snapshot_object(const TCHAR* path, Snapshot_Object** result_object)
+{
+	*result_object = NULL;
+
+	Filesystem_Snapshot* snapshot = &GLOBAL_FILESYSTEM_SNAPSHOT;
+	if(!snapshot->is_active || path == NULL || string_is_empty(path)) return false;
+
+	for(int i = 0; i < snapshot->num_excluded_paths; ++i)
+	{
+		if(path_is_inside_directory(path, snapshot->excluded_paths[i])) return false;
+	}
+
+	for(int i = 0; i < snapshot->num_roots; ++i)
+	{
+		const TCHAR* root_path = snapshot->root_paths[i];
+		if(!path_is_inside_directory(path, root_path)) continue;
+
+		Snapshot_Object* object = snapshot->root_objects[i];
+		const TCHAR* remaining_path = path + string_length(root_path);
+
+		while(*remaining_path != T('\0'))
+		{
+			while(*remaining_path == T('\\') || *remaining_path == T('/')) ++remaining_path;
+			if(*remaining_path == T('\0')) break;
+
+			const TCHAR* component_end = remaining_path;
+			while(*component_end != T('\0') && *component_end != T('\\') && *component_end != T('/')) ++component_end;
+			size_t num_component_chars = (size_t) (component_end - remaining_path);
+
+			TCHAR component[MAX_PATH_CHARS] = T("");
+			if(num_component_chars >= MAX_PATH_CHARS) return false;
+			CopyMemory(component, remaining_path, num_component_chars * sizeof(TCHAR));
+			remaining_path = component_end;
+
+			if(strings_are_equal(component, T("."))) continue;
+			// Relative components and any objects inside an excluded directory are left to the filesystem.
+			if(strings_are_equal(component, T("..")) || object->is_excluded) return false;
+
+			Snapshot_Object* child = NULL;
+			for(child = object->first_child; child != NULL; child = child->next_sibling)
+			{
+				if(strings_are_equal(child->name, component, true)) break;
+			}
+
+			if(child == NULL) return true;
+			object = child;
+		}
+
+		*result_object = object;
+		return true;
+	}
+
+	return false;
+}
+
+// Fills the traversal information of an object in the filesystem snapshot. The 'user_data' member is not set.
+//
+// @Parameters:
+// 1. directory_path - The path to the object's directory.
+// 2. object - The snapshot object.
+// 3. object_path - The buffer that receives the object's path. This buffer must be able to hold MAX_PATH_CHARS characters.
+// 4. info - The traversal information to fill.
+//
+// @Returns: Nothing.
+static void fill_snapshot_object_info(const TCHAR* directory_path, Snapshot_Object* object, TCHAR* object_path, Traversal_Object_Info* info)
+{
+	PathCombine(object_path, directory_path, object->name);
+
+	info->directory_path = directory_path;
+	info->object_name = object->name;
+	info->object_path = object_path;
+
+	info->object_size = object->size;
+	info->is_directory = object->is_directory;
+
+	info->creation_time = object->creation_time;
+	info->last_access_time = object->last_access_time;
+	info->last_write_time = object->last_write_time;
+}
+
+// Behaves like traverse_directory_objects() for a directory in the filesystem snapshot.
+static void traverse_snapshot_objects(	const TCHAR* directory_path, Snapshot_Object* directory, const Wildcard_Pattern* pattern,
+										const TCHAR* search_query, u32 traversal_flags, bool traverse_subdirectories,
+										Traverse_Directory_Callback* callback_function, void* user_data)
+{
+	bool continue_traversing = true;
+
+	for(Snapshot_Object* object = directory->first_child; object != NULL; object = object->next_sibling)
+	{
+		bool process_object = ( (traversal_flags & TRAVERSE_FILES) && !object->is_directory )
+						   || ( (traversal_flags & TRAVERSE_DIRECTORIES) && object->is_directory );
+
+		if(process_object && wildcard_pattern_matches(pattern, object->name))
+		{
+			TCHAR full_path[MAX_PATH_CHARS] = T("");
+			Traversal_Object_Info info = {};
+			fill_snapshot_object_info(directory_path, object, full_path, &info);
+			info.user_data = user_data;
+
+			continue_traversing = callback_function(&info);
+			if(!continue_traversing) break;
+		}
+	}
+
+	if(traverse_subdirectories && continue_traversing)
+	{
+		for(Snapshot_Object* object = directory->first_child; object != NULL; object = object->next_sibling)
+		{
+			if(!object->is_directory) continue;
+
+			TCHAR subdirectory_path[MAX_PATH_CHARS] = T("");
+			PathCombine(subdirectory_path, directory_path, object->name);
+
+			if(object->is_excluded)
+			{
+				traverse_directory_objects(	subdirectory_path, search_query,
+											traversal_flags, traverse_subdirectories,
+											callback_function, user_data);
+			}
+			else
+			{
+				traverse_snapshot_objects(	subdirectory_path, object, pattern,
+											search_query, traversal_flags, traverse_subdirectories,
+											callback_function, user_data);
+			}
+		}
+	}
+}
+
 // Determines whether or not a file exists given its path.
 //
 // @Parameters:
@@ -2372,6 +2785,9 @@ bool does_file_exist(const TCHAR* file_path)
 {
 	if(file_path == NULL || string_is_empty(file_path)) return false;
 
+	Snapshot_Object* object = NULL;
+	if(find_snapshot_object(file_path, &object)) return (object != NULL) && !object->is_directory;
+
 	DWORD attributes = GetFileAttributes(file_path);
 	return (attributes != INVALID_FILE_ATTRIBUTES) && ((attributes & FILE_ATTRIBUTE_DIRECTORY) == 0);
 }
@@ -2387,6 +2803,9 @@ bool does_directory_exist(const TCHAR* directory_path)
 {
 	if(directory_path == NULL || string_is_empty(directory_path)) return false;
 
+	Snapshot_Object* object = NULL;
+	if(find_snapshot_object(directory_path, &object)) return (object != NULL) && object->is_directory;
+
 	DWORD attributes = GetFileAttributes(directory_path);
 	return (attributes != INVALID_FILE_ATTRIBUTES) && ((attributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
 }
@@ -2544,6 +2963,22 @@ void traverse_directory_objects(const TCHAR* directory_path, const TCHAR* search
 {
 	if(string_is_empty(directory_path)) return;
 
+	Snapshot_Object* directory = NULL;
+	if(find_snapshot_object(directory_path, &directory))
+	{
+		if(directory == NULL || !directory->is_directory) return;
+
+		if(!directory->is_excluded)
+		{
+			Wildcard_Pattern pattern = {};
+			compile_wildcard_pattern(search_query, &pattern);
+			traverse_snapshot_objects(	directory_path, directory, &pattern,
+										search_query, traversal_flags, traverse_subdirectories,
+										callback_function, user_data);
+			return;
+		}
+	}
+
 	bool continue_traversing = true;
 
 	/*
@@ -2630,65 +3065,315 @@ void traverse_directory_objects(const TCHAR* directory_path, const TCHAR* search
 	}
 }
 
-// Helper structure to pass some values to and from count_objects_callback() and find_objects_callback().
-struct Find_Objects_Params
-{
-	int expected_num_objects;
-
-	Arena* arena;
-	int current_num_objects;
-	Traversal_Result* result;
-};
-
-// Called every time an object is found during traversal. Used to count the number of objects and preallocate the traversal result array.
+// Compiles a wildcard pattern (e.g. "mp*" or "*.x32") so it can be matched against many filenames. The comparison is case
+// insensitive, like FindFirstFile(). Unlike that function, short 8.3 filenames are not considered (e.g. "*.x32" doesn't match
+// "file.x32a").
 //
-// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+// @Parameters:
+// 1. pattern - The wildcard pattern, which may include asterisks (zero or more characters) and question marks (exactly one
+// character).
+// 2. result_pattern - The Wildcard_Pattern structure that receives the compiled pattern.
 //
-// @Returns: True.
-static TRAVERSE_DIRECTORY_CALLBACK(count_objects_callback)
+// @Returns: Nothing.
+void compile_wildcard_pattern(const TCHAR* pattern, Wildcard_Pattern* result_pattern)
 {
-	Find_Objects_Params* params = (Find_Objects_Params*) callback_info->user_data;
-	++(params->expected_num_objects);
-	return true;
-}
+	size_t text_length = 0;
+	int num_asterisks = 0;
+	int num_question_marks = 0;
 
-// Called every time an object is found during traversal. Used to fill the members of each element in the traversal result array.
-//
-// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
-//
-// @Returns: True if the callback still expects to process more objects. Otherwise, false. 
-static TRAVERSE_DIRECTORY_CALLBACK(find_objects_callback)
-{
-	Find_Objects_Params* params = (Find_Objects_Params*) callback_info->user_data;
-	++(params->current_num_objects);
+	for(const TCHAR* c = pattern; *c != T('\0') && text_length < MAX_PATH_CHARS - 1; ++c)
+	{
+		// Collapse any consecutive asterisks since they match the same names.
+		if(*c == T('*') && text_length > 0 && result_pattern->text[text_length - 1] == T('*')) continue;
 
-	if(params->current_num_objects > params->expected_num_objects) return false;
+		if(*c == T('*')) ++num_asterisks;
+		else if(*c == T('?')) ++num_question_marks;
 
-	Arena* arena = params->arena;
-	Traversal_Result* result = params->result;
+		result_pattern->text[text_length] = (TCHAR) _totupper(*c);
+		++text_length;
+	}
 
-	Traversal_Object_Info* object_info = &(result->object_info[result->num_objects]);
-	++(result->num_objects);
+	result_pattern->text[text_length] = T('\0');
+	result_pattern->text_length = text_length;
 
-	*object_info = *callback_info;
-	object_info->directory_path = push_string_to_arena(arena, callback_info->directory_path);
-	object_info->object_name = push_string_to_arena(arena, callback_info->object_name);
-	object_info->object_path = push_string_to_arena(arena, callback_info->object_path);
-	object_info->user_data = NULL;
+	TCHAR* text = result_pattern->text;
+	bool begins_with_asterisk = (text_length > 0 && text[0] == T('*'));
+	bool ends_with_asterisk = (text_length > 0 && text[text_length - 1] == T('*'));
 
-	return true;
+	if(strings_are_equal(text, T("*")) || strings_are_equal(text, T("*.*")))
+	{
+		result_pattern->type = WILDCARD_MATCH_ALL;
+	}
+	else if(num_question_marks > 0 || num_asterisks > 1 || (num_asterisks == 1 && !begins_with_asterisk && !ends_with_asterisk))
+	{
+		result_pattern->type = WILDCARD_MATCH_GENERIC;
+	}
+	else if(ends_with_asterisk)
+	{
+		result_pattern->type = WILDCARD_MATCH_PREFIX;
+		--(result_pattern->text_length);
+		text[result_pattern->text_length] = T('\0');
+	}
+	else if(begins_with_asterisk)
+	{
+		result_pattern->type = WILDCARD_MATCH_SUFFIX;
+		--(result_pattern->text_length);
+		MoveMemory(text, text + 1, (result_pattern->text_length + 1) * sizeof(TCHAR));
+	}
+	else
+	{
+		result_pattern->type = WILDCARD_MATCH_EXACT;
+	}
 }
 
-// Traverses the objects (files and directories) inside a directory, and optionally its subdirectories, given a search query for the
-// filename. Returns an array of every object found instead of calling a callback function.
+// Checks if a name matches a compiled wildcard pattern. See: compile_wildcard_pattern().
 //
-// @Parameters: This function takes most of the same parameters as traverse_directory_objects(), except the callback function and user
-// data. It also takes the following one:
-// 1. arena - The Arena structure that will receive the resulting array of objects found.
+// @Parameters:
+// 1. pattern - The compiled pattern.
+// 2. name - The name to check.
 //
-// @Returns: An array with information about each object.
-Traversal_Result* find_objects_in_directory(Arena* arena, const TCHAR* directory_path, const TCHAR* search_query,
-											u32 traversal_flags, bool traverse_subdirectories)
+// @Returns: True if the name matches the pattern. Otherwise, false.
+bool wildcard_pattern_matches(const Wildcard_Pattern* pattern, const TCHAR* name)
+{
+	if(pattern->type == WILDCARD_MATCH_ALL) return true;
+	else if(pattern->type == WILDCARD_MATCH_EXACT) return strings_are_equal(name, pattern->text, true);
+	else if(pattern->type == WILDCARD_MATCH_PREFIX) return string_begins_with(name, pattern->text, true);
+	else if(pattern->type == WILDCARD_MATCH_SUFFIX) return string_ends_with(name, pattern->text, true);
+
+	// Match the generic pattern by going back to the last asterisk whenever a character doesn't match. Since consecutive asterisks
+	// were collapsed, this only backtracks over the characters after that asterisk.
+	const TCHAR* p = pattern->text;
+	const TCHAR* n = name;
+	const TCHAR* last_asterisk = NULL;
+	const TCHAR* last_asterisk_name = NULL;
+
+	while(*n != T('\0'))
+	{
+		TCHAR c = (TCHAR) _totupper(*n);
+
+		if(*p == T('*'))
+		{
+			++p;
+			last_asterisk = p;
+			last_asterisk_name = n;
+		}
+		else if(*p != T('\0') && (*p == T('?') || *p == c))
+		{
+			++p;
+			++n;
+		}
+		else if(last_asterisk != NULL)
+		{
+			p = last_asterisk;
+			++last_asterisk_name;
+			n = last_asterisk_name;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while(*p == T('*')) ++p;
+	return *p == T('\0');
+}
+
+// Passes an object to every rule that matches it. See: traverse_directory_objects_with_rules().
+//
+// @Parameters:
+// 1. info - The object's information.
+// 2. rules - The array of rules.
+// 3. num_rules - The number of rules.
+// 4. is_base_directory - Whether the object is in the directory where the traversal started.
+//
+// @Returns: True if the object is a directory that should be traversed. Otherwise, false.
+static bool apply_traversal_rules(Traversal_Object_Info* info, Traversal_Rule* rules, int num_rules, bool is_base_directory)
+{
+	bool traverse_subdirectory = false;
+
+	for(int i = 0; i < num_rules; ++i)
+	{
+		Traversal_Rule* rule = &rules[i];
+		if(rule->stopped_traversing) continue;
+		if(!is_base_directory && !rule->traverse_subdirectories) continue;
+		
+		if(info->is_directory && rule->traverse_subdirectories) traverse_subdirectory = true;
+
+		bool process_object = ( (rule->traversal_flags & TRAVERSE_FILES) && !info->is_directory )
+						   || ( (rule->traversal_flags & TRAVERSE_DIRECTORIES) && info->is_directory );
+
+		if(process_object && wildcard_pattern_matches(&(rule->pattern), info->object_name))
+		{
+			info->user_data = rule->user_data;
+			if(!rule->callback_function(info)) rule->stopped_traversing = true;
+		}
+	}
+
+	return traverse_subdirectory;
+}
+
+static void traverse_directory_objects_with_rules(const TCHAR* directory_path, Traversal_Rule* rules, int num_rules, bool is_base_directory);
+
+// Behaves like traverse_directory_objects_with_rules() for a directory in the filesystem snapshot.
+static void traverse_snapshot_objects_with_rules(	const TCHAR* directory_path, Snapshot_Object* directory,
+													Traversal_Rule* rules, int num_rules, bool is_base_directory)
+{
+	for(Snapshot_Object* object = directory->first_child; object != NULL; object = object->next_sibling)
+	{
+		TCHAR full_path[MAX_PATH_CHARS] = T("");
+		Traversal_Object_Info info = {};
+		fill_snapshot_object_info(directory_path, object, full_path, &info);
+
+		if(apply_traversal_rules(&info, rules, num_rules, is_base_directory))
+		{
+			if(object->is_excluded) traverse_directory_objects_with_rules(full_path, rules, num_rules, false);
+			else traverse_snapshot_objects_with_rules(full_path, object, rules, num_rules, false);
+		}
+	}
+}
+
+// Visits every object in a directory using a set of rules. See: traverse_directory_objects_with_rules().
+static void traverse_directory_objects_with_rules(const TCHAR* directory_path, Traversal_Rule* rules, int num_rules, bool is_base_directory)
+{
+	Snapshot_Object* directory = NULL;
+	if(find_snapshot_object(directory_path, &directory))
+	{
+		if(directory == NULL || !directory->is_directory) return;
+
+		if(!directory->is_excluded)
+		{
+			traverse_snapshot_objects_with_rules(directory_path, directory, rules, num_rules, is_base_directory);
+			return;
+		}
+	}
+
+	TCHAR search_path[MAX_PATH_CHARS] = T("");
+	PathCombine(search_path, directory_path, ALL_OBJECTS_SEARCH_QUERY);
+
+	WIN32_FIND_DATA find_data = {};
+	HANDLE search_handle = FindFirstFile(search_path, &find_data);
+	
+	bool found_object = (search_handle != INVALID_HANDLE_VALUE);
+	while(found_object)
+	{
+		TCHAR* filename = find_data.cFileName;
+		if(!strings_are_equal(filename, T(".")) && !strings_are_equal(filename, T("..")))
+		{
+			TCHAR full_path[MAX_PATH_CHARS] = T("");
+			PathCombine(full_path, directory_path, filename);
+
+			Traversal_Object_Info info = {};
+			
+			info.directory_path = directory_path;
+			info.object_name = filename;
+			info.object_path = full_path;
+
+			info.object_size = combine_high_and_low_u32s_into_u64(find_data.nFileSizeHigh, find_data.nFileSizeLow);
+			info.is_directory = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+			info.creation_time = find_data.ftCreationTime;
+			info.last_access_time = find_data.ftLastAccessTime;
+			info.last_write_time = find_data.ftLastWriteTime;
+
+			if(apply_traversal_rules(&info, rules, num_rules, is_base_directory))
+			{
+				traverse_directory_objects_with_rules(full_path, rules, num_rules, false);
+			}
+		}
+
+		found_object = FindNextFile(search_handle, &find_data) != FALSE;
+	}
+
+	safe_find_close(&search_handle);
+}
+
+// Traverses the objects (files and directories) inside a directory, and optionally its subdirectories, using a set of rules
+// that each specify a search query and callback function. This is equivalent to calling traverse_directory_objects() once per
+// rule, except that each directory is only listed once and every object is passed to all the rules that match it.
+//
+// This function does not guarantee the order in which the files and directories are found. Unlike traverse_directory_objects(),
+// a subdirectory may be visited before the remaining objects in its parent directory.
+//
+// @Parameters:
+// 1. directory_path - The path to the directory whose files and subdirectories will be visited.
+// 2. rules - The array of rules. The 'search_query', 'traversal_flags', 'traverse_subdirectories', 'callback_function', and
+// 'user_data' members behave like the parameters in traverse_directory_objects(). If a rule's callback function returns false,
+// that rule stops visiting any more objects.
+// 3. num_rules - The number of rules.
+//
+// @Returns: Nothing.
+void traverse_directory_objects_with_rules(const TCHAR* directory_path, Traversal_Rule* rules, int num_rules)
+{
+	if(string_is_empty(directory_path)) return;
+
+	for(int i = 0; i < num_rules; ++i)
+	{
+		compile_wildcard_pattern(rules[i].search_query, &(rules[i].pattern));
+		rules[i].stopped_traversing = false;
+	}
+
+	traverse_directory_objects_with_rules(directory_path, rules, num_rules, true);
+}
+
+// Helper structure to pass some values to and from count_objects_callback() and find_objects_callback().
+struct Find_Objects_Params
+{
+	int expected_num_objects;
+
+	Arena* arena;
+	int current_num_objects;
+	Traversal_Result* result;
+};
+
+// Called every time an object is found during traversal. Used to count the number of objects and preallocate the traversal result array.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True.
+static TRAVERSE_DIRECTORY_CALLBACK(count_objects_callback)
+{
+	Find_Objects_Params* params = (Find_Objects_Params*) callback_info->user_data;
+	++(params->expected_num_objects);
+	return true;
+}
+
+// Called every time an object is found during traversal. Used to fill the members of each element in the traversal result array.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True if the callback still expects to process more objects. Otherwise, false. 
+static TRAVERSE_DIRECTORY_CALLBACK(find_objects_callback)
+{
+	Find_Objects_Params* params = (Find_Objects_Params*) callback_info->user_data;
+	++(params->current_num_objects);
+
+	if(params->current_num_objects > params->expected_num_objects) return false;
+
+	Arena* arena = params->arena;
+	Traversal_Result* result = params->result;
+
+	Traversal_Object_Info* object_info = &(result->object_info[result->num_objects]);
+	++(result->num_objects);
+
+	*object_info = *callback_info;
+	object_info->directory_path = push_string_to_arena(arena, callback_info->directory_path);
+	object_info->object_name = push_string_to_arena(arena, callback_info->object_name);
+	object_info->object_path = push_string_to_arena(arena, callback_info->object_path);
+	object_info->user_data = NULL;
+
+	return true;
+}
+
+// Traverses the objects (files and directories) inside a directory, and optionally its subdirectories, given a search query for the
+// filename. Returns an array of every object found instead of calling a callback function.
+//
+// @Parameters: This function takes most of the same parameters as traverse_directory_objects(), except the callback function and user
+// data. It also takes the following one:
+// 1. arena - The Arena structure that will receive the resulting array of objects found.
+//
+// @Returns: An array with information about each object.
+Traversal_Result* find_objects_in_directory(Arena* arena, const TCHAR* directory_path, const TCHAR* search_query,
+											u32 traversal_flags, bool traverse_subdirectories)
 {
 	Find_Objects_Params params = {};
 	traverse_directory_objects(	directory_path, search_query,
@@ -3326,16 +4011,32 @@ bool empty_file(HANDLE file_handle)
 	return (SetFilePointer(file_handle, 0, NULL, FILE_BEGIN) != INVALID_SET_FILE_POINTER) && (SetEndOfFile(file_handle) != FALSE);
 }
 
-// Generates the SHA-256 hash of a file.
+// Determines how many bytes should be read next when processing a byte range of a file in chunks.
+//
+// @Parameters:
+// 1. max_bytes_to_read - The size of the byte range. This may be READ_UNTIL_END_OF_FILE.
+// 2. total_bytes_read - How many bytes were already read from the beginning of the range.
+// 3. file_buffer_size - The size of the intermediate file buffer.
+//
+// @Returns: The number of bytes to read. This value is zero if the whole range was already read.
+static u32 get_num_bytes_to_read_in_range(u64 max_bytes_to_read, u64 total_bytes_read, u32 file_buffer_size)
+{
+	return (total_bytes_read < max_bytes_to_read) ? ( (u32) MIN(max_bytes_to_read - total_bytes_read, (u64) file_buffer_size) ) : (0);
+}
+
+// Generates the SHA-256 hash of a file or of a byte range inside that file.
 //
 // @Dependencies: This function calls third-party code from the Portable C++ Hashing Library.
 //
 // @Parameters:
 // 1. arena - The Arena structure that will receive the computed hash as a hexadecimal character string.
 // 2. file_path - The path of the file to hash.
+// 3. optional_file_offset - An optional parameter that specifies where the data to hash starts. This value defaults to zero.
+// 4. optional_max_bytes_to_hash - An optional parameter that specifies the size of the data to hash. This value defaults to
+// READ_UNTIL_END_OF_FILE.
 // 
 // @Returns: The computed hash as a string. If any part of the file cannot be read, this function returns NULL.
-TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path)
+TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path, u64 optional_file_offset, u64 optional_max_bytes_to_hash)
 {
 	if(file_path == NULL) return NULL;
 
@@ -3354,8 +4055,9 @@ TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path)
 		bool reached_end_of_file = false;
 		do
 		{	
+			u32 num_bytes_to_read = get_num_bytes_to_read_in_range(optional_max_bytes_to_hash, total_bytes_read, file_buffer_size);
 			u32 num_bytes_read = 0;
-			if(read_file_chunk(file_handle, file_buffer, file_buffer_size, total_bytes_read, true, &num_bytes_read))
+			if(read_file_chunk(file_handle, file_buffer, num_bytes_to_read, optional_file_offset + total_bytes_read, true, &num_bytes_read))
 			{
 				if(num_bytes_read > 0)
 				{
@@ -3390,6 +4092,60 @@ TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path)
 	return result;
 }
 
+// Generates the SHA-256 hash of the first and last bytes of a file. This is used to quickly tell apart files with the same size
+// before hashing their entire contents. If the file is smaller than twice the number of edge bytes, every byte is hashed once.
+//
+// @Parameters:
+// 1. arena - The Arena structure where the intermediate file buffer is stored.
+// 2. file_path - The path to the file.
+// 3. file_size - The file's size in bytes.
+// 4. num_edge_bytes - How many bytes to hash at the beginning and at the end of the file.
+// 5. result_hash - The buffer that receives the raw hash. This buffer must be able to hold SHA_256_SIZE bytes.
+// 
+// @Returns: True if the file was read successfully. Otherwise, false.
+bool generate_edge_sha_256_from_file(Arena* arena, const TCHAR* file_path, u64 file_size, u32 num_edge_bytes, u8* result_hash)
+{
+	_STATIC_ASSERT(SHA_256_SIZE == SHA256::HashBytes);
+
+	// @TemporaryFiles: Used by temporary files, meaning it must share reading, writing, and deletion.
+	HANDLE file_handle = create_handle(file_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, OPEN_EXISTING, 0);
+
+	if(file_handle == INVALID_HANDLE_VALUE)
+	{
+		log_error("Generate Edge Sha-256 From File: Failed to get the file handle for '%s' with the error code %lu.", file_path, GetLastError());
+		return false;
+	}
+
+	void* file_buffer = push_arena(arena, num_edge_bytes, u8);
+	SHA256 hash_stream;
+
+	u32 num_first_bytes = (u32) MIN(file_size, num_edge_bytes);
+	bool success = read_file_chunk(file_handle, file_buffer, num_first_bytes, 0);
+	if(success) hash_stream.add(file_buffer, num_first_bytes);
+
+	if(success && file_size > num_edge_bytes)
+	{
+		// Don't hash the same bytes twice if the two ranges overlap.
+		u64 last_bytes_offset = MAX(file_size - num_edge_bytes, num_edge_bytes);
+		u32 num_last_bytes = (u32) (file_size - last_bytes_offset);
+		success = read_file_chunk(file_handle, file_buffer, num_last_bytes, last_bytes_offset);
+		if(success) hash_stream.add(file_buffer, num_last_bytes);
+	}
+
+	if(success)
+	{
+		hash_stream.getHash(result_hash);
+	}
+	else
+	{
+		log_error("Generate Edge Sha-256 From File: Failed to read the first and last %I32u bytes of the file '%s'.", num_edge_bytes, file_path);
+	}
+
+	safe_close_handle(&file_handle);
+
+	return success;
+}
+
 const u32 MIN_DECOMPRESSION_DESTINATION_BUFFER_SIZE = (u32) kilobytes_to_bytes(1) / 2;
 
 // Custom memory allocation function passed to the Zlib library.
@@ -3415,9 +4171,13 @@ static void zlib_free(voidpf opaque, voidpf address)
 // 2. source_file_path - The path of the source file to decompress.
 // 3. destination_file_handle - The handle of the destination file where the decompressed data will be written to.
 // 4. result_error_code - The error code generated by Zlib's functions if the file cannot be decompressed.
+// 5. optional_file_offset - An optional parameter that specifies where the compressed data starts. This value defaults to zero.
+// 6. optional_max_bytes_to_read - An optional parameter that specifies the size of the compressed data. This value defaults to
+// READ_UNTIL_END_OF_FILE.
 // 
 // @Returns: True if the file was decompressed successfully. Otherwise, false.
-bool decompress_gzip_zlib_deflate_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code)
+bool decompress_gzip_zlib_deflate_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+										u64 optional_file_offset, u64 optional_max_bytes_to_read)
 {
 	*result_error_code = Z_ERRNO;
 
@@ -3442,7 +4202,7 @@ bool decompress_gzip_zlib_deflate_file(Arena* arena, const TCHAR* source_file_pa
 
 	const size_t file_signature_size = 2;
 	u8 file_signature[file_signature_size] = {};
-	read_first_file_bytes(source_file_handle, file_signature, file_signature_size);
+	read_file_chunk(source_file_handle, file_signature, (u32) MIN((u64) file_signature_size, optional_max_bytes_to_read), optional_file_offset);
 
 	// @Note: Assumes 0x78 as the first byte (DEFLATE with a 32K window) for the Zlib format.
 	bool is_gzip_or_zlib = memory_is_equal(file_signature, "\x1F\x8B", file_signature_size)
@@ -3469,8 +4229,9 @@ bool decompress_gzip_zlib_deflate_file(Arena* arena, const TCHAR* source_file_pa
 
 		do
 		{
+			u32 num_bytes_to_read = get_num_bytes_to_read_in_range(optional_max_bytes_to_read, total_bytes_read, source_file_buffer_size);
 			u32 num_bytes_read = 0;
-			if(read_file_chunk(source_file_handle, source_file_buffer, source_file_buffer_size, total_bytes_read, true, &num_bytes_read))
+			if(read_file_chunk(source_file_handle, source_file_buffer, num_bytes_to_read, optional_file_offset + total_bytes_read, true, &num_bytes_read))
 			{
 				// End of file.
 				if(num_bytes_read == 0)
@@ -3536,6 +4297,68 @@ bool decompress_gzip_zlib_deflate_file(Arena* arena, const TCHAR* source_file_pa
 	return success;
 }
 
+// Decompresses a buffer that uses the raw DEFLATE compression format (i.e. without a Gzip or Zlib header), like the members
+// of a ZIP archive, or the Zlib format. This function stops when the destination buffer is full, meaning it can be used to
+// decompress only the beginning of the data.
+//
+// @Dependencies: This function calls third-party code from the Zlib library.
+//
+// @Parameters:
+// 1. arena - The Arena structure that is used to hold Zlib's internal state. This memory is only freed when the caller clears
+// the arena.
+// 2. source_buffer - The compressed data.
+// 3. source_size - The size of the compressed data in bytes.
+// 4. destination_buffer - The buffer that receives the decompressed data.
+// 5. destination_size - The size of the destination buffer in bytes.
+// 6. result_size - The number of decompressed bytes that were written to the destination buffer.
+// 7. result_error_code - The error code generated by Zlib's functions if the buffer cannot be decompressed.
+// 8. optional_has_zlib_header - An optional parameter that specifies if the data starts with a Zlib header. This value defaults
+// to false.
+// 
+// @Returns: True if the data was decompressed successfully. Otherwise, false.
+bool decompress_deflate_buffer(	Arena* arena, const void* source_buffer, u32 source_size, void* destination_buffer, u32 destination_size,
+								u32* result_size, int* result_error_code, bool optional_has_zlib_header)
+{
+	*result_size = 0;
+	*result_error_code = Z_ERRNO;
+
+	// @Docs: "zlib 1.2.11 Manual"  - https://zlib.net/manual.html
+	z_stream stream = {};
+	stream.zalloc = zlib_alloc;
+	stream.zfree = zlib_free;
+	stream.opaque = arena;
+	stream.next_in = (Bytef*) source_buffer;
+	stream.avail_in = source_size;
+	stream.next_out = (Bytef*) destination_buffer;
+	stream.avail_out = destination_size;
+
+	int window_bits = (optional_has_zlib_header) ? (15) : (-15);
+	int error_code = inflateInit2(&stream, window_bits);
+
+	if(error_code == Z_OK)
+	{
+		error_code = inflate(&stream, Z_FINISH);
+		
+		// Running out of space in the destination buffer is not an error since we may only want the beginning of the data.
+		if(error_code == Z_BUF_ERROR && stream.avail_out == 0) error_code = Z_STREAM_END;
+		
+		if(error_code != Z_STREAM_END)
+		{
+			log_error("Decompress Deflate Buffer: Failed to decompress %I32u bytes with the error %d '%hs'.", source_size, error_code, (stream.msg != NULL) ? (stream.msg) : (""));
+		}
+	}
+	else
+	{
+		log_error("Decompress Deflate Buffer: Failed to initialize the stream with the error %d '%hs'.", error_code, (stream.msg != NULL) ? (stream.msg) : (""));
+	}
+
+	*result_size = destination_size - stream.avail_out;
+	inflateEnd(&stream);
+
+	*result_error_code = error_code;
+	return error_code == Z_STREAM_END;
+}
+
 // Custom memory allocation function passed to the Brotli library.
 static void* brotli_alloc(void* opaque, size_t size)
 {
@@ -3558,9 +4381,13 @@ static void brotli_free(void* opaque, void* address)
 // 2. source_file_path - The path of the source file to decompress.
 // 3. destination_file_handle - The handle of the destination file where the decompressed data will be written to.
 // 4. result_error_code - The error code generated by Brotli's functions if the file cannot be decompressed.
+// 5. optional_file_offset - An optional parameter that specifies where the compressed data starts. This value defaults to zero.
+// 6. optional_max_bytes_to_read - An optional parameter that specifies the size of the compressed data. This value defaults to
+// READ_UNTIL_END_OF_FILE.
 // 
 // @Returns: True if the file was decompressed successfully. Otherwise, false.
-bool decompress_brotli_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code)
+bool decompress_brotli_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+							u64 optional_file_offset, u64 optional_max_bytes_to_read)
 {
 	*result_error_code = BROTLI_LAST_ERROR_CODE;
 
@@ -3601,8 +4428,9 @@ bool decompress_brotli_file(Arena* arena, const TCHAR* source_file_path, HANDLE
 
 		do
 		{
+			u32 num_bytes_to_read = get_num_bytes_to_read_in_range(optional_max_bytes_to_read, total_bytes_read, source_file_buffer_size);
 			u32 num_bytes_read = 0;
-			if(read_file_chunk(source_file_handle, source_file_buffer, source_file_buffer_size, total_bytes_read, true, &num_bytes_read))
+			if(read_file_chunk(source_file_handle, source_file_buffer, num_bytes_to_read, optional_file_offset + total_bytes_read, true, &num_bytes_read))
 			{
 				// End of file.
 				if(num_bytes_read == 0)
@@ -3687,9 +4515,13 @@ bool decompress_brotli_file(Arena* arena, const TCHAR* source_file_path, HANDLE
 // 2. source_file_path - The path of the source file to decompress.
 // 3. destination_file_handle - The handle of the destination file where the decompressed data will be written to.
 // 4. result_error_code - The error code obtained if the file cannot be decompressed.
+// 5. optional_file_offset - An optional parameter that specifies where the compressed data starts. This value defaults to zero.
+// 6. optional_max_bytes_to_read - An optional parameter that specifies the size of the compressed data. This value defaults to
+// READ_UNTIL_END_OF_FILE.
 // 
 // @Returns: True if the file was decompressed successfully. Otherwise, false.
-bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code)
+bool decompress_compress_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+								u64 optional_file_offset, u64 optional_max_bytes_to_read)
 {
 	enum
 	{
@@ -3751,7 +4583,7 @@ bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDL
 
 	const size_t file_signature_size = 3;
 	u8 file_signature[file_signature_size] = {};
-	read_first_file_bytes(source_file_handle, file_signature, file_signature_size);
+	read_file_chunk(source_file_handle, file_signature, (u32) MIN((u64) file_signature_size, optional_max_bytes_to_read), optional_file_offset);
 
 	if(!memory_is_equal(file_signature, "\x1F\x9D", 2))
 	{
@@ -3906,8 +4738,9 @@ bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDL
 			}\
 		} while(false, false)
 
+		u32 num_bytes_to_read = get_num_bytes_to_read_in_range(optional_max_bytes_to_read, total_bytes_read, source_file_buffer_size);
 		u32 num_bytes_read = 0;
-		if(read_file_chunk(source_file_handle, source_file_buffer, source_file_buffer_size, total_bytes_read, true, &num_bytes_read))
+		if(read_file_chunk(source_file_handle, source_file_buffer, num_bytes_to_read, optional_file_offset + total_bytes_read, true, &num_bytes_read))
 		{
 			// End of file.
 			if(num_bytes_read == 0)
@@ -3930,7 +4763,7 @@ bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDL
 		s64 num_bits_remaining = num_bytes_read * CHAR_BIT;
 		_ASSERT(num_bits_remaining >= current_num_bits);
 
-		bool is_last_chunk = (num_bytes_read < source_file_buffer_size);
+		bool is_last_chunk = (num_bytes_read < source_file_buffer_size) || (total_bytes_read >= optional_max_bytes_to_read);
 		const u8* first_next_in_over_limit = (const u8*) advance_bytes(next_in, (u32) num_bytes_read);
 		
 		while(true, true)
@@ -4076,52 +4909,723 @@ bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDL
 	return success;
 }
 
-// Retrieves the data of a specified registry value of type string (REG_SZ).
-//
-// This function was created to replace RegGetValue() from ADVAPI32.DLL since it was only available from version 5.2 onwards
-// (Windows Server 2003 or later).
+// A small streaming LZMA decoder used to read UnityWeb bundles and LZMA compressed Flash movies. The decompressed data is kept in
+// a sliding window and passed to a callback in chunks, meaning the caller can stop decoding as soon as it has the data it needs.
 //
-// This function is usually called by using the macro query_registry(), which takes the same arguments but where key_name and
-// value_name are ANSI strings (for convenience).
-//
-// @Parameters:
-// 1. hkey - The handle to an open registry key. This can be one of the following predefined keys:
-// - HKEY_CLASSES_ROOT
-// - HKEY_CURRENT_USER
-// - HKEY_LOCAL_MACHINE
-// - HKEY_USERS
-// (Note that you may use others if you're targeting versions that are more recent than Windows 98).
-// 2. key_name - The name of the registry subkey to query.
-// 3. value_name - The name of the registry value to query.
-// 4. value_data - The buffer that receives the resulting string read from the registry value.
-// 5. value_data_size - The size of the buffer in bytes. This must include the null terminator.
-// 
-// @Returns: True if the value was retrieved successfully. Otherwise, false.
-bool tchar_query_registry(HKEY hkey, const TCHAR* key_name, const TCHAR* value_name, TCHAR* value_data, u32 value_data_size)
-{
-	bool success = true;
+// @Docs: This decoder follows the reference implementation described in "lzma-specification.txt" and "LzmaSpec.cpp" from the
+// LZMA SDK by Igor Pavlov (public domain) - https://www.7-zip.org/sdk.html
 
-	HKEY opened_key = NULL;
-	LONG error_code = RegOpenKeyEx(hkey, key_name, 0, KEY_QUERY_VALUE, &opened_key);
-	success = (error_code == ERROR_SUCCESS);
+static const u32 LZMA_MIN_DICTIONARY_SIZE = 1 << 12;
 
-	if(!success)
-	{
-		log_error("Query Registry: Failed to open the registry key '%s' with the error code %lu.", key_name, error_code);
-		return success;
-	}
+static const u32 LZMA_NUM_BIT_MODEL_TOTAL_BITS = 11;
+static const u32 LZMA_NUM_MOVE_BITS = 5;
+static const u32 LZMA_INITIAL_PROBABILITY = (1 << LZMA_NUM_BIT_MODEL_TOTAL_BITS) / 2;
+static const u32 LZMA_TOP_VALUE = 1 << 24;
 
-	DWORD value_data_type = REG_NONE;
-	DWORD actual_value_data_size = value_data_size;
-	// When RegQueryValueEx() returns, actual_value_data_size contains the size of the data that was copied to the buffer.
-	// For strings, this size includes any terminating null characters unless the data was stored without them.
-	error_code = RegQueryValueEx(opened_key, value_name, NULL, &value_data_type, (LPBYTE) value_data, &actual_value_data_size);
-	success = (error_code == ERROR_SUCCESS);
-	RegCloseKey(opened_key);
+static const u32 LZMA_NUM_STATES = 12;
+static const u32 LZMA_NUM_POS_BITS_MAX = 4;
+static const u32 LZMA_NUM_LEN_TO_POS_STATES = 4;
+static const u32 LZMA_NUM_ALIGN_BITS = 4;
+static const u32 LZMA_END_POS_MODEL_INDEX = 14;
+static const u32 LZMA_NUM_FULL_DISTANCES = 1 << (LZMA_END_POS_MODEL_INDEX >> 1);
+static const u32 LZMA_MATCH_MIN_LEN = 2;
 
-	_ASSERT(actual_value_data_size > 0);
+// How many bytes are read from the compressed file at a time, and how many decompressed bytes are accumulated before calling
+// the output callback.
+static const u32 LZMA_INPUT_BUFFER_SIZE = 16 * 1024;
+static const u32 LZMA_FLUSH_SIZE = 16 * 1024;
 
-	if(success)
+typedef u16 Lzma_Probability;
+
+struct Lzma_Length_Probabilities
+{
+	Lzma_Probability choice;
+	Lzma_Probability choice_2;
+	Lzma_Probability low[1 << LZMA_NUM_POS_BITS_MAX][1 << 3];
+	Lzma_Probability mid[1 << LZMA_NUM_POS_BITS_MAX][1 << 3];
+	Lzma_Probability high[1 << 8];
+};
+
+// Every probability except the literal ones, whose number depends on the stream's properties. This structure must only contain
+// Lzma_Probability members since it's initialized as an array.
+struct Lzma_Probabilities
+{
+	Lzma_Probability pos_slot[LZMA_NUM_LEN_TO_POS_STATES][1 << 6];
+	Lzma_Probability pos_special[1 + LZMA_NUM_FULL_DISTANCES - LZMA_END_POS_MODEL_INDEX];
+	Lzma_Probability align[1 << LZMA_NUM_ALIGN_BITS];
+	
+	Lzma_Probability is_match[LZMA_NUM_STATES << LZMA_NUM_POS_BITS_MAX];
+	Lzma_Probability is_rep[LZMA_NUM_STATES];
+	Lzma_Probability is_rep_g0[LZMA_NUM_STATES];
+	Lzma_Probability is_rep_g1[LZMA_NUM_STATES];
+	Lzma_Probability is_rep_g2[LZMA_NUM_STATES];
+	Lzma_Probability is_rep_0_long[LZMA_NUM_STATES << LZMA_NUM_POS_BITS_MAX];
+
+	Lzma_Length_Probabilities length;
+	Lzma_Length_Probabilities rep_length;
+};
+
+struct Lzma_Decoder
+{
+	// The compressed data, which is either read from a file or passed directly in a buffer (in which case the file handle is
+	// INVALID_HANDLE_VALUE).
+	HANDLE file_handle;
+	u64 input_offset;
+	u64 input_end_offset;
+	u8* input_buffer;
+	u32 input_size;
+	u32 input_position;
+
+	// The range decoder.
+	u32 range;
+	u32 code;
+	bool is_corrupted;
+
+	// The stream's properties.
+	u32 literal_context_bits;
+	u32 literal_pos_bits;
+	u32 pos_bits;
+	u32 dictionary_size;
+	u64 uncompressed_size;
+
+	// The sliding window with the decompressed data. This window may be smaller than the dictionary if we only want to decompress
+	// the beginning of the stream, in which case any match that goes past it is treated as an error.
+	u8* window;
+	u32 window_size;
+	u32 window_position;
+	u32 flushed_position;
+	bool is_window_full;
+	u64 total_position;
+
+	Lzma_Output_Callback* output_callback;
+	void* user_data;
+	bool was_stopped;
+
+	Lzma_Probability* literal_probabilities;
+	Lzma_Probabilities probabilities;
+};
+
+// Reads the next byte of compressed data, refilling the input buffer if necessary. Reading past the end of the compressed data
+// marks the stream as corrupted.
+static u8 read_lzma_byte(Lzma_Decoder* decoder)
+{
+	if(decoder->input_position >= decoder->input_size)
+	{
+		u32 num_bytes_to_read = (u32) MIN((u64) LZMA_INPUT_BUFFER_SIZE, decoder->input_end_offset - decoder->input_offset);
+		u32 num_bytes_read = 0;
+		
+		if(decoder->file_handle == INVALID_HANDLE_VALUE || num_bytes_to_read == 0 || !read_file_chunk(decoder->file_handle, decoder->input_buffer, num_bytes_to_read, decoder->input_offset, true, &num_bytes_read)
+			|| num_bytes_read == 0)
+		{
+			decoder->is_corrupted = true;
+			return 0;
+		}
+
+		decoder->input_offset += num_bytes_read;
+		decoder->input_size = num_bytes_read;
+		decoder->input_position = 0;
+	}
+
+	u8 result = decoder->input_buffer[decoder->input_position];
+	decoder->input_position += 1;
+	return result;
+}
+
+// Decodes a single bit using the range decoder and updates its probability.
+static u32 decode_lzma_bit(Lzma_Decoder* decoder, Lzma_Probability* probability)
+{
+	u32 value = *probability;
+	u32 bound = (decoder->range >> LZMA_NUM_BIT_MODEL_TOTAL_BITS) * value;
+	u32 bit = 0;
+
+	if(decoder->code < bound)
+	{
+		value += ((1 << LZMA_NUM_BIT_MODEL_TOTAL_BITS) - value) >> LZMA_NUM_MOVE_BITS;
+		decoder->range = bound;
+		bit = 0;
+	}
+	else
+	{
+		value -= value >> LZMA_NUM_MOVE_BITS;
+		decoder->code -= bound;
+		decoder->range -= bound;
+		bit = 1;
+	}
+
+	*probability = (Lzma_Probability) value;
+
+	if(decoder->range < LZMA_TOP_VALUE)
+	{
+		decoder->range <<= 8;
+		decoder->code = (decoder->code << 8) | read_lzma_byte(decoder);
+	}
+
+	return bit;
+}
+
+// Decodes a number of bits that have a fixed probability of one half.
+static u32 decode_lzma_direct_bits(Lzma_Decoder* decoder, u32 num_bits)
+{
+	u32 result = 0;
+	
+	for(u32 i = 0; i < num_bits; ++i)
+	{
+		decoder->range >>= 1;
+		decoder->code -= decoder->range;
+		u32 mask = 0 - (decoder->code >> 31);
+		decoder->code += decoder->range & mask;
+		
+		if(decoder->code == decoder->range) decoder->is_corrupted = true;
+		
+		if(decoder->range < LZMA_TOP_VALUE)
+		{
+			decoder->range <<= 8;
+			decoder->code = (decoder->code << 8) | read_lzma_byte(decoder);
+		}
+
+		result = (result << 1) + (mask + 1);
+	}
+
+	return result;
+}
+
+// Decodes a number from a binary tree of probabilities, starting with the most significant bit.
+static u32 decode_lzma_bit_tree(Lzma_Decoder* decoder, Lzma_Probability* probabilities, u32 num_bits)
+{
+	u32 index = 1;
+	for(u32 i = 0; i < num_bits; ++i)
+	{
+		index = (index << 1) + decode_lzma_bit(decoder, &probabilities[index]);
+	}
+	return index - ((u32) 1 << num_bits);
+}
+
+// Decodes a number from a binary tree of probabilities, starting with the least significant bit.
+static u32 decode_lzma_reverse_bit_tree(Lzma_Decoder* decoder, Lzma_Probability* probabilities, u32 num_bits)
+{
+	u32 index = 1;
+	u32 result = 0;
+	for(u32 i = 0; i < num_bits; ++i)
+	{
+		u32 bit = decode_lzma_bit(decoder, &probabilities[index]);
+		index = (index << 1) + bit;
+		result |= bit << i;
+	}
+	return result;
+}
+
+// Decodes the length of a match (minus the minimum length).
+static u32 decode_lzma_length(Lzma_Decoder* decoder, Lzma_Length_Probabilities* probabilities, u32 pos_state)
+{
+	if(decode_lzma_bit(decoder, &probabilities->choice) == 0)
+	{
+		return decode_lzma_bit_tree(decoder, probabilities->low[pos_state], 3);
+	}
+	
+	if(decode_lzma_bit(decoder, &probabilities->choice_2) == 0)
+	{
+		return 8 + decode_lzma_bit_tree(decoder, probabilities->mid[pos_state], 3);
+	}
+	
+	return 16 + decode_lzma_bit_tree(decoder, probabilities->high, 8);
+}
+
+// Decodes the distance of a match (minus one). The value 0xFFFFFFFF represents the end of stream marker.
+static u32 decode_lzma_distance(Lzma_Decoder* decoder, u32 length)
+{
+	u32 length_state = MIN(length, LZMA_NUM_LEN_TO_POS_STATES - 1);
+	u32 pos_slot = decode_lzma_bit_tree(decoder, decoder->probabilities.pos_slot[length_state], 6);
+	if(pos_slot < 4) return pos_slot;
+
+	u32 num_direct_bits = (pos_slot >> 1) - 1;
+	u32 distance = (2 | (pos_slot & 1)) << num_direct_bits;
+	
+	if(pos_slot < LZMA_END_POS_MODEL_INDEX)
+	{
+		distance += decode_lzma_reverse_bit_tree(decoder, decoder->probabilities.pos_special + distance - pos_slot, num_direct_bits);
+	}
+	else
+	{
+		distance += decode_lzma_direct_bits(decoder, num_direct_bits - LZMA_NUM_ALIGN_BITS) << LZMA_NUM_ALIGN_BITS;
+		distance += decode_lzma_reverse_bit_tree(decoder, decoder->probabilities.align, LZMA_NUM_ALIGN_BITS);
+	}
+
+	return distance;
+}
+
+// Passes any decompressed bytes that weren't seen yet to the output callback.
+static void flush_lzma_window(Lzma_Decoder* decoder)
+{
+	// Don't pass along any data that was decoded after the stream was found to be corrupted.
+	if(decoder->window_position > decoder->flushed_position && !decoder->was_stopped && !decoder->is_corrupted)
+	{
+		u32 num_bytes = decoder->window_position - decoder->flushed_position;
+		if(!decoder->output_callback(decoder->window + decoder->flushed_position, num_bytes, decoder->user_data))
+		{
+			decoder->was_stopped = true;
+		}
+	}
+
+	decoder->flushed_position = decoder->window_position;
+}
+
+// Adds a decompressed byte to the sliding window.
+static void put_lzma_byte(Lzma_Decoder* decoder, u8 value)
+{
+	decoder->window[decoder->window_position] = value;
+	decoder->window_position += 1;
+	decoder->total_position += 1;
+
+	if(decoder->window_position == decoder->window_size)
+	{
+		flush_lzma_window(decoder);
+		decoder->window_position = 0;
+		decoder->flushed_position = 0;
+		decoder->is_window_full = true;
+	}
+}
+
+// Retrieves a previously decompressed byte at a given distance from the current position (where one is the last byte).
+static u8 get_lzma_byte(Lzma_Decoder* decoder, u32 distance)
+{
+	u32 index = (distance <= decoder->window_position) ? (decoder->window_position - distance) : (decoder->window_size - distance + decoder->window_position);
+	return decoder->window[index];
+}
+
+// Parses the properties of an LZMA stream and determines how much memory is required to decode it.
+//
+// @Parameters:
+// 1. properties - The five bytes that contain the stream's properties and dictionary size.
+// 2. uncompressed_size - The size of the decompressed data, or LZMA_UNKNOWN_SIZE if it's not known.
+// 3. max_window_size - The maximum size of the sliding window. This should be at least the dictionary size if the entire stream
+// is decompressed.
+// 4. result_properties - The Lzma_Properties structure that receives the stream's properties.
+//
+// @Returns: True if the properties are valid. Otherwise, false.
+bool parse_lzma_properties(const void* properties, u64 uncompressed_size, u32 max_window_size, Lzma_Properties* result_properties)
+{
+	const u8* properties_bytes = (const u8*) properties;
+
+	// @Format: lc + lp * 9 + pb * 9 * 5, followed by the dictionary size (little endian).
+	u32 properties_value = properties_bytes[0];
+	if(properties_value >= 9 * 5 * 5)
+	{
+		log_error("Parse Lzma Properties: Found the invalid properties byte 0x%02X.", properties_value);
+		return false;
+	}
+
+	u32 dictionary_size = 0;
+	CopyMemory(&dictionary_size, properties_bytes + 1, sizeof(dictionary_size));
+	LITTLE_ENDIAN_TO_HOST(dictionary_size);
+	dictionary_size = MAX(dictionary_size, LZMA_MIN_DICTIONARY_SIZE);
+
+	result_properties->literal_context_bits = properties_value % 9;
+	properties_value /= 9;
+	result_properties->literal_pos_bits = properties_value % 5;
+	result_properties->pos_bits = properties_value / 5;
+	result_properties->dictionary_size = dictionary_size;
+	result_properties->uncompressed_size = uncompressed_size;
+
+	// There's no point in allocating more than the dictionary or the stream's size.
+	u32 window_size = MIN(dictionary_size, max_window_size);
+	if(uncompressed_size != LZMA_UNKNOWN_SIZE) window_size = (u32) MIN((u64) window_size, MAX(uncompressed_size, (u64) 1));
+	result_properties->window_size = window_size;
+
+	result_properties->num_literal_probabilities = (size_t) 0x300 << (result_properties->literal_context_bits + result_properties->literal_pos_bits);
+	
+	// Include some extra bytes for the alignment of each allocation.
+	result_properties->required_memory_size = sizeof(Lzma_Decoder) + LZMA_INPUT_BUFFER_SIZE + window_size
+											+ result_properties->num_literal_probabilities * sizeof(Lzma_Probability) + 64;
+
+	return true;
+}
+
+// Reads the properties of an LZMA stream that starts with the 13 byte header used by the .lzma format (the properties followed
+// by the uncompressed size).
+//
+// @Parameters:
+// 1. file_handle - The handle to the file that contains the stream.
+// 2. stream_offset - The offset of the stream's header in the file.
+// 3. max_window_size - The maximum size of the sliding window. See: parse_lzma_properties().
+// 4. result_properties - The Lzma_Properties structure that receives the stream's properties.
+//
+// @Returns: True if the header was read and is valid. Otherwise, false.
+bool read_lzma_properties(HANDLE file_handle, u64 stream_offset, u32 max_window_size, Lzma_Properties* result_properties)
+{
+	u8 header[LZMA_HEADER_SIZE] = {};
+	if(!read_file_chunk(file_handle, header, LZMA_HEADER_SIZE, stream_offset))
+	{
+		log_error("Read Lzma Properties: Failed to read the stream's header at the offset %I64u.", stream_offset);
+		return false;
+	}
+
+	u64 uncompressed_size = 0;
+	CopyMemory(&uncompressed_size, header + LZMA_PROPERTIES_SIZE, sizeof(uncompressed_size));
+	LITTLE_ENDIAN_TO_HOST(uncompressed_size);
+
+	return parse_lzma_properties(header, uncompressed_size, max_window_size, result_properties);
+}
+
+// Prepares a decoder for an LZMA stream whose properties were previously read. The compressed data is either read from a file
+// or passed directly in a buffer.
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the decoder's buffers. This arena must have at least the number of bytes specified
+// in the properties' 'required_memory_size' member.
+// 2. properties - The Lzma_Properties structure returned by parse_lzma_properties() or read_lzma_properties().
+// 3. input - The Lzma_Input structure that specifies where the compressed data is stored.
+// 4. output_callback - The function that receives the decompressed data.
+// 5. user_data - A pointer that is passed to the output callback.
+//
+// @Returns: The decoder if there's enough memory for it. Otherwise, NULL.
+Lzma_Decoder* create_lzma_decoder(Arena* arena, Lzma_Properties* properties, Lzma_Input* input, Lzma_Output_Callback* output_callback, void* user_data)
+{
+	size_t remaining_arena_size = arena->total_size - arena->used_size;
+	if(properties->required_memory_size > remaining_arena_size)
+	{
+		log_warning("Create Lzma Decoder: The decoder requires %Iu bytes (dictionary size = %I32u, lc = %I32u, lp = %I32u) but only %Iu bytes are available.",
+					properties->required_memory_size, properties->dictionary_size, properties->literal_context_bits, properties->literal_pos_bits, remaining_arena_size);
+		return NULL;
+	}
+
+	Lzma_Decoder* decoder = push_arena(arena, sizeof(Lzma_Decoder), Lzma_Decoder);
+	decoder->window = push_arena(arena, properties->window_size, u8);
+	decoder->literal_probabilities = push_array_to_arena(arena, properties->num_literal_probabilities, Lzma_Probability);
+
+	decoder->file_handle = input->file_handle;
+	decoder->input_position = 0;
+
+	if(input->file_handle != INVALID_HANDLE_VALUE)
+	{
+		decoder->input_buffer = push_arena(arena, LZMA_INPUT_BUFFER_SIZE, u8);
+		decoder->input_offset = input->file_offset;
+		decoder->input_end_offset = MAX(input->file_end_offset, decoder->input_offset);
+		decoder->input_size = 0;
+	}
+	else
+	{
+		decoder->input_buffer = (u8*) input->buffer;
+		decoder->input_offset = 0;
+		decoder->input_end_offset = 0;
+		decoder->input_size = input->buffer_size;
+	}
+
+	decoder->is_corrupted = false;
+	decoder->literal_context_bits = properties->literal_context_bits;
+	decoder->literal_pos_bits = properties->literal_pos_bits;
+	decoder->pos_bits = properties->pos_bits;
+	decoder->dictionary_size = properties->dictionary_size;
+	decoder->uncompressed_size = properties->uncompressed_size;
+
+	decoder->window_size = properties->window_size;
+	decoder->window_position = 0;
+	decoder->flushed_position = 0;
+	decoder->is_window_full = false;
+	decoder->total_position = 0;
+
+	decoder->output_callback = output_callback;
+	decoder->user_data = user_data;
+	decoder->was_stopped = false;
+
+	for(size_t i = 0; i < properties->num_literal_probabilities; ++i)
+	{
+		decoder->literal_probabilities[i] = LZMA_INITIAL_PROBABILITY;
+	}
+
+	Lzma_Probability* probabilities = (Lzma_Probability*) &(decoder->probabilities);
+	for(size_t i = 0; i < sizeof(Lzma_Probabilities) / sizeof(Lzma_Probability); ++i)
+	{
+		probabilities[i] = LZMA_INITIAL_PROBABILITY;
+	}
+
+	return decoder;
+}
+
+// Decompresses an LZMA stream until it ends or until the output callback stops the decoder.
+//
+// @Parameters:
+// 1. decoder - The Lzma_Decoder structure returned by create_lzma_decoder().
+//
+// @Returns: True if the stream was decompressed successfully or if the output callback stopped the decoder. Otherwise, false.
+bool decode_lzma_stream(Lzma_Decoder* decoder)
+{
+	decoder->range = 0xFFFFFFFF;
+	decoder->code = 0;
+	
+	u8 first_byte = read_lzma_byte(decoder);
+	for(int i = 0; i < 4; ++i)
+	{
+		decoder->code = (decoder->code << 8) | read_lzma_byte(decoder);
+	}
+
+	if(first_byte != 0 || decoder->code == decoder->range) decoder->is_corrupted = true;
+
+	Lzma_Probabilities* probabilities = &(decoder->probabilities);
+	bool is_size_known = (decoder->uncompressed_size != LZMA_UNKNOWN_SIZE);
+	u64 remaining_size = decoder->uncompressed_size;
+	u32 pos_mask = ((u32) 1 << decoder->pos_bits) - 1;
+	u32 literal_pos_mask = ((u32) 1 << decoder->literal_pos_bits) - 1;
+	
+	u32 state = 0;
+	u32 rep_0 = 0, rep_1 = 0, rep_2 = 0, rep_3 = 0;
+	bool reached_end = false;
+
+	while(!decoder->is_corrupted && !decoder->was_stopped)
+	{
+		if(decoder->window_position - decoder->flushed_position >= LZMA_FLUSH_SIZE)
+		{
+			flush_lzma_window(decoder);
+			if(decoder->was_stopped) break;
+		}
+
+		// We don't require the end marker when the size is known.
+		if(is_size_known && remaining_size == 0)
+		{
+			reached_end = true;
+			break;
+		}
+
+		u32 pos_state = (u32) decoder->total_position & pos_mask;
+
+		if(decode_lzma_bit(decoder, &probabilities->is_match[(state << LZMA_NUM_POS_BITS_MAX) + pos_state]) == 0)
+		{
+			u32 previous_byte = (decoder->total_position > 0) ? (get_lzma_byte(decoder, 1)) : (0);
+			u32 literal_state = (((u32) decoder->total_position & literal_pos_mask) << decoder->literal_context_bits) + (previous_byte >> (8 - decoder->literal_context_bits));
+			Lzma_Probability* literal_probabilities = decoder->literal_probabilities + 0x300 * literal_state;
+			
+			u32 symbol = 1;
+			if(state >= 7)
+			{
+				u32 match_byte = get_lzma_byte(decoder, rep_0 + 1);
+				do
+				{
+					u32 match_bit = (match_byte >> 7) & 1;
+					match_byte <<= 1;
+					u32 bit = decode_lzma_bit(decoder, &literal_probabilities[((1 + match_bit) << 8) + symbol]);
+					symbol = (symbol << 1) | bit;
+					if(match_bit != bit) break;
+				} while(symbol < 0x100);
+			}
+
+			while(symbol < 0x100)
+			{
+				symbol = (symbol << 1) | decode_lzma_bit(decoder, &literal_probabilities[symbol]);
+			}
+
+			put_lzma_byte(decoder, (u8) (symbol - 0x100));
+			remaining_size -= 1;
+			
+			if(state < 4) state = 0;
+			else if(state < 10) state -= 3;
+			else state -= 6;
+
+			continue;
+		}
+
+		u32 length = 0;
+
+		if(decode_lzma_bit(decoder, &probabilities->is_rep[state]) != 0)
+		{
+			if(decoder->total_position == 0)
+			{
+				decoder->is_corrupted = true;
+				break;
+			}
+
+			if(decode_lzma_bit(decoder, &probabilities->is_rep_g0[state]) == 0)
+			{
+				// A single byte at the last distance.
+				if(decode_lzma_bit(decoder, &probabilities->is_rep_0_long[(state << LZMA_NUM_POS_BITS_MAX) + pos_state]) == 0)
+				{
+					state = (state < 7) ? (9) : (11);
+					put_lzma_byte(decoder, get_lzma_byte(decoder, rep_0 + 1));
+					remaining_size -= 1;
+					continue;
+				}
+			}
+			else
+			{
+				u32 distance = 0;
+				if(decode_lzma_bit(decoder, &probabilities->is_rep_g1[state]) == 0)
+				{
+					distance = rep_1;
+				}
+				else
+				{
+					if(decode_lzma_bit(decoder, &probabilities->is_rep_g2[state]) == 0)
+					{
+						distance = rep_2;
+					}
+					else
+					{
+						distance = rep_3;
+						rep_3 = rep_2;
+					}
+					rep_2 = rep_1;
+				}
+				rep_1 = rep_0;
+				rep_0 = distance;
+			}
+
+			length = decode_lzma_length(decoder, &probabilities->rep_length, pos_state);
+			state = (state < 7) ? (8) : (11);
+		}
+		else
+		{
+			rep_3 = rep_2;
+			rep_2 = rep_1;
+			rep_1 = rep_0;
+			length = decode_lzma_length(decoder, &probabilities->length, pos_state);
+			state = (state < 7) ? (7) : (10);
+			rep_0 = decode_lzma_distance(decoder, length);
+
+			if(rep_0 == 0xFFFFFFFF)
+			{
+				reached_end = (decoder->code == 0);
+				if(!reached_end) decoder->is_corrupted = true;
+				break;
+			}
+		}
+
+		// The distance must point to a byte in the window, which is only smaller than the dictionary if the caller doesn't need
+		// the entire stream.
+		if(rep_0 >= decoder->window_size || (!decoder->is_window_full && rep_0 >= decoder->window_position))
+		{
+			decoder->is_corrupted = true;
+			break;
+		}
+
+		length += LZMA_MATCH_MIN_LEN;
+		if(is_size_known && remaining_size < length)
+		{
+			decoder->is_corrupted = true;
+			break;
+		}
+
+		for(u32 i = 0; i < length; ++i)
+		{
+			put_lzma_byte(decoder, get_lzma_byte(decoder, rep_0 + 1));
+		}
+		remaining_size -= length;
+	}
+
+	flush_lzma_window(decoder);
+
+	return !decoder->is_corrupted && (decoder->was_stopped || reached_end);
+}
+
+// The state used by decompress_lzma_buffer() to copy the decompressed data to the destination buffer.
+struct Lzma_Buffer_Output
+{
+	u8* buffer;
+	u32 buffer_size;
+	u32 num_bytes_written;
+};
+
+// Called by decompress_lzma_buffer() to copy each chunk of decompressed data. Stops the decoder once the buffer is full.
+static LZMA_OUTPUT_CALLBACK(lzma_buffer_output_callback)
+{
+	Lzma_Buffer_Output* output = (Lzma_Buffer_Output*) user_data;
+	
+	u32 num_bytes_to_copy = MIN(data_size, output->buffer_size - output->num_bytes_written);
+	CopyMemory(output->buffer + output->num_bytes_written, data, num_bytes_to_copy);
+	output->num_bytes_written += num_bytes_to_copy;
+
+	return output->num_bytes_written < output->buffer_size;
+}
+
+// Decompresses a buffer that contains an LZMA stream without the header used by the .lzma format (i.e. where the properties
+// are stored separately). This function stops when the destination buffer is full, meaning it can be used to decompress only
+// the beginning of the data.
+//
+// @Parameters:
+// 1. arena - The Arena structure that is used to hold the decoder's state. This memory is only freed when the caller clears the
+// arena.
+// 2. properties - The five bytes that contain the stream's properties and dictionary size.
+// 3. uncompressed_size - The size of the decompressed data, or LZMA_UNKNOWN_SIZE if it's not known.
+// 4. source_buffer - The compressed data.
+// 5. source_size - The size of the compressed data in bytes.
+// 6. destination_buffer - The buffer that receives the decompressed data.
+// 7. destination_size - The size of the destination buffer in bytes.
+// 8. result_size - The number of decompressed bytes that were written to the destination buffer.
+// 
+// @Returns: True if the data was decompressed successfully. Otherwise, false.
+bool decompress_lzma_buffer(Arena* arena, const void* properties, u64 uncompressed_size, const void* source_buffer, u32 source_size,
+							void* destination_buffer, u32 destination_size, u32* result_size)
+{
+	*result_size = 0;
+
+	// Any match that goes past the destination buffer's size would point to data that we don't need.
+	Lzma_Properties lzma_properties = {};
+	if(!parse_lzma_properties(properties, uncompressed_size, destination_size, &lzma_properties)) return false;
+
+	Lzma_Input input = {};
+	input.file_handle = INVALID_HANDLE_VALUE;
+	input.buffer = source_buffer;
+	input.buffer_size = source_size;
+
+	Lzma_Buffer_Output output = {};
+	output.buffer = (u8*) destination_buffer;
+	output.buffer_size = destination_size;
+
+	Lzma_Decoder* decoder = create_lzma_decoder(arena, &lzma_properties, &input, lzma_buffer_output_callback, &output);
+	bool success = (decoder != NULL) && decode_lzma_stream(decoder);
+	
+	if(decoder != NULL && !success)
+	{
+		log_error("Decompress Lzma Buffer: Failed to decompress %I32u bytes after writing %I32u bytes.", source_size, output.num_bytes_written);
+	}
+
+	*result_size = output.num_bytes_written;
+	return success;
+}
+
+// Retrieves the data of a specified registry value of type string (REG_SZ).
+//
+// This function was created to replace RegGetValue() from ADVAPI32.DLL since it was only available from version 5.2 onwards
+// (Windows Server 2003 or later).
+//
+// This function is usually called by using the macro query_registry(), which takes the same arguments but where key_name and
+// value_name are ANSI strings (for convenience).
+//
+// @Parameters:
+// 1. hkey - The handle to an open registry key. This can be one of the following predefined keys:
+// - HKEY_CLASSES_ROOT
+// - HKEY_CURRENT_USER
+// - HKEY_LOCAL_MACHINE
+// - HKEY_USERS
+// (Note that you may use others if you're targeting versions that are more recent than Windows 98).
+// 2. key_name - The name of the registry subkey to query.
+// 3. value_name - The name of the registry value to query.
+// 4. value_data - The buffer that receives the resulting string read from the registry value.
+// 5. value_data_size - The size of the buffer in bytes. This must include the null terminator.
+// 
+// @Returns: True if the value was retrieved successfully. Otherwise, false.
+bool tchar_query_registry(HKEY hkey, const TCHAR* key_name, const TCHAR* value_name, TCHAR* value_data, u32 value_data_size)
+{
+	bool success = true;
+
+	HKEY opened_key = NULL;
+	LONG error_code = RegOpenKeyEx(hkey, key_name, 0, KEY_QUERY_VALUE, &opened_key);
+	success = (error_code == ERROR_SUCCESS);
+
+	if(!success)
+	{
+		log_error("Query Registry: Failed to open the registry key '%s' with the error code %lu.", key_name, error_code);
+		return success;
+	}
+
+	DWORD value_data_type = REG_NONE;
+	DWORD actual_value_data_size = value_data_size;
+	// When RegQueryValueEx() returns, actual_value_data_size contains the size of the data that was copied to the buffer.
+	// For strings, this size includes any terminating null characters unless the data was stored without them.
+	error_code = RegQueryValueEx(opened_key, value_name, NULL, &value_data_type, (LPBYTE) value_data, &actual_value_data_size);
+	success = (error_code == ERROR_SUCCESS);
+	RegCloseKey(opened_key);
+
+	_ASSERT(actual_value_data_size > 0);
+
+	if(success)
 	{
 		if(value_data_type == REG_SZ)
 		{
@@ -4145,105 +5649,428 @@ bool tchar_query_registry(HKEY hkey, const TCHAR* key_name, const TCHAR* value_n
 	return success;
 }
 
-// Retrieves a specific file property from an executable or DLL.
+/*
+	Portable Executable (PE) version information parser. This replaces the GetFileVersionInfo() and VerQueryValue() functions
+	so that the file is only read once and every property is retrieved in a single pass.
+
+	@ByteOrder: Little Endian.
+
+	@Docs:
+	- PE Format: https://docs.microsoft.com/en-us/windows/win32/debug/pe-format
+	- VS_VERSIONINFO structure: https://docs.microsoft.com/en-us/windows/win32/menurc/vs-versioninfo
+*/
+
+#pragma pack(push, 1)
+
+struct Pe_Section_Header
+{
+	u8 name[8];
+	u32 virtual_size;
+	u32 virtual_address;
+	u32 size_of_raw_data;
+	u32 pointer_to_raw_data;
+	u32 pointer_to_relocations;
+	u32 pointer_to_line_numbers;
+	u16 num_relocations;
+	u16 num_line_numbers;
+	u32 characteristics;
+};
+
+struct Pe_Resource_Directory
+{
+	u32 characteristics;
+	u32 time_date_stamp;
+	u16 major_version;
+	u16 minor_version;
+	u16 num_named_entries;
+	u16 num_id_entries;
+};
+
+struct Pe_Resource_Directory_Entry
+{
+	u32 name_or_id;
+	u32 offset_to_data; // Relative to the beginning of the resource section.
+};
+
+struct Pe_Resource_Data_Entry
+{
+	u32 data_rva;
+	u32 size;
+	u32 code_page;
+	u32 reserved;
+};
+
+struct Version_Info_Block_Header
+{
+	u16 length;
+	u16 value_length;
+	u16 type;
+};
+
+#pragma pack(pop)
+
+_STATIC_ASSERT(sizeof(Pe_Section_Header) == 40);
+_STATIC_ASSERT(sizeof(Pe_Resource_Directory) == 16);
+_STATIC_ASSERT(sizeof(Pe_Resource_Directory_Entry) == 8);
+_STATIC_ASSERT(sizeof(Pe_Resource_Data_Entry) == 16);
+
+const u32 PE_DOS_HEADER_SIZE = 64;
+const u32 PE_DOS_NEW_HEADER_OFFSET = 0x3C;
+const u32 PE_FILE_HEADER_SIZE = 20;
+const u16 PE_32_MAGIC = 0x010B;
+const u16 PE_32_PLUS_MAGIC = 0x020B;
+const u32 PE_RESOURCE_DIRECTORY_INDEX = 2;
+const u32 PE_RESOURCE_TYPE_VERSION = 16; // RT_VERSION
+const u32 PE_RESOURCE_SUBDIRECTORY_FLAG = 0x80000000;
+
+// Converts a relative virtual address (RVA) to a pointer in the mapped file, using the section headers.
+//
+// @Parameters:
+// 1. file - The mapped file.
+// 2. file_size - The file's size in bytes.
+// 3. sections - The section headers.
+// 4. num_sections - The number of section headers.
+// 5. rva - The relative virtual address.
+// 6. size - How many bytes must be available at this address.
+//
+// @Returns: The address in the mapped file, or NULL if the RVA doesn't belong to any section or if the data goes past the end of
+// the file.
+static const u8* pe_rva_to_pointer(const u8* file, u64 file_size, const Pe_Section_Header* sections, u16 num_sections, u32 rva, u32 size)
+{
+	for(u16 i = 0; i < num_sections; ++i)
+	{
+		const Pe_Section_Header* section = &sections[i];
+		u64 section_size = MAX(section->virtual_size, section->size_of_raw_data);
+
+		if(section->virtual_address <= rva && rva < section->virtual_address + section_size)
+		{
+			u64 file_offset = (u64) section->pointer_to_raw_data + (rva - section->virtual_address);
+			return (file_offset + size <= file_size) ? (file + file_offset) : (NULL);
+		}
+	}
+
+	return NULL;
+}
+
+// Finds an entry in a resource directory.
+//
+// @Parameters:
+// 1. resources - The beginning of the resource section.
+// 2. resources_size - The resource section's size in bytes.
+// 3. directory_offset - The offset of the resource directory relative to the beginning of the resource section.
+// 4. use_id - Whether to look for a specific ID. If false, the first entry is returned.
+// 5. id - The ID to look for.
+//
+// @Returns: The resource directory entry, or NULL if it doesn't exist.
+static const Pe_Resource_Directory_Entry* find_pe_resource_entry(const u8* resources, u32 resources_size, u32 directory_offset, bool use_id, u32 id)
+{
+	if(directory_offset > resources_size || resources_size - directory_offset < sizeof(Pe_Resource_Directory)) return NULL;
+
+	const Pe_Resource_Directory* directory = (Pe_Resource_Directory*) (resources + directory_offset);
+	u32 num_entries = (u32) directory->num_named_entries + directory->num_id_entries;
+	u32 entries_offset = directory_offset + (u32) sizeof(Pe_Resource_Directory);
+	if((resources_size - entries_offset) / sizeof(Pe_Resource_Directory_Entry) < num_entries) return NULL;
+
+	const Pe_Resource_Directory_Entry* entries = (Pe_Resource_Directory_Entry*) (resources + entries_offset);
+	if(!use_id) return (num_entries > 0) ? (&entries[0]) : (NULL);
+
+	// The named entries always come before the ones identified by an ID.
+	for(u32 i = directory->num_named_entries; i < num_entries; ++i)
+	{
+		if(entries[i].name_or_id == id) return &entries[i];
+	}
+
+	return NULL;
+}
+
+// Finds the version information resource in a mapped PE file.
+//
+// @Parameters:
+// 1. file - The mapped file.
+// 2. file_size - The file's size in bytes.
+// 3. result_size - The address of the variable that receives the version information's size in bytes.
+//
+// @Returns: The address of the version information, or NULL if the file isn't a valid PE file or if it doesn't have this resource.
+// If there is more than one language, the first one is used.
+static const u8* find_pe_version_resource(const u8* file, u64 file_size, u32* result_size)
+{
+	*result_size = 0;
+
+	if(file_size < PE_DOS_HEADER_SIZE || !memory_is_equal(file, "MZ", 2)) return NULL;
+
+	u32 pe_header_offset = *(u32*) (file + PE_DOS_NEW_HEADER_OFFSET);
+	if((u64) pe_header_offset + 4 + PE_FILE_HEADER_SIZE > file_size || !memory_is_equal(file + pe_header_offset, "PE\0\0", 4)) return NULL;
+
+	const u8* file_header = file + pe_header_offset + 4;
+	u16 num_sections = *(u16*) (file_header + 2);
+	u16 optional_header_size = *(u16*) (file_header + 16);
+
+	const u8* optional_header = file_header + PE_FILE_HEADER_SIZE;
+	u64 section_table_offset = (u64) (optional_header - file) + optional_header_size;
+	if(optional_header_size < 2 || section_table_offset + (u64) num_sections * sizeof(Pe_Section_Header) > file_size) return NULL;
+
+	// The data directories are located at different offsets in 32 and 64-bit files.
+	u16 magic = *(u16*) optional_header;
+	u32 num_data_directories_offset = 0;
+	if(magic == PE_32_MAGIC) num_data_directories_offset = 92;
+	else if(magic == PE_32_PLUS_MAGIC) num_data_directories_offset = 108;
+	else return NULL;
+
+	u32 resource_directory_offset = num_data_directories_offset + 4 + PE_RESOURCE_DIRECTORY_INDEX * 8;
+	if(optional_header_size < resource_directory_offset + 8) return NULL;
+
+	u32 num_data_directories = *(u32*) (optional_header + num_data_directories_offset);
+	if(num_data_directories <= PE_RESOURCE_DIRECTORY_INDEX) return NULL;
+
+	u32 resources_rva = *(u32*) (optional_header + resource_directory_offset);
+	u32 resources_size = *(u32*) (optional_header + resource_directory_offset + 4);
+	if(resources_rva == 0 || resources_size == 0) return NULL;
+
+	const Pe_Section_Header* sections = (Pe_Section_Header*) (file + section_table_offset);
+	const u8* resources = pe_rva_to_pointer(file, file_size, sections, num_sections, resources_rva, 0);
+	if(resources == NULL) return NULL;
+	resources_size = (u32) MIN(resources_size, file_size - (u64) (resources - file));
+
+	// The resource tree has three levels: type, name, and language.
+	const Pe_Resource_Directory_Entry* type_entry = find_pe_resource_entry(resources, resources_size, 0, true, PE_RESOURCE_TYPE_VERSION);
+	if(type_entry == NULL || (type_entry->offset_to_data & PE_RESOURCE_SUBDIRECTORY_FLAG) == 0) return NULL;
+
+	const Pe_Resource_Directory_Entry* name_entry = find_pe_resource_entry(resources, resources_size, type_entry->offset_to_data & ~PE_RESOURCE_SUBDIRECTORY_FLAG, false, 0);
+	if(name_entry == NULL || (name_entry->offset_to_data & PE_RESOURCE_SUBDIRECTORY_FLAG) == 0) return NULL;
+
+	const Pe_Resource_Directory_Entry* language_entry = find_pe_resource_entry(resources, resources_size, name_entry->offset_to_data & ~PE_RESOURCE_SUBDIRECTORY_FLAG, false, 0);
+	if(language_entry == NULL || (language_entry->offset_to_data & PE_RESOURCE_SUBDIRECTORY_FLAG) != 0) return NULL;
+
+	u32 data_entry_offset = language_entry->offset_to_data;
+	if(data_entry_offset > resources_size || resources_size - data_entry_offset < sizeof(Pe_Resource_Data_Entry)) return NULL;
+
+	const Pe_Resource_Data_Entry* data_entry = (Pe_Resource_Data_Entry*) (resources + data_entry_offset);
+	const u8* version_info = pe_rva_to_pointer(file, file_size, sections, num_sections, data_entry->data_rva, data_entry->size);
+	if(version_info != NULL) *result_size = data_entry->size;
+
+	return version_info;
+}
+
+// A block in the version information, which contains a key, an optional value, and any number of child blocks.
+struct Version_Info_Block
+{
+	u32 end_offset;
+
+	const u16* key;
+	u32 num_key_chars;
+
+	u16 type;
+	u32 value_offset;
+	u32 value_size;
+
+	u32 children_offset;
+};
+
+// Reads a block in the version information.
+//
+// @Parameters:
+// 1. version_info - The version information.
+// 2. parent_end_offset - The offset where the parent block ends, which limits this block's size.
+// 3. offset - The offset of the block relative to the beginning of the version information.
+// 4. block - The Version_Info_Block structure that receives the block's information.
+//
+// @Returns: True if the block was read successfully. Otherwise, false.
+static bool read_version_info_block(const u8* version_info, u32 parent_end_offset, u32 offset, Version_Info_Block* block)
+{
+	if(offset > parent_end_offset || parent_end_offset - offset < sizeof(Version_Info_Block_Header)) return false;
+
+	const Version_Info_Block_Header* header = (Version_Info_Block_Header*) (version_info + offset);
+	if(header->length < sizeof(Version_Info_Block_Header)) return false;
+
+	block->end_offset = MIN(offset + header->length, parent_end_offset);
+	block->key = (u16*) (version_info + offset + sizeof(Version_Info_Block_Header));
+	block->num_key_chars = 0;
+
+	u32 max_key_chars = (u32) ((block->end_offset - offset - sizeof(Version_Info_Block_Header)) / sizeof(u16));
+	while(block->num_key_chars < max_key_chars && block->key[block->num_key_chars] != 0) ++(block->num_key_chars);
+	if(block->num_key_chars == max_key_chars) return false;
+
+	u32 key_end_offset = (u32) (offset + sizeof(Version_Info_Block_Header) + (block->num_key_chars + 1) * sizeof(u16));
+
+	// The value's length is in characters for text values and in bytes for binary ones.
+	block->type = header->type;
+	block->value_offset = MIN(ALIGN_UP(key_end_offset, 4), block->end_offset);
+	block->value_size = (header->type == 1) ? ((u32) (header->value_length * sizeof(u16))) : (header->value_length);
+	block->value_size = MIN(block->value_size, block->end_offset - block->value_offset);
+	block->children_offset = MIN(ALIGN_UP(block->value_offset + block->value_size, 4), block->end_offset);
+
+	return true;
+}
+
+// Checks if a version information block's key is equal to an ASCII string.
+static bool version_info_key_is_equal(const Version_Info_Block* block, const char* key)
+{
+	u32 i = 0;
+	for(; i < block->num_key_chars && key[i] != '\0'; ++i)
+	{
+		if(block->key[i] != (u8) key[i]) return false;
+	}
+	return i == block->num_key_chars && key[i] == '\0';
+}
+
+// Converts a string table's key (e.g. "040904B0") to its language and code page identifier (e.g. 0x040904B0).
+static bool version_info_key_to_translation(const Version_Info_Block* block, u32* result_translation)
+{
+	if(block->num_key_chars != 8) return false;
+
+	u32 translation = 0;
+	for(u32 i = 0; i < block->num_key_chars; ++i)
+	{
+		u16 c = block->key[i];
+		u32 digit = 0;
+		if(L'0' <= c && c <= L'9') digit = c - L'0';
+		else if(L'a' <= c && c <= L'f') digit = c - L'a' + 10;
+		else if(L'A' <= c && c <= L'F') digit = c - L'A' + 10;
+		else return false;
+		translation = (translation << 4) | digit;
+	}
+
+	*result_translation = translation;
+	return true;
+}
+
+// Retrieves every property string (description, version, copyright, etc) from an executable or DLL. This function reads the PE
+// file's version resource directly, meaning the file is only mapped once regardless of how many properties are used.
+//
+// The string table whose language and code page match the first value in "\VarFileInfo\Translation" is used. If there's no
+// match, the first string table is used instead. 16-bit (NE) executables are not supported.
 //
 // @Parameters:
-// 1. arena - The Arena structure that will receive the file property as a string.
+// 1. arena - The Arena structure that will receive the property strings.
 // 2. full_file_path - The full path to the file.
-// 3. info_type - The file property to retrieve.
-// 4. result_info - The resulting file property string.
+// 3. result_info - The File_Info structure that receives the property strings. Any missing properties are set to NULL.
 // 
-// @Returns: True if the specified file property was read successfully. Otherwise, false.
-bool get_file_info(Arena* arena, const TCHAR* full_file_path, File_Info_Type info_type, TCHAR** result_info)
+// @Returns: True if the file has version information. Otherwise, false.
+bool get_file_info(Arena* arena, const TCHAR* full_file_path, File_Info* result_info)
 {
-	// @Assert: The requested file info type is handled and is associated with a string identifier.
-	_ASSERT(0 <= info_type && info_type < NUM_FILE_INFO_TYPES);
+	ZeroMemory(result_info, sizeof(File_Info));
 
-	// @Assert: The file path argument is an absolute path. Otherwise, it searches for it in various locations
-	// as specified by LoadLibrary().
-	_ASSERT(PathIsRelative(full_file_path) == FALSE);
+	HANDLE file_handle = create_handle(full_file_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS);
+	if(file_handle == INVALID_HANDLE_VALUE) return false;
 
+	u64 file_size = 0;
+	void* file = memory_map_entire_file(file_handle, &file_size);
+	
 	bool success = false;
+	u32 version_info_size = 0;
+	const u8* version_info = (file != NULL) ? (find_pe_version_resource((u8*) file, file_size, &version_info_size)) : (NULL);
 
-	DWORD handle = 0;
-	DWORD info_size = GetFileVersionInfoSize(full_file_path, &handle);
-	if(info_size > 0)
+	Version_Info_Block root = {};
+	if(version_info != NULL && read_version_info_block(version_info, version_info_size, 0, &root)
+		&& version_info_key_is_equal(&root, "VS_VERSION_INFO"))
 	{
-		void* info_block = push_arena(arena, info_size, char);
-		if(GetFileVersionInfo(full_file_path, handle, info_size, info_block) != FALSE)
-		{
-			struct Language_Code_Page_Info
-			{
-				WORD wLanguage;
-				WORD wCodePage;
-			};
+		/*
+			>>>> Find the preferred translation and the string tables.
+		*/
+
+		bool found_translation = false;
+		u32 translation = 0;
 
-			Language_Code_Page_Info* language_code_page_info = NULL;
-			UINT queried_info_size = 0;
+		bool found_string_file_info = false;
+		Version_Info_Block string_file_info = {};
 
-			if(VerQueryValue(info_block, T("\\VarFileInfo\\Translation"), (LPVOID*) &language_code_page_info, &queried_info_size) != FALSE)
+		Version_Info_Block child = {};
+		for(u32 child_offset = root.children_offset;
+			read_version_info_block(version_info, root.end_offset, child_offset, &child);
+			child_offset = ALIGN_UP(child.end_offset, 4))
+		{
+			if(version_info_key_is_equal(&child, "StringFileInfo"))
 			{
-				UINT num_languages_and_code_pages = queried_info_size / sizeof(Language_Code_Page_Info);
-				if(num_languages_and_code_pages > 0)
+				string_file_info = child;
+				found_string_file_info = true;
+			}
+			else if(version_info_key_is_equal(&child, "VarFileInfo"))
+			{
+				Version_Info_Block var = {};
+				for(u32 var_offset = child.children_offset;
+					!found_translation && read_version_info_block(version_info, child.end_offset, var_offset, &var);
+					var_offset = ALIGN_UP(var.end_offset, 4))
 				{
-					if(num_languages_and_code_pages > 1)
+					if(version_info_key_is_equal(&var, "Translation") && var.value_size >= 4)
 					{
-						log_warning("Get File Info: Ignoring %d language and code page info structures for the file '%s' and info type %d.", num_languages_and_code_pages - 1, full_file_path, info_type);
+						u16 language = *(u16*) (version_info + var.value_offset);
+						u16 code_page = *(u16*) (version_info + var.value_offset + 2);
+						translation = ((u32) language << 16) | code_page;
+						found_translation = true;
 					}
+				}
+			}
+		}
 
-					WORD language = language_code_page_info[0].wLanguage;
-					WORD code_page = language_code_page_info[0].wCodePage;
-					const char* info_type_string = FILE_INFO_TYPE_TO_STRING[info_type];
-
-					TCHAR* string_subblock = push_arena(arena, info_size, TCHAR);
-					StringCbPrintf(string_subblock, info_size, T("\\StringFileInfo\\%04x%04x\\%hs"), language, code_page, info_type_string);
+		/*
+			>>>> Read every property string in the chosen string table.
+		*/
 
-					TCHAR* file_information = NULL;
-					UINT file_information_size = 0;
+		Version_Info_Block string_table = {};
+		bool found_string_table = false;
 
-					if(VerQueryValue(info_block, string_subblock, (LPVOID*) &file_information, &file_information_size) != FALSE)
-					{
-						if(file_information_size > 0)
-						{
-							if(code_page != CODE_PAGE_WINDOWS_1252 && code_page != CODE_PAGE_UTF_16_LE)
-							{
-								log_info("Get File Info: Found code page %u in the info for the file '%s' and info type %d.", code_page, full_file_path, info_type);
-							}
+		if(found_string_file_info)
+		{
+			Version_Info_Block table = {};
+			for(u32 table_offset = string_file_info.children_offset;
+				read_version_info_block(version_info, string_file_info.end_offset, table_offset, &table);
+				table_offset = ALIGN_UP(table.end_offset, 4))
+			{
+				u32 table_translation = 0;
+				bool matches_translation = found_translation && version_info_key_to_translation(&table, &table_translation)
+										&& table_translation == translation;
 
-							// This file information was found in the info_block which is already part of our own memory arena.
-							*result_info = file_information;
-							success = true;
-						}
-						else
-						{
-							log_warning("Get File Info: No language and code page info for the file '%s' and info type %d.", full_file_path, info_type);
-						}
-					}
-					else
-					{
-						log_error("Get File Info: Failed to query the language and code page info for the file '%s' and info type %d. The subblock query was '%s'.", full_file_path, info_type, string_subblock);
-					}
-				}
-				else
+				if(!found_string_table || matches_translation)
 				{
-					log_warning("Get File Info: No translation info found for the file '%s' and info type %d.", full_file_path, info_type);
+					string_table = table;
+					found_string_table = true;
+					if(matches_translation) break;
 				}
 			}
-			else
-			{
-				log_error("Get File Info: Failed to query the translation info for the file '%s' and info type %d.", full_file_path, info_type);
-			}
 		}
-		else
+
+		if(found_string_table)
 		{
-			log_error("Get File Info: Failed to get the version info for the file '%s' and info type %d with the error code %lu.", full_file_path, info_type, GetLastError());
+			Version_Info_Block string = {};
+			for(u32 string_offset = string_table.children_offset;
+				read_version_info_block(version_info, string_table.end_offset, string_offset, &string);
+				string_offset = ALIGN_UP(string.end_offset, 4))
+			{
+				for(int i = 0; i < NUM_FILE_INFO_TYPES; ++i)
+				{
+					if(result_info->strings[i] == NULL && version_info_key_is_equal(&string, FILE_INFO_TYPE_TO_STRING[i]))
+					{
+						// Copy the value since it may not be null terminated.
+						const u16* value = (u16*) (version_info + string.value_offset);
+						u32 num_value_chars = 0;
+						while(num_value_chars < string.value_size / sizeof(u16) && value[num_value_chars] != 0) ++num_value_chars;
+
+						wchar_t* utf_16_value = push_array_to_arena(arena, num_value_chars + 1, wchar_t);
+						CopyMemory(utf_16_value, value, num_value_chars * sizeof(wchar_t));
+						utf_16_value[num_value_chars] = L'\0';
+
+						#ifdef WCE_9X
+							result_info->strings[i] = convert_utf_16_string_to_tchar(arena, utf_16_value);
+						#else
+							result_info->strings[i] = utf_16_value;
+						#endif
+
+						break;
+					}
+				}
+			}
+
+			success = true;
 		}
 	}
-	else if(GetLastError() != ERROR_RESOURCE_DATA_NOT_FOUND && GetLastError() != ERROR_RESOURCE_TYPE_NOT_FOUND)
+	else if(version_info != NULL)
 	{
-		log_error("Get File Info: Failed to determine the version info size for the file '%s' and info type %d with the error code %lu.", full_file_path, info_type, GetLastError());
+		log_warning("Get File Info: The version information in the file '%s' is malformed.", full_file_path);
 	}
 
+	safe_unmap_view_of_file(&file);
+	safe_close_handle(&file_handle);
+
 	return success;
 }
 
@@ -4256,6 +6083,9 @@ bool get_file_info(Arena* arena, const TCHAR* full_file_path, File_Info_Type inf
 // @Returns: True if the log file was created successfully. Otherwise, it returns false and all future log_print() calls
 // will do nothing.
 static HANDLE GLOBAL_LOG_FILE_HANDLE = INVALID_HANDLE_VALUE;
+// Serializes the writes to the log file since multiple profiles may be exported at the same time. See: tchar_log_print().
+static CRITICAL_SECTION GLOBAL_LOG_CRITICAL_SECTION;
+static bool GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED = false;
 bool create_log_file(const TCHAR* log_file_path)
 {
 	if(GLOBAL_LOG_FILE_HANDLE != INVALID_HANDLE_VALUE)
@@ -4264,6 +6094,12 @@ bool create_log_file(const TCHAR* log_file_path)
 		return false;
 	}
 
+	if(!GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED)
+	{
+		InitializeCriticalSection(&GLOBAL_LOG_CRITICAL_SECTION);
+		GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED = true;
+	}
+
 	// Create any missing intermediate directories. 
 	TCHAR full_log_directory_path[MAX_PATH_CHARS] = T("");
 	get_full_path_name(log_file_path, full_log_directory_path);
@@ -4285,6 +6121,12 @@ bool create_log_file(const TCHAR* log_file_path)
 void close_log_file(void)
 {
 	safe_close_handle(&GLOBAL_LOG_FILE_HANDLE);
+
+	if(GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED)
+	{
+		DeleteCriticalSection(&GLOBAL_LOG_CRITICAL_SECTION);
+		GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED = false;
+	}
 }
 
 // Appends a formatted TCHAR string to the global log file. This file must have been previously created using create_log_file().
@@ -4353,7 +6195,10 @@ void tchar_log_print(Log_Type log_type, const TCHAR* string_format, ...)
 	size_t num_bytes_to_write = 0;
 	StringCbLengthA(utf_8_log_buffer, sizeof(utf_8_log_buffer), &num_bytes_to_write);
 
+	// Each line is written in one call so that the lines from different threads are never mixed together.
+	if(GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED) EnterCriticalSection(&GLOBAL_LOG_CRITICAL_SECTION);
 	write_to_file(GLOBAL_LOG_FILE_HANDLE, utf_8_log_buffer, (u32) num_bytes_to_write);
+	if(GLOBAL_LOG_CRITICAL_SECTION_INITIALIZED) LeaveCriticalSection(&GLOBAL_LOG_CRITICAL_SECTION);
 
 	SetLastError(previous_error_code);
 }
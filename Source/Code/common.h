@@ -126,6 +126,7 @@ bool format_filetime_date_time(u64 value, TCHAR* formatted_string);
 bool format_dos_date_time(Dos_Date_Time date_time, TCHAR* formatted_string);
 bool format_dos_date_time(u32 value, TCHAR* formatted_string);
 bool format_time64_t_date_time(__time64_t date_time, TCHAR* formatted_string);
+__time64_t convert_filetime_to_time64_t(u64 value);
 
 /*
 	>>>>>>>>>>>>>>>>>>>>
@@ -330,6 +331,46 @@ void traverse_directory_objects(const TCHAR* directory_path, const TCHAR* search
 								u32 traversal_flags, bool traverse_subdirectories,
 								Traverse_Directory_Callback* callback_function, void* user_data);
 
+// The types of wildcard patterns that are matched against filenames. The most common ones (e.g. "mp*" or "*.x32") are handled
+// separately so that they only require a single string comparison. See: compile_wildcard_pattern().
+enum Wildcard_Pattern_Type
+{
+	WILDCARD_MATCH_ALL = 0, // "*" or "*.*"
+	WILDCARD_MATCH_EXACT = 1, // "name.ext"
+	WILDCARD_MATCH_PREFIX = 2, // "name*"
+	WILDCARD_MATCH_SUFFIX = 3, // "*.ext"
+	WILDCARD_MATCH_GENERIC = 4 // Any other combination of "*" and "?".
+};
+
+struct Wildcard_Pattern
+{
+	Wildcard_Pattern_Type type;
+
+	// The uppercase pattern without any consecutive asterisks. The asterisk is removed from prefix and suffix patterns.
+	TCHAR text[MAX_PATH_CHARS];
+	size_t text_length;
+};
+
+void compile_wildcard_pattern(const TCHAR* pattern, Wildcard_Pattern* result_pattern);
+bool wildcard_pattern_matches(const Wildcard_Pattern* pattern, const TCHAR* name);
+
+// A search query and callback function that are used to visit objects in traverse_directory_objects_with_rules(). Each rule
+// behaves like a separate call to traverse_directory_objects() with the same parameters.
+struct Traversal_Rule
+{
+	const TCHAR* search_query;
+	u32 traversal_flags;
+	bool traverse_subdirectories;
+	Traverse_Directory_Callback* callback_function;
+	void* user_data;
+
+	// Set by traverse_directory_objects_with_rules().
+	Wildcard_Pattern pattern;
+	bool stopped_traversing;
+};
+
+void traverse_directory_objects_with_rules(const TCHAR* directory_path, Traversal_Rule* rules, int num_rules);
+
 // An array with information about each object.
 // See: find_objects_in_directory().
 struct Traversal_Result
@@ -341,6 +382,9 @@ struct Traversal_Result
 Traversal_Result* find_objects_in_directory(Arena* arena, const TCHAR* directory_path, const TCHAR* search_query,
 											u32 traversal_flags, bool traverse_subdirectories);
 
+bool take_filesystem_snapshot(Arena* arena, const TCHAR** root_paths, int num_root_paths, const TCHAR** excluded_paths, int num_excluded_paths);
+void discard_filesystem_snapshot(void);
+
 bool create_directories(const TCHAR* path_to_create, bool optional_resolve_naming_collisions = false, TCHAR* optional_result_path = NULL);
 bool delete_directory_and_contents(const TCHAR* directory_path);
 
@@ -371,11 +415,66 @@ bool copy_file_chunks(Arena* arena, const TCHAR* source_file_path, u64 total_byt
 
 bool empty_file(HANDLE file_handle);
 
-TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path);
+// Used by the functions that process a byte range of a file to specify that the range goes until the end of that file.
+const u64 READ_UNTIL_END_OF_FILE = ~((u64) 0);
+
+TCHAR* generate_sha_256_from_file(Arena* arena, const TCHAR* file_path, u64 optional_file_offset = 0, u64 optional_max_bytes_to_hash = READ_UNTIL_END_OF_FILE);
+
+const u32 SHA_256_SIZE = 32;
+bool generate_edge_sha_256_from_file(Arena* arena, const TCHAR* file_path, u64 file_size, u32 num_edge_bytes, u8* result_hash);
+
+bool decompress_gzip_zlib_deflate_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+										u64 optional_file_offset = 0, u64 optional_max_bytes_to_read = READ_UNTIL_END_OF_FILE);
+bool decompress_deflate_buffer(	Arena* arena, const void* source_buffer, u32 source_size, void* destination_buffer, u32 destination_size,
+								u32* result_size, int* result_error_code, bool optional_has_zlib_header = false);
+bool decompress_brotli_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+							u64 optional_file_offset = 0, u64 optional_max_bytes_to_read = READ_UNTIL_END_OF_FILE);
+bool decompress_compress_file(	Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code,
+								u64 optional_file_offset = 0, u64 optional_max_bytes_to_read = READ_UNTIL_END_OF_FILE);
 
-bool decompress_gzip_zlib_deflate_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code);
-bool decompress_brotli_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code);
-bool decompress_compress_file(Arena* arena, const TCHAR* source_file_path, HANDLE destination_file_handle, int* result_error_code);
+// The sizes used by the .lzma format, where the compressed data is preceded by the stream's properties and uncompressed size.
+const u32 LZMA_PROPERTIES_SIZE = 5;
+const u32 LZMA_HEADER_SIZE = LZMA_PROPERTIES_SIZE + 8;
+// Used to specify that an LZMA stream's uncompressed size is unknown, meaning it must end with an end of stream marker.
+const u64 LZMA_UNKNOWN_SIZE = ~((u64) 0);
+
+// The properties of an LZMA stream, along with the memory required to decode it. See: parse_lzma_properties().
+struct Lzma_Properties
+{
+	u32 literal_context_bits;
+	u32 literal_pos_bits;
+	u32 pos_bits;
+	u32 dictionary_size;
+	u64 uncompressed_size;
+
+	u32 window_size;
+	size_t num_literal_probabilities;
+	size_t required_memory_size;
+};
+
+// Where an LZMA stream's compressed data is stored. If the file handle is INVALID_HANDLE_VALUE, the data is read from the buffer
+// instead. See: create_lzma_decoder().
+struct Lzma_Input
+{
+	HANDLE file_handle;
+	u64 file_offset;
+	u64 file_end_offset;
+
+	const void* buffer;
+	u32 buffer_size;
+};
+
+// Called every time the LZMA decoder has a chunk of decompressed data. Returning false stops the decoder.
+#define LZMA_OUTPUT_CALLBACK(function_name) bool function_name(const u8* data, u32 data_size, void* user_data)
+typedef LZMA_OUTPUT_CALLBACK(Lzma_Output_Callback);
+
+struct Lzma_Decoder;
+bool parse_lzma_properties(const void* properties, u64 uncompressed_size, u32 max_window_size, Lzma_Properties* result_properties);
+bool read_lzma_properties(HANDLE file_handle, u64 stream_offset, u32 max_window_size, Lzma_Properties* result_properties);
+Lzma_Decoder* create_lzma_decoder(Arena* arena, Lzma_Properties* properties, Lzma_Input* input, Lzma_Output_Callback* output_callback, void* user_data);
+bool decode_lzma_stream(Lzma_Decoder* decoder);
+bool decompress_lzma_buffer(Arena* arena, const void* properties, u64 uncompressed_size, const void* source_buffer, u32 source_size,
+							void* destination_buffer, u32 destination_size, u32* result_size);
 
 bool tchar_query_registry(HKEY hkey, const TCHAR* key_name, const TCHAR* value_name, TCHAR* value_data, u32 value_data_size);
 #define query_registry(hkey, key_name, value_name, value_data, value_data_size) tchar_query_registry(hkey, T(key_name), T(value_name), value_data, value_data_size)
@@ -410,7 +509,14 @@ const char* const FILE_INFO_TYPE_TO_STRING[] =
 };
 _STATIC_ASSERT(_countof(FILE_INFO_TYPE_TO_STRING) == NUM_FILE_INFO_TYPES);
 
-bool get_file_info(Arena* arena, const TCHAR* full_file_path, File_Info_Type info_type, TCHAR** result_info);
+// The property strings stored in an executable or DLL file's information. Any missing properties are NULL.
+// See: get_file_info().
+struct File_Info
+{
+	TCHAR* strings[NUM_FILE_INFO_TYPES];
+};
+
+bool get_file_info(Arena* arena, const TCHAR* full_file_path, File_Info* result_info);
 
 extern bool GLOBAL_LOG_ENABLED;
 extern bool GLOBAL_CONSOLE_ENABLED;
@@ -549,18 +655,37 @@ enum Csv_Type
 	CSV_CUSTOM_URL_GROUP,
 	CSV_SHA_256,
 
+	// For the Mozilla cache:
+	CSV_INTEGRITY,
+	CSV_FRECENCY,
+
 	// For the Flash Player:
 	CSV_LIBRARY_SHA_256,
 
+	// Set automatically for Flash movies (SWF files):
+	CSV_SWF_VERSION,
+	CSV_STAGE_DIMENSIONS,
+	CSV_FRAME_RATE,
+	CSV_FRAME_COUNT,
+
 	// For the Shockwave Player:
 	CSV_DIRECTOR_FILE_TYPE,
 	CSV_XTRA_DESCRIPTION,
 	CSV_XTRA_VERSION,
 	CSV_XTRA_COPYRIGHT,
+	CSV_RESOURCE_ID,
+	CSV_CHUNK_ID,
 
 	// For the Java Plugin:
 	CSV_CODEBASE_IP,
 	CSV_VERSION,
+	CSV_MAIN_CLASS,
+	CSV_APPLICATION_NAME,
+	CSV_MEMBER_NAME,
+	CSV_COMPRESSED_SIZE,
+	CSV_UNCOMPRESSED_SIZE,
+	CSV_CRC_32,
+	CSV_COMPRESSION_METHOD,
 
 	// When exploring files:
 	CSV_FILE_DESCRIPTION,
@@ -568,6 +693,18 @@ enum Csv_Type
 	CSV_PRODUCT_NAME,
 	CSV_PRODUCT_VERSION,
 	CSV_COPYRIGHT,
+	CSV_DUPLICATE_OF,
+
+	// For the batch manifest summary:
+	CSV_JOB_NAME,
+	CSV_CACHE_TYPE,
+	CSV_CACHE_PATH,
+	CSV_OUTPUT_PATH,
+	CSV_JOB_STATUS,
+	CSV_ELAPSED_TIME,
+	CSV_CSV_FILES_CREATED,
+	CSV_PROCESSED_FILES,
+	CSV_COPIED_FILES,
 
 	NUM_CSV_TYPES,
 };
@@ -589,10 +726,15 @@ const char* const CSV_TYPE_TO_UTF_8_STRING[] =
 	"Location In Output", "Copy Error", "Exporter Warning",
 	"Custom File Group", "Custom URL Group", "SHA-256",
 	
+	"Integrity", "Frecency",
 	"Library SHA-256",
-	"Director File Type", "Xtra Description", "Xtra Version", "Xtra Copyright",
-	"Codebase IP", "Version",
-	"File Description", "File Version", "Product Name", "Product Version", "Copyright"
+	"SWF Version", "Stage Dimensions", "Frame Rate", "Frame Count",
+	"Director File Type", "Xtra Description", "Xtra Version", "Xtra Copyright", "Resource ID", "Chunk ID",
+	"Codebase IP", "Version", "Main Class", "Application Name",
+	"Member Name", "Compressed Size", "Uncompressed Size", "CRC-32", "Compression Method",
+	"File Description", "File Version", "Product Name", "Product Version", "Copyright", "Duplicate Of",
+	"Job Name", "Cache Type", "Cache Path", "Output Path", "Job Status", "Elapsed Time",
+	"CSV Files Created", "Processed Files", "Copied Files"
 };
 _STATIC_ASSERT(_countof(CSV_TYPE_TO_UTF_8_STRING) == NUM_CSV_TYPES);
 
@@ -7,6 +7,8 @@
 	plugin's cache.
 
 	To learn how these files are supposed to work, refer to the "About Groups.txt" help file in "Source\Groups".
+
+	This file also defines the entry filter used by the '-filter-entries' command line option. See: compile_entry_filter().
 */
 
 static const TCHAR* GROUP_FILES_SEARCH_QUERY = T("*.group");
@@ -107,10 +109,9 @@ size_t get_total_group_files_size(Exporter* exporter, int* result_num_groups)
 
 	*result_num_groups = num_groups;
 	
-	// Total Size = Size for the Group array + Size for the string data + Size for the file signature buffer.
+	// Total Size = Size for the Group array + Size for the string data.
 	return 	sizeof(Custom_Groups) + MAX(num_groups - 1, 0) * sizeof(Group)
-			+ total_group_size * sizeof(TCHAR)
-			+ MAX_FILE_SIGNATURE_BUFFER_SIZE;
+			+ total_group_size * sizeof(TCHAR);
 }
 
 // Copies the current string tokens from a line of delimited values, and converts it from UTF-8 to a TCHAR (ANSI or UTF-16 string
@@ -687,9 +688,8 @@ void load_all_group_files(Exporter* exporter, int num_groups)
 		log_error("Load All Group Files: Loaded %d groups when %d were expected.", num_processed_groups, num_groups);
 	}
 
-	log_info("Load All Group Files: Allocating %d bytes for the file signature buffer.", max_num_file_signature_bytes);
-	custom_groups->file_signature_buffer = push_arena(permanent_arena, max_num_file_signature_bytes, u8);
-	custom_groups->file_signature_buffer_size = max_num_file_signature_bytes;
+	log_info("Load All Group Files: The largest file signature has %d bytes.", max_num_file_signature_bytes);
+	custom_groups->max_file_signature_size = max_num_file_signature_bytes;
 
 	exporter->custom_groups = custom_groups;
 }
@@ -810,6 +810,91 @@ static bool url_host_and_path_match_domain(TCHAR* host, TCHAR* path, Domain* dom
 	return urls_match;
 }
 
+// Checks if a cached file could be allowed by the group filter using only its metadata (i.e. its MIME type, file extension, and URL).
+// This function follows the same rules as match_cache_entry_to_groups() but ignores the file signature, meaning that any file group
+// with at least one signature is treated as a possible match. If this function returns false, then the full match would never allow
+// the cached file to be exported, so the caller may skip any work that depends on its contents (decompressing, hashing, copying, etc).
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on the previously group files.
+// 2. entry_to_match - The Matchable_Cache_Entry structure whose input members were set, except for the file signature.
+//
+// @Returns: True if the cached file may be allowed by the group filter. Otherwise, false.
+bool can_cache_entry_pass_group_filter(Exporter* exporter, Matchable_Cache_Entry* entry_to_match)
+{
+	Arena* temporary_arena = &(exporter->temporary_arena);
+	Custom_Groups* custom_groups = exporter->custom_groups;
+
+	// If no groups were loaded.
+	if(custom_groups == NULL) return false;
+
+	TCHAR* mime_type_to_match = entry_to_match->mime_type_to_match;
+	TCHAR* file_extension_to_match = entry_to_match->file_extension_to_match;
+
+	Url_Parts url_parts_to_match = {};
+	bool partioned_url_successfully = entry_to_match->match_url_group
+									&& partition_url(temporary_arena, entry_to_match->url_to_match, &url_parts_to_match);
+
+	// The matched file group is only known once we find one whose MIME types or file extensions match, since any previous group
+	// could still be matched using its file signatures. The matched URL group is known as soon as any of its domains match.
+	bool found_file_group = !entry_to_match->match_file_group;
+	bool found_url_group = !entry_to_match->match_url_group;
+
+	for(int i = 0; i < custom_groups->num_groups && !(found_file_group && found_url_group); ++i)
+	{
+		Group* group = &(custom_groups->groups[i]);
+
+		if(group->type == GROUP_FILE && !found_file_group)
+		{
+			bool metadata_matches = false;
+
+			if(mime_type_to_match != NULL)
+			{
+				for(int j = 0; j < group->file_info.num_mime_types && !metadata_matches; ++j)
+				{
+					metadata_matches = string_begins_with(mime_type_to_match, group->file_info.mime_types[j], true);
+				}
+			}
+
+			if(file_extension_to_match != NULL)
+			{
+				for(int j = 0; j < group->file_info.num_file_extensions && !metadata_matches; ++j)
+				{
+					metadata_matches = filenames_are_equal(file_extension_to_match, group->file_info.file_extensions[j]);
+				}
+			}
+
+			bool signature_may_match = (group->file_info.num_file_signatures > 0);
+
+			if(group->enabled_for_filtering && (metadata_matches || signature_may_match))
+			{
+				return true;
+			}
+
+			// The full match would pick either this group or a previous one whose file signatures matched, and none of these
+			// are enabled for filtering.
+			found_file_group = metadata_matches;
+		}
+		else if(group->type == GROUP_URL && !found_url_group)
+		{
+			if(partioned_url_successfully)
+			{
+				for(int j = 0; j < group->url_info.num_domains && !found_url_group; ++j)
+				{
+					found_url_group = url_host_and_path_match_domain(url_parts_to_match.host, url_parts_to_match.path, group->url_info.domains[j]);
+				}
+			}
+
+			if(found_url_group && group->enabled_for_filtering)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 // Attempts to match a cached file to any previously loaded groups.
 //
 // @Parameters:
@@ -832,18 +917,14 @@ bool match_cache_entry_to_groups(Exporter* exporter, Matchable_Cache_Entry* entr
 	bool match_file_group = entry_to_match->match_file_group;
 	bool match_url_group = entry_to_match->match_url_group;
 
-	TCHAR* full_file_path = entry_to_match->full_file_path;
 	TCHAR* mime_type_to_match = entry_to_match->mime_type_to_match;
 	TCHAR* file_extension_to_match = entry_to_match->file_extension_to_match;
 
-	// Read the cached file's signature, taking into account empty files and file's smaller than the signature buffer (reading
-	// less bytes than the ones requested).
-	u32 file_signature_size = 0;
-	bool read_file_signature_successfully = does_file_exist(full_file_path)
-										&& read_first_file_bytes(full_file_path,
-																 custom_groups->file_signature_buffer,
-																 custom_groups->file_signature_buffer_size,
-																 true, &file_signature_size) && file_signature_size > 0;
+	// The cached file's signature was already read by the caller, taking into account empty files and files smaller than the
+	// largest signature.
+	u8* file_signature = entry_to_match->file_signature;
+	u32 file_signature_size = entry_to_match->file_signature_size;
+	bool read_file_signature_successfully = (file_signature != NULL) && (file_signature_size > 0);
 
 	Url_Parts url_parts_to_match = {};
 	bool partioned_url_successfully = match_url_group
@@ -861,9 +942,9 @@ bool match_cache_entry_to_groups(Exporter* exporter, Matchable_Cache_Entry* entr
 				for(int j = 0; j < group->file_info.num_file_signatures; ++j)
 				{
 					File_Signature* signature = group->file_info.file_signatures[j];
-					_ASSERT(signature->num_bytes <= custom_groups->file_signature_buffer_size);
+					_ASSERT(signature->num_bytes <= custom_groups->max_file_signature_size);
 
-					if(bytes_match_file_signature(custom_groups->file_signature_buffer, file_signature_size, signature))
+					if(bytes_match_file_signature(file_signature, file_signature_size, signature))
 					{
 						file_group = group;
 					}
@@ -942,3 +1023,450 @@ bool match_cache_entry_to_groups(Exporter* exporter, Matchable_Cache_Entry* entr
 	// If we matched at least one group.
 	return (file_group != NULL) || (url_group != NULL);
 }
+
+/*
+	The following defines the functions used to compile and evaluate the entry filter expression that is passed to the '-filter-entries'
+	command line option. Unlike the groups above, this filter is evaluated by each cache exporter using the raw values from the cache's
+	metadata, meaning that any rejected entries are skipped before formatting their dates, decoding their URLs, or reading their files.
+
+	An expression is a list of terms separated by spaces, where each term has the format "<Field><Operator><Value>". A cache entry passes
+	the filter if it matches every term. The supported fields are:
+
+	- host - Matches the end of the URL's host using the same rules as the domains in a URL group.
+	- type - Matches the beginning of the Content-Type HTTP header (case insensitive).
+	- size - Compares the cached file's size in bytes. The value may end in "K", "M", or "G" to use kilobytes, megabytes, or gigabytes.
+	- modified - Compares the last modified time (UTC) using the date formats "YYYY", "YYYY-MM", or "YYYY-MM-DD".
+
+	The host and type fields only support the "=" operator, and accept multiple values separated by commas, where the term matches if
+	any value matches. The size and modified fields support the operators "=", "<", "<=", ">", and ">=", as well as inclusive ranges
+	with the format "=<Begin>..<End>", where either limit may be omitted. Each date refers to the whole period it represents. For
+	example, "modified=2005..2009" matches any time between 2005-01-01 00:00:00 and 2009-12-31 23:59:59.
+
+	For example: "host=example.com,go.com size>100K modified=2005..2009 type=application/x-shockwave-flash"
+*/
+
+static const TCHAR* FILTER_TERM_DELIMITERS = T(" ");
+static const TCHAR* FILTER_VALUE_DELIMITERS = T(",");
+static const TCHAR* FILTER_OPERATOR_CHARS = T("<>=");
+static const TCHAR* FILTER_RANGE_SEPARATOR = T("..");
+static const size_t MAX_FILTER_OPERATOR_CHARS = 2;
+
+// Retrieves how many bytes are (roughly) required to store the compiled entry filter.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the entry filter expression.
+//
+// @Returns: The total size in bytes required to store the compiled filter.
+size_t get_entry_filter_size(Exporter* exporter)
+{
+	// Every term, value, and split string is at most as large as the expression itself. We'll also take into account any copies
+	// of the expression and alignment padding. This should guarantee enough memory (in excess) for the compiled filter.
+	size_t num_chars = string_length(exporter->entry_filter_expression) + 1;
+	return sizeof(Entry_Filter) + num_chars * (sizeof(Filter_Term) + sizeof(String_Array<TCHAR>) + 2 * sizeof(TCHAR*) + 3 * sizeof(TCHAR) + 16);
+}
+
+// Converts a size or date value from a filter expression to the range of values it represents. Sizes represent a single value while
+// dates represent the whole year, month, or day they specify.
+//
+// @Parameters:
+// 1. field - The field whose value format should be used.
+// 2. value - The value to convert.
+// 3. result_begin - The first value in the range.
+// 4. result_end - The last value in the range.
+//
+// @Returns: True if the value was converted successfully. Otherwise, false.
+static bool convert_filter_value_to_range(Filter_Field field, const TCHAR* value, s64* result_begin, s64* result_end)
+{
+	TCHAR* end = NULL;
+
+	if(field == FILTER_SIZE)
+	{
+		u64 size = _tcstoui64(value, &end, 10);
+		if(end == value) return false;
+
+		u64 multiplier = 1;
+		if(strings_are_equal(end, T("K"), true) || strings_are_equal(end, T("KB"), true)) multiplier = 1024;
+		else if(strings_are_equal(end, T("M"), true) || strings_are_equal(end, T("MB"), true)) multiplier = 1024 * 1024;
+		else if(strings_are_equal(end, T("G"), true) || strings_are_equal(end, T("GB"), true)) multiplier = 1024 * 1024 * 1024;
+		else if(!string_is_empty(end)) return false;
+
+		if(size > (u64) _I64_MAX / multiplier) return false;
+
+		*result_begin = (s64) (size * multiplier);
+		*result_end = *result_begin;
+		return true;
+	}
+	else if(field == FILTER_LAST_MODIFIED_TIME)
+	{
+		SYSTEMTIME begin_time = {};
+		begin_time.wMonth = 1;
+		begin_time.wDay = 1;
+
+		// Read each date component separated by dashes. E.g. "2005-03-01" -> 2005 + 3 + 1.
+		WORD* components[] = {&(begin_time.wYear), &(begin_time.wMonth), &(begin_time.wDay)};
+		int num_components = 0;
+		const TCHAR* remaining_value = value;
+
+		while(num_components < (int) _countof(components))
+		{
+			unsigned long component = _tcstoul(remaining_value, &end, 10);
+			if(end == remaining_value || component > 0xFFFF) return false;
+
+			*components[num_components] = (WORD) component;
+			++num_components;
+
+			if(*end != T('-')) break;
+			remaining_value = end + 1;
+		}
+
+		if(!string_is_empty(end)) return false;
+
+		// The range ends one second before the next year, month, or day begins.
+		SYSTEMTIME next_time = begin_time;
+		s64 num_seconds_to_add = 0;
+
+		if(num_components == 1)
+		{
+			++next_time.wYear;
+		}
+		else if(num_components == 2)
+		{
+			if(next_time.wMonth == 12)
+			{
+				next_time.wMonth = 1;
+				++next_time.wYear;
+			}
+			else
+			{
+				++next_time.wMonth;
+			}
+		}
+		else
+		{
+			num_seconds_to_add = 24 * 60 * 60;
+		}
+
+		// This also validates the date (e.g. the month 13 or the day 32).
+		FILETIME begin_filetime = {};
+		FILETIME next_filetime = {};
+		if(SystemTimeToFileTime(&begin_time, &begin_filetime) == FALSE || SystemTimeToFileTime(&next_time, &next_filetime) == FALSE)
+		{
+			return false;
+		}
+
+		u64 begin_value = combine_high_and_low_u32s_into_u64(begin_filetime.dwHighDateTime, begin_filetime.dwLowDateTime);
+		u64 next_value = combine_high_and_low_u32s_into_u64(next_filetime.dwHighDateTime, next_filetime.dwLowDateTime);
+
+		*result_begin = convert_filetime_to_time64_t(begin_value);
+		*result_end = convert_filetime_to_time64_t(next_value) + num_seconds_to_add - 1;
+		return true;
+	}
+	else
+	{
+		_ASSERT(false);
+		return false;
+	}
+}
+
+// Compiles an entry filter expression. See the comment at the beginning of this section for the supported syntax.
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the compiled filter and any strings it uses.
+// 2. expression - The filter expression to compile.
+// 3. result_filter - The compiled filter. This value is set to NULL if the expression is invalid.
+//
+// @Returns: True if the expression was compiled successfully. Otherwise, false.
+bool compile_entry_filter(Arena* arena, const TCHAR* expression, Entry_Filter** result_filter)
+{
+	*result_filter = NULL;
+
+	String_Array<TCHAR>* split_terms = copy_and_split_string(arena, expression, FILTER_TERM_DELIMITERS);
+	if(split_terms->num_strings == 0)
+	{
+		log_error("Compile Entry Filter: The expression '%s' does not contain any terms.", expression);
+		return false;
+	}
+
+	size_t entry_filter_size = sizeof(Entry_Filter) + sizeof(Filter_Term) * (split_terms->num_strings - 1);
+	Entry_Filter* entry_filter = push_arena(arena, entry_filter_size, Entry_Filter);
+	entry_filter->num_terms = split_terms->num_strings;
+
+	for(int i = 0; i < split_terms->num_strings; ++i)
+	{
+		TCHAR* term_string = split_terms->strings[i];
+		Filter_Term* term = &(entry_filter->terms[i]);
+		ZeroMemory(term, sizeof(Filter_Term));
+
+		// The term is modified in place below, so we'll keep the original around for any error messages.
+		TCHAR* original_term = push_string_to_arena(arena, term_string);
+
+		// Split the term into its field, operator, and value. E.g. "size>=100K" -> "size" + ">=" + "100K".
+		TCHAR* operator_begin = _tcspbrk(term_string, FILTER_OPERATOR_CHARS);
+		if(operator_begin == NULL)
+		{
+			log_error("Compile Entry Filter: The term '%s' does not contain an operator.", original_term);
+			return false;
+		}
+
+		TCHAR* value = operator_begin;
+		while(*value != T('\0') && _tcschr(FILTER_OPERATOR_CHARS, *value) != NULL)
+		{
+			++value;
+		}
+
+		size_t num_operator_chars = (size_t) (value - operator_begin);
+		if(num_operator_chars > MAX_FILTER_OPERATOR_CHARS)
+		{
+			log_error("Compile Entry Filter: The term '%s' contains an unknown operator.", original_term);
+			return false;
+		}
+
+		TCHAR operator_string[MAX_FILTER_OPERATOR_CHARS + 1] = T("");
+		CopyMemory(operator_string, operator_begin, num_operator_chars * sizeof(TCHAR));
+		*operator_begin = T('\0');
+
+		term->field = FILTER_INVALID;
+		for(int j = FILTER_INVALID + 1; j < NUM_FILTER_FIELDS; ++j)
+		{
+			if(strings_are_equal(term_string, FILTER_FIELD_TO_STRING[j], true))
+			{
+				term->field = (Filter_Field) j;
+				break;
+			}
+		}
+
+		if(term->field == FILTER_INVALID)
+		{
+			log_error("Compile Entry Filter: The term '%s' uses the unknown field '%s'.", original_term, term_string);
+			return false;
+		}
+
+		if(string_is_empty(value))
+		{
+			log_error("Compile Entry Filter: The term '%s' does not have a value.", original_term);
+			return false;
+		}
+
+		bool is_equal_operator = strings_are_equal(operator_string, T("="));
+
+		if(term->field == FILTER_HOST || term->field == FILTER_CONTENT_TYPE)
+		{
+			if(!is_equal_operator)
+			{
+				log_error("Compile Entry Filter: The term '%s' uses the operator '%s' when the field only supports '='.", original_term, operator_string);
+				return false;
+			}
+
+			String_Array<TCHAR>* split_values = split_string(arena, value, FILTER_VALUE_DELIMITERS);
+			if(split_values->num_strings == 0)
+			{
+				log_error("Compile Entry Filter: The term '%s' does not have a value.", original_term);
+				return false;
+			}
+
+			term->num_values = split_values->num_strings;
+			term->values = split_values->strings;
+		}
+		else
+		{
+			term->min_value = _I64_MIN;
+			term->max_value = _I64_MAX;
+
+			s64 range_begin = 0;
+			s64 range_end = 0;
+
+			TCHAR* range_separator = _tcsstr(value, FILTER_RANGE_SEPARATOR);
+			if(range_separator != NULL)
+			{
+				if(!is_equal_operator)
+				{
+					log_error("Compile Entry Filter: The term '%s' uses a range with the operator '%s' when only '=' is supported.", original_term, operator_string);
+					return false;
+				}
+
+				*range_separator = T('\0');
+				TCHAR* last_value = range_separator + string_length(FILTER_RANGE_SEPARATOR);
+
+				if(string_is_empty(value) && string_is_empty(last_value))
+				{
+					log_error("Compile Entry Filter: The term '%s' uses a range without any limits.", original_term);
+					return false;
+				}
+
+				if(!string_is_empty(value))
+				{
+					if(!convert_filter_value_to_range(term->field, value, &range_begin, &range_end))
+					{
+						log_error("Compile Entry Filter: The term '%s' has the invalid value '%s'.", original_term, value);
+						return false;
+					}
+
+					term->min_value = range_begin;
+				}
+
+				if(!string_is_empty(last_value))
+				{
+					if(!convert_filter_value_to_range(term->field, last_value, &range_begin, &range_end))
+					{
+						log_error("Compile Entry Filter: The term '%s' has the invalid value '%s'.", original_term, last_value);
+						return false;
+					}
+
+					term->max_value = range_end;
+				}
+			}
+			else
+			{
+				if(!convert_filter_value_to_range(term->field, value, &range_begin, &range_end))
+				{
+					log_error("Compile Entry Filter: The term '%s' has the invalid value '%s'.", original_term, value);
+					return false;
+				}
+
+				if(is_equal_operator)
+				{
+					term->min_value = range_begin;
+					term->max_value = range_end;
+				}
+				else if(strings_are_equal(operator_string, T(">=")))
+				{
+					term->min_value = range_begin;
+				}
+				else if(strings_are_equal(operator_string, T(">")))
+				{
+					term->min_value = range_end + 1;
+				}
+				else if(strings_are_equal(operator_string, T("<=")))
+				{
+					term->max_value = range_end;
+				}
+				else if(strings_are_equal(operator_string, T("<")))
+				{
+					term->max_value = range_begin - 1;
+				}
+				else
+				{
+					log_error("Compile Entry Filter: The term '%s' contains the unknown operator '%s'.", original_term, operator_string);
+					return false;
+				}
+			}
+
+			if(term->min_value > term->max_value)
+			{
+				log_error("Compile Entry Filter: The term '%s' can never be matched since its range is empty.", original_term);
+				return false;
+			}
+		}
+	}
+
+	*result_filter = entry_filter;
+	return true;
+}
+
+// Compiles the entry filter expression passed to the '-filter-entries' command line option. This function should be called after
+// get_entry_filter_size() and with a memory arena that is capable of holding the number of bytes it returned.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the filter expression and the permanent memory arena where the compiled filter
+// will be stored. After compiling it, this structure's 'entry_filter' member will be modified.
+//
+// @Returns: Nothing.
+void load_entry_filter(Exporter* exporter)
+{
+	Entry_Filter* entry_filter = NULL;
+	if(compile_entry_filter(&(exporter->permanent_arena), exporter->entry_filter_expression, &entry_filter))
+	{
+		log_info("Load Entry Filter: Compiled %d terms from the expression '%s'.", entry_filter->num_terms, exporter->entry_filter_expression);
+		exporter->entry_filter = entry_filter;
+	}
+	else
+	{
+		log_error("Load Entry Filter: Failed to compile the expression '%s'. No entries will be filtered.", exporter->entry_filter_expression);
+	}
+}
+
+// Checks if a cache entry passes the entry filter. Cache exporters should call this function using the raw values from the cache's
+// metadata, and skip the entry if it returns false. In that case, the temporary memory arena and the exporter's warning message are
+// cleared just like when calling export_cache_entry().
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the compiled filter.
+// 2. entry_to_filter - The Filterable_Cache_Entry structure that contains the entry's values. Any unknown values never match.
+//
+// @Returns: True if the entry passes the filter or if no filter was loaded. Otherwise, false.
+bool cache_entry_passes_filter(Exporter* exporter, Filterable_Cache_Entry* entry_to_filter)
+{
+	Entry_Filter* entry_filter = exporter->entry_filter;
+	if(entry_filter == NULL) return true;
+
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	Url_Parts url_parts = {};
+	bool partitioned_url = false;
+	bool passes_filter = true;
+
+	for(int i = 0; i < entry_filter->num_terms && passes_filter; ++i)
+	{
+		Filter_Term* term = &(entry_filter->terms[i]);
+		bool term_matches = false;
+
+		switch(term->field)
+		{
+			case(FILTER_HOST):
+			{
+				// Only split the URL if its host is compared.
+				if(!partitioned_url)
+				{
+					partition_url(temporary_arena, entry_to_filter->url, &url_parts);
+					partitioned_url = true;
+				}
+
+				if(url_parts.host != NULL)
+				{
+					for(int j = 0; j < term->num_values && !term_matches; ++j)
+					{
+						term_matches = url_host_ends_with(url_parts.host, term->values[j]);
+					}
+				}
+			} break;
+
+			case(FILTER_CONTENT_TYPE):
+			{
+				if(entry_to_filter->content_type != NULL)
+				{
+					for(int j = 0; j < term->num_values && !term_matches; ++j)
+					{
+						term_matches = string_begins_with(entry_to_filter->content_type, term->values[j], true);
+					}
+				}
+			} break;
+
+			case(FILTER_SIZE):
+			{
+				s64 size = (s64) entry_to_filter->size;
+				term_matches = entry_to_filter->has_size && (term->min_value <= size) && (size <= term->max_value);
+			} break;
+
+			case(FILTER_LAST_MODIFIED_TIME):
+			{
+				__time64_t last_modified_time = entry_to_filter->last_modified_time;
+				term_matches = (last_modified_time != 0) && (term->min_value <= last_modified_time) && (last_modified_time <= term->max_value);
+			} break;
+
+			default:
+			{
+				_ASSERT(false);
+			} break;
+		}
+
+		passes_filter = term_matches;
+	}
+
+	if(!passes_filter)
+	{
+		clear_arena(temporary_arena);
+		exporter->warning_message[0] = T('\0');
+	}
+
+	return passes_filter;
+}
@@ -91,12 +91,11 @@ struct Group
 	};
 };
 
-// A structure that contains every loaded group and a sufficiently large buffer for all file signatures.
+// A structure that contains every loaded group and the size of the largest file signature.
 // See: load_all_group_files().
 struct Custom_Groups
 {
-	u8* file_signature_buffer;
-	int file_signature_buffer_size;
+	int max_file_signature_size;
 
 	int num_groups;
 	Group groups[ANYSIZE_ARRAY];
@@ -108,7 +107,10 @@ struct Matchable_Cache_Entry
 {
 	// Input
 	
-	TCHAR* full_file_path;
+	// The first bytes of the cached data, which are read by the caller. This buffer should hold at least the largest file
+	// signature's size unless the cached data is smaller than that. May be NULL if the file doesn't exist or couldn't be read.
+	u8* file_signature;
+	u32 file_signature_size;
 	TCHAR* mime_type_to_match;
 	TCHAR* file_extension_to_match;
 	TCHAR* url_to_match;
@@ -125,8 +127,71 @@ struct Matchable_Cache_Entry
 	bool match_is_enabled_for_filtering;
 };
 
+// The fields that may be compared in an entry filter expression.
+// See: compile_entry_filter().
+enum Filter_Field
+{
+	FILTER_NONE = 0,
+	FILTER_INVALID = 1,
+
+	FILTER_HOST = 2,
+	FILTER_CONTENT_TYPE = 3,
+	FILTER_SIZE = 4,
+	FILTER_LAST_MODIFIED_TIME = 5,
+
+	NUM_FILTER_FIELDS = 6
+};
+
+// An array that maps the previous values to the field names used in a filter expression.
+const TCHAR* const FILTER_FIELD_TO_STRING[] = {T(""), T("Invalid"), T("host"), T("type"), T("size"), T("modified")};
+_STATIC_ASSERT(_countof(FILTER_FIELD_TO_STRING) == NUM_FILTER_FIELDS);
+
+// A structure that represents a single term in an entry filter expression. The host and content type terms match if any of their
+// values match, while the size and last modified time terms match if the entry's value is inside an inclusive range.
+struct Filter_Term
+{
+	Filter_Field field;
+
+	int num_values;
+	TCHAR** values;
+
+	s64 min_value;
+	s64 max_value;
+};
+
+// A structure that contains every term in a compiled entry filter expression. A cache entry passes the filter if it matches every term.
+// See: compile_entry_filter().
+struct Entry_Filter
+{
+	int num_terms;
+	Filter_Term terms[ANYSIZE_ARRAY];
+};
+
+// A structure that is used to pass the raw values of a cache entry to the entry filter. Each cache exporter fills these values using
+// the cache's metadata before formatting any dates, decoding the URL, or reading the cached file.
+// See: cache_entry_passes_filter().
+struct Filterable_Cache_Entry
+{
+	// The URL as it's stored in the cache (i.e. not decoded). May be NULL.
+	TCHAR* url;
+	// The Content-Type HTTP header. May be NULL.
+	TCHAR* content_type;
+
+	bool has_size;
+	u64 size;
+
+	// Zero if the time is unknown.
+	__time64_t last_modified_time;
+};
+
 size_t get_total_group_files_size(Exporter* exporter, int* num_groups);
 void load_all_group_files(Exporter* exporter, int num_groups);
+bool can_cache_entry_pass_group_filter(Exporter* exporter, Matchable_Cache_Entry* entry_to_match);
 bool match_cache_entry_to_groups(Exporter* exporter, Matchable_Cache_Entry* entry_to_match);
 
+size_t get_entry_filter_size(Exporter* exporter);
+bool compile_entry_filter(Arena* arena, const TCHAR* expression, Entry_Filter** result_filter);
+void load_entry_filter(Exporter* exporter);
+bool cache_entry_passes_filter(Exporter* exporter, Filterable_Cache_Entry* entry_to_filter);
+
 #endif
@@ -13,12 +13,406 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 	CSV_FILENAME, CSV_FILE_EXTENSION, CSV_FILE_SIZE, 
 	CSV_CREATION_TIME, CSV_LAST_WRITE_TIME, CSV_LAST_ACCESS_TIME,
 	CSV_FILE_DESCRIPTION, CSV_FILE_VERSION, CSV_PRODUCT_NAME, CSV_PRODUCT_VERSION, CSV_COPYRIGHT,
+	CSV_SWF_VERSION, CSV_STAGE_DIMENSIONS, CSV_FRAME_RATE, CSV_FRAME_COUNT,
 	CSV_LOCATION_ON_DISK, CSV_LOCATION_IN_OUTPUT, CSV_COPY_ERROR,
-	CSV_CUSTOM_FILE_GROUP, CSV_SHA_256
+	CSV_CUSTOM_FILE_GROUP, CSV_SHA_256, CSV_DUPLICATE_OF
 };
 
 static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 
+/*
+	Duplicate files are found in three stages, where each one is only performed if the previous one found a possible match:
+	1. Before exporting anything, the size of every file is collected. Files with a unique size cannot have any duplicates, meaning
+	that they are never read.
+	2. The first and last DUPLICATE_EDGE_SIZE bytes of the remaining files are hashed. Files that were created from the same
+	template (e.g. cached images with the same header) usually differ at the beginning or at the end.
+	3. The entire contents of any files with the same size and edge hash are hashed and compared. A file's full hash is computed
+	at most once.
+
+	Every exported file that isn't a duplicate is added to a hash table so it can be compared with the files that are explored after it.
+	This table and the paths it refers to are stored in a memory arena whose size is determined before exporting.
+*/
+
+// The number of bytes that are hashed at the beginning and at the end of a file during the second stage.
+static const u32 DUPLICATE_EDGE_SIZE = 4096;
+
+// The number of hexadecimal characters in a SHA-256 hash, including the null terminator.
+static const size_t SHA_256_STRING_COUNT = SHA_256_SIZE * 2 + 1;
+
+// A file that may have duplicates, i.e., one that shares its size with at least one other file.
+struct Duplicate_Candidate
+{
+	u64 file_size;
+	u8 edge_hash[SHA_256_SIZE];
+	TCHAR* file_path;
+
+	// The full SHA-256 hash, which is only generated once another file has the same size and edge hash.
+	bool generated_sha_256;
+	TCHAR* sha_256;
+
+	Duplicate_Candidate* next;
+};
+
+struct Duplicate_Finder
+{
+	// Whether or not the finder was set up successfully. If not, each file is exported as if duplicates weren't being found.
+	bool is_ready;
+	Arena arena;
+
+	// The sorted file sizes that are shared by at least two files.
+	u32 num_duplicate_sizes;
+	u64* duplicate_sizes;
+
+	// A hash table of files that were already explored, indexed by their edge hash.
+	u32 num_buckets;
+	Duplicate_Candidate** buckets;
+
+	// Whether the arena ran out of memory because the directory was changed after the file sizes were collected.
+	bool ran_out_of_memory;
+};
+
+// The size of a file and the length of its path. Used to determine how much memory is necessary to find duplicate files.
+struct File_Size_Entry
+{
+	u64 file_size;
+	u32 path_count;
+};
+
+struct Collect_File_Sizes_Params
+{
+	u32 num_files;
+	u32 max_num_files;
+	File_Size_Entry* entries;
+};
+
+// Called every time a file is found in the specified directory and subdirectories. Used to count the number of files before
+// collecting their sizes.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True.
+static TRAVERSE_DIRECTORY_CALLBACK(count_explored_files_callback)
+{
+	u32* num_files = (u32*) callback_info->user_data;
+	*num_files += 1;
+	return true;
+}
+
+// Called every time a file is found in the specified directory and subdirectories. Used to collect the size of each file.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True until the maximum number of files is reached. Otherwise, false.
+static TRAVERSE_DIRECTORY_CALLBACK(collect_file_sizes_callback)
+{
+	Collect_File_Sizes_Params* params = (Collect_File_Sizes_Params*) callback_info->user_data;
+
+	// Stop if more files were created since they were counted.
+	if(params->num_files >= params->max_num_files) return false;
+
+	File_Size_Entry* entry = &(params->entries[params->num_files]);
+	entry->file_size = callback_info->object_size;
+	entry->path_count = (u32) string_length(callback_info->object_path) + 1;
+	params->num_files += 1;
+
+	return true;
+}
+
+// Called by qsort() to sort the file size entries by their sizes.
+//
+// @Parameters:
+// 1. entry_pointer_1 - The first entry to compare.
+// 2. entry_pointer_2 - The second entry to compare.
+//
+// @Returns: A negative number, zero, or a positive number if the first entry's size is less than, equal to, or greater than
+// the second entry's size, respectively.
+static int compare_file_size_entries(const void* entry_pointer_1, const void* entry_pointer_2)
+{
+	File_Size_Entry* entry_1 = (File_Size_Entry*) entry_pointer_1;
+	File_Size_Entry* entry_2 = (File_Size_Entry*) entry_pointer_2;
+
+	if(entry_1->file_size < entry_2->file_size) return -1;
+	else if(entry_1->file_size > entry_2->file_size) return 1;
+	else return 0;
+}
+
+// Called by bsearch() to find a file size in the sorted duplicate size array.
+//
+// @Parameters:
+// 1. size_pointer_1 - The first size to compare.
+// 2. size_pointer_2 - The second size to compare.
+//
+// @Returns: A negative number, zero, or a positive number if the first size is less than, equal to, or greater than the second
+// size, respectively.
+static int compare_file_sizes(const void* size_pointer_1, const void* size_pointer_2)
+{
+	u64 size_1 = *((u64*) size_pointer_1);
+	u64 size_2 = *((u64*) size_pointer_2);
+
+	if(size_1 < size_2) return -1;
+	else if(size_1 > size_2) return 1;
+	else return 0;
+}
+
+// Performs the first stage of finding duplicate files by collecting the size of every file in a directory and its subdirectories.
+// This function then creates the memory arena that is used by find_duplicate_file().
+//
+// @Parameters:
+// 1. directory_path - The path to the directory that will be explored.
+// 2. finder - The Duplicate_Finder structure that receives the sizes that are shared by at least two files. Its 'is_ready' member
+// is set to true on success.
+//
+// @Returns: Nothing.
+static void prepare_duplicate_finder(const TCHAR* directory_path, Duplicate_Finder* finder)
+{
+	u32 num_files = 0;
+	traverse_directory_objects(directory_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, count_explored_files_callback, &num_files);
+	log_info("Find Duplicates: Found %I32u files to check for duplicates.", num_files);
+
+	if(num_files == 0)
+	{
+		finder->is_ready = true;
+		return;
+	}
+
+	Arena size_arena = {};
+	if(!create_arena(&size_arena, num_files * sizeof(File_Size_Entry)))
+	{
+		log_error("Find Duplicates: Failed to create the arena for the sizes of %I32u files. Duplicate files will not be found.", num_files);
+		return;
+	}
+
+	Collect_File_Sizes_Params params = {};
+	params.max_num_files = num_files;
+	params.entries = push_array_to_arena(&size_arena, num_files, File_Size_Entry);
+	traverse_directory_objects(directory_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, collect_file_sizes_callback, &params);
+
+	qsort(params.entries, params.num_files, sizeof(File_Size_Entry), compare_file_size_entries);
+
+	// Only keep the sizes that are shared by at least two files, along with how much memory is needed to store these files' paths.
+	u32 num_duplicate_sizes = 0;
+	u32 num_candidates = 0;
+	size_t total_path_count = 0;
+
+	for(u32 i = 0; i < params.num_files;)
+	{
+		u32 group_end = i + 1;
+		while(group_end < params.num_files && params.entries[group_end].file_size == params.entries[i].file_size) group_end += 1;
+
+		if(group_end - i >= 2)
+		{
+			// The sizes are compacted to the beginning of the array since there are never more groups than entries.
+			params.entries[num_duplicate_sizes].file_size = params.entries[i].file_size;
+			num_duplicate_sizes += 1;
+
+			for(u32 j = i; j < group_end; ++j)
+			{
+				total_path_count += params.entries[j].path_count;
+			}
+			num_candidates += group_end - i;
+		}
+
+		i = group_end;
+	}
+
+	log_info("Find Duplicates: Found %I32u files that share %I32u different sizes.", num_candidates, num_duplicate_sizes);
+
+	u32 num_buckets = 1;
+	while(num_buckets < num_candidates) num_buckets *= 2;
+
+	size_t finder_arena_size = 	num_duplicate_sizes * sizeof(u64)
+								+ num_buckets * sizeof(Duplicate_Candidate*)
+								+ num_candidates * (sizeof(Duplicate_Candidate) + SHA_256_STRING_COUNT * sizeof(TCHAR) + 2 * MAX_SCALAR_ALIGNMENT_SIZE)
+								+ total_path_count * sizeof(TCHAR)
+								+ MAX_SCALAR_ALIGNMENT_SIZE;
+
+	if(create_arena(&(finder->arena), finder_arena_size))
+	{
+		finder->num_duplicate_sizes = num_duplicate_sizes;
+		finder->duplicate_sizes = push_array_to_arena(&(finder->arena), MAX(num_duplicate_sizes, 1), u64);
+		for(u32 i = 0; i < num_duplicate_sizes; ++i)
+		{
+			finder->duplicate_sizes[i] = params.entries[i].file_size;
+		}
+
+		finder->num_buckets = num_buckets;
+		finder->buckets = push_array_to_arena(&(finder->arena), num_buckets, Duplicate_Candidate*);
+		ZeroMemory(finder->buckets, num_buckets * sizeof(Duplicate_Candidate*));
+
+		finder->is_ready = true;
+	}
+	else
+	{
+		log_error("Find Duplicates: Failed to create the arena with %Iu bytes for %I32u candidates. Duplicate files will not be found.", finder_arena_size, num_candidates);
+	}
+
+	destroy_arena(&size_arena);
+}
+
+// Checks if there's enough space to store a value in the duplicate finder's memory arena.
+//
+// @Parameters:
+// 1. finder - The Duplicate_Finder structure.
+// 2. required_size - The size of the value in bytes.
+//
+// @Returns: True if the value can be stored. Otherwise, false.
+static bool duplicate_finder_has_space(Duplicate_Finder* finder, size_t required_size)
+{
+	Arena* arena = &(finder->arena);
+	return required_size + 2 * MAX_SCALAR_ALIGNMENT_SIZE <= arena->total_size - arena->used_size;
+}
+
+// Generates and stores a candidate's full SHA-256 hash if it wasn't already generated.
+//
+// @Parameters:
+// 1. finder - The Duplicate_Finder structure where the hash is stored.
+// 2. temporary_arena - The Arena structure where the intermediate file buffer is stored.
+// 3. candidate - The candidate file.
+//
+// @Returns: The hash, or NULL if it couldn't be generated. This string is only valid until the temporary arena is cleared.
+static TCHAR* get_duplicate_candidate_sha_256(Duplicate_Finder* finder, Arena* temporary_arena, Duplicate_Candidate* candidate)
+{
+	if(candidate->generated_sha_256) return candidate->sha_256;
+
+	TCHAR* sha_256 = generate_sha_256_from_file(temporary_arena, candidate->file_path);
+	
+	// The space for this hash is reserved when the candidate is added, unless the directory changed after the file sizes were
+	// collected. In that case, the hash is generated again the next time it's needed.
+	if(duplicate_finder_has_space(finder, SHA_256_STRING_COUNT * sizeof(TCHAR)))
+	{
+		candidate->generated_sha_256 = true;
+		candidate->sha_256 = (sha_256 != NULL) ? (push_string_to_arena(&(finder->arena), sha_256)) : (NULL);
+	}
+
+	return sha_256;
+}
+
+// Performs the second and third stages of finding duplicate files by comparing a file with every previously explored file that
+// has the same size. The file is added to the hash table if it's not a duplicate.
+//
+// @Parameters:
+// 1. finder - The Duplicate_Finder structure that was set up by prepare_duplicate_finder().
+// 2. temporary_arena - The Arena structure where any intermediate values are stored.
+// 3. file_path - The path to the file.
+// 4. file_size - The file's size in bytes.
+// 5. result_sha_256 - The address of the string that receives the file's full SHA-256 hash. This string is set to NULL if the file
+// didn't have to be fully hashed.
+// 6. result_duplicate_of - The address of the string that receives the path to the original file. This string is set to NULL if
+// the file isn't a duplicate.
+//
+// @Returns: Nothing.
+static void find_duplicate_file(Duplicate_Finder* finder, Arena* temporary_arena, const TCHAR* file_path, u64 file_size,
+								TCHAR** result_sha_256, TCHAR** result_duplicate_of)
+{
+	*result_sha_256 = NULL;
+	*result_duplicate_of = NULL;
+
+	// First stage: files with a unique size can't be duplicates.
+	if(bsearch(&file_size, finder->duplicate_sizes, finder->num_duplicate_sizes, sizeof(u64), compare_file_sizes) == NULL) return;
+
+	// Second stage: compare the first and last bytes.
+	u8 edge_hash[SHA_256_SIZE] = {};
+	if(!generate_edge_sha_256_from_file(temporary_arena, file_path, file_size, DUPLICATE_EDGE_SIZE, edge_hash)) return;
+
+	u32 bucket_index = 0;
+	CopyMemory(&bucket_index, edge_hash, sizeof(bucket_index));
+	bucket_index &= finder->num_buckets - 1;
+
+	// Third stage: compare the full hashes.
+	bool generated_sha_256 = false;
+	TCHAR* sha_256 = NULL;
+
+	for(Duplicate_Candidate* candidate = finder->buckets[bucket_index]; candidate != NULL; candidate = candidate->next)
+	{
+		if(candidate->file_size != file_size || !memory_is_equal(candidate->edge_hash, edge_hash, SHA_256_SIZE)) continue;
+
+		if(!generated_sha_256)
+		{
+			generated_sha_256 = true;
+			sha_256 = generate_sha_256_from_file(temporary_arena, file_path);
+			if(sha_256 == NULL) return;
+		}
+
+		TCHAR* candidate_sha_256 = get_duplicate_candidate_sha_256(finder, temporary_arena, candidate);
+		if(candidate_sha_256 != NULL && strings_are_equal(sha_256, candidate_sha_256))
+		{
+			*result_sha_256 = sha_256;
+			*result_duplicate_of = candidate->file_path;
+			return;
+		}
+	}
+
+	*result_sha_256 = sha_256;
+
+	size_t candidate_size = sizeof(Duplicate_Candidate) + (SHA_256_STRING_COUNT + string_length(file_path) + 1) * sizeof(TCHAR);
+	if(!duplicate_finder_has_space(finder, candidate_size))
+	{
+		if(!finder->ran_out_of_memory)
+		{
+			log_warning("Find Duplicates: Ran out of memory while adding the file '%s'. Any files that are explored after this point will only be compared with the previous ones.", file_path);
+			finder->ran_out_of_memory = true;
+		}
+		return;
+	}
+
+	Duplicate_Candidate* candidate = push_arena(&(finder->arena), sizeof(Duplicate_Candidate), Duplicate_Candidate);
+	candidate->file_size = file_size;
+	CopyMemory(candidate->edge_hash, edge_hash, SHA_256_SIZE);
+	candidate->file_path = push_string_to_arena(&(finder->arena), file_path);
+
+	candidate->generated_sha_256 = generated_sha_256;
+	candidate->sha_256 = (sha_256 != NULL) ? (push_string_to_arena(&(finder->arena), sha_256)) : (NULL);
+
+	candidate->next = finder->buckets[bucket_index];
+	finder->buckets[bucket_index] = candidate;
+}
+
+struct Explore_Files_Params
+{
+	Exporter* exporter;
+	// The duplicate finder, or NULL if duplicate files shouldn't be found.
+	Duplicate_Finder* duplicate_finder;
+};
+
+// The file that is compared with the previously explored ones by find_explored_duplicate_file_callback().
+struct Explored_File_Duplicate_Params
+{
+	Duplicate_Finder* duplicate_finder;
+	Traversal_Object_Info* file_info;
+};
+
+// Called by export_cache_entry() after the explored file passes the group filter. Used to find duplicate files so that the files
+// that aren't exported are never hashed and never added to the duplicate finder.
+//
+// @Parameters: See the EXPORTED_ENTRY_CALLBACK macro.
+//
+// @Returns: Nothing.
+static EXPORTED_ENTRY_CALLBACK(find_explored_duplicate_file_callback)
+{
+	Explored_File_Duplicate_Params* duplicate_params = (Explored_File_Duplicate_Params*) user_data;
+	Traversal_Object_Info* file_info = duplicate_params->file_info;
+
+	TCHAR* sha_256 = NULL;
+	TCHAR* duplicate_of = NULL;
+	find_duplicate_file(duplicate_params->duplicate_finder, &(exporter->temporary_arena), file_info->object_path, file_info->object_size, &sha_256, &duplicate_of);
+
+	for(int i = 0; i < CSV_NUM_COLUMNS; ++i)
+	{
+		switch(CSV_COLUMN_TYPES[i])
+		{
+			case(CSV_SHA_256):
+			{
+				column_values[i].value = sha_256;
+			} break;
+
+			case(CSV_DUPLICATE_OF):
+			{
+				column_values[i].value = duplicate_of;
+			} break;
+		}
+	}
+}
+
 // Called every time a file is found in the specified directory and subdirectories. Used to export every file.
 //
 // @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
@@ -26,44 +420,56 @@ static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 // @Returns: True.
 static TRAVERSE_DIRECTORY_CALLBACK(explore_files_callback)
 {
-	Exporter* exporter = (Exporter*) callback_info->user_data;
+	Explore_Files_Params* explore_params = (Explore_Files_Params*) callback_info->user_data;
+	Exporter* exporter = explore_params->exporter;
+	Duplicate_Finder* duplicate_finder = explore_params->duplicate_finder;
 	Arena* arena = &(exporter->temporary_arena);
 
 	TCHAR* full_location_on_cache = callback_info->object_path;
 
+	Exporter_Params params = {};
+	params.copy_source_path = full_location_on_cache;
+	params.file_info = callback_info;
+
+	// Skip the files that belong to other shards before reading their version information or hashing them.
+	if(!is_cache_entry_in_exporter_shard(exporter, &params)) return true;
+
 	const u32 SIGNATURE_BUFFER_SIZE = 2;
 	u8 signature_buffer[SIGNATURE_BUFFER_SIZE] = {};
 	bool is_executable = read_first_file_bytes(full_location_on_cache, signature_buffer, SIGNATURE_BUFFER_SIZE)
 						&& memory_is_equal(signature_buffer, "MZ", SIGNATURE_BUFFER_SIZE);
 
-	TCHAR* file_description = NULL;
-	TCHAR* file_version = NULL;
-	TCHAR* product_name = NULL;
-	TCHAR* product_version = NULL;
-	TCHAR* copyright = NULL;
+	File_Info file_info = {};
+	if(is_executable) get_file_info(arena, full_location_on_cache, &file_info);
 
-	if(is_executable)
-	{
-		get_file_info(arena, full_location_on_cache, INFO_FILE_DESCRIPTION, &file_description);
-		get_file_info(arena, full_location_on_cache, INFO_FILE_VERSION, &file_version);
-		get_file_info(arena, full_location_on_cache, INFO_PRODUCT_NAME, &product_name);
-		get_file_info(arena, full_location_on_cache, INFO_PRODUCT_VERSION, &product_version);
-		get_file_info(arena, full_location_on_cache, INFO_LEGAL_COPYRIGHT, &copyright);
-	}
+	TCHAR* file_description = file_info.strings[INFO_FILE_DESCRIPTION];
+	TCHAR* file_version = file_info.strings[INFO_FILE_VERSION];
+	TCHAR* product_name = file_info.strings[INFO_PRODUCT_NAME];
+	TCHAR* product_version = file_info.strings[INFO_PRODUCT_VERSION];
+	TCHAR* copyright = file_info.strings[INFO_LEGAL_COPYRIGHT];
 
 	Csv_Entry csv_row[] =
 	{
 		{/* Filename */}, {/* File Extension */}, {/* File Size */},
 		{/* Creation Time */}, {/* Last Write Time */}, {/* Last Access Time */},
 		{file_description}, {file_version}, {product_name}, {product_version}, {copyright},
+		{/* SWF Version */}, {/* Stage Dimensions */}, {/* Frame Rate */}, {/* Frame Count */},
 		{/* Location On Disk */}, {/* Location In Output */}, {/* Copy Error */},
-		{/* Custom File Group */}, {/* SHA-256 */}
+		{/* Custom File Group */}, {/* SHA-256 */}, {/* Duplicate Of */}
 	};
 	_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
 
-	Exporter_Params params = {};
-	params.copy_source_path = full_location_on_cache;
-	params.file_info = callback_info;
+	// The SHA-256 column is filled while finding duplicates, which only happens if the file passes the group filter.
+	Explored_File_Duplicate_Params duplicate_params = {};
+	if(duplicate_finder != NULL)
+	{
+		duplicate_params.duplicate_finder = duplicate_finder;
+		duplicate_params.file_info = callback_info;
+
+		params.has_precomputed_sha_256 = true;
+		params.exported_entry_callback = find_explored_duplicate_file_callback;
+		params.exported_entry_user_data = &duplicate_params;
+	}
 
 	export_cache_entry(exporter, csv_row, &params);
 
@@ -83,9 +489,22 @@ void export_explored_files(Exporter* exporter)
 
 	initialize_cache_exporter(exporter, CACHE_EXPLORE, CSV_COLUMN_TYPES, CSV_NUM_COLUMNS);
 	{
+		Duplicate_Finder duplicate_finder = {};
+		if(exporter->find_duplicate_files)
+		{
+			log_info("Explore Files: Collecting the file sizes in '%s' to find duplicate files.", exporter->cache_path);
+			prepare_duplicate_finder(exporter->cache_path, &duplicate_finder);
+		}
+
+		Explore_Files_Params params = {};
+		params.exporter = exporter;
+		params.duplicate_finder = (duplicate_finder.is_ready) ? (&duplicate_finder) : (NULL);
+
 		log_info("Explore Files: Exploring the files in '%s'.", exporter->cache_path);
-		traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, explore_files_callback, exporter);
+		traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, explore_files_callback, &params);
 		log_info("Explore Files: Finished exploring the files.");
+
+		destroy_arena(&(duplicate_finder.arena));
 	}
 	terminate_cache_exporter(exporter);
 }
@@ -18,6 +18,9 @@
 
 	The previously mentioned Asset Cache is in: <Cache Location>\AssetCache\<8 Character Directory>
 
+	The header of any Flash movie that is exported (by this or any other exporter) is probed to fill the SWF Version, Stage
+	Dimensions, Frame Rate, and Frame Count columns. See: probe_swf_header().
+
 	This exporter will also look for FLV video files in the Temporary Files directory. These were cached by Flash video players (e.g. 
 	YouTube's old player) when they were watched in a browser.
 
@@ -43,12 +46,19 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 	CSV_FILENAME, CSV_FILE_EXTENSION, CSV_FILE_SIZE, 
 	CSV_LAST_MODIFIED_TIME, CSV_CREATION_TIME, CSV_LAST_WRITE_TIME, CSV_LAST_ACCESS_TIME,
 	CSV_ACCESS_COUNT, CSV_LIBRARY_SHA_256,
+	CSV_SWF_VERSION, CSV_STAGE_DIMENSIONS, CSV_FRAME_RATE, CSV_FRAME_COUNT,
 	CSV_LOCATION_ON_CACHE, CSV_LOCATION_IN_OUTPUT, CSV_COPY_ERROR,
 	CSV_CUSTOM_FILE_GROUP, CSV_SHA_256
 };
 
 static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 
+// The maximum number of bytes read from each HEU metadata file. These files only contain a few short strings (around 150 bytes),
+// so they're read into a fixed size buffer instead of allocating memory for each one.
+static const u32 MAX_HEU_FILE_SIZE = 1024;
+// The number of strings in each HEU metadata file. Used to guarantee that there's a null terminator for each one in the buffer.
+static const u32 NUM_HEU_STRINGS = 5;
+
 // Entry point for the Flash Player's cache exporter. This function will determine where to look for the cache before
 // processing its contents.
 //
@@ -124,9 +134,12 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_flash_cache_files_callback)
 			PathCombine(metadata_file_path, callback_info->directory_path, filename);
 			StringCchCat(metadata_file_path, MAX_PATH_CHARS, T(".heu"));
 
-			u64 metadata_file_size = 0;
-			char* metadata_file = (char*) read_entire_file(arena, metadata_file_path, &metadata_file_size, true);
-			if(metadata_file != NULL)
+			// Each SWZ file has its own HEU file, so there's nothing to share between the files in the same directory.
+			// We'll just avoid allocating memory and getting the file's size, and read it directly into a zeroed buffer
+			// that is large enough to hold any missing null terminators.
+			char metadata_file[MAX_HEU_FILE_SIZE + NUM_HEU_STRINGS] = "";
+			u32 metadata_file_size = 0;
+			if(read_first_file_bytes(metadata_file_path, metadata_file, MAX_HEU_FILE_SIZE, true, &metadata_file_size) && metadata_file_size > 0)
 			{
 				// @FormatVersion: Flash Player 9 and later.
 				// @ByteOrder: None. The data is stored as null terminated ASCII strings.
@@ -179,6 +192,7 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_flash_cache_files_callback)
 		{/* Filename */}, {/* File Extension */}, {/* File Size */},
 		{last_modified_time}, {/* Creation Time */}, {/* Last Write Time */}, {/* Last Access Time */},
 		{access_count}, {library_sha_256},
+		{/* SWF Version */}, {/* Stage Dimensions */}, {/* Frame Rate */}, {/* Frame Count */},
 		{/* Location On Cache */}, {/* Location In Output */}, {/* Copy Error */},
 		{/* Custom File Group */}, {/* SHA-256 */}
 	};
@@ -219,6 +233,7 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_flash_video_files_callback)
 		{/* Filename */}, {/* File Extension */}, {/* File Size */},
 		{/* Last Modified Time */}, {/* Creation Time */}, {/* Last Write Time */}, {/* Last Access Time */},
 		{/* Access Count */}, {/* Library SHA-256 */},
+		{/* SWF Version */}, {/* Stage Dimensions */}, {/* Frame Rate */}, {/* Frame Count */},
 		{/* Location On Cache */}, {/* Location In Output */}, {/* Copy Error */},
 		{/* Custom File Group */}, {/* SHA-256 */}
 	};
@@ -235,3 +250,116 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_flash_video_files_callback)
 
 	return true;
 }
+
+// Parses a Flash movie's (SWF file) header from the first bytes of a file. Uncompressed movies (FWS) are read directly, while only
+// the first few bytes of compressed ones (CWS for Zlib and ZWS for LZMA) are decompressed.
+//
+// @Format: See "SWF File Format Specification Version 19", chapter 2 - https://www.adobe.com/content/dam/acom/en/devnet/pdf/swf-file-format-spec.pdf
+//
+// @Parameters:
+// 1. arena - The Arena structure that is used to decompress the header. This memory is only freed when the caller clears the arena.
+// 2. file_bytes - The first bytes of the file. This buffer should contain at least MAX_SWF_PROBE_SIZE bytes unless the file is
+// smaller than that.
+// 3. num_file_bytes - The number of bytes in the buffer.
+// 4. result_header - The Swf_Header structure that receives the header's values.
+//
+// @Returns: True if the file is a Flash movie and its header was read successfully. Otherwise, false.
+bool probe_swf_header(Arena* arena, const void* file_bytes, u32 num_file_bytes, Swf_Header* result_header)
+{
+	// The signature (3 bytes), version (1 byte), and file length (4 bytes) are never compressed.
+	const u32 SWF_SIGNATURE_SIZE = 8;
+	// The frame size rectangle (up to 17 bytes), followed by the frame rate (2 bytes) and frame count (2 bytes).
+	const u32 MAX_SWF_BODY_HEADER_SIZE = 21;
+
+	if(num_file_bytes < SWF_SIGNATURE_SIZE) return false;
+
+	const u8* file = (const u8*) file_bytes;
+	bool is_uncompressed = memory_is_equal(file, "FWS", 3);
+	bool is_zlib_compressed = memory_is_equal(file, "CWS", 3);
+	bool is_lzma_compressed = memory_is_equal(file, "ZWS", 3);
+	if(!is_uncompressed && !is_zlib_compressed && !is_lzma_compressed) return false;
+
+	// @ByteOrder: Little Endian.
+
+	u8 version = file[3];
+	
+	u32 file_length = 0;
+	CopyMemory(&file_length, file + 4, sizeof(file_length));
+	LITTLE_ENDIAN_TO_HOST(file_length);
+
+	const u8* body = file + SWF_SIGNATURE_SIZE;
+	u32 body_size = num_file_bytes - SWF_SIGNATURE_SIZE;
+
+	u8 body_header[MAX_SWF_BODY_HEADER_SIZE] = {};
+	u32 body_header_size = 0;
+
+	if(is_uncompressed)
+	{
+		body_header_size = MIN(body_size, MAX_SWF_BODY_HEADER_SIZE);
+		CopyMemory(body_header, body, body_header_size);
+	}
+	else if(is_zlib_compressed)
+	{
+		int error_code = 0;
+		if(!decompress_deflate_buffer(arena, body, body_size, body_header, MAX_SWF_BODY_HEADER_SIZE, &body_header_size, &error_code, true))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// @Format: The LZMA data is preceded by its compressed size (4 bytes) and properties (5 bytes). Unlike the .lzma format,
+		// the uncompressed size is not stored, though it can be determined from the file length.
+		const u32 LZMA_SWF_HEADER_SIZE = 4 + LZMA_PROPERTIES_SIZE;
+		if(body_size < LZMA_SWF_HEADER_SIZE) return false;
+
+		u64 uncompressed_size = (file_length > SWF_SIGNATURE_SIZE) ? (file_length - SWF_SIGNATURE_SIZE) : (LZMA_UNKNOWN_SIZE);
+		if(!decompress_lzma_buffer(	arena, body + 4, uncompressed_size, body + LZMA_SWF_HEADER_SIZE, body_size - LZMA_SWF_HEADER_SIZE,
+									body_header, MAX_SWF_BODY_HEADER_SIZE, &body_header_size))
+		{
+			return false;
+		}
+	}
+
+	if(body_header_size == 0) return false;
+
+	// @Format: The RECT structure starts with a 5 bit field that specifies the size of the four signed fields that follow it
+	// (Xmin, Xmax, Ymin, and Ymax). This structure is padded to a whole byte.
+	u32 num_bits = body_header[0] >> 3;
+	u32 rect_size = (5 + 4 * num_bits + 7) / 8;
+	if(body_header_size < rect_size + 4) return false;
+
+	s32 rect[4] = {};
+	u32 bit_position = 5;
+	for(int i = 0; i < _countof(rect); ++i)
+	{
+		u32 value = 0;
+		for(u32 j = 0; j < num_bits; ++j)
+		{
+			u32 bit = (body_header[bit_position / 8] >> (7 - bit_position % 8)) & 1;
+			value = (value << 1) | bit;
+			++bit_position;
+		}
+
+		// Sign extend the value.
+		if(num_bits > 0 && (value & (1U << (num_bits - 1))) != 0) value |= 0xFFFFFFFFU << num_bits;
+		rect[i] = (s32) value;
+	}
+
+	u16 frame_rate = 0;
+	CopyMemory(&frame_rate, body_header + rect_size, sizeof(frame_rate));
+	LITTLE_ENDIAN_TO_HOST(frame_rate);
+
+	u16 frame_count = 0;
+	CopyMemory(&frame_count, body_header + rect_size + 2, sizeof(frame_count));
+	LITTLE_ENDIAN_TO_HOST(frame_count);
+
+	result_header->version = version;
+	result_header->file_length = file_length;
+	result_header->stage_width = rect[1] - rect[0];
+	result_header->stage_height = rect[3] - rect[2];
+	result_header->frame_rate = frame_rate;
+	result_header->frame_count = frame_count;
+
+	return true;
+}
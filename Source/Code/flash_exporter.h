@@ -3,4 +3,25 @@
 
 void export_default_or_specific_flash_cache(Exporter* exporter);
 
+// The number of bytes that should be read from the beginning of a file when probing its SWF header. This is enough to decompress
+// the header's remaining fields in compressed Flash movies. See: probe_swf_header().
+const u32 MAX_SWF_PROBE_SIZE = 512;
+
+// The values stored in a Flash movie's (SWF file) header.
+struct Swf_Header
+{
+	u8 version;
+	u32 file_length;
+
+	// In twips (1/20 of a pixel).
+	s32 stage_width;
+	s32 stage_height;
+
+	// An 8.8 fixed point number.
+	u16 frame_rate;
+	u16 frame_count;
+};
+
+bool probe_swf_header(Arena* arena, const void* file_bytes, u32 num_file_bytes, Swf_Header* result_header);
+
 #endif
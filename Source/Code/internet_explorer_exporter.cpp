@@ -145,6 +145,16 @@ enum Ie_Index_Entry_Signature
 	// The value in IE_4_5_DEALLOCATED_VALUE can also appear in an entry's signature member.
 };
 
+// @Format: The low bits in each hash table item's key are used as flags. The remaining bits are the high bits of the URL's hash.
+static const u32 IE_4_5_HASH_FLAG_BITS = 6;
+
+// @Format: The key values used by hash table items that don't point to any entry.
+enum Ie_Index_Hash_Key
+{
+	HASH_KEY_DELETED = 0x01,
+	HASH_KEY_FREE = 0x03
+};
+
 // We'll tightly pack the structures that represent different parts of the index.dat file and then access each member directly after
 // mapping it into memory. Due to the way the file is designed, there shouldn't be any memory alignment problems when accessing this
 // structure's values. 
@@ -187,6 +197,23 @@ struct Ie_4_5_Index_File_Map_Entry
 	u32 num_allocated_blocks; // @Used.
 };
 
+// @Format: The beginning of each hash table page in the index.dat file. This page is followed by an array of hash table items
+// that fill the remaining allocated blocks.
+struct Ie_4_5_Index_Hash_Table_Header
+{
+	u32 signature; // @Used.
+	u32 num_allocated_blocks; // @Used.
+	u32 file_offset_to_next_hash_table_page; // @Used.
+	u32 sequence_number; // @Used.
+};
+
+// @Format: Each item in a hash table page.
+struct Ie_4_5_Index_Hash_Table_Item
+{
+	u32 key; // @Used.
+	u32 file_offset_to_entry; // @Used.
+};
+
 // @Format: The body of a URL entry in the index.dat file (IE 4, format version 4.7).
 struct Ie_4_Index_Url_Entry
 {
@@ -268,6 +295,8 @@ struct Ie_5_Index_Url_Entry
 
 _STATIC_ASSERT(sizeof(Ie_4_5_Index_Header) == 0x0250);
 _STATIC_ASSERT(sizeof(Ie_4_5_Index_File_Map_Entry) == 0x08);
+_STATIC_ASSERT(sizeof(Ie_4_5_Index_Hash_Table_Header) == 0x10);
+_STATIC_ASSERT(sizeof(Ie_4_5_Index_Hash_Table_Item) == 0x08);
 _STATIC_ASSERT(sizeof(Ie_4_Index_Url_Entry) == 0x60);
 _STATIC_ASSERT(sizeof(Ie_5_Index_Url_Entry) == 0x60);
 
@@ -446,7 +475,9 @@ void export_default_or_specific_internet_explorer_cache(Exporter* exporter)
 				log_newline();\
 				log_info("Internet Explorer 10 to 11: Checking the database file '%ls'.", database_filename);\
 				PathCombineW(exporter->index_path, exporter->cache_path, database_filename);\
+				if(exporter->ese_critical_section != NULL) EnterCriticalSection(exporter->ese_critical_section);\
 				export_internet_explorer_10_to_11_cache(exporter, T(ese_files_prefix));\
+				if(exporter->ese_critical_section != NULL) LeaveCriticalSection(exporter->ese_critical_section);\
 			} while(false, false)
 			
 			EXPORT_USING_DATABASE_FILE("V01");
@@ -459,7 +490,8 @@ void export_default_or_specific_internet_explorer_cache(Exporter* exporter)
 
 		#endif
 
-		if(ie_4_to_9_cache_exists)
+		// The raw export copies every file in the cache directories, which defeats the purpose of looking up specific URLs.
+		if(ie_4_to_9_cache_exists && !exporter->use_ie_url_lookup)
 		{
 			if(exporter->is_exporting_from_default_locations)
 			{
@@ -521,6 +553,982 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_internet_explorer_4_to_9_cache_files_cal
 	return true;
 }
 
+// Exports a URL or LEAK entry from Internet Explorer 4 through 9's index file. The entry's members are converted to the host's byte
+// order in place, meaning this function must only be called once for each entry.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how Internet Explorer's cache should be exported.
+// 2. header - The index file's header. Used to find the name of the directory where the cached file is stored.
+// 3. entry - The beginning of the entry. Every block allocated to this entry must be in memory.
+// 4. major_version - The index file's major format version ('4' or '5').
+// 5. cache_version - The value of the Cache Version column.
+// 6. block_number - The block where the entry starts. Used for logging purposes and as the record identifier for the -shard option.
+//
+// @Returns: Nothing.
+static void export_internet_explorer_4_to_9_url_entry(	Exporter* exporter, Ie_4_5_Index_Header* header, Ie_4_5_Index_File_Map_Entry* entry,
+														char major_version, TCHAR* cache_version, u32 block_number)
+{
+	Arena* arena = &(exporter->temporary_arena);
+
+	// Some entries may contain garbage fields whose value is IE_4_5_DEALLOCATED_VALUE (which is used to fill deallocated
+	// blocks). We'll use this macro to check if the low 32 bits of each member match this value. If so, we'll
+	// clear them to zero. Empty strings or NULL values will show up as missing values in the CSV files.
+	// This won't work for the few u8 members, though we only use 'cache_directory_index' whose value is always
+	// strictly checked to see if it's within the correct bounds. Note that the low part of the cached file
+	// size may still exist even if the high part is garbage. For example:
+	// - low_cached_file_size = 1234
+	// - high_cached_file_size = IE_4_5_DEALLOCATED_VALUE
+	// Since these values are checked individually, we'll still keep the useful value and set the high part
+	// to zero.
+	bool found_deallocated_member = false;
+	#define READ_MEMBER(member)\
+	do\
+	{\
+		LITTLE_ENDIAN_TO_HOST(url_entry->member);\
+		if( (major_version <= '4') && (((u32) url_entry->member & 0xFFFFFFFF) == IE_4_5_DEALLOCATED_VALUE) )\
+		{\
+			url_entry->member = 0;\
+			found_deallocated_member = true;\
+		}\
+	} while(false, false)
+
+	u32 entry_offset_to_filename = 0;
+	u32 entry_offset_to_url = 0;
+	u32 entry_offset_to_headers = 0;
+	u32 headers_size = 0;
+
+	// The raw values are only formatted after checking if the entry passes the -filter-entries option.
+	u64 last_modified_time_value = 0;
+	u64 last_access_time_value = 0;
+	u64 expiry_time_value = 0; // A FILETIME in version 4 and a DOS date time in version 5.
+	u32 creation_time_value = 0;
+
+	u8 cache_directory_index = 0;
+
+	u64 cached_file_size_value = 0;
+	u32 num_entry_locks = 0;
+
+	#define READ_COMMON()\
+	do\
+	{\
+		entry_offset_to_filename = url_entry->entry_offset_to_filename;\
+		entry_offset_to_url = url_entry->entry_offset_to_url;\
+		entry_offset_to_headers = url_entry->entry_offset_to_headers;\
+		headers_size = url_entry->headers_size;\
+		\
+		last_modified_time_value = url_entry->last_modified_time;\
+		last_access_time_value = url_entry->last_access_time;\
+		expiry_time_value = url_entry->expiry_time;\
+		creation_time_value = url_entry->creation_time;\
+		\
+		cache_directory_index = url_entry->cache_directory_index;\
+		\
+		num_entry_locks = url_entry->num_entry_locks;\
+	} while(false, false)
+
+	if(major_version == '4')
+	{
+		Ie_4_Index_Url_Entry* url_entry = (Ie_4_Index_Url_Entry*) advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));
+		_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(url_entry, u64));
+
+		READ_MEMBER(last_modified_time);
+		READ_MEMBER(last_access_time);
+		READ_MEMBER(expiry_time);
+
+		READ_MEMBER(cached_file_size);
+		READ_MEMBER(_reserved_1);
+		READ_MEMBER(_reserved_2);
+		READ_MEMBER(_reserved_3);
+
+		READ_MEMBER(_reserved_4);
+		READ_MEMBER(_reserved_5);
+		READ_MEMBER(entry_offset_to_url);
+
+		READ_MEMBER(cache_directory_index);
+		READ_MEMBER(_reserved_6);
+		READ_MEMBER(_reserved_7);
+		READ_MEMBER(_reserved_8);
+
+		READ_MEMBER(entry_offset_to_filename);
+		READ_MEMBER(cache_flags);
+		READ_MEMBER(entry_offset_to_headers);
+		READ_MEMBER(headers_size);
+		
+		READ_MEMBER(_reserved_9);
+		READ_MEMBER(last_sync_time);
+		READ_MEMBER(num_entry_locks);
+		READ_MEMBER(_reserved_10);
+		
+		READ_MEMBER(creation_time);
+		READ_MEMBER(_reserved_11);
+
+		READ_COMMON();
+
+		cached_file_size_value = url_entry->cached_file_size;
+	}
+	else if(major_version == '5')
+	{
+		Ie_5_Index_Url_Entry* url_entry = (Ie_5_Index_Url_Entry*) advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));
+		_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(url_entry, u64));
+
+		READ_MEMBER(last_modified_time);
+		READ_MEMBER(last_access_time);
+		READ_MEMBER(expiry_time);
+		READ_MEMBER(_reserved_1);
+
+		READ_MEMBER(low_cached_file_size);
+		READ_MEMBER(high_cached_file_size);
+
+		READ_MEMBER(file_offset_to_group_or_group_list);
+		
+		if(entry->signature == ENTRY_URL) READ_MEMBER(sticky_time_delta);
+		else READ_MEMBER(file_offset_to_next_leak_entry);
+
+		READ_MEMBER(_reserved_3);
+		READ_MEMBER(entry_offset_to_url);
+
+		READ_MEMBER(cache_directory_index);
+		READ_MEMBER(sync_count);
+		READ_MEMBER(format_version);
+		READ_MEMBER(format_version_copy);
+
+		READ_MEMBER(entry_offset_to_filename);
+		READ_MEMBER(cache_flags);
+		READ_MEMBER(entry_offset_to_headers);
+		READ_MEMBER(headers_size);
+		
+		READ_MEMBER(entry_offset_to_file_extension);
+		READ_MEMBER(last_sync_time);
+		READ_MEMBER(num_entry_locks);
+		READ_MEMBER(level_of_entry_lock_nesting);
+		
+		READ_MEMBER(creation_time);
+		READ_MEMBER(_reserved_4);
+		READ_MEMBER(_reserved_5);
+
+		READ_COMMON();
+
+		cached_file_size_value = combine_high_and_low_u32s_into_u64(url_entry->high_cached_file_size, url_entry->low_cached_file_size);
+	}
+	else
+	{
+		_ASSERT(false);
+	}
+
+	#undef READ_MEMBER
+	#undef READ_COMMON
+
+	TCHAR* url = T("");
+	if(entry_offset_to_url > 0)
+	{
+		char* url_in_entry = (char*) advance_bytes(entry, entry_offset_to_url);
+		url = convert_ansi_string_to_tchar(arena, url_in_entry);
+	}
+
+	Http_Headers headers = {};
+	if(entry_offset_to_headers > 0 && headers_size > 0)
+	{
+		char* headers_in_entry = (char*) advance_bytes(entry, entry_offset_to_headers);
+		parse_http_headers(arena, headers_in_entry, headers_size, &headers);
+	}
+
+	Filterable_Cache_Entry entry_to_filter = {};
+	entry_to_filter.url = url;
+	entry_to_filter.content_type = headers.content_type;
+	entry_to_filter.has_size = true;
+	entry_to_filter.size = cached_file_size_value;
+	entry_to_filter.last_modified_time = convert_filetime_to_time64_t(last_modified_time_value);
+
+	if(!cache_entry_passes_filter(exporter, &entry_to_filter)) return;
+
+	url = decode_url(arena, url);
+
+	TCHAR* decorated_filename = T("");
+	if(entry_offset_to_filename > 0)
+	{
+		char* filename_in_entry = (char*) advance_bytes(entry, entry_offset_to_filename);
+		decorated_filename = convert_ansi_string_to_tchar(arena, filename_in_entry);
+	}
+
+	TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	format_filetime_date_time(last_modified_time_value, last_modified_time);
+
+	TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	format_filetime_date_time(last_access_time_value, last_access_time);
+
+	TCHAR creation_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	format_dos_date_time(creation_time_value, creation_time);
+
+	TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	if(major_version == '4') format_filetime_date_time(expiry_time_value, expiry_time);
+	else format_dos_date_time((u32) expiry_time_value, expiry_time);
+
+	TCHAR cached_file_size[MAX_INT_64_CHARS] = T("");
+	convert_u64_to_string(cached_file_size_value, cached_file_size);
+
+	TCHAR access_count[MAX_INT_32_CHARS] = T("");
+	convert_u32_to_string(num_entry_locks, access_count);
+
+	TCHAR* short_location_pointer = NULL;
+	TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
+	TCHAR full_location_on_cache[MAX_PATH_CHARS] = T("");
+
+	const u8 CHANNEL_DEFINITION_FORMAT_INDEX = 0xFF;
+	if(cache_directory_index < IE_4_5_ESE_MAX_NUM_CACHE_DIRECTORIES)
+	{
+		short_location_pointer = short_location_on_cache;
+
+		// Build the short file path by using the cached file's directory and its decorated filename.
+		// E.g. "ABCDEFGH\image[1].gif".
+		// @Format: The cache directory's name doesn't include the null terminator.
+		char* cache_directory_name_in_entry = (char*) header->cache_directories[cache_directory_index].name;
+		char cache_directory_ansi_name[IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS + 1] = "";
+		CopyMemory(cache_directory_ansi_name, cache_directory_name_in_entry, IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS * sizeof(char));
+		cache_directory_ansi_name[IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS] = '\0';
+
+		TCHAR* cache_directory_name = convert_ansi_string_to_tchar(arena, cache_directory_ansi_name);
+		PathCombine(short_location_on_cache, cache_directory_name, decorated_filename);
+
+		// Build the absolute file path to the cache file. The cache directories are next to the index file
+		// in this version of Internet Explorer. Here, exporter->index_path is already a full path.
+		PathCombine(full_location_on_cache, exporter->index_path, T(".."));
+		PathAppend(full_location_on_cache, short_location_on_cache);
+	}
+	else if(cache_directory_index == CHANNEL_DEFINITION_FORMAT_INDEX)
+	{
+		// CDF files are marked with this special string since they're not stored on disk.
+		short_location_pointer = T("<CDF>");
+	}
+	else
+	{
+		// Any other unknown indexes.
+		log_warning("Internet Explorer 4 to 9: Found unknown cache directory index 0x%02X for the file '%s' with the following URL: '%s'.", cache_directory_index, decorated_filename, url);
+		short_location_pointer = T("<?>");
+	}
+
+	// @Alias: 'short_location_pointer' may alias 'short_location_on_cache'.
+	TCHAR* format_version_prefix = (major_version == '5') ? (T("Content.IE5")) : (T(""));
+	PathCombine(short_location_on_cache, format_version_prefix, short_location_pointer);
+
+	if(found_deallocated_member)
+	{
+		add_exporter_warning_message(exporter, "Cleared one or more deallocated fields with the value 0x%08X (%I32u) to zero.", IE_4_5_DEALLOCATED_VALUE, IE_4_5_DEALLOCATED_VALUE);
+		log_warning("Internet Explorer 4 to 9: The entry starting in block %I32u with %I32u blocks allocated and the signature 0x%08X contained one or more garbage values (0x%08X). The filename is '%s' and the URL is '%s'.", block_number, entry->num_allocated_blocks, entry->signature, IE_4_5_DEALLOCATED_VALUE, decorated_filename, url);
+	}
+
+	Csv_Entry csv_row[] =
+	{
+		{/* Filename */}, {/* URL */}, {/* File Extension */}, {cached_file_size},
+		{last_modified_time}, {creation_time}, {/* Last Write Time */}, {last_access_time}, {expiry_time}, {access_count},
+		{/* Response */}, {/* Server */}, {/* Cache Control */}, {/* Pragma */},
+		{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
+		{/* Decompressed File Size */}, {/* Location On Cache */}, {cache_version},
+		{/* Missing File */}, {/* Location In Output */}, {/* Copy Error */}, {/* Exporter Warning */},
+		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
+	};
+	_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
+
+	Exporter_Params params = {};
+	params.copy_source_path = full_location_on_cache;
+	params.url = url;
+	params.filename = NULL; // Comes from the URL.
+	params.headers = headers;
+	params.short_location_on_cache = short_location_on_cache;
+	params.has_record_id = true;
+	params.record_id = block_number;
+
+	export_cache_entry(exporter, csv_row, &params);
+}
+
+/*
+	The following defines the functions used to look up specific URLs in the index.dat file without going through every allocated
+	block. The file's hash tables map each URL's hash to the offset of its entry, meaning we can check if a list of URLs exists in
+	the cache by only reading the hash table pages and the entries that match. This is useful when searching for known lost media
+	across a large number of profiles.
+
+	The URL list file is a text file where each line contains a URL exactly as it's stored in the index.dat file. Empty lines and
+	lines that start with a semicolon are skipped.
+*/
+
+// The list of URLs to look up in the index.dat file, along with their precomputed hash keys.
+struct Ie_Url_Lookup
+{
+	int num_urls;
+	char** urls;
+	u32* hash_keys;
+};
+
+// A used item from the index file's hash tables. The key is stored without the flag bits.
+struct Ie_Hash_Lookup_Item
+{
+	u32 hash_key;
+	u32 file_offset_to_entry;
+};
+
+// Various keywords and delimiters for the URL list file syntax.
+static const char URL_LOOKUP_COMMENT = ';';
+static const char* URL_LOOKUP_LINE_DELIMITERS = "\r\n";
+
+// @Format: The lookup table used to hash URLs. This is the same table used by UrlHash() from the Shell API, though WinINet's
+// algorithm produces a different result. See: urlcache_hash_key() in Wine's WinINet implementation ("dlls/wininet/urlcache.c").
+static const u8 IE_4_5_HASH_LOOKUP_TABLE[256] =
+{
+	0x01, 0x0E, 0x6E, 0x19, 0x61, 0xAE, 0x84, 0x77, 0x8A, 0xAA, 0x7D, 0x76, 0x1B, 0xE9, 0x8C, 0x33,
+	0x57, 0xC5, 0xB1, 0x6B, 0xEA, 0xA9, 0x38, 0x44, 0x1E, 0x07, 0xAD, 0x49, 0xBC, 0x28, 0x24, 0x41,
+	0x31, 0xD5, 0x68, 0xBE, 0x39, 0xD3, 0x94, 0xDF, 0x30, 0x73, 0x0F, 0x02, 0x43, 0xBA, 0xD2, 0x1C,
+	0x0C, 0xB5, 0x67, 0x46, 0x16, 0x3A, 0x4B, 0x4E, 0xB7, 0xA7, 0xEE, 0x9D, 0x7C, 0x93, 0xAC, 0x90,
+	0xB0, 0xA1, 0x8D, 0x56, 0x3C, 0x42, 0x80, 0x53, 0x9C, 0xF1, 0x4F, 0x2E, 0xA8, 0xC6, 0x29, 0xFE,
+	0xB2, 0x55, 0xFD, 0xED, 0xFA, 0x9A, 0x85, 0x58, 0x23, 0xCE, 0x5F, 0x74, 0xFC, 0xC0, 0x36, 0xDD,
+	0x66, 0xDA, 0xFF, 0xF0, 0x52, 0x6A, 0x9E, 0xC9, 0x3D, 0x03, 0x59, 0x09, 0x2A, 0x9B, 0x9F, 0x5D,
+	0xA6, 0x50, 0x32, 0x22, 0xAF, 0xC3, 0x64, 0x63, 0x1A, 0x96, 0x10, 0x91, 0x04, 0x21, 0x08, 0xBD,
+	0x79, 0x40, 0x4D, 0x48, 0xD0, 0xF5, 0x82, 0x7A, 0x8F, 0x37, 0x69, 0x86, 0x1D, 0xA4, 0xB9, 0xC2,
+	0xC1, 0xEF, 0x65, 0xF2, 0x05, 0xAB, 0x7E, 0x0B, 0x4A, 0x3B, 0x89, 0xE4, 0x6C, 0xBF, 0xE8, 0x8B,
+	0x06, 0x18, 0x51, 0x14, 0x7F, 0x11, 0x5B, 0x5C, 0xFB, 0x97, 0xE1, 0xCF, 0x15, 0x62, 0x71, 0x70,
+	0x54, 0xE2, 0x12, 0xD6, 0xC7, 0xBB, 0x0D, 0x20, 0x5E, 0xDC, 0xE0, 0xD4, 0xF7, 0xCC, 0xC4, 0x2B,
+	0xF9, 0xEC, 0x2D, 0xF4, 0x6F, 0xB6, 0x99, 0x88, 0x81, 0x5A, 0xD9, 0xCA, 0x13, 0xA5, 0xE7, 0x47,
+	0xE6, 0x8E, 0x60, 0xE3, 0x3E, 0xB3, 0xF6, 0x72, 0xA2, 0x35, 0xA0, 0xD7, 0xCD, 0xB4, 0x2F, 0x6D,
+	0x2C, 0x26, 0x1F, 0x95, 0x87, 0x00, 0xD8, 0x34, 0x3F, 0x17, 0x25, 0x45, 0x27, 0x75, 0x92, 0xB8,
+	0xA3, 0xC8, 0xDE, 0xEB, 0xF8, 0xF3, 0xDB, 0x0A, 0x98, 0x83, 0x7B, 0xE5, 0xCB, 0x4C, 0x78, 0xD1
+};
+
+// Hashes a URL the same way WinINet does when inserting it into the index.dat file's hash tables. Four Pearson hashes are computed
+// at the same time and then combined into a single 32-bit value.
+//
+// @Parameters:
+// 1. url - The URL to hash, exactly as it's stored in the index file.
+//
+// @Returns: The hash key without the flag bits.
+static u32 get_internet_explorer_4_to_9_url_hash_key(const char* url)
+{
+	u8 key[4] = {};
+
+	for(int i = 0; i < _countof(key); ++i)
+	{
+		key[i] = IE_4_5_HASH_LOOKUP_TABLE[(url[0] + i) & 0xFF];
+	}
+
+	if(*url != '\0')
+	{
+		for(++url; *url != '\0'; ++url)
+		{
+			for(int i = 0; i < _countof(key); ++i)
+			{
+				key[i] = IE_4_5_HASH_LOOKUP_TABLE[((u8) *url) ^ key[i]];
+			}
+		}
+	}
+
+	u32 result = ((u32) key[0]) | (((u32) key[1]) << 8) | (((u32) key[2]) << 16) | (((u32) key[3]) << 24);
+	return result >> IE_4_5_HASH_FLAG_BITS;
+}
+
+// Retrieves the number of URLs and how many bytes are (roughly) required to store them from the URL list file.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the path to the URL list file.
+// 2. result_num_urls - The number of URLs found.
+//
+// @Returns: The total size in bytes required to store the URLs found.
+size_t get_internet_explorer_url_lookup_file_size(Exporter* exporter, int* result_num_urls)
+{
+	Arena* temporary_arena = &(exporter->temporary_arena);
+	lock_arena(temporary_arena);
+
+	u64 file_size = 0;
+	char* file = (char*) read_entire_file(temporary_arena, exporter->ie_url_lookup_file_path, &file_size, true);
+
+	size_t total_urls_size = 0;
+	int num_urls = 0;
+
+	if(file != NULL)
+	{
+		String_Array<char>* split_lines = split_string(temporary_arena, file, URL_LOOKUP_LINE_DELIMITERS);
+		
+		for(int i = 0; i < split_lines->num_strings; ++i)
+		{
+			char* line = split_lines->strings[i];
+			line = skip_leading_whitespace(line);
+
+			if(*line == URL_LOOKUP_COMMENT || string_is_empty(line))
+			{
+				// Skip comments and empty lines.
+			}
+			else
+			{
+				total_urls_size += string_size(line);
+				++num_urls;
+			}
+		}
+	}
+	else
+	{
+		log_error("Get Internet Explorer Url Lookup File Size: Failed to load the URL list file '%s'.", exporter->ie_url_lookup_file_path);
+	}
+
+	clear_arena(temporary_arena);
+	unlock_arena(temporary_arena);
+
+	*result_num_urls = num_urls;
+
+	// Total Size = Size for the lookup structure + Size for the URL and hash arrays + Size for the string data.
+	// We'll add a few more bytes to account for each push's alignment.
+	return 	sizeof(Ie_Url_Lookup) + num_urls * (sizeof(char*) + sizeof(u32))
+			+ total_urls_size + (3 + num_urls) * MAX_SCALAR_ALIGNMENT_SIZE;
+}
+
+// Loads the URL list file on disk. This function must be called after get_internet_explorer_url_lookup_file_size() and with a
+// memory arena that is capable of holding the number of bytes it returned.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the path to the URL list file, and the permanent memory arena where the URLs
+// will be stored. After loading this data, this structure's 'ie_url_lookup' member will modified.
+// 2. num_urls - The number of URLs found by an earlier call to get_internet_explorer_url_lookup_file_size().
+//
+// @Returns: Nothing.
+void load_internet_explorer_url_lookup_file(Exporter* exporter, int num_urls)
+{
+	if(num_urls == 0)
+	{
+		log_warning("Load Internet Explorer Url Lookup File: Attempted to load zero URLs. No Internet Explorer cache entries will be exported.");
+		return;
+	}
+
+	Arena* permanent_arena = &(exporter->permanent_arena);
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	lock_arena(temporary_arena);
+
+	Ie_Url_Lookup* url_lookup = push_arena(permanent_arena, sizeof(Ie_Url_Lookup), Ie_Url_Lookup);
+	url_lookup->urls = push_array_to_arena(permanent_arena, num_urls, char*);
+	url_lookup->hash_keys = push_array_to_arena(permanent_arena, num_urls, u32);
+
+	u64 file_size = 0;
+	char* file = (char*) read_entire_file(temporary_arena, exporter->ie_url_lookup_file_path, &file_size, true);
+
+	int num_loaded_urls = 0;
+
+	if(file != NULL)
+	{
+		String_Array<char>* split_lines = split_string(temporary_arena, file, URL_LOOKUP_LINE_DELIMITERS);
+
+		for(int i = 0; i < split_lines->num_strings && num_loaded_urls < num_urls; ++i)
+		{
+			char* line = split_lines->strings[i];
+			line = skip_leading_whitespace(line);
+
+			if(*line == URL_LOOKUP_COMMENT || string_is_empty(line))
+			{
+				// Skip comments and empty lines.
+			}
+			else
+			{
+				size_t url_size = string_size(line);
+				char* url = push_and_copy_to_arena(permanent_arena, url_size, char, line, url_size);
+
+				url_lookup->urls[num_loaded_urls] = url;
+				url_lookup->hash_keys[num_loaded_urls] = get_internet_explorer_4_to_9_url_hash_key(url);
+				++num_loaded_urls;
+			}
+		}
+	}
+	else
+	{
+		log_error("Load Internet Explorer Url Lookup File: Failed to load the URL list file '%s'.", exporter->ie_url_lookup_file_path);
+	}
+
+	clear_arena(temporary_arena);
+	unlock_arena(temporary_arena);
+
+	url_lookup->num_urls = num_loaded_urls;
+	if(num_loaded_urls != num_urls)
+	{
+		log_error("Load Internet Explorer Url Lookup File: Loaded %d URLs when %d were expected.", num_loaded_urls, num_urls);
+	}
+
+	exporter->ie_url_lookup = url_lookup;
+}
+
+// Called by qsort() to sort the hash table items by their keys.
+static int compare_hash_lookup_items(const void* item_pointer_1, const void* item_pointer_2)
+{
+	Ie_Hash_Lookup_Item* item_1 = (Ie_Hash_Lookup_Item*) item_pointer_1;
+	Ie_Hash_Lookup_Item* item_2 = (Ie_Hash_Lookup_Item*) item_pointer_2;
+
+	if(item_1->hash_key < item_2->hash_key) return -1;
+	else if(item_1->hash_key > item_2->hash_key) return 1;
+	else return 0;
+}
+
+// Exports the entries whose URLs match the ones in the URL list file by probing the index file's hash tables.
+//
+// How the lookup works:
+// 1. Walk through the linked list of hash table pages and collect every used item.
+// 2. Sort these items by their keys. We don't rely on the bucket layout inside each page since the exact number of items per bucket
+// may vary between WinINet versions. Sorting them once lets us find every candidate with a binary search instead.
+// 3. For each URL in the list, find the items with the same hash key and read their entries. Since different URLs can have the same
+// hash, each candidate is only exported if the URL stored in the entry matches the one in the list.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains the loaded URL list.
+// 2. index_handle - The handle to the index file.
+// 3. header - The index file's header.
+// 4. index_file_size - The size of the index file in bytes.
+// 5. major_version - The index file's major format version ('4' or '5').
+// 6. cache_version - The value of the Cache Version column.
+//
+// @Returns: Nothing.
+static void lookup_internet_explorer_4_to_9_urls(	Exporter* exporter, HANDLE index_handle, Ie_4_5_Index_Header* header,
+													u64 index_file_size, char major_version, TCHAR* cache_version)
+{
+	Ie_Url_Lookup* url_lookup = exporter->ie_url_lookup;
+	if(url_lookup == NULL || url_lookup->num_urls == 0)
+	{
+		log_warning("Internet Explorer 4 to 9: Skipping the URL lookup since no URLs were loaded.");
+		return;
+	}
+
+	Arena* arena = &(exporter->temporary_arena);
+
+	const u32 MAX_NUM_PAGE_BLOCKS = 1000;
+	const u32 PAGE_BUFFER_SIZE = MAX_NUM_PAGE_BLOCKS * IE_4_5_BLOCK_SIZE;
+	void* page_buffer = aligned_push_arena(arena, PAGE_BUFFER_SIZE, MAX_SCALAR_ALIGNMENT_SIZE);
+
+	const u64 FIRST_BLOCK_OFFSET = sizeof(Ie_4_5_Index_Header) + IE_4_5_ALLOCATION_BITMAP_SIZE;
+	const u64 MAX_NUM_PAGES = index_file_size / IE_4_5_BLOCK_SIZE;
+
+	Ie_Hash_Lookup_Item* items = NULL;
+	int num_items = 0;
+	u32 num_pages = 0;
+
+	// The items from each page are pushed one after the other and end up in a single contiguous array.
+	u32 page_offset = header->file_offset_to_first_hash_table_page;
+	while(page_offset != 0)
+	{
+		if(page_offset < FIRST_BLOCK_OFFSET || page_offset >= index_file_size)
+		{
+			log_error("Internet Explorer 4 to 9: Found the hash table page offset 0x%08X outside the index file's blocks after reading %I32u pages.", page_offset, num_pages);
+			break;
+		}
+
+		if(num_pages >= MAX_NUM_PAGES)
+		{
+			log_error("Internet Explorer 4 to 9: Stopped reading the hash tables after %I32u pages since the list of pages loops back on itself.", num_pages);
+			break;
+		}
+
+		Ie_4_5_Index_Hash_Table_Header* page = (Ie_4_5_Index_Hash_Table_Header*) page_buffer;
+		if(!read_file_chunk(index_handle, page, sizeof(Ie_4_5_Index_Hash_Table_Header), page_offset))
+		{
+			log_error("Internet Explorer 4 to 9: Failed to read the hash table page header at 0x%08X.", page_offset);
+			break;
+		}
+
+		LITTLE_ENDIAN_TO_HOST(page->signature);
+		LITTLE_ENDIAN_TO_HOST(page->num_allocated_blocks);
+		LITTLE_ENDIAN_TO_HOST(page->file_offset_to_next_hash_table_page);
+		LITTLE_ENDIAN_TO_HOST(page->sequence_number);
+
+		if(page->signature != ENTRY_HASH)
+		{
+			log_error("Internet Explorer 4 to 9: Found the unexpected signature 0x%08X in the hash table page at 0x%08X.", page->signature, page_offset);
+			break;
+		}
+
+		if(page->num_allocated_blocks == 0 || page->num_allocated_blocks > MAX_NUM_PAGE_BLOCKS)
+		{
+			log_error("Internet Explorer 4 to 9: The hash table page at 0x%08X has %I32u allocated blocks when at most %I32u were expected.", page_offset, page->num_allocated_blocks, MAX_NUM_PAGE_BLOCKS);
+			break;
+		}
+
+		if(page->sequence_number != num_pages)
+		{
+			log_warning("Internet Explorer 4 to 9: The hash table page at 0x%08X has the sequence number %I32u when %I32u was expected.", page_offset, page->sequence_number, num_pages);
+		}
+
+		u32 page_size = page->num_allocated_blocks * IE_4_5_BLOCK_SIZE;
+		u32 next_page_offset = page->file_offset_to_next_hash_table_page;
+
+		if(!read_file_chunk(index_handle, page_buffer, page_size, page_offset))
+		{
+			log_error("Internet Explorer 4 to 9: Failed to read the %I32u bytes in the hash table page at 0x%08X.", page_size, page_offset);
+			break;
+		}
+
+		Ie_4_5_Index_Hash_Table_Item* page_items = (Ie_4_5_Index_Hash_Table_Item*) advance_bytes(page_buffer, sizeof(Ie_4_5_Index_Hash_Table_Header));
+		int num_page_items = (int) ((page_size - sizeof(Ie_4_5_Index_Hash_Table_Header)) / sizeof(Ie_4_5_Index_Hash_Table_Item));
+		int num_used_page_items = 0;
+
+		for(int i = 0; i < num_page_items; ++i)
+		{
+			Ie_4_5_Index_Hash_Table_Item* item = &page_items[i];
+			LITTLE_ENDIAN_TO_HOST(item->key);
+			LITTLE_ENDIAN_TO_HOST(item->file_offset_to_entry);
+
+			bool is_used = 	item->key != HASH_KEY_DELETED && item->key != HASH_KEY_FREE && item->key != IE_4_5_DEALLOCATED_VALUE
+							&& item->file_offset_to_entry >= FIRST_BLOCK_OFFSET && item->file_offset_to_entry < index_file_size;
+			
+			if(is_used)
+			{
+				// Compact the used items at the beginning of the page buffer.
+				page_items[num_used_page_items] = *item;
+				++num_used_page_items;
+			}
+		}
+
+		Ie_Hash_Lookup_Item* new_items = push_array_to_arena(arena, num_used_page_items, Ie_Hash_Lookup_Item);
+		if(new_items == NULL)
+		{
+			log_error("Internet Explorer 4 to 9: Ran out of memory while storing the items in the hash table page at 0x%08X.", page_offset);
+			break;
+		}
+
+		if(items == NULL) items = new_items;
+		_ASSERT(new_items == items + num_items);
+
+		for(int i = 0; i < num_used_page_items; ++i)
+		{
+			new_items[i].hash_key = page_items[i].key >> IE_4_5_HASH_FLAG_BITS;
+			new_items[i].file_offset_to_entry = page_items[i].file_offset_to_entry;
+		}
+
+		num_items += num_used_page_items;
+		++num_pages;
+		page_offset = next_page_offset;
+	}
+
+	log_info("Internet Explorer 4 to 9: Found %d used items in %I32u hash table pages.", num_items, num_pages);
+
+	if(num_items > 0)
+	{
+		qsort(items, num_items, sizeof(Ie_Hash_Lookup_Item), compare_hash_lookup_items);
+	}
+
+	// Reuse the page buffer to read each candidate entry.
+	void* entry_buffer = page_buffer;
+	u32 entry_buffer_size = PAGE_BUFFER_SIZE;
+
+	int num_found_urls = 0;
+	int num_hash_collisions = 0;
+
+	lock_arena(arena);
+
+	for(int i = 0; i < url_lookup->num_urls; ++i)
+	{
+		char* url = url_lookup->urls[i];
+		u32 hash_key = url_lookup->hash_keys[i];
+		size_t url_size = string_size(url);
+
+		// Find the first item with this key.
+		int low = 0;
+		int high = num_items;
+		while(low < high)
+		{
+			int middle = low + (high - low) / 2;
+			if(items[middle].hash_key < hash_key) low = middle + 1;
+			else high = middle;
+		}
+
+		bool found_url = false;
+
+		for(int j = low; j < num_items && items[j].hash_key == hash_key && !found_url; ++j)
+		{
+			u32 entry_offset = items[j].file_offset_to_entry;
+			u32 block_number = (u32) ((entry_offset - FIRST_BLOCK_OFFSET) / IE_4_5_BLOCK_SIZE);
+
+			Ie_4_5_Index_File_Map_Entry* entry = (Ie_4_5_Index_File_Map_Entry*) entry_buffer;
+			if(!read_file_chunk(index_handle, entry, IE_4_5_BLOCK_SIZE, entry_offset))
+			{
+				log_error("Internet Explorer 4 to 9: Failed to read the first block of the entry at 0x%08X.", entry_offset);
+				continue;
+			}
+
+			LITTLE_ENDIAN_TO_HOST(entry->signature);
+			LITTLE_ENDIAN_TO_HOST(entry->num_allocated_blocks);
+
+			// Redirect entries are also stored in the hash tables, but we only export URL and LEAK entries.
+			if(entry->signature != ENTRY_URL && entry->signature != ENTRY_LEAK) continue;
+
+			u32 entry_size = entry->num_allocated_blocks * IE_4_5_BLOCK_SIZE;
+			if(entry->num_allocated_blocks == 0 || entry_size > entry_buffer_size)
+			{
+				log_error("Internet Explorer 4 to 9: The entry at 0x%08X has an invalid number of allocated blocks (%I32u).", entry_offset, entry->num_allocated_blocks);
+				continue;
+			}
+
+			if(!read_file_chunk(index_handle, entry_buffer, entry_size, entry_offset))
+			{
+				log_error("Internet Explorer 4 to 9: Failed to read the %I32u bytes of the entry at 0x%08X.", entry_size, entry_offset);
+				continue;
+			}
+
+			LITTLE_ENDIAN_TO_HOST(entry->signature);
+			LITTLE_ENDIAN_TO_HOST(entry->num_allocated_blocks);
+
+			void* url_entry = advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));
+			u32 entry_offset_to_url = (major_version == '4') ? (((Ie_4_Index_Url_Entry*) url_entry)->entry_offset_to_url)
+															 : (((Ie_5_Index_Url_Entry*) url_entry)->entry_offset_to_url);
+			LITTLE_ENDIAN_TO_HOST(entry_offset_to_url);
+
+			bool is_same_url = 	entry_offset_to_url > 0 && entry_offset_to_url < entry_size && url_size <= entry_size - entry_offset_to_url
+								&& memory_is_equal(advance_bytes(entry, entry_offset_to_url), url, url_size);
+
+			if(is_same_url)
+			{
+				found_url = true;
+				++num_found_urls;
+				export_internet_explorer_4_to_9_url_entry(exporter, header, entry, major_version, cache_version, block_number);
+			}
+			else
+			{
+				++num_hash_collisions;
+			}
+		}
+	}
+
+	unlock_arena(arena);
+
+	log_info("Internet Explorer 4 to 9: Found %d of %d URLs in the index file with %d hash collisions.", num_found_urls, url_lookup->num_urls, num_hash_collisions);
+}
+
+// Checks if a string in an entry starts after the entry's body and ends before its last allocated block. Used to validate entries
+// that were found in the unallocated blocks of the index file.
+//
+// @Parameters:
+// 1. entry - The beginning of the entry.
+// 2. entry_size - The size of the entry in bytes.
+// 3. entry_offset_to_string - The offset of the string relative to the beginning of the entry.
+//
+// @Returns: True if the string is non-empty and null terminated inside the entry. Otherwise, false.
+static bool is_string_inside_internet_explorer_4_to_9_entry(Ie_4_5_Index_File_Map_Entry* entry, u32 entry_size, u32 entry_offset_to_string)
+{
+	const u32 MIN_STRING_OFFSET = sizeof(Ie_4_5_Index_File_Map_Entry) + sizeof(Ie_5_Index_Url_Entry);
+	_STATIC_ASSERT(sizeof(Ie_4_Index_Url_Entry) == sizeof(Ie_5_Index_Url_Entry));
+
+	if(entry_offset_to_string < MIN_STRING_OFFSET || entry_offset_to_string >= entry_size) return false;
+
+	char* str = (char*) advance_bytes(entry, entry_offset_to_string);
+	if(*str == '\0') return false;
+
+	for(u32 i = entry_offset_to_string; i < entry_size; ++i, ++str)
+	{
+		if(*str == '\0') return true;
+	}
+
+	return false;
+}
+
+// Checks if a URL or LEAK entry that was found in the unallocated blocks of the index file is plausible enough to be exported. Since
+// these blocks may have been partially overwritten, we'll require that every offset points inside the entry, that the URL and
+// filename strings are terminated, and that the cache directory index is either valid or one of the known special values.
+//
+// @Parameters:
+// 1. header - The index file's header.
+// 2. entry - The beginning of the entry. Every block allocated to this entry must be in memory.
+// 3. major_version - The index file's major format version ('4' or '5').
+//
+// @Returns: True if the entry looks valid. Otherwise, false.
+static bool is_recovered_internet_explorer_4_to_9_entry_valid(Ie_4_5_Index_Header* header, Ie_4_5_Index_File_Map_Entry* entry, char major_version)
+{
+	u32 entry_size = entry->num_allocated_blocks * IE_4_5_BLOCK_SIZE;
+
+	u32 entry_offset_to_url = 0;
+	u32 entry_offset_to_filename = 0;
+	u32 entry_offset_to_headers = 0;
+	u32 headers_size = 0;
+	u8 cache_directory_index = 0;
+
+	#define GET_MEMBERS(Url_Entry_Type)\
+	do\
+	{\
+		Url_Entry_Type* url_entry = (Url_Entry_Type*) advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));\
+		entry_offset_to_url = url_entry->entry_offset_to_url;\
+		entry_offset_to_filename = url_entry->entry_offset_to_filename;\
+		entry_offset_to_headers = url_entry->entry_offset_to_headers;\
+		headers_size = url_entry->headers_size;\
+		cache_directory_index = url_entry->cache_directory_index;\
+	} while(false, false)
+
+	if(major_version == '4') GET_MEMBERS(Ie_4_Index_Url_Entry);
+	else GET_MEMBERS(Ie_5_Index_Url_Entry);
+
+	#undef GET_MEMBERS
+
+	LITTLE_ENDIAN_TO_HOST(entry_offset_to_url);
+	LITTLE_ENDIAN_TO_HOST(entry_offset_to_filename);
+	LITTLE_ENDIAN_TO_HOST(entry_offset_to_headers);
+	LITTLE_ENDIAN_TO_HOST(headers_size);
+
+	// The export function only clears offsets that were filled with IE_4_5_DEALLOCATED_VALUE in version 4, so we'll reject them
+	// here for every version. Otherwise, they would point far past the end of the entry.
+	if(		entry_offset_to_url == IE_4_5_DEALLOCATED_VALUE || entry_offset_to_filename == IE_4_5_DEALLOCATED_VALUE
+		||	entry_offset_to_headers == IE_4_5_DEALLOCATED_VALUE || headers_size == IE_4_5_DEALLOCATED_VALUE)
+	{
+		return false;
+	}
+
+	if(!is_string_inside_internet_explorer_4_to_9_entry(entry, entry_size, entry_offset_to_url)) return false;
+
+	if(entry_offset_to_filename != 0 && !is_string_inside_internet_explorer_4_to_9_entry(entry, entry_size, entry_offset_to_filename))
+	{
+		return false;
+	}
+
+	if(entry_offset_to_headers != 0 && headers_size > 0)
+	{
+		if(entry_offset_to_headers >= entry_size || headers_size > entry_size - entry_offset_to_headers) return false;
+	}
+
+	const u8 CHANNEL_DEFINITION_FORMAT_INDEX = 0xFF;
+	u32 num_directories = MIN(header->num_directories, (u32) IE_4_5_ESE_MAX_NUM_CACHE_DIRECTORIES);
+	return (cache_directory_index < num_directories) || (cache_directory_index == CHANNEL_DEFINITION_FORMAT_INDEX);
+}
+
+// Exports any URL and LEAK entries that still exist in the unallocated blocks of the index file. When WinINet evicts an entry, it
+// only clears its bits in the allocation bitmap, meaning its data may remain intact until those blocks are reused. These entries
+// are exported with the "Recovered" cache version.
+//
+// Since entries always start at the beginning of a block, we only need to compare the first four bytes of each unallocated block
+// with the URL and LEAK signatures. Fully allocated regions are skipped 32 blocks at a time by checking the allocation bitmap one
+// 32-bit word at a time. The index file is read sequentially in large chunks, so this process is mostly bound by the disk speed.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how Internet Explorer's cache should be exported.
+// 2. index_handle - The handle to the index file.
+// 3. header - The index file's header.
+// 4. allocation_bitmap - The index file's allocation bitmap.
+// 5. total_num_blocks - The number of blocks in the index file.
+// 6. block_buffer - A buffer used to read chunks of blocks. The allocated blocks of each recovered entry must fit in this buffer.
+// 7. block_buffer_size - The size of this buffer in bytes.
+// 8. major_version - The index file's major format version ('4' or '5').
+//
+// @Returns: Nothing.
+static void recover_internet_explorer_4_to_9_entries(	Exporter* exporter, HANDLE index_handle, Ie_4_5_Index_Header* header,
+														u8* allocation_bitmap, u32 total_num_blocks,
+														void* block_buffer, u32 block_buffer_size, char major_version)
+{
+	TCHAR* cache_version = T("Recovered");
+
+	const u64 FIRST_BLOCK_OFFSET = sizeof(Ie_4_5_Index_Header) + IE_4_5_ALLOCATION_BITMAP_SIZE;
+	const u32 NUM_BITMAP_WORD_BLOCKS = sizeof(u32) * CHAR_BIT;
+	const u32 FULLY_ALLOCATED_BITMAP_WORD = 0xFFFFFFFF;
+	u32 num_blocks_per_read = block_buffer_size / IE_4_5_BLOCK_SIZE;
+
+	#define IS_BLOCK_ALLOCATED(block) ( (allocation_bitmap[(block) / CHAR_BIT] & (1 << ((block) % CHAR_BIT))) != 0 )
+
+	int num_recovered_url_entries = 0;
+	int num_recovered_leak_entries = 0;
+	int num_rejected_entries = 0;
+
+	u32 chunk_first_block = 0;
+	u32 chunk_num_blocks = 0;
+
+	u32 block_count = 0;
+	while(block_count < total_num_blocks)
+	{
+		if(block_count % NUM_BITMAP_WORD_BLOCKS == 0 && block_count + NUM_BITMAP_WORD_BLOCKS <= total_num_blocks)
+		{
+			u32 bitmap_word = 0;
+			CopyMemory(&bitmap_word, &allocation_bitmap[block_count / CHAR_BIT], sizeof(bitmap_word));
+
+			if(bitmap_word == FULLY_ALLOCATED_BITMAP_WORD)
+			{
+				block_count += NUM_BITMAP_WORD_BLOCKS;
+				continue;
+			}
+		}
+
+		if(IS_BLOCK_ALLOCATED(block_count))
+		{
+			++block_count;
+			continue;
+		}
+
+		if(block_count < chunk_first_block || block_count >= chunk_first_block + chunk_num_blocks)
+		{
+			u64 chunk_offset = FIRST_BLOCK_OFFSET + ((u64) block_count) * IE_4_5_BLOCK_SIZE;
+			u32 num_bytes_read = 0;
+			if(!read_file_chunk(index_handle, block_buffer, num_blocks_per_read * IE_4_5_BLOCK_SIZE, chunk_offset, true, &num_bytes_read)
+			|| num_bytes_read < IE_4_5_BLOCK_SIZE)
+			{
+				log_error("Internet Explorer 4 to 9: Failed to read the next block chunk while recovering entries after processing %I32u blocks.", block_count);
+				break;
+			}
+
+			chunk_first_block = block_count;
+			chunk_num_blocks = num_bytes_read / IE_4_5_BLOCK_SIZE;
+		}
+
+		Ie_4_5_Index_File_Map_Entry* entry = (Ie_4_5_Index_File_Map_Entry*) advance_bytes(block_buffer, (block_count - chunk_first_block) * IE_4_5_BLOCK_SIZE);
+		_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(entry, u32));
+
+		u32 signature = entry->signature;
+		LITTLE_ENDIAN_TO_HOST(signature);
+
+		if(signature != ENTRY_URL && signature != ENTRY_LEAK)
+		{
+			++block_count;
+			continue;
+		}
+
+		u32 num_entry_blocks = entry->num_allocated_blocks;
+		LITTLE_ENDIAN_TO_HOST(num_entry_blocks);
+
+		// Every block in a recovered entry must be unallocated. Otherwise, part of it was likely overwritten by a newer entry.
+		bool is_plausible = (num_entry_blocks > 0) && (num_entry_blocks <= num_blocks_per_read) && (num_entry_blocks <= total_num_blocks - block_count);
+		for(u32 i = 1; i < num_entry_blocks && is_plausible; ++i)
+		{
+			if(IS_BLOCK_ALLOCATED(block_count + i)) is_plausible = false;
+		}
+
+		if(!is_plausible)
+		{
+			++num_rejected_entries;
+			++block_count;
+			continue;
+		}
+
+		if(block_count + num_entry_blocks > chunk_first_block + chunk_num_blocks)
+		{
+			if(block_count == chunk_first_block)
+			{
+				// The index file ends before the entry's last block.
+				++num_rejected_entries;
+				++block_count;
+			}
+			else
+			{
+				// Read the next chunk starting at this entry so all of its blocks are in memory.
+				chunk_num_blocks = 0;
+			}
+
+			continue;
+		}
+
+		LITTLE_ENDIAN_TO_HOST(entry->signature);
+		LITTLE_ENDIAN_TO_HOST(entry->num_allocated_blocks);
+
+		if(is_recovered_internet_explorer_4_to_9_entry_valid(header, entry, major_version))
+		{
+			export_internet_explorer_4_to_9_url_entry(exporter, header, entry, major_version, cache_version, block_count);
+
+			if(signature == ENTRY_URL) ++num_recovered_url_entries;
+			else ++num_recovered_leak_entries;
+
+			block_count += num_entry_blocks;
+		}
+		else
+		{
+			++num_rejected_entries;
+			++block_count;
+		}
+	}
+
+	#undef IS_BLOCK_ALLOCATED
+
+	log_info("Internet Explorer 4 to 9: Recovered the following entries from the unallocated blocks: Url = %d, Leak = %d, Rejected = %d.",
+						num_recovered_url_entries, num_recovered_leak_entries, num_rejected_entries);
+}
+
 // Exports Internet Explorer 4 through 9's cache from a given location.
 //
 // @Parameters:
@@ -537,7 +1545,10 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 
 	Arena* arena = &(exporter->temporary_arena);
 
-	HANDLE index_handle = create_handle(exporter->index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+	// Looking up URLs jumps around the index file instead of reading every block in order.
+	DWORD access_flag = (exporter->use_ie_url_lookup) ? (FILE_FLAG_RANDOM_ACCESS) : (FILE_FLAG_SEQUENTIAL_SCAN);
+
+	HANDLE index_handle = create_handle(exporter->index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, access_flag);
 	if(index_handle == INVALID_HANDLE_VALUE)
 	{
 		DWORD error_code = GetLastError();
@@ -552,7 +1563,7 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 			if(copy_success)
 			{
 				log_info("Internet Explorer 4 to 9: Copied the index file to the temporary file in '%s'.", temporary_index_path);
-				index_handle = create_handle(temporary_index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+				index_handle = create_handle(temporary_index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, access_flag);
 			}
 			else
 			{
@@ -652,6 +1663,14 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 		return;
 	}
 
+	if(exporter->use_ie_url_lookup)
+	{
+		lookup_internet_explorer_4_to_9_urls(exporter, index_handle, header, index_file_size, major_version, cache_version);
+		safe_close_handle(&index_handle);
+		reset_temporary_exporter_members(exporter);
+		return;
+	}
+
 	// Go through each bit to check if a particular block was allocated. If so, we'll skip to that block and handle
 	// that specific entry type. If not, we'll ignore it and move to the next one.
 	u8* allocation_bitmap = (u8*) advance_bytes(header, sizeof(Ie_4_5_Index_Header));
@@ -763,244 +1782,7 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 			case(ENTRY_URL):
 			case(ENTRY_LEAK):
 			{
-				// Some entries may contain garbage fields whose value is IE_4_5_DEALLOCATED_VALUE (which is used to fill deallocated
-				// blocks). We'll use this macro to check if the low 32 bits of each member match this value. If so, we'll
-				// clear them to zero. Empty strings or NULL values will show up as missing values in the CSV files.
-				// This won't work for the few u8 members, though we only use 'cache_directory_index' whose value is always
-				// strictly checked to see if it's within the correct bounds. Note that the low part of the cached file
-				// size may still exist even if the high part is garbage. For example:
-				// - low_cached_file_size = 1234
-				// - high_cached_file_size = IE_4_5_DEALLOCATED_VALUE
-				// Since these values are checked individually, we'll still keep the useful value and set the high part
-				// to zero.
-				bool found_deallocated_member = false;
-				#define READ_MEMBER(member)\
-				do\
-				{\
-					LITTLE_ENDIAN_TO_HOST(url_entry->member);\
-					if( (major_version <= '4') && (((u32) url_entry->member & 0xFFFFFFFF) == IE_4_5_DEALLOCATED_VALUE) )\
-					{\
-						url_entry->member = 0;\
-						found_deallocated_member = true;\
-					}\
-				} while(false, false)
-
-				u32 entry_offset_to_filename = 0;
-				u32 entry_offset_to_url = 0;
-				u32 entry_offset_to_headers = 0;
-				u32 headers_size = 0;
-	
-				TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-				TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-				TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-				TCHAR creation_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-
-				u8 cache_directory_index = 0;
-
-				TCHAR cached_file_size[MAX_INT_64_CHARS] = T("");
-				TCHAR access_count[MAX_INT_32_CHARS] = T("");
-
-				#define READ_COMMON()\
-				do\
-				{\
-					entry_offset_to_filename = url_entry->entry_offset_to_filename;\
-					entry_offset_to_url = url_entry->entry_offset_to_url;\
-					entry_offset_to_headers = url_entry->entry_offset_to_headers;\
-					headers_size = url_entry->headers_size;\
-					\
-					format_filetime_date_time(url_entry->last_modified_time, last_modified_time);\
-					format_filetime_date_time(url_entry->last_access_time, last_access_time);\
-					format_dos_date_time(url_entry->creation_time, creation_time);\
-					\
-					cache_directory_index = url_entry->cache_directory_index;\
-					\
-					convert_u32_to_string(url_entry->num_entry_locks, access_count);\
-				} while(false, false)
-
-				if(major_version == '4')
-				{
-					Ie_4_Index_Url_Entry* url_entry = (Ie_4_Index_Url_Entry*) advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));
-					_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(url_entry, u64));
-
-					READ_MEMBER(last_modified_time);
-					READ_MEMBER(last_access_time);
-					READ_MEMBER(expiry_time);
-
-					READ_MEMBER(cached_file_size);
-					READ_MEMBER(_reserved_1);
-					READ_MEMBER(_reserved_2);
-					READ_MEMBER(_reserved_3);
-
-					READ_MEMBER(_reserved_4);
-					READ_MEMBER(_reserved_5);
-					READ_MEMBER(entry_offset_to_url);
-
-					READ_MEMBER(cache_directory_index);
-					READ_MEMBER(_reserved_6);
-					READ_MEMBER(_reserved_7);
-					READ_MEMBER(_reserved_8);
-
-					READ_MEMBER(entry_offset_to_filename);
-					READ_MEMBER(cache_flags);
-					READ_MEMBER(entry_offset_to_headers);
-					READ_MEMBER(headers_size);
-					
-					READ_MEMBER(_reserved_9);
-					READ_MEMBER(last_sync_time);
-					READ_MEMBER(num_entry_locks);
-					READ_MEMBER(_reserved_10);
-					
-					READ_MEMBER(creation_time);
-					READ_MEMBER(_reserved_11);
-
-					READ_COMMON();
-
-					format_filetime_date_time(url_entry->expiry_time, expiry_time);
-					convert_u32_to_string(url_entry->cached_file_size, cached_file_size);
-				}
-				else if(major_version == '5')
-				{
-					Ie_5_Index_Url_Entry* url_entry = (Ie_5_Index_Url_Entry*) advance_bytes(entry, sizeof(Ie_4_5_Index_File_Map_Entry));
-					_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(url_entry, u64));
-
-					READ_MEMBER(last_modified_time);
-					READ_MEMBER(last_access_time);
-					READ_MEMBER(expiry_time);
-					READ_MEMBER(_reserved_1);
-
-					READ_MEMBER(low_cached_file_size);
-					READ_MEMBER(high_cached_file_size);
-
-					READ_MEMBER(file_offset_to_group_or_group_list);
-					
-					if(entry->signature == ENTRY_URL) READ_MEMBER(sticky_time_delta);
-					else READ_MEMBER(file_offset_to_next_leak_entry);
-
-					READ_MEMBER(_reserved_3);
-					READ_MEMBER(entry_offset_to_url);
-
-					READ_MEMBER(cache_directory_index);
-					READ_MEMBER(sync_count);
-					READ_MEMBER(format_version);
-					READ_MEMBER(format_version_copy);
-
-					READ_MEMBER(entry_offset_to_filename);
-					READ_MEMBER(cache_flags);
-					READ_MEMBER(entry_offset_to_headers);
-					READ_MEMBER(headers_size);
-					
-					READ_MEMBER(entry_offset_to_file_extension);
-					READ_MEMBER(last_sync_time);
-					READ_MEMBER(num_entry_locks);
-					READ_MEMBER(level_of_entry_lock_nesting);
-					
-					READ_MEMBER(creation_time);
-					READ_MEMBER(_reserved_4);
-					READ_MEMBER(_reserved_5);
-
-					READ_COMMON();
-
-					format_dos_date_time(url_entry->expiry_time, expiry_time);					
-					u64 cached_file_size_value = combine_high_and_low_u32s_into_u64(url_entry->high_cached_file_size, url_entry->low_cached_file_size);
-					convert_u64_to_string(cached_file_size_value, cached_file_size);
-				}
-				else
-				{
-					_ASSERT(false);
-				}
-
-				#undef READ_MEMBER
-				#undef READ_COMMON
-
-				TCHAR* decorated_filename = T("");
-				if(entry_offset_to_filename > 0)
-				{
-					char* filename_in_entry = (char*) advance_bytes(entry, entry_offset_to_filename);
-					decorated_filename = convert_ansi_string_to_tchar(arena, filename_in_entry);
-				}
-
-				TCHAR* url = T("");
-				if(entry_offset_to_url > 0)
-				{
-					char* url_in_entry = (char*) advance_bytes(entry, entry_offset_to_url);
-					url = convert_ansi_string_to_tchar(arena, url_in_entry);
-					url = decode_url(arena, url);
-				}
-
-				Http_Headers headers = {};
-				if(entry_offset_to_headers > 0 && headers_size > 0)
-				{
-					char* headers_in_entry = (char*) advance_bytes(entry, entry_offset_to_headers);
-					parse_http_headers(arena, headers_in_entry, headers_size, &headers);
-				}
-
-				TCHAR* short_location_pointer = NULL;
-				TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
-				TCHAR full_location_on_cache[MAX_PATH_CHARS] = T("");
-
-				const u8 CHANNEL_DEFINITION_FORMAT_INDEX = 0xFF;
-				if(cache_directory_index < IE_4_5_ESE_MAX_NUM_CACHE_DIRECTORIES)
-				{
-					short_location_pointer = short_location_on_cache;
-
-					// Build the short file path by using the cached file's directory and its decorated filename.
-					// E.g. "ABCDEFGH\image[1].gif".
-					// @Format: The cache directory's name doesn't include the null terminator.
-					char* cache_directory_name_in_entry = (char*) header->cache_directories[cache_directory_index].name;
-					char cache_directory_ansi_name[IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS + 1] = "";
-					CopyMemory(cache_directory_ansi_name, cache_directory_name_in_entry, IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS * sizeof(char));
-					cache_directory_ansi_name[IE_4_5_ESE_NUM_CACHE_DIRECTORY_NAME_CHARS] = '\0';
-
-					TCHAR* cache_directory_name = convert_ansi_string_to_tchar(arena, cache_directory_ansi_name);
-					PathCombine(short_location_on_cache, cache_directory_name, decorated_filename);
-
-					// Build the absolute file path to the cache file. The cache directories are next to the index file
-					// in this version of Internet Explorer. Here, exporter->index_path is already a full path.
-					PathCombine(full_location_on_cache, exporter->index_path, T(".."));
-					PathAppend(full_location_on_cache, short_location_on_cache);
-				}
-				else if(cache_directory_index == CHANNEL_DEFINITION_FORMAT_INDEX)
-				{
-					// CDF files are marked with this special string since they're not stored on disk.
-					short_location_pointer = T("<CDF>");
-				}
-				else
-				{
-					// Any other unknown indexes.
-					log_warning("Internet Explorer 4 to 9: Found unknown cache directory index 0x%02X for the file '%s' with the following URL: '%s'.", cache_directory_index, decorated_filename, url);
-					short_location_pointer = T("<?>");
-				}
-
-				// @Alias: 'short_location_pointer' may alias 'short_location_on_cache'.
-				TCHAR* format_version_prefix = (major_version == '5') ? (T("Content.IE5")) : (T(""));
-				PathCombine(short_location_on_cache, format_version_prefix, short_location_pointer);
-
-				if(found_deallocated_member)
-				{
-					add_exporter_warning_message(exporter, "Cleared one or more deallocated fields with the value 0x%08X (%I32u) to zero.", IE_4_5_DEALLOCATED_VALUE, IE_4_5_DEALLOCATED_VALUE);
-					log_warning("Internet Explorer 4 to 9: The entry starting in block %I32u with %I32u blocks allocated and the signature 0x%08X contained one or more garbage values (0x%08X). The filename is '%s' and the URL is '%s'.", block_count, entry->num_allocated_blocks, entry->signature, IE_4_5_DEALLOCATED_VALUE, decorated_filename, url);
-				}
-
-				Csv_Entry csv_row[] =
-				{
-					{/* Filename */}, {/* URL */}, {/* File Extension */}, {cached_file_size},
-					{last_modified_time}, {creation_time}, {/* Last Write Time */}, {last_access_time}, {expiry_time}, {access_count},
-					{/* Response */}, {/* Server */}, {/* Cache Control */}, {/* Pragma */},
-					{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
-					{/* Decompressed File Size */}, {/* Location On Cache */}, {cache_version},
-					{/* Missing File */}, {/* Location In Output */}, {/* Copy Error */}, {/* Exporter Warning */},
-					{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
-				};
-				_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
-
-				Exporter_Params params = {};
-				params.copy_source_path = full_location_on_cache;
-				params.url = url;
-				params.filename = NULL; // Comes from the URL.
-				params.headers = headers;
-				params.short_location_on_cache = short_location_on_cache;
-
-				export_cache_entry(exporter, csv_row, &params);
+				export_internet_explorer_4_to_9_url_entry(exporter, header, entry, major_version, cache_version, block_count);
 
 				if(entry->signature == ENTRY_URL)
 				{
@@ -1076,6 +1858,12 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 		}
 	}
 
+	if(exporter->recover_ie_entries)
+	{
+		recover_internet_explorer_4_to_9_entries(	exporter, index_handle, header, allocation_bitmap, total_num_blocks,
+													block_buffer, block_buffer_size, major_version);
+	}
+
 	unlock_arena(arena);
 
 	if(total_bytes_read < index_file_size)
@@ -1576,6 +2364,12 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 			return;
 		}
 
+		if(exporter->use_ie_url_lookup)
+		{
+			log_info("Internet Explorer 10 to 11: Skipping the ESE database file '%ls' since URL lookups are only supported for index.dat files.", index_filename);
+			return;
+		}
+
 		if(!exporter->was_temporary_exporter_directory_created)
 		{
 			log_error("Internet Explorer 10 to 11: The temporary exporter directory used to recover the ESE database's contents was not previously created.");
@@ -1987,7 +2781,19 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 									}
 								}
 
-								// Handle the retrieved values.
+								Http_Headers cache_headers = {};
+								parse_http_headers(arena, headers, headers_size, &cache_headers);
+
+								Filterable_Cache_Entry entry_to_filter = {};
+								entry_to_filter.url = url;
+								entry_to_filter.content_type = cache_headers.content_type;
+								entry_to_filter.has_size = (file_size >= 0);
+								entry_to_filter.size = (u64) file_size;
+								u64 last_modified_filetime = combine_high_and_low_u32s_into_u64(last_modified_time_value.dwHighDateTime, last_modified_time_value.dwLowDateTime);
+								entry_to_filter.last_modified_time = convert_filetime_to_time64_t(last_modified_filetime);
+
+								// Handle the retrieved values if the entry passes the -filter-entries option.
+								if(cache_entry_passes_filter(exporter, &entry_to_filter))
 								{
 									wchar_t* decorated_filename = push_string_to_arena(arena, filename);
 									undecorate_path(filename);
@@ -2009,9 +2815,6 @@ static void export_internet_explorer_4_to_9_cache(Exporter* exporter)
 									wchar_t expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = L"";
 									format_filetime_date_time(expiry_time_value, expiry_time);
 
-									Http_Headers cache_headers = {};
-									parse_http_headers(arena, headers, headers_size, &cache_headers);
-
 									wchar_t access_count_string[MAX_INT_32_CHARS] = L"";
 									convert_u32_to_string(access_count, access_count_string);
 
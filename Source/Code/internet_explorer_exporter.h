@@ -4,6 +4,9 @@
 bool find_internet_explorer_version(TCHAR* ie_version, u32 ie_version_size);
 void export_default_or_specific_internet_explorer_cache(Exporter* exporter);
 
+size_t get_internet_explorer_url_lookup_file_size(Exporter* exporter, int* result_num_urls);
+void load_internet_explorer_url_lookup_file(Exporter* exporter, int num_urls);
+
 // These functions are only meant to be used in the Windows 2000 through 10 builds. In the Windows 98 and ME builds, attempting
 // to call these functions will result in a compile time error.
 // If we want to use them, we have to explicitly wrap the code with #ifndef WCE_9X [...] #endif.
@@ -91,6 +91,7 @@
 	--> Used to decompiled some Java classes to get a better understanding of how the cache works.
 */
 
+// The last columns are only added to the CSV file when listing each archive's members (the -list-java-archives option).
 static Csv_Type CSV_COLUMN_TYPES[] =
 {
 	CSV_FILENAME, CSV_URL, CSV_FILE_EXTENSION, CSV_FILE_SIZE,
@@ -98,10 +99,40 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 	CSV_RESPONSE, CSV_SERVER, CSV_CACHE_CONTROL, CSV_PRAGMA, CSV_CONTENT_TYPE, CSV_CONTENT_LENGTH, CSV_CONTENT_RANGE, CSV_CONTENT_ENCODING,
 	CSV_CODEBASE_IP, CSV_VERSION,
 	CSV_DECOMPRESSED_FILE_SIZE, CSV_LOCATION_ON_CACHE, CSV_CACHE_VERSION, CSV_MISSING_FILE, CSV_LOCATION_IN_OUTPUT, CSV_COPY_ERROR,
-	CSV_CUSTOM_FILE_GROUP, CSV_CUSTOM_URL_GROUP, CSV_SHA_256
+	CSV_CUSTOM_FILE_GROUP, CSV_CUSTOM_URL_GROUP, CSV_SHA_256,
+	CSV_MAIN_CLASS, CSV_APPLICATION_NAME
 };
 
 static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
+static const int CSV_NUM_ARCHIVE_COLUMNS = 2;
+
+// The columns of the separate CSV file that lists the members of each cached archive. The location on cache matches the one in the
+// main CSV file and identifies the cache entry.
+static Csv_Type ARCHIVE_CSV_COLUMN_TYPES[] =
+{
+	CSV_LOCATION_ON_CACHE, CSV_MEMBER_NAME, CSV_COMPRESSED_SIZE, CSV_UNCOMPRESSED_SIZE, CSV_CRC_32, CSV_COMPRESSION_METHOD
+};
+
+static const int ARCHIVE_CSV_NUM_COLUMNS = _countof(ARCHIVE_CSV_COLUMN_TYPES);
+
+// The separate CSV file that lists the members of each cached archive. See: print_java_archive_members().
+struct Java_Archive_Csv
+{
+	HANDLE file_handle;
+	TCHAR file_path[MAX_PATH_CHARS];
+	bool listed_at_least_one_member;
+};
+
+// The parameters passed to the callbacks that export the Java Plugin's cache.
+struct Java_Directory_Listing;
+struct Java_Traversal_Params
+{
+	Exporter* exporter;
+	// The archive CSV file, or NULL if the archives' members shouldn't be listed.
+	Java_Archive_Csv* archive_csv;
+	// Only used by find_java_index_files_callback().
+	Java_Directory_Listing* listing;
+};
 
 // Entry point for the Java Plugin's cache exporter. This function will determine where to look for the cache before
 // processing its contents.
@@ -112,13 +143,41 @@ static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 //
 // @Returns: Nothing.
 static TRAVERSE_DIRECTORY_CALLBACK(find_java_applet_store_files_callback);
-static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback);
+static void export_java_index_files(Java_Traversal_Params* params);
 void export_default_or_specific_java_cache(Exporter* exporter)
 {
 	console_print("Exporting the Java Plugin's cache...");
 
-	initialize_cache_exporter(exporter, CACHE_JAVA, CSV_COLUMN_TYPES, CSV_NUM_COLUMNS);
+	// The rows always have every column, but the last ones are ignored if they weren't added to the CSV file.
+	int num_columns = (exporter->list_java_archive_members) ? (CSV_NUM_COLUMNS) : (CSV_NUM_COLUMNS - CSV_NUM_ARCHIVE_COLUMNS);
+	initialize_cache_exporter(exporter, CACHE_JAVA, CSV_COLUMN_TYPES, num_columns);
 	{
+		Java_Traversal_Params params = {};
+		params.exporter = exporter;
+
+		Java_Archive_Csv archive_csv = {};
+		archive_csv.file_handle = INVALID_HANDLE_VALUE;
+
+		if(exporter->create_csvs && exporter->list_java_archive_members)
+		{
+			// E.g. "JV.csv" and "JV_Archive_Members.csv".
+			StringCchCopy(archive_csv.file_path, MAX_PATH_CHARS, exporter->output_copy_path);
+			StringCchCat(archive_csv.file_path, MAX_PATH_CHARS, T("_Archive_Members.csv"));
+
+			if(create_csv_file(archive_csv.file_path, &(archive_csv.file_handle)))
+			{
+				++(exporter->total_csv_files_created);
+				csv_print_header(&(exporter->temporary_arena), archive_csv.file_handle, ARCHIVE_CSV_COLUMN_TYPES, ARCHIVE_CSV_NUM_COLUMNS);
+				clear_arena(&(exporter->temporary_arena));
+				params.archive_csv = &archive_csv;
+			}
+			else
+			{
+				log_error("Java Plugin: Failed to create the archive CSV file '%s'.", archive_csv.file_path);
+				++(exporter->total_export_errors);
+			}
+		}
+
 		TCHAR* java_appdata_path = NULL;
 		if(exporter->is_exporting_from_default_locations)
 		{
@@ -131,7 +190,7 @@ void export_default_or_specific_java_cache(Exporter* exporter)
 
 		log_info("Java Plugin: Exporting the cache from '%s'.", exporter->cache_path);
 		
-		traverse_directory_objects(exporter->cache_path, T("*.idx"), TRAVERSE_FILES, true, find_java_index_files_callback, exporter);
+		export_java_index_files(&params);
 		
 		if(exporter->is_exporting_from_default_locations)
 		{
@@ -141,18 +200,25 @@ void export_default_or_specific_java_cache(Exporter* exporter)
 			// For Java 1.4 and later (distributed by IBM).
 			PathCombine(exporter->cache_path, java_appdata_path, T("IBM\\Java\\Deployment\\cache"));
 			log_info("Java Plugin: Exporting the IBM Java cache from '%s'.", exporter->cache_path);
-			traverse_directory_objects(exporter->cache_path, T("*.idx"), TRAVERSE_FILES, true, find_java_index_files_callback, exporter);
+			export_java_index_files(&params);
 
 			// For Java 1.4.
 			PathCombine(exporter->cache_path, java_user_home_path, T(".jpi_cache"));
 			log_info("Java Plugin: Exporting the .jpi_cache from '%s'.", exporter->cache_path);
-			traverse_directory_objects(exporter->cache_path, T("*.idx"), TRAVERSE_FILES, true, find_java_index_files_callback, exporter);
+			export_java_index_files(&params);
 
 			// For Java 1.3.
 			PathCombine(exporter->cache_path, java_user_home_path, T("java_plugin_AppletStore"));
 			log_info("Java Plugin: Exporting the AppletStore cache from '%s'.", exporter->cache_path);
 			set_exporter_output_copy_subdirectory(exporter, T("AppletStore"));
-			traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_java_applet_store_files_callback, exporter);
+			traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_java_applet_store_files_callback, &params);
+		}
+
+		safe_close_handle(&(archive_csv.file_handle));
+		if(params.archive_csv != NULL && !archive_csv.listed_at_least_one_member)
+		{
+			log_info("Java Plugin: Deleting the archive CSV file '%s' since no archive members were listed.", archive_csv.file_path);
+			DeleteFile(archive_csv.file_path);
 		}
 
 		log_info("Java Plugin: Finished exporting the cache.");
@@ -165,6 +231,7 @@ void export_default_or_specific_java_cache(Exporter* exporter)
 // @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
 //
 // @Returns: True.
+static void export_java_cache_entry(Java_Traversal_Params* traversal_params, Csv_Entry* csv_row, Exporter_Params* params);
 static TRAVERSE_DIRECTORY_CALLBACK(find_java_applet_store_files_callback)
 {
 	TCHAR* full_location_on_cache = callback_info->object_path;
@@ -179,18 +246,23 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_java_applet_store_files_callback)
 		{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
 		{/* Codebase IP */}, {/* Version */},
 		{/* Decompressed File Size */}, {/* Location On Cache */}, {cache_version}, {/* Missing File */}, {/* Location In Output */}, {/* Copy Error */},
-		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
+		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */},
+		{/* Main Class */}, {/* Application Name */}
 	};
 	_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
 
-	Exporter* exporter = (Exporter*) callback_info->user_data;
+	Java_Traversal_Params* traversal_params = (Java_Traversal_Params*) callback_info->user_data;
+
+	// These files don't store any metadata, so they only pass the -filter-entries option if it's empty.
+	Filterable_Cache_Entry entry_to_filter = {};
+	if(!cache_entry_passes_filter(traversal_params->exporter, &entry_to_filter)) return true;
 
 	Exporter_Params params = {};
 	params.copy_source_path = full_location_on_cache;
 	params.short_location_on_cache = short_location_on_cache;
 	params.file_info = callback_info;
 
-	export_cache_entry(exporter, csv_row, &params);
+	export_java_cache_entry(traversal_params, csv_row, &params);
 
 	return true;
 }
@@ -292,9 +364,9 @@ struct Java_Index
 	s32 reduced_manifest_2_length;
 	s8 is_proxied_host;
 
+	// The namespace ID string is skipped since it's not exported.
 	TCHAR* version;
 	TCHAR* url;
-	TCHAR* namespace_id;
 	TCHAR* codebase_ip;
 
 	// The content length string in this struct is used for the Content Length CSV column if it exists.
@@ -323,42 +395,137 @@ static TCHAR* get_cached_file_extension_from_java_file_type(s32 type)
 	}
 }
 
-// Finds the first file that begins with a given prefix in a given directory. This search does not include any subdirectories.
+// A sorted list of the filenames in a cache directory, excluding any index files. This is used to find the cached files in version 1
+// without searching the same directory for every index file.
+struct Java_Directory_Listing
+{
+	TCHAR directory_path[MAX_PATH_CHARS];
+	bool is_loaded;
+
+	int num_filenames;
+	TCHAR** filenames; // Sorted alphabetically (case insensitive).
+};
+
+// Called by qsort() to sort the filenames in a directory listing alphabetically (case insensitive).
+static int compare_java_filenames(const void* filename_pointer_1, const void* filename_pointer_2)
+{
+	TCHAR* filename_1 = *((TCHAR**) filename_pointer_1);
+	TCHAR* filename_2 = *((TCHAR**) filename_pointer_2);
+	return _tcsicmp(filename_1, filename_2);
+}
+
+// Lists the files in a cache directory once so that any cached filename in it can be found with find_cached_filename_that_starts_with().
+// The previous listing is discarded if it belongs to a different directory. This listing is stored in the temporary arena, which
+// is locked afterwards so that exporting each cache entry doesn't clear it. The arena must have been locked once before the
+// traversal so that discarding a listing doesn't clear anything else. See: unload_java_directory_listing().
 //
 // @Parameters:
-// 1. arena - The Arena structure that will receive the string and any intermediate values.
-// 2. directory_path - The path of the directory to search.
-// 3. filename_prefix - The filename prefix to search for.
-// 4. result_filename - The resulting filename or NULL if the file wasn't found.
-// 
-// @Returns: True if the file was found. Otherwise, false.
-static bool find_cached_filename_that_starts_with(Arena* arena, const TCHAR* directory_path, const TCHAR* filename_prefix, TCHAR** result_filename)
+// 1. arena - The Arena structure that receives the listing.
+// 2. directory_path - The path of the directory to list. This search does not include any subdirectories.
+// 3. listing - The Java_Directory_Listing structure that receives the sorted filenames.
+//
+// @Returns: Nothing.
+static void unload_java_directory_listing(Arena* arena, Java_Directory_Listing* listing);
+static void load_java_directory_listing(Arena* arena, const TCHAR* directory_path, Java_Directory_Listing* listing)
 {
-	*result_filename = NULL;
+	if(listing->is_loaded && strings_are_equal(listing->directory_path, directory_path)) return;
 
-	TCHAR search_query[MAX_PATH_CHARS] = T("");
-	StringCchCopy(search_query, MAX_PATH_CHARS, filename_prefix);
-	StringCchCat(search_query, MAX_PATH_CHARS, ALL_OBJECTS_SEARCH_QUERY);
+	unload_java_directory_listing(arena, listing);
 
-	Traversal_Result* files = find_objects_in_directory(arena, directory_path, search_query, TRAVERSE_FILES, false);
+	Traversal_Result* files = find_objects_in_directory(arena, directory_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, false);
+	TCHAR** filenames = push_array_to_arena(arena, MAX(files->num_objects, 1), TCHAR*);
+	int num_filenames = 0;
 
-	bool was_found = false;
 	for(int i = 0; i < files->num_objects; ++i)
 	{
-		Traversal_Object_Info file_info = files->object_info[i];
-		TCHAR* filename = file_info.object_name;		
-
+		TCHAR* filename = files->object_info[i].object_name;
 		if(!filename_ends_with(filename, T(".idx")))
 		{
-			was_found = true;
-			*result_filename = filename;
-			break;
+			filenames[num_filenames] = filename;
+			++num_filenames;
 		}
 	}
 
+	qsort(filenames, num_filenames, sizeof(TCHAR*), compare_java_filenames);
+
+	StringCchCopy(listing->directory_path, MAX_PATH_CHARS, directory_path);
+	listing->is_loaded = true;
+	listing->num_filenames = num_filenames;
+	listing->filenames = filenames;
+
+	lock_arena(arena);
+}
+
+// Discards a directory listing created by load_java_directory_listing() and clears the memory it used.
+//
+// @Parameters:
+// 1. arena - The Arena structure that contains the listing.
+// 2. listing - The Java_Directory_Listing structure to discard.
+//
+// @Returns: Nothing.
+static void unload_java_directory_listing(Arena* arena, Java_Directory_Listing* listing)
+{
+	if(listing->is_loaded)
+	{
+		unlock_arena(arena);
+		ZeroMemory(listing, sizeof(Java_Directory_Listing));
+	}
+
+	clear_arena(arena);
+}
+
+// Finds the first file that begins with a given prefix in a directory listing. Since the filenames are sorted, every match is
+// stored contiguously after the position where the prefix would be inserted.
+//
+// @Parameters:
+// 1. listing - The directory listing to search.
+// 2. filename_prefix - The filename prefix to search for.
+// 3. result_filename - The resulting filename or NULL if the file wasn't found.
+// 
+// @Returns: True if the file was found. Otherwise, false.
+static bool find_cached_filename_that_starts_with(Java_Directory_Listing* listing, const TCHAR* filename_prefix, TCHAR** result_filename)
+{
+	*result_filename = NULL;
+
+	int low = 0;
+	int high = listing->num_filenames;
+
+	while(low < high)
+	{
+		int middle = low + (high - low) / 2;
+		if(_tcsicmp(listing->filenames[middle], filename_prefix) < 0) low = middle + 1;
+		else high = middle;
+	}
+
+	bool was_found = (low < listing->num_filenames) && filename_begins_with(listing->filenames[low], filename_prefix);
+	if(was_found) *result_filename = listing->filenames[low];
+
 	return was_found;
 }
 
+// Exports every cache entry in the current cache path by finding its index files. Any subdirectories are also searched.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how the cache should be exported.
+//
+// @Returns: Nothing.
+static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback);
+static void export_java_index_files(Java_Traversal_Params* params)
+{
+	Exporter* exporter = params->exporter;
+	Arena* arena = &(exporter->temporary_arena);
+
+	Java_Directory_Listing listing = {};
+	params->listing = &listing;
+
+	lock_arena(arena);
+	traverse_directory_objects(exporter->cache_path, T("*.idx"), TRAVERSE_FILES, true, find_java_index_files_callback, params);
+	unload_java_directory_listing(arena, &listing);
+	unlock_arena(arena);
+
+	params->listing = NULL;
+}
+
 // Called every time an index file is found in the Java Plugin's cache. Used to export every cache entry.
 //
 // @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
@@ -367,7 +534,8 @@ static bool find_cached_filename_that_starts_with(Arena* arena, const TCHAR* dir
 static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* index, Java_Location_Type location_type);
 static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback)
 {
-	Exporter* exporter = (Exporter*) callback_info->user_data;
+	Java_Traversal_Params* traversal_params = (Java_Traversal_Params*) callback_info->user_data;
+	Exporter* exporter = traversal_params->exporter;
 	Arena* arena = &(exporter->temporary_arena);
 
 	// Find out what kind of cache location we're in by looking at the directory's name:
@@ -391,10 +559,28 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback)
 		location_type = LOCATION_ARCHIVES;
 	}
 
+	// The cached filenames in version 1 may have to be found on disk. Since the index files in the same directory are visited
+	// one after the other, we'll list each directory only once.
+	if(location_type != LOCATION_ALL)
+	{
+		load_java_directory_listing(arena, callback_info->directory_path, traversal_params->listing);
+	}
+
 	TCHAR* index_filename = callback_info->object_name;
 	Java_Index index = {};
 	read_index_file(arena, callback_info->object_path, &index, location_type);
 
+	// @Format: A content length of zero means that it wasn't stored in the index file.
+	Filterable_Cache_Entry entry_to_filter = {};
+	entry_to_filter.url = index.url;
+	entry_to_filter.content_type = index.headers.content_type;
+	entry_to_filter.has_size = (index.content_length > 0);
+	entry_to_filter.size = (u64) index.content_length;
+	entry_to_filter.last_modified_time = index.last_modified_time / 1000;
+
+	// The directory listing was locked in the arena when it was loaded, so it's not cleared if this entry is skipped.
+	if(!cache_entry_passes_filter(exporter, &entry_to_filter)) return true;
+
 	// @Docs: According to Java's URL class description: "The URL class does not itself encode or decode
 	// any URL components according to the escaping mechanism defined in RFC2396." - java.net.URL - Java
 	// API Specification. We'll decode it anyways though it's technically possible that the final URL's
@@ -492,7 +678,7 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback)
 				// If that fails, take the time to search on disk for the actual filename.
 				// This applies to the version 1 cache directories that still exist in version 6.
 				TCHAR* actual_filename = NULL;
-				if(find_cached_filename_that_starts_with(arena, callback_info->directory_path, cached_filename, &actual_filename))
+				if(traversal_params->listing->is_loaded && find_cached_filename_that_starts_with(traversal_params->listing, cached_filename, &actual_filename))
 				{
 					StringCchCopy(cached_filename, MAX_PATH_CHARS, actual_filename);
 				}
@@ -525,7 +711,8 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback)
 		{/* Content Type */}, {content_length}, {/* Content Range */}, {/* Content Encoding */},
 		{index.codebase_ip}, {index.version},
 		{/* Decompressed File Size */}, {/* Location On Cache */}, {cache_version}, {/* Missing File */}, {/* Location In Output */}, {/* Copy Error */},
-		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
+		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */},
+		{/* Main Class */}, {/* Application Name */}
 	};
 	_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
 	
@@ -537,7 +724,7 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_java_index_files_callback)
 	params.short_location_on_cache = short_location_on_cache;
 	params.file_info = callback_info;
 
-	export_cache_entry(exporter, csv_row, &params);
+	export_java_cache_entry(traversal_params, csv_row, &params);
 
 	return true;
 }
@@ -558,6 +745,41 @@ static TCHAR* convert_modified_utf_8_string_to_tchar(Arena* arena, const char* m
 {
 	if(utf_length == 0) return NULL;
 
+	// Most strings (URLs, versions, and HTTP headers) only contain ASCII characters, which use a single byte in modified UTF-8.
+	// We'll check four bytes at a time for any with the highest bit set and copy these strings directly. Any other characters
+	// (including the two byte null character and surrogate pairs) are handled by the general case below.
+	bool is_ascii = true;
+	u16 num_checked_bytes = 0;
+
+	for(; num_checked_bytes + sizeof(u32) <= utf_length; num_checked_bytes += sizeof(u32))
+	{
+		u32 group = 0;
+		CopyMemory(&group, modified_utf_8_string + num_checked_bytes, sizeof(group));
+		if( (group & 0x80808080) != 0 )
+		{
+			is_ascii = false;
+			break;
+		}
+	}
+
+	for(; is_ascii && num_checked_bytes < utf_length; ++num_checked_bytes)
+	{
+		if( (modified_utf_8_string[num_checked_bytes] & 0x80) != 0 ) is_ascii = false;
+	}
+
+	if(is_ascii)
+	{
+		// ASCII characters have the same value in UTF-16 and in any ANSI code page.
+		TCHAR* ascii_string = push_array_to_arena(arena, utf_length + 1, TCHAR);
+		for(u16 i = 0; i < utf_length; ++i)
+		{
+			ascii_string[i] = (TCHAR) modified_utf_8_string[i];
+		}
+		ascii_string[utf_length] = T('\0');
+
+		return ascii_string;
+	}
+
 	// This UTF-16 string will be the same length or smaller than the modified UTF-8 one. In the worst memory case, all character
 	// groups are represented by one byte, meaning the UTF length matches the actual string length.
 	wchar_t* utf_16_string = push_array_to_arena(arena, utf_length + 1, wchar_t);
@@ -590,13 +812,13 @@ static TCHAR* convert_modified_utf_8_string_to_tchar(Arena* arena, const char* m
 				}
 				else
 				{
-					log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%hs'. The second byte (0x%08X) does not match the pattern.", modified_utf_8_string, b);
+					log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%.*hs'. The second byte (0x%08X) does not match the pattern.", utf_length, modified_utf_8_string, b);
 					return NULL;
 				}
 			}
 			else
 			{
-				log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%hs'. Missing the second byte in the group.", modified_utf_8_string);
+				log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%.*hs'. Missing the second byte in the group.", utf_length, modified_utf_8_string);
 				return NULL;
 			}
 		}
@@ -617,19 +839,19 @@ static TCHAR* convert_modified_utf_8_string_to_tchar(Arena* arena, const char* m
 				}
 				else
 				{
-					log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%hs'. The second (0x%08X) or third byte (0x%08X) does not match the pattern.", modified_utf_8_string, b, c);
+					log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%.*hs'. The second (0x%08X) or third byte (0x%08X) does not match the pattern.", utf_length, modified_utf_8_string, b, c);
 					return NULL;
 				}
 			}
 			else
 			{
-				log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%hs'. Missing the second or third byte in the group.", modified_utf_8_string);
+				log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%.*hs'. Missing the second or third byte in the group.", utf_length, modified_utf_8_string);
 				return NULL;
 			}
 		}
 		else
 		{
-			log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%hs'. The first byte (0x%08X) does not match any pattern.", modified_utf_8_string, a);
+			log_error("Convert Modified Utf-8 String To Tchar: Error while parsing the string '%.*hs'. The first byte (0x%08X) does not match any pattern.", utf_length, modified_utf_8_string, a);
 			return NULL;
 		}
 
@@ -645,7 +867,21 @@ static TCHAR* convert_modified_utf_8_string_to_tchar(Arena* arena, const char* m
 	#endif
 }
 
-// Reads any of the supported index file formats and fills an Java_Index structure with any relevant information.
+// Checks if a modified UTF-8 string is equal to an ASCII one. This comparison is case insensitive.
+//
+// @Parameters:
+// 1. modified_utf_8_string - The modified UTF-8 string. This string is not null terminated.
+// 2. utf_length - The size of the modified UTF-8 string in bytes.
+// 3. ascii_string - The null terminated ASCII string.
+//
+// @Returns: True if the strings are equal. Otherwise, false.
+static bool modified_utf_8_string_is_equal_to_ascii(const char* modified_utf_8_string, u16 utf_length, const char* ascii_string)
+{
+	return (string_length(ascii_string) == utf_length) && (_strnicmp(modified_utf_8_string, ascii_string, utf_length) == 0);
+}
+
+// Reads any of the supported index file formats and fills an Java_Index structure with any relevant information. The index file
+// is mapped into memory and parsed in place, meaning only the strings that are exported are converted and copied to the arena.
 //
 // @Parameters:
 // 1. arena - The Arena structure where any read string values are stored.
@@ -658,15 +894,19 @@ static TCHAR* convert_modified_utf_8_string_to_tchar(Arena* arena, const char* m
 // @Returns: Nothing.
 static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* index, Java_Location_Type location_type)
 {
+	HANDLE index_handle = create_handle(index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
 	u64 file_size = 0;
-	void* file = read_entire_file(arena, index_path, &file_size);
+	void* mapped_file = memory_map_entire_file(index_handle, &file_size);
 	
-	if(file == NULL)
+	if(mapped_file == NULL)
 	{
-		log_error("Read Java Index File: Failed to read the index file.");
+		log_error("Read Java Index File: Failed to map the index file '%s' into memory.", index_path);
+		safe_close_handle(&index_handle);
 		return;
 	}
 
+	void* file = mapped_file;
+
 	/*
 		Primitive Types in Java:
 		- byte 	= 1 byte (signed) 		= s8
@@ -711,82 +951,122 @@ static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* i
 		remaining_file_size -= sizeof(variable);\
 	} while(false, false)
 
-	// Helper macro function used to read a string that was encoded using modified UTF-8 from
-	// the current file position. This emulates the behavior of the readUTF() function from
-	// java.io.DataInput, where first processes the string's size and then its contents. The
-	// variable passed to this macro must be a TCHAR string.
-	#define READ_STRING(variable)\
+	// Helper macro function used to find a string that was encoded using modified UTF-8 at the
+	// current file position without converting it. This emulates the behavior of the readUTF()
+	// function from java.io.DataInput, where first processes the string's size and then its
+	// contents. The variables passed to this macro receive the string's address in the mapped
+	// file (which is not null terminated) and its size in bytes.
+	#define READ_STRING_VIEW(string_variable, utf_length_variable)\
 	do\
 	{\
+		string_variable = NULL;\
+		utf_length_variable = 0;\
+		\
 		u16 utf_length = 0;\
 		READ_INTEGER(utf_length);\
 		\
-		char* modified_utf_8_string = (char*) file;\
-		variable = convert_modified_utf_8_string_to_tchar(arena, modified_utf_8_string, utf_length);\
-		file = advance_bytes(file, utf_length);\
+		if(remaining_file_size < utf_length) reached_end_of_file = true;\
+		if(reached_end_of_file) break;\
 		\
+		string_variable = (const char*) file;\
+		utf_length_variable = utf_length;\
+		\
+		file = advance_bytes(file, utf_length);\
 		remaining_file_size -= utf_length;\
 	} while(false, false)
 
+	// Helper macro function used to read a string that was encoded using modified UTF-8 from
+	// the current file position. The variable passed to this macro must be a TCHAR string.
+	#define READ_STRING(variable)\
+	do\
+	{\
+		const char* modified_utf_8_string = NULL;\
+		u16 utf_length = 0;\
+		READ_STRING_VIEW(modified_utf_8_string, utf_length);\
+		variable = convert_modified_utf_8_string_to_tchar(arena, modified_utf_8_string, utf_length);\
+	} while(false, false)
+
+	// Helper macro function used to skip a string that was encoded using modified UTF-8 at the
+	// current file position. Used for the values that aren't exported.
+	#define SKIP_STRING()\
+	do\
+	{\
+		const char* modified_utf_8_string = NULL;\
+		u16 utf_length = 0;\
+		READ_STRING_VIEW(modified_utf_8_string, utf_length);\
+	} while(false, false)
+
 	// Helper macro function used to read multiple HTTP header values as modified UTF-8 strings.
 	// This emulates the behavior of the readHeaders() type of functions from the Java code that
-	// handles the cache. The variable passed to this macro specifies the key name used to retrieve
-	// the value of the 'codebase_ip' member from the headers map. This parameter may be NULL if
-	// the Codebase IP value is found elsewhere.
+	// handles the cache. The variable passed to this macro specifies the key name (an ASCII string)
+	// used to retrieve the value of the 'codebase_ip' member from the headers map. This parameter
+	// may be NULL if the Codebase IP value is found elsewhere. The keys are compared in place and
+	// only the values that are exported are converted.
 	#define READ_HEADERS(codebase_ip_key)\
 	do\
 	{\
 		s32 num_headers = 0;\
 		READ_INTEGER(num_headers);\
 		\
-		for(s32 i = 0; i < num_headers; ++i)\
+		for(s32 i = 0; i < num_headers && !reached_end_of_file; ++i)\
 		{\
-			TCHAR* key = NULL;\
-			TCHAR* value = NULL;\
-			READ_STRING(key);\
-			READ_STRING(value);\
+			const char* key = NULL;\
+			u16 key_length = 0;\
+			READ_STRING_VIEW(key, key_length);\
+			\
+			const char* value = NULL;\
+			u16 value_length = 0;\
+			READ_STRING_VIEW(value, value_length);\
 			\
 			if(key == NULL || value == NULL) continue;\
 			\
+			TCHAR** header_value = NULL;\
+			\
 			/* Disable the constant expression and logical operation on string literal warnings. */\
 			__pragma(warning(push))\
 			__pragma(warning(disable : 4127 4130))\
-			if(codebase_ip_key != NULL && strings_are_equal(key, codebase_ip_key, true))\
+			if(codebase_ip_key != NULL && modified_utf_8_string_is_equal_to_ascii(key, key_length, codebase_ip_key))\
 			__pragma(warning(pop))\
 			{\
-				index->codebase_ip = value;\
+				header_value = &(index->codebase_ip);\
+			}\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "<null>"))\
+			{\
+				header_value = &(index->headers.response);\
 			}\
-			else if(strings_are_equal(key, T("<null>"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "server"))\
 			{\
-				index->headers.response = value;\
+				header_value = &(index->headers.server);\
 			}\
-			else if(strings_are_equal(key, T("server"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "cache-control"))\
 			{\
-				index->headers.server = value;\
+				header_value = &(index->headers.cache_control);\
 			}\
-			else if(strings_are_equal(key, T("cache-control"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "pragma"))\
 			{\
-				index->headers.cache_control = value;\
+				header_value = &(index->headers.pragma);\
 			}\
-			else if(strings_are_equal(key, T("pragma"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "content-type"))\
 			{\
-				index->headers.pragma = value;\
+				header_value = &(index->headers.content_type);\
 			}\
-			else if(strings_are_equal(key, T("content-type"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "content-length"))\
 			{\
-				index->headers.content_type = value;\
+				header_value = &(index->headers.content_length);\
 			}\
-			else if(strings_are_equal(key, T("content-length"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "content-range"))\
 			{\
-				index->headers.content_length = value;\
+				header_value = &(index->headers.content_range);\
 			}\
-			else if(strings_are_equal(key, T("content-range"), true))\
+			else if(modified_utf_8_string_is_equal_to_ascii(key, key_length, "content-encoding"))\
 			{\
-				index->headers.content_range = value;\
+				header_value = &(index->headers.content_encoding);\
 			}\
-			else if(strings_are_equal(key, T("content-encoding"), true))\
+			\
+			if(header_value != NULL)\
 			{\
-				index->headers.content_encoding = value;\
+				TCHAR* converted_value = convert_modified_utf_8_string_to_tchar(arena, value, value_length);\
+				if(converted_value != NULL) *header_value = converted_value;\
 			}\
 		}\
 	} while(false, false)
@@ -809,7 +1089,7 @@ static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* i
 		{\
 			READ_STRING(index->version);\
 			READ_STRING(index->url);\
-			READ_STRING(index->namespace_id);\
+			SKIP_STRING(); /* Namespace ID */\
 			READ_STRING(index->codebase_ip);\
 			\
 			READ_HEADERS(NULL);\
@@ -843,7 +1123,7 @@ static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* i
 
 		if(location_type == LOCATION_FILES)
 		{
-			READ_HEADERS(T("plugin_resource_codebase_ip"));
+			READ_HEADERS("plugin_resource_codebase_ip");
 		}
 		else if(location_type == LOCATION_ARCHIVES)
 		{
@@ -957,9 +1237,9 @@ static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* i
 
 				READ_STRING(index->version);
 				READ_STRING(index->url);
-				READ_STRING(index->namespace_id);
+				SKIP_STRING(); // Namespace ID
 
-				READ_HEADERS(T("deploy_resource_codebase_ip"));
+				READ_HEADERS("deploy_resource_codebase_ip");
 
 			} break;
 
@@ -972,9 +1252,527 @@ static void read_index_file(Arena* arena, const TCHAR* index_path, Java_Index* i
 
 	#undef SKIP_BYTES
 	#undef READ_INTEGER
+	#undef READ_STRING_VIEW
 	#undef READ_STRING
+	#undef SKIP_STRING
 	#undef READ_HEADERS
 	#undef READ_SECTION_2
+
+	safe_unmap_view_of_file(&mapped_file);
+	safe_close_handle(&index_handle);
+}
+
+// @FormatVersion: ZIP archives without the ZIP64 extensions (.jar, .jarjar, and .zip files).
+// @ByteOrder: Little Endian.
+// @CharacterEncoding: IBM Code Page 437 or UTF-8 (depending on a flag) for the member names, and UTF-8 for the manifest file.
+// @Docs: "APPNOTE.TXT - .ZIP File Format Specification" - https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+// @Docs: "JAR File Specification" - https://docs.oracle.com/javase/8/docs/technotes/guides/jar/jar.html
+
+static const u32 ZIP_LOCAL_FILE_HEADER_SIGNATURE = 0x04034B50; // "PK\x03\x04"
+static const u32 ZIP_CENTRAL_DIRECTORY_FILE_HEADER_SIGNATURE = 0x02014B50; // "PK\x01\x02"
+static const u32 ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054B50; // "PK\x05\x06"
+
+static const u16 ZIP_FLAG_ENCRYPTED = 0x0001;
+static const u16 ZIP_FLAG_UTF_8 = 0x0800;
+
+static const u16 ZIP_METHOD_STORED = 0;
+static const u16 ZIP_METHOD_DEFLATED = 8;
+
+static const u32 ZIP_IBM_CODE_PAGE_437 = 437;
+
+static const char* JAVA_MANIFEST_PATH = "META-INF/MANIFEST.MF";
+// The main attributes are at the beginning of the manifest file, meaning we only need to decompress the first bytes of
+// signed archives, whose manifests list the digests of every member.
+static const u32 MAX_JAVA_MANIFEST_SIZE = 64 * 1024;
+
+#pragma pack(push, 1)
+
+struct Zip_Local_File_Header
+{
+	u32 signature;
+	u16 version_needed_to_extract;
+	u16 flags;
+	u16 compression_method;
+	u16 last_modified_time;
+	u16 last_modified_date;
+	u32 crc_32;
+	u32 compressed_size;
+	u32 uncompressed_size;
+	u16 filename_size;
+	u16 extra_field_size;
+};
+
+struct Zip_Central_Directory_File_Header
+{
+	u32 signature;
+	u16 version_made_by;
+	u16 version_needed_to_extract;
+	u16 flags;
+	u16 compression_method;
+	u16 last_modified_time;
+	u16 last_modified_date;
+	u32 crc_32;
+	u32 compressed_size;
+	u32 uncompressed_size;
+	u16 filename_size;
+	u16 extra_field_size;
+	u16 comment_size;
+	u16 disk_number_start;
+	u16 internal_file_attributes;
+	u32 external_file_attributes;
+	u32 local_header_offset;
+};
+
+struct Zip_End_Of_Central_Directory
+{
+	u32 signature;
+	u16 disk_number;
+	u16 central_directory_disk_number;
+	u16 num_disk_entries;
+	u16 num_total_entries;
+	u32 central_directory_size;
+	u32 central_directory_offset;
+	u16 comment_size;
+};
+
+#pragma pack(pop)
+
+_STATIC_ASSERT(sizeof(Zip_Local_File_Header) == 30);
+_STATIC_ASSERT(sizeof(Zip_Central_Directory_File_Header) == 46);
+_STATIC_ASSERT(sizeof(Zip_End_Of_Central_Directory) == 22);
+
+// The maximum size of the end of central directory record, including the archive's comment.
+static const u32 MAX_ZIP_END_OF_CENTRAL_DIRECTORY_SIZE = sizeof(Zip_End_Of_Central_Directory) + 0xFFFF;
+
+// A member of a cached archive, as listed in its central directory.
+struct Java_Archive_Member
+{
+	TCHAR* name;
+	u32 compressed_size;
+	u32 uncompressed_size;
+	u32 crc_32;
+	u16 compression_method;
+};
+
+// The members of a cached archive and the main attributes from its manifest file.
+struct Java_Archive
+{
+	int num_members;
+	Java_Archive_Member* members;
+
+	TCHAR* main_class;
+	TCHAR* application_name;
+};
+
+// Retrieves the value of a given attribute from the main section of a JAR manifest file.
+//
+// @Parameters:
+// 1. arena - The Arena structure that will receive the converted TCHAR value.
+// 2. main_section - The main section of the manifest file, where each attribute is on a separate line and any continuation lines
+// were already joined.
+// 3. name - The attribute's name. This comparison is case insensitive.
+//
+// @Returns: The attribute's value, or NULL if it doesn't exist.
+static TCHAR* get_java_manifest_attribute(Arena* arena, const char* main_section, const char* name)
+{
+	size_t name_size = string_length(name);
+
+	const char* line = main_section;
+	while(*line != '\0')
+	{
+		const char* line_end = strchr(line, '\n');
+		if(line_end == NULL) line_end = line + string_length(line);
+
+		// @Format: "name: value", where the name is case insensitive.
+		if( (size_t) (line_end - line) > name_size && _strnicmp(line, name, name_size) == 0 && line[name_size] == ':')
+		{
+			const char* value = line + name_size + 1;
+			if(*value == ' ') ++value;
+
+			size_t value_size = (size_t) (line_end - value);
+			char* utf_8_value = push_array_to_arena(arena, value_size + 1, char);
+			CopyMemory(utf_8_value, value, value_size);
+			utf_8_value[value_size] = '\0';
+
+			return convert_utf_8_string_to_tchar(arena, utf_8_value);
+		}
+
+		line = (*line_end == '\n') ? (line_end + 1) : (line_end);
+	}
+
+	return NULL;
+}
+
+// Reads the main section of a JAR manifest file and retrieves the attributes that are shown in the CSV file.
+//
+// @Parameters:
+// 1. arena - The Arena structure that will receive the manifest file and the attribute values.
+// 2. archive_handle - The handle to the archive.
+// 3. manifest_header - The manifest's file header in the central directory.
+// 4. archive - The Java_Archive structure that receives the attribute values.
+//
+// @Returns: Nothing.
+static void read_java_archive_manifest(Arena* arena, HANDLE archive_handle, Zip_Central_Directory_File_Header* manifest_header, Java_Archive* archive)
+{
+	if( (manifest_header->flags & ZIP_FLAG_ENCRYPTED) != 0 )
+	{
+		log_warning("Read Java Archive Manifest: Skipping the encrypted manifest file.");
+		return;
+	}
+
+	if(manifest_header->compression_method != ZIP_METHOD_STORED && manifest_header->compression_method != ZIP_METHOD_DEFLATED)
+	{
+		log_warning("Read Java Archive Manifest: Skipping the manifest file with the unsupported compression method %hu.", manifest_header->compression_method);
+		return;
+	}
+
+	Zip_Local_File_Header local_header = {};
+	if(!read_file_chunk(archive_handle, &local_header, sizeof(local_header), manifest_header->local_header_offset)
+		|| local_header.signature != ZIP_LOCAL_FILE_HEADER_SIGNATURE)
+	{
+		log_error("Read Java Archive Manifest: Failed to find the local file header at the offset %I32u.", manifest_header->local_header_offset);
+		return;
+	}
+
+	// @Format: The sizes in the local header may be zero if they were written after the data, so we'll use the ones in the central directory.
+	u64 data_offset = (u64) manifest_header->local_header_offset + sizeof(local_header) + local_header.filename_size + local_header.extra_field_size;
+	u32 compressed_size = MIN(manifest_header->compressed_size, MAX_JAVA_MANIFEST_SIZE);
+	if(compressed_size == 0) return;
+
+	char* compressed_data = push_array_to_arena(arena, compressed_size, char);
+	u32 num_compressed_bytes = 0;
+	if(!read_file_chunk(archive_handle, compressed_data, compressed_size, data_offset, true, &num_compressed_bytes))
+	{
+		log_error("Read Java Archive Manifest: Failed to read %I32u bytes from the manifest file at the offset %I64u.", compressed_size, data_offset);
+		return;
+	}
+
+	char* manifest = NULL;
+	u32 manifest_size = 0;
+
+	if(manifest_header->compression_method == ZIP_METHOD_DEFLATED)
+	{
+		manifest = push_array_to_arena(arena, MAX_JAVA_MANIFEST_SIZE, char);
+		int error_code = 0;
+		if(!decompress_deflate_buffer(arena, compressed_data, num_compressed_bytes, manifest, MAX_JAVA_MANIFEST_SIZE, &manifest_size, &error_code))
+		{
+			log_error("Read Java Archive Manifest: Failed to decompress the manifest file with the error %d.", error_code);
+			return;
+		}
+	}
+	else
+	{
+		manifest = compressed_data;
+		manifest_size = num_compressed_bytes;
+	}
+
+	// @Format: The main section ends with an empty line, and each line ends with CR LF, LF, or CR. Lines may be at most 72 bytes
+	// long, meaning longer values continue on the next line, which begins with a single space. We'll join these continuation
+	// lines and separate the attributes with LF.
+	char* main_section = push_array_to_arena(arena, manifest_size + 1, char);
+	u32 main_section_size = 0;
+
+	u32 line_begin = 0;
+	while(line_begin < manifest_size)
+	{
+		u32 line_end = line_begin;
+		while(line_end < manifest_size && manifest[line_end] != '\r' && manifest[line_end] != '\n') ++line_end;
+
+		u32 next_line_begin = line_end;
+		if(next_line_begin < manifest_size && manifest[next_line_begin] == '\r') ++next_line_begin;
+		if(next_line_begin < manifest_size && manifest[next_line_begin] == '\n') ++next_line_begin;
+
+		if(line_end == line_begin) break;
+
+		u32 copy_begin = line_begin;
+		if(manifest[line_begin] == ' ')
+		{
+			copy_begin += 1;
+		}
+		else if(main_section_size > 0)
+		{
+			main_section[main_section_size] = '\n';
+			main_section_size += 1;
+		}
+
+		CopyMemory(main_section + main_section_size, manifest + copy_begin, line_end - copy_begin);
+		main_section_size += line_end - copy_begin;
+
+		line_begin = next_line_begin;
+	}
+
+	main_section[main_section_size] = '\0';
+
+	archive->main_class = get_java_manifest_attribute(arena, main_section, "Main-Class");
+	archive->application_name = get_java_manifest_attribute(arena, main_section, "Application-Name");
+}
+
+// Reads the central directory of a cached Java archive without decompressing its members. The only exception is the manifest file,
+// whose main attributes are also retrieved. Since this function is called for every cached file, it returns early if the file
+// doesn't start with a ZIP signature.
+//
+// @Parameters:
+// 1. arena - The Arena structure that will receive the central directory and the member information.
+// 2. archive_path - The path to the cached file.
+// 3. archive - The Java_Archive structure that receives the member information.
+//
+// @Returns: True if the file is a ZIP archive whose central directory was read. Otherwise, false.
+static bool read_java_archive(Arena* arena, const TCHAR* archive_path, Java_Archive* archive)
+{
+	HANDLE archive_handle = create_handle(archive_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL);
+	if(archive_handle == INVALID_HANDLE_VALUE) return false;
+
+	bool success = false;
+
+	u64 file_size = 0;
+	u32 signature = 0;
+	if(!get_file_size(archive_handle, &file_size) || file_size < sizeof(Zip_End_Of_Central_Directory)
+		|| !read_file_chunk(archive_handle, &signature, sizeof(signature), 0) || signature != ZIP_LOCAL_FILE_HEADER_SIGNATURE)
+	{
+		goto clean_up;
+	}
+
+	{
+		// The end of central directory record is at the end of the file, followed by a comment of up to 64 KB. We'll read this
+		// range once and search it backwards for a record whose comment ends exactly at the end of the file.
+		u32 tail_size = (u32) MIN(file_size, (u64) MAX_ZIP_END_OF_CENTRAL_DIRECTORY_SIZE);
+		u64 tail_offset = file_size - tail_size;
+		u8* tail = push_array_to_arena(arena, tail_size, u8);
+		if(!read_file_chunk(archive_handle, tail, tail_size, tail_offset))
+		{
+			log_error("Read Java Archive: Failed to read the last %I32u bytes of the archive '%s'.", tail_size, archive_path);
+			goto clean_up;
+		}
+
+		Zip_End_Of_Central_Directory end_record = {};
+		u64 end_record_offset = 0;
+		bool found_end_record = false;
+
+		for(u32 i = tail_size - (u32) sizeof(end_record) + 1; i > 0; --i)
+		{
+			u32 record_offset = i - 1;
+			CopyMemory(&end_record, tail + record_offset, sizeof(end_record));
+			if(end_record.signature == ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE
+				&& record_offset + sizeof(end_record) + end_record.comment_size == tail_size)
+			{
+				end_record_offset = tail_offset + record_offset;
+				found_end_record = true;
+				break;
+			}
+		}
+
+		if(!found_end_record)
+		{
+			log_warning("Read Java Archive: Could not find the end of central directory record in the archive '%s'.", archive_path);
+			goto clean_up;
+		}
+
+		if(end_record.num_total_entries == 0xFFFF || end_record.central_directory_offset == 0xFFFFFFFF)
+		{
+			log_warning("Read Java Archive: Skipping the archive '%s' since it uses the unsupported ZIP64 format.", archive_path);
+			goto clean_up;
+		}
+
+		if( (u64) end_record.central_directory_offset + end_record.central_directory_size > end_record_offset)
+		{
+			log_error("Read Java Archive: The central directory (offset = %I32u, size = %I32u) goes past its end record (offset = %I64u) in the archive '%s'.",
+						end_record.central_directory_offset, end_record.central_directory_size, end_record_offset, archive_path);
+			goto clean_up;
+		}
+
+		// Reuse the tail if it already contains the whole central directory.
+		u32 central_directory_size = end_record.central_directory_size;
+		u8* central_directory = NULL;
+		if(end_record.central_directory_offset >= tail_offset)
+		{
+			central_directory = tail + (end_record.central_directory_offset - tail_offset);
+		}
+		else
+		{
+			central_directory = push_array_to_arena(arena, central_directory_size, u8);
+			if(!read_file_chunk(archive_handle, central_directory, central_directory_size, end_record.central_directory_offset))
+			{
+				log_error("Read Java Archive: Failed to read the central directory (offset = %I32u, size = %I32u) in the archive '%s'.",
+							end_record.central_directory_offset, central_directory_size, archive_path);
+				goto clean_up;
+			}
+		}
+
+		archive->members = push_array_to_arena(arena, MAX(end_record.num_total_entries, 1), Java_Archive_Member);
+		archive->num_members = 0;
+
+		Zip_Central_Directory_File_Header manifest_header = {};
+		bool found_manifest = false;
+
+		u32 header_offset = 0;
+		for(u16 i = 0; i < end_record.num_total_entries; ++i)
+		{
+			Zip_Central_Directory_File_Header header = {};
+			if(header_offset + sizeof(header) > central_directory_size) break;
+			CopyMemory(&header, central_directory + header_offset, sizeof(header));
+
+			const char* filename = (char*) (central_directory + header_offset + sizeof(header));
+			u32 header_size = (u32) sizeof(header) + header.filename_size + header.extra_field_size + header.comment_size;
+
+			if(header.signature != ZIP_CENTRAL_DIRECTORY_FILE_HEADER_SIGNATURE || header_offset + header_size > central_directory_size)
+			{
+				log_warning("Read Java Archive: Found an invalid central directory file header at the offset %I32u after %d members in the archive '%s'.",
+							header_offset, archive->num_members, archive_path);
+				break;
+			}
+
+			char* null_terminated_filename = push_array_to_arena(arena, header.filename_size + 1, char);
+			CopyMemory(null_terminated_filename, filename, header.filename_size);
+			null_terminated_filename[header.filename_size] = '\0';
+
+			Java_Archive_Member* member = &(archive->members[archive->num_members]);
+			if( (header.flags & ZIP_FLAG_UTF_8) != 0 )
+			{
+				member->name = convert_utf_8_string_to_tchar(arena, null_terminated_filename);
+			}
+			else
+			{
+				member->name = convert_code_page_string_to_tchar(arena, ZIP_IBM_CODE_PAGE_437, null_terminated_filename);
+			}
+
+			member->compressed_size = header.compressed_size;
+			member->uncompressed_size = header.uncompressed_size;
+			member->crc_32 = header.crc_32;
+			member->compression_method = header.compression_method;
+			archive->num_members += 1;
+
+			if(!found_manifest && header.filename_size == string_length(JAVA_MANIFEST_PATH)
+				&& _strnicmp(filename, JAVA_MANIFEST_PATH, header.filename_size) == 0)
+			{
+				manifest_header = header;
+				found_manifest = true;
+			}
+
+			header_offset += header_size;
+		}
+
+		if(found_manifest)
+		{
+			read_java_archive_manifest(arena, archive_handle, &manifest_header, archive);
+		}
+
+		success = true;
+	}
+
+	clean_up:;
+	safe_close_handle(&archive_handle);
+	return success;
+}
+
+// Writes one row per member of a cached Java archive to the archive CSV file.
+//
+// @Parameters:
+// 1. arena - The Arena structure where any intermediary strings are stored.
+// 2. archive_csv - The Java_Archive_Csv structure that contains the CSV file's handle.
+// 3. location_on_cache - The location of the archive, which is shown in the main CSV file.
+// 4. archive - The Java_Archive structure that contains the member information.
+//
+// @Returns: Nothing.
+static void print_java_archive_members(Arena* arena, Java_Archive_Csv* archive_csv, TCHAR* location_on_cache, Java_Archive* archive)
+{
+	for(int i = 0; i < archive->num_members; ++i)
+	{
+		Java_Archive_Member* member = &(archive->members[i]);
+
+		TCHAR compressed_size[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(member->compressed_size, compressed_size);
+
+		TCHAR uncompressed_size[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(member->uncompressed_size, uncompressed_size);
+
+		TCHAR crc_32[MAX_INT_32_CHARS] = T("");
+		StringCchPrintf(crc_32, MAX_INT_32_CHARS, T("%08I32X"), member->crc_32);
+
+		TCHAR* compression_method = NULL;
+		TCHAR compression_method_buffer[MAX_INT_16_CHARS] = T("");
+		switch(member->compression_method)
+		{
+			case(ZIP_METHOD_STORED): 	compression_method = T("Stored"); break;
+			case(ZIP_METHOD_DEFLATED): 	compression_method = T("Deflated"); break;
+			default:
+			{
+				convert_u32_to_string(member->compression_method, compression_method_buffer);
+				compression_method = compression_method_buffer;
+			} break;
+		}
+
+		Csv_Entry csv_row[] =
+		{
+			{location_on_cache}, {member->name}, {compressed_size}, {uncompressed_size}, {crc_32}, {compression_method}
+		};
+		_STATIC_ASSERT(_countof(csv_row) == ARCHIVE_CSV_NUM_COLUMNS);
+
+		lock_arena(arena);
+		csv_print_row(arena, archive_csv->file_handle, csv_row, ARCHIVE_CSV_NUM_COLUMNS);
+		clear_arena(arena);
+		unlock_arena(arena);
+	}
+
+	if(archive->num_members > 0) archive_csv->listed_at_least_one_member = true;
+}
+
+// Exports a Java Plugin cache entry. If the archive CSV file exists and the cached file is a ZIP archive, this function also fills the
+// manifest columns and lists the archive's members, as long as the entry itself was exported.
+//
+// @Parameters:
+// 1. traversal_params - The Java_Traversal_Params structure that contains the exporter and the archive CSV file.
+// 2. csv_row - The CSV column values for the main CSV file. See: export_cache_entry().
+// 3. params - The exporter parameters for this entry. See: export_cache_entry().
+//
+// @Returns: Nothing.
+static void export_java_cache_entry(Java_Traversal_Params* traversal_params, Csv_Entry* csv_row, Exporter_Params* params)
+{
+	Exporter* exporter = traversal_params->exporter;
+	Java_Archive_Csv* archive_csv = traversal_params->archive_csv;
+
+	if(archive_csv == NULL)
+	{
+		export_cache_entry(exporter, csv_row, params);
+		return;
+	}
+
+	Arena* arena = &(exporter->temporary_arena);
+
+	Java_Archive archive = {};
+	bool is_archive = read_java_archive(arena, params->copy_source_path, &archive);
+
+	// Keep the archive's members in memory since export_cache_entry() clears the temporary arena back to its last lock.
+	lock_arena(arena);
+
+	for(int i = 0; i < CSV_NUM_COLUMNS; ++i)
+	{
+		switch(CSV_COLUMN_TYPES[i])
+		{
+			case(CSV_MAIN_CLASS):
+			{
+				csv_row[i].value = archive.main_class;
+			} break;
+
+			case(CSV_APPLICATION_NAME):
+			{
+				csv_row[i].value = archive.application_name;
+			} break;
+		}
+	}
+
+	export_cache_entry(exporter, csv_row, params);
+
+	if(is_archive && exporter->was_last_entry_exported)
+	{
+		TCHAR* location_on_cache = (exporter->show_full_paths) ? (params->copy_source_path) : (params->short_location_on_cache);
+		print_java_archive_members(arena, archive_csv, location_on_cache, &archive);
+	}
+
+	clear_arena(arena);
+	unlock_arena(arena);
+
+	// Free the archive's members.
+	clear_arena(arena);
 }
 
 /*
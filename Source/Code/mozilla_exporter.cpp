@@ -92,7 +92,7 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 	CSV_FILENAME, CSV_URL, CSV_REQUEST_ORIGIN, CSV_FILE_EXTENSION, CSV_FILE_SIZE,
 	CSV_LAST_MODIFIED_TIME, CSV_LAST_ACCESS_TIME, CSV_EXPIRY_TIME, CSV_ACCESS_COUNT,
 	CSV_RESPONSE, CSV_SERVER, CSV_CACHE_CONTROL, CSV_PRAGMA, CSV_CONTENT_TYPE, CSV_CONTENT_LENGTH, CSV_CONTENT_RANGE, CSV_CONTENT_ENCODING, 
-	CSV_DECOMPRESSED_FILE_SIZE, CSV_LOCATION_ON_CACHE, CSV_CACHE_ORIGIN, CSV_CACHE_VERSION,
+	CSV_DECOMPRESSED_FILE_SIZE, CSV_LOCATION_ON_CACHE, CSV_CACHE_ORIGIN, CSV_CACHE_VERSION, CSV_INTEGRITY, CSV_FRECENCY,
 	CSV_MISSING_FILE, CSV_LOCATION_IN_OUTPUT, CSV_COPY_ERROR, CSV_EXPORTER_WARNING,
 	CSV_CUSTOM_FILE_GROUP, CSV_CUSTOM_URL_GROUP, CSV_SHA_256
 };
@@ -360,6 +360,76 @@ void export_default_or_specific_mozilla_cache(Exporter* exporter)
 	log_info("Mozilla Cache Exporter: Finished exporting the cache.");
 }
 
+// Computes the hash function used by both Mozilla cache formats. In version 1, it's applied to each entry's key to determine
+// the hash number in the map records (and therefore the names of any external files). In version 2, it's used to check the
+// integrity of the metadata and of each chunk in the cached file. This is Bob Jenkins' lookup2 hash function with an initial
+// value of zero.
+//
+// @Parameters:
+// 1. data - The data to hash.
+// 2. data_size - The size of the data in bytes.
+//
+// @Returns: The 32-bit hash value. The chunk hashes only use the lower 16 bits of this value.
+static u32 get_mozilla_cache_hash(const void* data, u32 data_size)
+{
+	// @Format: nsDiskCache::Hash() in https://hg.mozilla.org/mozilla-central/file/2d6becec52a482ad114c633cf3a0a5aa2909263b/netwerk/cache/nsDiskCache.cpp
+	// and CacheHash::Hash() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheHash.cpp
+	#define HASH_MIX(a, b, c)\
+	do\
+	{\
+		a -= b; a -= c; a ^= (c >> 13);\
+		b -= c; b -= a; b ^= (a << 8);\
+		c -= a; c -= b; c ^= (b >> 13);\
+		a -= b; a -= c; a ^= (c >> 12);\
+		b -= c; b -= a; b ^= (a << 16);\
+		c -= a; c -= b; c ^= (b >> 5);\
+		a -= b; a -= c; a ^= (c >> 3);\
+		b -= c; b -= a; b ^= (a << 10);\
+		c -= a; c -= b; c ^= (b >> 15);\
+	} while(false, false)
+
+	const u8* k = (const u8*) data;
+	u32 a = 0x9E3779B9;
+	u32 b = 0x9E3779B9;
+	u32 c = 0;
+	u32 remaining_size = data_size;
+
+	while(remaining_size >= 12)
+	{
+		a += k[0] + ((u32) k[1] << 8) + ((u32) k[2] << 16) + ((u32) k[3] << 24);
+		b += k[4] + ((u32) k[5] << 8) + ((u32) k[6] << 16) + ((u32) k[7] << 24);
+		c += k[8] + ((u32) k[9] << 8) + ((u32) k[10] << 16) + ((u32) k[11] << 24);
+		HASH_MIX(a, b, c);
+
+		k += 12;
+		remaining_size -= 12;
+	}
+
+	c += data_size;
+
+	// The lowest byte of c is reserved for the size.
+	switch(remaining_size)
+	{
+		case(11): c += ((u32) k[10] << 24); // Intentional fallthrough.
+		case(10): c += ((u32) k[9] << 16); // Intentional fallthrough.
+		case(9): c += ((u32) k[8] << 8); // Intentional fallthrough.
+		case(8): b += ((u32) k[7] << 24); // Intentional fallthrough.
+		case(7): b += ((u32) k[6] << 16); // Intentional fallthrough.
+		case(6): b += ((u32) k[5] << 8); // Intentional fallthrough.
+		case(5): b += k[4]; // Intentional fallthrough.
+		case(4): a += ((u32) k[3] << 24); // Intentional fallthrough.
+		case(3): a += ((u32) k[2] << 16); // Intentional fallthrough.
+		case(2): a += ((u32) k[1] << 8); // Intentional fallthrough.
+		case(1): a += k[0];
+	}
+
+	HASH_MIX(a, b, c);
+
+	#undef HASH_MIX
+
+	return c;
+}
+
 // @FormatVersion: Mozilla 0.9.5 to Firefox 31 (Cache\_CACHE_MAP_).
 // @ByteOrder: Big Endian.
 // @CharacterEncoding: ASCII.
@@ -466,6 +536,99 @@ _STATIC_ASSERT(sizeof(Mozilla_1_Map_Header_Version_6_To_19) == 276);
 _STATIC_ASSERT(sizeof(Mozilla_1_Map_Record) == 16);
 _STATIC_ASSERT(sizeof(Mozilla_1_Metadata_Entry) == 36);
 
+// The maximum number of blocks used by each record's data or metadata, and the number of block files (_CACHE_001_ to _CACHE_003_).
+static const u32 MZ1_MAX_NUM_BLOCKS_PER_RECORD = 4;
+static const u32 MZ1_MAX_NUM_BLOCK_FILES = 3;
+static const size_t MZ1_MAX_BLOCK_FILENAME_CHARS = 12;
+
+// A block file that is mapped into memory while the cache is being exported.
+struct Mozilla_1_Block_File
+{
+	TCHAR filename[MZ1_MAX_BLOCK_FILENAME_CHARS];
+	TCHAR file_path[MAX_PATH_CHARS];
+	HANDLE file_handle;
+
+	void* mapped_file; // NULL if the file could not be mapped.
+	u64 file_size;
+
+	u32 header_size; // Bitmap.
+	u32 block_size;
+	u32 max_entry_size;
+
+	// Used to find the blocks that aren't referenced by any map record when recovering entries.
+	u32 num_blocks;
+	u8* referenced_blocks; // One bit per block. NULL if we're not recovering entries.
+};
+
+// A map record whose values were converted to the host's byte order, along with its position in the map file.
+struct Mozilla_1_Sorted_Record
+{
+	Mozilla_1_Map_Record record;
+	u32 index;
+};
+
+// Called by qsort() to sort the map records by their hashes. Since these determine the names and directories of any external
+// files, this groups the reads from the same directory together.
+static int compare_mozilla_1_sorted_records(const void* record_pointer_1, const void* record_pointer_2)
+{
+	const Mozilla_1_Sorted_Record* record_1 = (const Mozilla_1_Sorted_Record*) record_pointer_1;
+	const Mozilla_1_Sorted_Record* record_2 = (const Mozilla_1_Sorted_Record*) record_pointer_2;
+
+	if(record_1->record.hash_number != record_2->record.hash_number)
+	{
+		return (record_1->record.hash_number < record_2->record.hash_number) ? (-1) : (1);
+	}
+
+	return (record_1->index < record_2->index) ? (-1) : ( (record_1->index > record_2->index) ? (1) : (0) );
+}
+
+// Retrieves a range of blocks from a block file that was mapped into memory.
+//
+// @Parameters:
+// 1. block_file - The Mozilla_1_Block_File structure that contains the mapped file.
+// 2. first_block - The number of the first block.
+// 3. num_blocks - The number of blocks.
+// 4. result_offset - The resulting offset of the first block in the file.
+// 5. result_size - The resulting size of the range in bytes. This value is smaller than the size of every requested block if the
+// range goes past the end of the file.
+//
+// @Returns: The address of the first block in the mapped file. Otherwise, NULL if the file wasn't mapped or if the range starts
+// past the end of the file.
+static void* get_mozilla_cache_version_1_blocks(Mozilla_1_Block_File* block_file, u32 first_block, u32 num_blocks,
+												u32* result_offset, u32* result_size)
+{
+	*result_offset = 0;
+	*result_size = 0;
+
+	u64 offset = block_file->header_size + (u64) first_block * block_file->block_size;
+	if(block_file->mapped_file == NULL || offset >= block_file->file_size) return NULL;
+
+	u64 size = MIN((u64) num_blocks * block_file->block_size, block_file->file_size - offset);
+
+	*result_offset = (u32) offset;
+	*result_size = (u32) size;
+	return advance_bytes(block_file->mapped_file, *result_offset);
+}
+
+// Marks a range of blocks in a block file as being referenced by a map record. Used to find the blocks that may contain any
+// entries that can be recovered.
+//
+// @Parameters:
+// 1. block_file - The Mozilla_1_Block_File structure whose blocks will be marked.
+// 2. first_block - The number of the first block.
+// 3. num_blocks - The number of blocks.
+//
+// @Returns: Nothing.
+static void mark_mozilla_cache_version_1_blocks(Mozilla_1_Block_File* block_file, u32 first_block, u32 num_blocks)
+{
+	if(block_file->referenced_blocks == NULL) return;
+
+	for(u32 i = first_block; i < first_block + num_blocks && i < block_file->num_blocks; ++i)
+	{
+		block_file->referenced_blocks[i / CHAR_BIT] |= (u8) (1 << (i % CHAR_BIT));
+	}
+}
+
 // Retrieves any HTTP headers and request origin information from the elements structure used by the Mozilla cache file format.
 // This structure maps keys to values, both of which are null terminated ASCII strings that are stored contiguously.
 //
@@ -500,6 +663,288 @@ static void parse_mozilla_cache_elements(	Arena* arena, void* elements, u32 elem
 	}
 }
 
+// Called every time an external data file is found for an entry that was recovered from a block file. Used to find the first one.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: False, to stop searching.
+static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_1_data_file_callback)
+{
+	TCHAR* result_path = (TCHAR*) callback_info->user_data;
+	StringCchCopy(result_path, MAX_PATH_CHARS, callback_info->object_path);
+	return false;
+}
+
+// Exports any entries whose metadata still exists in the blocks that aren't referenced by any map record. When an entry is evicted,
+// Mozilla only clears its bits in the block file's allocation bitmap and removes its map record, meaning its metadata may remain
+// intact until those blocks are reused. These entries are exported with the "Recovered" cache version.
+//
+// Since the metadata always starts at the beginning of a block, we only need to check each unreferenced block once. A candidate is
+// accepted if its version matches the map file's, if its metadata location points back to itself, if none of its blocks are
+// referenced by a map record, and if its key and elements are null terminated inside those blocks. Fully referenced regions are
+// skipped eight blocks at a time. The block files were mapped into memory, so this process is mostly bound by the disk speed.
+//
+// The location of the cached file is not stored in the metadata. If the data was stored in an external file, we'll look for it
+// using the hash of the entry's key. Otherwise, only the metadata is exported.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how the Mozilla cache should be exported.
+// 2. block_file_array - The block files, where the first element is unused.
+// 3. major_version - The map file's major version.
+// 4. minor_version - The map file's minor version.
+// 5. is_version_1_19_or_later - Whether external files are stored in subdirectories.
+//
+// @Returns: Nothing.
+static void recover_mozilla_cache_version_1_entries(Exporter* exporter, Mozilla_1_Block_File* block_file_array,
+													u16 major_version, u16 minor_version, bool is_version_1_19_or_later)
+{
+	Arena* arena = &(exporter->temporary_arena);
+	TCHAR* cache_version = T("Recovered");
+
+	#define IS_BLOCK_REFERENCED(block) ( (block_file->referenced_blocks[(block) / CHAR_BIT] & (1 << ((block) % CHAR_BIT))) != 0 )
+
+	int num_recovered_entries = 0;
+	int num_recovered_allocated_entries = 0;
+	int num_recovered_data_files = 0;
+	int num_rejected_entries = 0;
+	int num_filtered_entries = 0;
+
+	for(u32 selector = 1; selector <= MZ1_MAX_NUM_BLOCK_FILES; ++selector)
+	{
+		Mozilla_1_Block_File* block_file = &block_file_array[selector];
+		if(block_file->mapped_file == NULL || block_file->referenced_blocks == NULL) continue;
+
+		// @Format: The allocation bitmap is stored as big endian 32-bit words, where each bit represents a block.
+		// See nsDiskCacheBlockFile::Open() in https://hg.mozilla.org/mozilla-central/file/2d6becec52a482ad114c633cf3a0a5aa2909263b/netwerk/cache/nsDiskCacheBlockFile.cpp
+		const u32* allocation_bitmap = (const u32*) block_file->mapped_file;
+		u32 num_bitmap_words = (u32) MIN((u64) block_file->header_size, block_file->file_size) / sizeof(u32);
+
+		u32 block = 0;
+		while(block < block_file->num_blocks)
+		{
+			if(block % CHAR_BIT == 0 && block + CHAR_BIT <= block_file->num_blocks && block_file->referenced_blocks[block / CHAR_BIT] == 0xFF)
+			{
+				block += CHAR_BIT;
+				continue;
+			}
+
+			if(IS_BLOCK_REFERENCED(block))
+			{
+				++block;
+				continue;
+			}
+
+			u32 offset_in_block_file = 0;
+			u32 available_size = 0;
+			void* metadata_in_file = get_mozilla_cache_version_1_blocks(block_file, block, MZ1_MAX_NUM_BLOCKS_PER_RECORD, &offset_in_block_file, &available_size);
+
+			if(metadata_in_file == NULL || available_size < sizeof(Mozilla_1_Metadata_Entry))
+			{
+				++block;
+				continue;
+			}
+
+			Mozilla_1_Metadata_Entry metadata = {};
+			CopyMemory(&metadata, metadata_in_file, sizeof(metadata));
+			BIG_ENDIAN_TO_HOST(metadata.header_major_version);
+			BIG_ENDIAN_TO_HOST(metadata.header_minor_version);
+
+			if(metadata.header_major_version != major_version || metadata.header_minor_version != minor_version)
+			{
+				++block;
+				continue;
+			}
+
+			BIG_ENDIAN_TO_HOST(metadata.meta_location);
+			BIG_ENDIAN_TO_HOST(metadata.access_count);
+
+			BIG_ENDIAN_TO_HOST(metadata.last_access_time);
+			BIG_ENDIAN_TO_HOST(metadata.last_modified_time);
+			BIG_ENDIAN_TO_HOST(metadata.expiry_time);
+			BIG_ENDIAN_TO_HOST(metadata.data_size);
+
+			BIG_ENDIAN_TO_HOST(metadata.key_size);
+			BIG_ENDIAN_TO_HOST(metadata.elements_size);
+
+			u32 metadata_selector = (metadata.meta_location & MZ1_LOCATION_SELECTOR_MASK) >> MZ1_LOCATION_SELECTOR_OFFSET;
+			u32 metadata_first_block = (metadata.meta_location & MZ1_BLOCK_NUMBER_MASK);
+			u32 metadata_num_blocks = ((metadata.meta_location & MZ1_EXTRA_BLOCKS_MASK) >> MZ1_EXTRA_BLOCKS_OFFSET) + 1;
+			u32 metadata_size = metadata_num_blocks * block_file->block_size;
+
+			bool is_plausible = ( (metadata.meta_location & MZ1_LOCATION_INITIALIZED_MASK) != 0 )
+								&& (metadata_selector == selector) && (metadata_first_block == block)
+								&& (metadata_size <= available_size);
+
+			// Every block in a recovered entry must be unreferenced. Otherwise, part of it was likely overwritten by a newer entry.
+			for(u32 i = 1; i < metadata_num_blocks && is_plausible; ++i)
+			{
+				if(IS_BLOCK_REFERENCED(block + i)) is_plausible = false;
+			}
+
+			char* key_in_metadata = (char*) advance_bytes(metadata_in_file, sizeof(Mozilla_1_Metadata_Entry));
+			char* elements = NULL;
+
+			if(is_plausible)
+			{
+				u32 remaining_metadata_size = metadata_size - (u32) sizeof(Mozilla_1_Metadata_Entry);
+
+				is_plausible = (metadata.key_size > 1) && (metadata.key_size <= remaining_metadata_size)
+								&& (key_in_metadata[metadata.key_size - 1] == '\0')
+								&& (string_length(key_in_metadata) == metadata.key_size - 1);
+
+				if(is_plausible)
+				{
+					remaining_metadata_size -= metadata.key_size;
+					elements = (char*) advance_bytes(key_in_metadata, metadata.key_size);
+
+					is_plausible = (metadata.elements_size <= remaining_metadata_size)
+									&& (metadata.elements_size == 0 || elements[metadata.elements_size - 1] == '\0');
+				}
+			}
+
+			if(!is_plausible)
+			{
+				++num_rejected_entries;
+				++block;
+				continue;
+			}
+
+			// Check if these blocks were still marked as allocated. This happens when the map record was lost but the block
+			// file wasn't updated (e.g. if the browser crashed).
+			u32 bitmap_word_index = block / 32;
+			if(bitmap_word_index < num_bitmap_words)
+			{
+				u32 bitmap_word = allocation_bitmap[bitmap_word_index];
+				BIG_ENDIAN_TO_HOST(bitmap_word);
+				if( (bitmap_word & ((u32) 1 << (block % 32))) != 0 ) ++num_recovered_allocated_entries;
+			}
+
+			// @Format: See the key's format in export_mozilla_cache_version_1().
+			TCHAR* url = NULL;
+			TCHAR* key = convert_ansi_string_to_tchar(arena, key_in_metadata);
+			String_Array<TCHAR>* split_key = split_string(arena, key, T(":"), 1);
+
+			if(split_key->num_strings == 2)
+			{
+				url = split_key->strings[1];
+			}
+
+			TCHAR* request_origin = NULL;
+			Http_Headers headers = {};
+
+			if(metadata.elements_size > 0)
+			{
+				parse_mozilla_cache_elements(arena, elements, metadata.elements_size, &headers, &request_origin);
+			}
+
+			Filterable_Cache_Entry entry_to_filter = {};
+			entry_to_filter.url = url;
+			entry_to_filter.content_type = headers.content_type;
+			entry_to_filter.has_size = true;
+			entry_to_filter.size = metadata.data_size;
+			entry_to_filter.last_modified_time = metadata.last_modified_time;
+
+			// Skip the entry's blocks since they were already checked, but don't look for its external data file.
+			if(!cache_entry_passes_filter(exporter, &entry_to_filter))
+			{
+				++num_filtered_entries;
+				block += metadata_num_blocks;
+				continue;
+			}
+
+			TCHAR cached_file_size_string[MAX_INT_32_CHARS] = T("");
+			TCHAR access_count[MAX_INT_32_CHARS] = T("");
+
+			TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+			TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+			TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+
+			convert_u32_to_string(metadata.data_size, cached_file_size_string);
+			convert_s32_to_string(metadata.access_count, access_count);
+
+			format_time64_t_date_time(metadata.last_access_time, last_access_time);
+			format_time64_t_date_time(metadata.last_modified_time, last_modified_time);
+			format_time64_t_date_time(metadata.expiry_time, expiry_time);
+
+			if(url != NULL) url = decode_url(arena, url);
+
+			// Look for an external data file whose name starts with the hash of the key, regardless of its generation.
+			u32 hash_number = get_mozilla_cache_hash(key_in_metadata, metadata.key_size - 1);
+
+			TCHAR hash[MAX_INT_32_CHARS] = T("");
+			StringCchPrintf(hash, MAX_INT_32_CHARS, T("%08X"), hash_number);
+
+			TCHAR data_directory_path[MAX_PATH_CHARS] = T("");
+			TCHAR data_search_query[MAX_PATH_CHARS] = T("");
+
+			if(is_version_1_19_or_later)
+			{
+				StringCchPrintf(data_directory_path, MAX_PATH_CHARS, T("%s\\") T("%.1s\\") T("%.2s"), exporter->cache_path, hash, hash + 1);
+				StringCchPrintf(data_search_query, MAX_PATH_CHARS, T("%sd??"), hash + 3);
+			}
+			else
+			{
+				StringCchCopy(data_directory_path, MAX_PATH_CHARS, exporter->cache_path);
+				StringCchPrintf(data_search_query, MAX_PATH_CHARS, T("%sd??"), hash);
+			}
+
+			TCHAR data_file_path[MAX_PATH_CHARS] = T("");
+			traverse_directory_objects(data_directory_path, data_search_query, TRAVERSE_FILES, false, find_mozilla_cache_version_1_data_file_callback, data_file_path);
+
+			TCHAR* copy_source_path = NULL;
+			if(!string_is_empty(data_file_path))
+			{
+				copy_source_path = data_file_path;
+				++num_recovered_data_files;
+			}
+
+			// Use the location of the recovered metadata since we don't know where the cached file was stored in a block file.
+			const size_t MAX_LOCATION_IN_FILE_CHARS = MAX_INT_32_CHARS * 2 + 2;
+			TCHAR location_in_file[MAX_LOCATION_IN_FILE_CHARS] = T("");
+			StringCchPrintf(location_in_file, MAX_LOCATION_IN_FILE_CHARS, T("@%08X") T("#%08X"), offset_in_block_file, metadata_size);
+
+			TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
+			PathCombine(short_location_on_cache, exporter->browser_profile, block_file->filename);
+			StringCchCat(short_location_on_cache, MAX_PATH_CHARS, location_in_file);
+
+			TCHAR full_location_on_cache[MAX_PATH_CHARS] = T("");
+			StringCchCopy(full_location_on_cache, MAX_PATH_CHARS, block_file->file_path);
+			StringCchCat(full_location_on_cache, MAX_PATH_CHARS, location_in_file);
+
+			Csv_Entry csv_row[] =
+			{
+				{/* Filename */}, {/* URL */}, {/* Request Origin */}, {/* File Extension */}, {cached_file_size_string},
+				{last_modified_time}, {last_access_time}, {expiry_time}, {access_count},
+				{/* Response */}, {/* Server */}, {/* Cache Control */}, {/* Pragma */},
+				{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
+				{/* Decompressed File Size */}, {/* Location On Cache */}, {exporter->browser_name}, {cache_version}, {/* Integrity */}, {/* Frecency */},
+				{/* Missing File */}, {/* Location In Output */}, {/* Copy Error */}, {/* Exporter Warning */},
+				{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
+			};
+			_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
+
+			Exporter_Params params = {};
+			params.copy_source_path = copy_source_path;
+			params.url = url;
+			params.filename = NULL; // Comes from the URL.
+			params.request_origin = request_origin;
+			params.headers = headers;
+			params.short_location_on_cache = short_location_on_cache;
+			params.full_location_on_cache = full_location_on_cache;
+
+			export_cache_entry(exporter, csv_row, &params);
+
+			++num_recovered_entries;
+			block += metadata_num_blocks;
+		}
+	}
+
+	#undef IS_BLOCK_REFERENCED
+
+	log_info("Mozilla Cache Version 1: Recovered %d entries from the unreferenced blocks (%d still marked as allocated, %d with external data files), skipped %d that didn't pass the entry filter, and rejected %d others.",
+						num_recovered_entries, num_recovered_allocated_entries, num_recovered_data_files, num_filtered_entries, num_rejected_entries);
+}
+
 // Exports the Mozilla cache format (version 1) from a given location.
 //
 // @Parameters:
@@ -518,12 +963,17 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 	}
 
 	Arena* arena = &(exporter->temporary_arena);
+
+	// The map and block files are mapped into memory so that we can parse each record's metadata in place instead of reading it
+	// into an intermediate buffer.
+	HANDLE map_file_handle = create_handle(exporter->index_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
 	u64 map_file_size = 0;
-	void* map_file = read_entire_file(arena, exporter->index_path, &map_file_size);
-	
+	void* map_file = memory_map_entire_file(map_file_handle, &map_file_size);
+
 	if(map_file == NULL)
 	{
-		log_error("Mozilla Cache Version 1: Failed to read the map file.");
+		log_error("Mozilla Cache Version 1: Failed to map the map file into memory.");
+		safe_close_handle(&map_file_handle);
 		return;
 	}
 
@@ -531,15 +981,8 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 	if(map_file_size < MINIMUM_MAP_HEADER_SIZE)
 	{
 		log_error("Mozilla Cache Version 1: The size of the map file (%I64u) is smaller than the minimum header size (%Iu).", map_file_size, MINIMUM_MAP_HEADER_SIZE);
-		return;
-	}
-
-	TCHAR temporary_file_path[MAX_PATH_CHARS] = T("");
-	HANDLE temporary_file_handle = INVALID_HANDLE_VALUE;
-
-	if(!create_temporary_exporter_file(exporter, temporary_file_path, &temporary_file_handle))
-	{
-		log_error("Mozilla Cache Version 1: Failed to create the intermediate file in the temporary exporter directory.");
+		safe_unmap_view_of_file(&map_file);
+		safe_close_handle(&map_file_handle);
 		return;
 	}
 
@@ -578,7 +1021,7 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 
 	bool is_version_1_5_or_earlier = (header.major_version <= 1 && header.minor_version <= 5);
 	bool is_version_1_19_or_later = (header.major_version >= 1 && header.minor_version >= 19);
-	
+
 	const u32 MAP_HEADER_SIZE = (is_version_1_5_or_earlier) ?
 								(sizeof(Mozilla_1_Map_Header_Version_3_To_5) + MZ1_MAP_HEADER_VERSION_3_TO_5_PADDING_SIZE) :
 								(sizeof(Mozilla_1_Map_Header_Version_6_To_19));
@@ -616,7 +1059,7 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 		log_warning("Mozilla Cache Version 1: The map file's dirty flag is set to 0x%08X.", header.dirty_flag);
 	}
 
-	u32 num_records = ((u32) map_file_size - MAP_HEADER_SIZE) / sizeof(Mozilla_1_Map_Record);
+	u32 num_records = (map_file_size > MAP_HEADER_SIZE) ? (((u32) map_file_size - MAP_HEADER_SIZE) / sizeof(Mozilla_1_Map_Record)) : (0);
 	if(!is_version_1_5_or_earlier)
 	{
 		if(header.num_records < 0)
@@ -629,39 +1072,30 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 		}
 	}
 
-	// Open any existing blocks files for reading and determine version-specific parameters.
-	const size_t MAX_BLOCK_FILENAME_CHARS = 12;
-	struct Block_File
-	{
-		TCHAR filename[MAX_BLOCK_FILENAME_CHARS];
-		TCHAR file_path[MAX_PATH_CHARS];		
-		HANDLE file_handle;
-
-		u32 header_size; // Bitmap.
-		u32 block_size;
-		u32 max_entry_size;
-	};
-
-	const int MAX_NUM_BLOCKS_PER_RECORD = 4;
-	const int MAX_NUM_BLOCK_FILES = 3;
-	Block_File block_file_array[MAX_NUM_BLOCK_FILES + 1] = {};
-
+	// Open and map any existing blocks files and determine version-specific parameters.
 	// Block file zero corresponds to an external file and is never accessed using this array.
-	for(int i = 1; i <= MAX_NUM_BLOCK_FILES; ++i)
+	Mozilla_1_Block_File block_file_array[MZ1_MAX_NUM_BLOCK_FILES + 1] = {};
+
+	for(u32 i = 1; i <= MZ1_MAX_NUM_BLOCK_FILES; ++i)
 	{
-		Block_File* block_file = &block_file_array[i];
+		Mozilla_1_Block_File* block_file = &block_file_array[i];
 
-		StringCchPrintf(block_file->filename, MAX_BLOCK_FILENAME_CHARS, T("_CACHE_00%d_"), i);
+		StringCchPrintf(block_file->filename, MZ1_MAX_BLOCK_FILENAME_CHARS, T("_CACHE_00%I32u_"), i);
 		PathCombine(block_file->file_path, exporter->cache_path, block_file->filename);
 
 		block_file->file_handle = create_handle(block_file->file_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS);
 
 		if(block_file->file_handle != INVALID_HANDLE_VALUE)
 		{
-			u64 file_size = 0;
-			if(get_file_size(block_file->file_handle, &file_size))
+			block_file->mapped_file = memory_map_entire_file(block_file->file_handle, &block_file->file_size);
+
+			if(block_file->mapped_file != NULL)
+			{
+				log_info("Mozilla Cache Version 1: The block file '%s' has a size of %I64u bytes.", block_file->filename, block_file->file_size);
+			}
+			else
 			{
-				log_info("Mozilla Cache Version 1: The block file '%s' has a size of %I64u bytes.", block_file->filename, file_size);
+				log_error("Mozilla Cache Version 1: Failed to map the block file '%s' into memory.", block_file->filename);
 			}
 		}
 		else
@@ -676,7 +1110,7 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 				log_error("Mozilla Cache Version 1: Failed to open block file '%s' with the error code %lu.", block_file->filename, error_code);
 			}
 		}
-		
+
 		// @Format:
 		//
 		// - Mozilla 0.9.5 (1.3) to Firefox 4.0 (1.19)
@@ -715,7 +1149,7 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 			_ASSERT(false);
 		}
 
-		block_file->max_entry_size = MAX_NUM_BLOCKS_PER_RECORD * block_file->block_size;
+		block_file->max_entry_size = MZ1_MAX_NUM_BLOCKS_PER_RECORD * block_file->block_size;
 	}
 
 	// E.g. "C:\Users\<Username>\AppData\Local\<Vendor and Browser>\Profiles\<Profile Name>\Cache".
@@ -731,17 +1165,18 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 
 		TCHAR* profile_and_salt_name = push_arena(arena, MAX_PATH_SIZE, TCHAR);
 		PathCombine(profile_and_salt_name, profile_name, salt_name);
-		
+
 		exporter->browser_name = find_path_component(arena, exporter->cache_path, -5);
 		exporter->browser_profile = profile_and_salt_name;
 	}
 
-	lock_arena(arena);
-
 	Mozilla_1_Map_Record* record_array = (Mozilla_1_Map_Record*) advance_bytes(map_file, MAP_HEADER_SIZE);
 	_ASSERT(IS_POINTER_ALIGNED_TO_TYPE(record_array, u32));
 
-	log_info("Mozilla Cache Version 1: Processing %I32u records in the map file.", num_records);
+	// Convert every used record to the host's byte order and sort them by their hashes. The records are stored by bucket in the
+	// map file, meaning their external files would otherwise be read in a random order from each directory.
+	Mozilla_1_Sorted_Record* sorted_record_array = push_array_to_arena(arena, MAX(num_records, (u32) 1), Mozilla_1_Sorted_Record);
+	u32 num_sorted_records = 0;
 
 	for(u32 i = 0; i < num_records; ++i)
 	{
@@ -758,16 +1193,49 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 			LITTLE_ENDIAN_TO_HOST(record.hash_number);
 			LITTLE_ENDIAN_TO_HOST(record.eviction_rank);
 			LITTLE_ENDIAN_TO_HOST(record.data_location);
-			LITTLE_ENDIAN_TO_HOST(record.metadata_location);			
+			LITTLE_ENDIAN_TO_HOST(record.metadata_location);
 		}
 		else
 		{
 			BIG_ENDIAN_TO_HOST(record.hash_number);
 			BIG_ENDIAN_TO_HOST(record.eviction_rank);
 			BIG_ENDIAN_TO_HOST(record.data_location);
-			BIG_ENDIAN_TO_HOST(record.metadata_location);	
+			BIG_ENDIAN_TO_HOST(record.metadata_location);
 		}
-	
+
+		if( (record.data_location & MZ1_LOCATION_INITIALIZED_MASK) == 0 && (record.metadata_location & MZ1_LOCATION_INITIALIZED_MASK) == 0 ) continue;
+
+		Mozilla_1_Sorted_Record* sorted_record = &sorted_record_array[num_sorted_records];
+		sorted_record->record = record;
+		sorted_record->index = i;
+		++num_sorted_records;
+	}
+
+	qsort(sorted_record_array, num_sorted_records, sizeof(Mozilla_1_Sorted_Record), compare_mozilla_1_sorted_records);
+
+	// Keep track of which blocks are referenced by the map records so we can look for entries in the remaining ones later.
+	if(exporter->recover_mozilla_entries)
+	{
+		for(u32 i = 1; i <= MZ1_MAX_NUM_BLOCK_FILES; ++i)
+		{
+			Mozilla_1_Block_File* block_file = &block_file_array[i];
+			if(block_file->mapped_file == NULL || block_file->file_size <= block_file->header_size) continue;
+
+			u64 blocks_size = block_file->file_size - block_file->header_size;
+			block_file->num_blocks = (u32) ((blocks_size + block_file->block_size - 1) / block_file->block_size);
+			block_file->referenced_blocks = push_array_to_arena(arena, block_file->num_blocks / CHAR_BIT + 1, u8);
+		}
+	}
+
+	lock_arena(arena);
+
+	log_info("Mozilla Cache Version 1: Processing %I32u used records out of %I32u in the map file.", num_sorted_records, num_records);
+
+	for(u32 j = 0; j < num_sorted_records; ++j)
+	{
+		Mozilla_1_Map_Record record = sorted_record_array[j].record;
+		u32 i = sorted_record_array[j].index;
+
 		u32 file_initialized = (record.data_location & MZ1_LOCATION_INITIALIZED_MASK);
 		u32 file_selector = (record.data_location & MZ1_LOCATION_SELECTOR_MASK) >> MZ1_LOCATION_SELECTOR_OFFSET;
 		u8 file_generation = (u8) (record.data_location & MZ1_FILE_GENERATION_MASK);
@@ -778,15 +1246,23 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 		u32 metadata_selector = (record.metadata_location & MZ1_LOCATION_SELECTOR_MASK) >> MZ1_LOCATION_SELECTOR_OFFSET;
 		u8 metadata_generation = (u8) (record.metadata_location & MZ1_FILE_GENERATION_MASK);
 		u32 metadata_first_block = (record.metadata_location & MZ1_BLOCK_NUMBER_MASK);
-		u32 metadata_num_blocks = ((record.metadata_location & MZ1_EXTRA_BLOCKS_MASK) >> MZ1_EXTRA_BLOCKS_OFFSET) + 1;	
+		u32 metadata_num_blocks = ((record.metadata_location & MZ1_EXTRA_BLOCKS_MASK) >> MZ1_EXTRA_BLOCKS_OFFSET) + 1;
 
 		bool is_file_initialized = (file_initialized != 0);
 		bool is_metadata_initialized = (metadata_initialized != 0);
 
-		if(!is_file_initialized && !is_metadata_initialized) continue;
+		_ASSERT(1 <= file_num_blocks && file_num_blocks <= MZ1_MAX_NUM_BLOCKS_PER_RECORD);
+		_ASSERT(1 <= metadata_num_blocks && metadata_num_blocks <= MZ1_MAX_NUM_BLOCKS_PER_RECORD);
+
+		if(is_file_initialized && 1 <= file_selector && file_selector <= MZ1_MAX_NUM_BLOCK_FILES)
+		{
+			mark_mozilla_cache_version_1_blocks(&block_file_array[file_selector], file_first_block, file_num_blocks);
+		}
 
-		_ASSERT(1 <= file_num_blocks && file_num_blocks <= MAX_NUM_BLOCKS_PER_RECORD);
-		_ASSERT(1 <= metadata_num_blocks && metadata_num_blocks <= MAX_NUM_BLOCKS_PER_RECORD);
+		if(is_metadata_initialized && 1 <= metadata_selector && metadata_selector <= MZ1_MAX_NUM_BLOCK_FILES)
+		{
+			mark_mozilla_cache_version_1_blocks(&block_file_array[metadata_selector], metadata_first_block, metadata_num_blocks);
+		}
 
 		// Determines the filename or short path of an external file associated with the current record.
 		//
@@ -812,27 +1288,34 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 			}\
 		} while(false, false)
 
-		Mozilla_1_Metadata_Entry* metadata = NULL;
+		// The metadata is either in an external file (which is read into memory) or in a mapped block file. In both cases, the
+		// entry header is copied and converted to the host's byte order, while the key and elements are accessed in place.
+		void* metadata_in_file = NULL;
+		u32 metadata_size = 0;
 
 		if(is_metadata_initialized)
 		{
-			if(metadata_selector <= MAX_NUM_BLOCK_FILES)
+			if(metadata_selector <= MZ1_MAX_NUM_BLOCK_FILES)
 			{
 				if(metadata_selector == 0)
-				{				
+				{
 					TCHAR full_metadata_path[MAX_PATH_CHARS] = T("");
 					GET_EXTERNAL_DATA_FILE_PATH(true, full_metadata_path);
 					PathCombine(full_metadata_path, exporter->cache_path, full_metadata_path);
-					
+
 					u64 metadata_file_size = 0;
-					metadata = (Mozilla_1_Metadata_Entry*) read_entire_file(arena, full_metadata_path, &metadata_file_size);
-					if(metadata != NULL)
+					metadata_in_file = read_entire_file(arena, full_metadata_path, &metadata_file_size);
+					if(metadata_in_file != NULL)
 					{
 						if(metadata_file_size < sizeof(Mozilla_1_Metadata_Entry))
 						{
-							metadata = NULL;
+							metadata_in_file = NULL;
 							log_warning("Mozilla Cache Version 1: Skipping the read metadata file for record %I32u in '%s' since its size of %I64u is smaller than the minimum possible entry size.", i, full_metadata_path, metadata_file_size);
 						}
+						else
+						{
+							metadata_size = (u32) MIN(metadata_file_size, (u64) 0xFFFFFFFF);
+						}
 					}
 					else
 					{
@@ -841,29 +1324,17 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 				}
 				else
 				{
-					Block_File block_file = block_file_array[metadata_selector];
-					if(block_file.file_handle != INVALID_HANDLE_VALUE)
+					Mozilla_1_Block_File* block_file = &block_file_array[metadata_selector];
+					if(block_file->mapped_file != NULL)
 					{
-						u32 offset_in_block_file = block_file.header_size + metadata_first_block * block_file.block_size;
-						u32 total_metadata_size = metadata_num_blocks * block_file.block_size;
-						_ASSERT(sizeof(Mozilla_1_Metadata_Entry) <= total_metadata_size);
-						_ASSERT(total_metadata_size <= block_file.max_entry_size);
-
-						metadata = push_arena(arena, total_metadata_size, Mozilla_1_Metadata_Entry);
+						u32 offset_in_block_file = 0;
+						metadata_in_file = get_mozilla_cache_version_1_blocks(block_file, metadata_first_block, metadata_num_blocks, &offset_in_block_file, &metadata_size);
+						_ASSERT(metadata_size <= block_file->max_entry_size);
 
-						u32 read_metadata_size = 0;
-						if(read_file_chunk(block_file.file_handle, metadata, total_metadata_size, offset_in_block_file, true, &read_metadata_size))
-						{
-							if(read_metadata_size < sizeof(Mozilla_1_Metadata_Entry))
-							{
-								metadata = NULL;
-								log_warning("Mozilla Cache Version 1: Skipping the read metadata for record %I32u in block file '%s' at the offset %I32u since the read size of %I32u is smaller than the minimum possible entry size.", i, block_file.filename, offset_in_block_file, read_metadata_size);
-							}
-						}
-						else
+						if(metadata_size < sizeof(Mozilla_1_Metadata_Entry))
 						{
-							metadata = NULL;
-							log_error("Mozilla Cache Version 1: Failed to read the metadata for record %I32u in block file '%s' at the offset %I32u and with a total size of %I32u.", i, block_file.filename, offset_in_block_file, total_metadata_size);
+							metadata_in_file = NULL;
+							log_warning("Mozilla Cache Version 1: Skipping the metadata for record %I32u in block file '%s' at the offset %I32u since the available size of %I32u is smaller than the minimum possible entry size.", i, block_file->filename, offset_in_block_file, metadata_size);
 						}
 					}
 				}
@@ -880,44 +1351,41 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 		TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
 		TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
 		TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-		
+
 		TCHAR* url = NULL;
 		TCHAR* request_origin = NULL;
 		Http_Headers headers = {};
 
-		if(metadata != NULL)
+		bool has_metadata = (metadata_in_file != NULL);
+		Mozilla_1_Metadata_Entry metadata = {};
+
+		if(has_metadata)
 		{
 			// Here, the metadata size is at least sizeof(Mozilla_1_Metadata_Entry).
+			CopyMemory(&metadata, metadata_in_file, sizeof(metadata));
 
-			BIG_ENDIAN_TO_HOST(metadata->header_major_version);
-			BIG_ENDIAN_TO_HOST(metadata->header_minor_version);
-			BIG_ENDIAN_TO_HOST(metadata->meta_location);
-			BIG_ENDIAN_TO_HOST(metadata->access_count);
-			
-			BIG_ENDIAN_TO_HOST(metadata->last_access_time);
-			BIG_ENDIAN_TO_HOST(metadata->last_modified_time);
-			BIG_ENDIAN_TO_HOST(metadata->expiry_time);
-			BIG_ENDIAN_TO_HOST(metadata->data_size);
-			
-			BIG_ENDIAN_TO_HOST(metadata->key_size);
-			BIG_ENDIAN_TO_HOST(metadata->elements_size);
+			BIG_ENDIAN_TO_HOST(metadata.header_major_version);
+			BIG_ENDIAN_TO_HOST(metadata.header_minor_version);
+			BIG_ENDIAN_TO_HOST(metadata.meta_location);
+			BIG_ENDIAN_TO_HOST(metadata.access_count);
 
-			_ASSERT( (metadata->header_major_version == header.major_version) && (metadata->header_minor_version == header.minor_version) );
+			BIG_ENDIAN_TO_HOST(metadata.last_access_time);
+			BIG_ENDIAN_TO_HOST(metadata.last_modified_time);
+			BIG_ENDIAN_TO_HOST(metadata.expiry_time);
+			BIG_ENDIAN_TO_HOST(metadata.data_size);
 
-			convert_u32_to_string(metadata->data_size, cached_file_size_string);
-			convert_s32_to_string(metadata->access_count, access_count);
-		
-			format_time64_t_date_time(metadata->last_access_time, last_access_time);
-			format_time64_t_date_time(metadata->last_modified_time, last_modified_time);
-			format_time64_t_date_time(metadata->expiry_time, expiry_time);
+			BIG_ENDIAN_TO_HOST(metadata.key_size);
+			BIG_ENDIAN_TO_HOST(metadata.elements_size);
+
+			_ASSERT( (metadata.header_major_version == header.major_version) && (metadata.header_minor_version == header.minor_version) );
 
-			Block_File block_file = block_file_array[metadata_selector];
-			u32 remaining_metadata_size = (metadata_num_blocks * block_file.block_size) - sizeof(Mozilla_1_Metadata_Entry);
-			_ASSERT( (metadata_num_blocks * block_file.block_size) >= sizeof(Mozilla_1_Metadata_Entry) );
+			u32 remaining_metadata_size = metadata_size - (u32) sizeof(Mozilla_1_Metadata_Entry);
 
-			// @Format: The key and elements are null terminated.
+			// @Format: The key and elements are null terminated. Since they're accessed in place, we'll make sure that their
+			// last characters are null before using them so that we never read past the end of the mapped file.
+			char* key_in_metadata = (char*) advance_bytes(metadata_in_file, sizeof(Mozilla_1_Metadata_Entry));
 
-			if(remaining_metadata_size >= metadata->key_size)
+			if(metadata.key_size > 0 && remaining_metadata_size >= metadata.key_size && key_in_metadata[metadata.key_size - 1] == '\0')
 			{
 				// @Format: Extract the URL from the metadata key. This key contains two values separated by the colon character,
 				// where the URL is the second one. For example: "HTTP:http://www.example.com/index.html"
@@ -926,58 +1394,80 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 				// - ClientKeyFromCacheKey() in https://hg.mozilla.org/mozilla-central/file/2d6becec52a482ad114c633cf3a0a5aa2909263b/netwerk/cache/nsCache.cpp
 				// - nsCacheService::CreateRequest() in https://hg.mozilla.org/mozilla-central/file/2d6becec52a482ad114c633cf3a0a5aa2909263b/netwerk/cache/nsCacheService.cpp
 
-				char* key_in_metadata = (char*) advance_bytes(metadata, sizeof(Mozilla_1_Metadata_Entry));
 				TCHAR* key = convert_ansi_string_to_tchar(arena, key_in_metadata);
-				
+
 				String_Array<TCHAR>* split_key = split_string(arena, key, T(":"), 1);
 
 				if(split_key->num_strings == 2)
 				{
 					url = split_key->strings[1];
-					url = decode_url(arena, url);
 				}
 				else
 				{
 					log_warning("Mozilla Cache Version 1: The key '%s' in record %I32u does not contain the URL.", key, i);
 				}
 
-				remaining_metadata_size -= metadata->key_size;
+				remaining_metadata_size -= metadata.key_size;
 
-				if(remaining_metadata_size >= metadata->elements_size)
-				{
-					void* elements = advance_bytes(key_in_metadata, metadata->key_size);
-					parse_mozilla_cache_elements(arena, elements, metadata->elements_size, &headers, &request_origin);
+				char* elements = (char*) advance_bytes(key_in_metadata, metadata.key_size);
 
-					remaining_metadata_size -= metadata->elements_size;
+				if(metadata.elements_size > 0 && remaining_metadata_size >= metadata.elements_size && elements[metadata.elements_size - 1] == '\0')
+				{
+					parse_mozilla_cache_elements(arena, elements, metadata.elements_size, &headers, &request_origin);
+					remaining_metadata_size -= metadata.elements_size;
 				}
 				else
 				{
-					log_warning("Mozilla Cache Version 1: Skipping the elements metadata in record %I32u since the remaining size (%I32u) is too small to contain the elements (%I32u).", i, remaining_metadata_size, metadata->elements_size);
+					log_warning("Mozilla Cache Version 1: Skipping the elements metadata in record %I32u since the remaining size (%I32u) is too small to contain the elements (%I32u) or they're not null terminated.", i, remaining_metadata_size, metadata.elements_size);
 				}
 			}
 			else
 			{
-				log_warning("Mozilla Cache Version 1: Skipping the key and elements metadata in record %I32u since the remaining size (%I32u) is too small to contain the key (%I32u).", i, remaining_metadata_size, metadata->key_size);
+				log_warning("Mozilla Cache Version 1: Skipping the key and elements metadata in record %I32u since the remaining size (%I32u) is too small to contain the key (%I32u) or it's not null terminated.", i, remaining_metadata_size, metadata.key_size);
 			}
 		}
 
-		// The file we'll copy will either be the cached file (if the data is stored in its own file),
-		// or the temporary file (if we had to extract some chunks from a block file).
+		Filterable_Cache_Entry entry_to_filter = {};
+		entry_to_filter.url = url;
+		entry_to_filter.content_type = headers.content_type;
+		entry_to_filter.has_size = has_metadata;
+		entry_to_filter.size = metadata.data_size;
+		entry_to_filter.last_modified_time = metadata.last_modified_time;
+
+		// The blocks used by this record were already marked above, so skipping it won't affect the recovery.
+		if(!cache_entry_passes_filter(exporter, &entry_to_filter)) continue;
+
+		if(has_metadata)
+		{
+			convert_u32_to_string(metadata.data_size, cached_file_size_string);
+			convert_s32_to_string(metadata.access_count, access_count);
+
+			format_time64_t_date_time(metadata.last_access_time, last_access_time);
+			format_time64_t_date_time(metadata.last_modified_time, last_modified_time);
+			format_time64_t_date_time(metadata.expiry_time, expiry_time);
+		}
+
+		if(url != NULL) url = decode_url(arena, url);
+
+		// The file we'll copy will either be the cached file (if the data is stored in its own file), or a byte range in a block file.
 		TCHAR cached_file_path[MAX_PATH_CHARS] = T("");
 		TCHAR* copy_source_path = NULL;
+		bool use_copy_source_range = false;
+		u32 copy_source_offset = 0;
+		u32 copy_source_size = 0;
 
 		TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
 		TCHAR full_location_on_cache[MAX_PATH_CHARS] = T("");
 
 		if(is_file_initialized)
 		{
-			if(file_selector <= MAX_NUM_BLOCK_FILES)
+			if(file_selector <= MZ1_MAX_NUM_BLOCK_FILES)
 			{
 				if(file_selector == 0)
-				{	
-					TCHAR short_data_path[MAX_PATH_CHARS] = T("");		
+				{
+					TCHAR short_data_path[MAX_PATH_CHARS] = T("");
 					GET_EXTERNAL_DATA_FILE_PATH(false, short_data_path);
-					
+
 					PathCombine(cached_file_path, exporter->cache_path, short_data_path);
 					PathCombine(short_location_on_cache, exporter->browser_profile, short_data_path);
 
@@ -985,75 +1475,62 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 				}
 				else
 				{
-					// For external data, the file we'll copy will always be the intermediate temporary file that was previously created
-					// (unless we fail to extract some chunks from the block file).
-					Block_File block_file = block_file_array[file_selector];
-					if(block_file.file_handle != INVALID_HANDLE_VALUE)
+					Mozilla_1_Block_File* block_file = &block_file_array[file_selector];
+					if(block_file->mapped_file != NULL)
 					{
-						u32 offset_in_block_file = block_file.header_size + file_first_block * block_file.block_size;
-						u32 total_file_size = file_num_blocks * block_file.block_size;
-
-						_ASSERT(total_file_size <= block_file.max_entry_size);
-						
-						void* cached_file_in_block_file = push_arena(arena, total_file_size, u8);
-						u32 read_cached_file_size = 0;
+						u32 offset_in_block_file = 0;
+						u32 available_file_size = 0;
+						void* cached_file_in_block_file = get_mozilla_cache_version_1_blocks(block_file, file_first_block, file_num_blocks, &offset_in_block_file, &available_file_size);
+						_ASSERT(available_file_size <= block_file->max_entry_size);
 
-						if(read_file_chunk(block_file.file_handle, cached_file_in_block_file, total_file_size, offset_in_block_file, true, &read_cached_file_size))
+						if(cached_file_in_block_file != NULL)
 						{
-							if(metadata != NULL)
+							u32 cached_file_size = available_file_size;
+
+							if(has_metadata)
 							{
 								// Avoid copying more bytes than expected if the size in the metadata is wrong.
-								read_cached_file_size = MIN(read_cached_file_size, metadata->data_size);
+								cached_file_size = MIN(cached_file_size, metadata.data_size);
 							}
 							else
 							{
 								// Try to guess the cached file's size if there's no metadata. This isn't guaranteed to work since
 								// we might remove one too many null bytes and corrupt the real cached file.
 								// @Format: The data in a block file is padded with null bytes, unless it's the last entry.
-								u32 num_null_bytes = 0;
-								u8* last_cached_file_byte = (u8*) advance_bytes(cached_file_in_block_file, read_cached_file_size - 1);
-
-								while(*last_cached_file_byte == 0 && num_null_bytes < read_cached_file_size)
+								u8* cached_file_bytes = (u8*) cached_file_in_block_file;
+								while(cached_file_size > 0 && cached_file_bytes[cached_file_size - 1] == 0)
 								{
-									++num_null_bytes;
-									--last_cached_file_byte;
+									--cached_file_size;
 								}
 
-								_ASSERT(num_null_bytes <= read_cached_file_size);
-								read_cached_file_size -= num_null_bytes;
-
-								add_exporter_warning_message(exporter, "Removed %I32u bytes from the end of the file due to missing metadata. The file size was reduced from %I32u to %I32u.", num_null_bytes, read_cached_file_size + num_null_bytes, read_cached_file_size);
-								log_warning("Mozilla Cache Version 1: Attempted to find the cached file's size in record %I32u since the metadata was missing. Reduced the size to %I32u after finding %I32u null bytes. The exported file may be corrupted.", i, read_cached_file_size, num_null_bytes);
+								u32 num_null_bytes = available_file_size - cached_file_size;
+								add_exporter_warning_message(exporter, "Removed %I32u bytes from the end of the file due to missing metadata. The file size was reduced from %I32u to %I32u.", num_null_bytes, available_file_size, cached_file_size);
+								log_warning("Mozilla Cache Version 1: Attempted to find the cached file's size in record %I32u since the metadata was missing. Reduced the size to %I32u after finding %I32u null bytes. The exported file may be corrupted.", i, cached_file_size, num_null_bytes);
 							}
 
-							bool write_success = empty_file(temporary_file_handle) && write_to_file(temporary_file_handle, cached_file_in_block_file, read_cached_file_size);
-
-							if(write_success)
-							{
-								copy_source_path = temporary_file_path;
-							}
-							else
-							{
-								log_error("Mozilla Cache Version 1: Failed to write the cached file (%I32u) in record %I32u from block file '%s' to the temporary exporter directory.", read_cached_file_size, i, block_file.filename);
-							}
+							// Export this byte range directly from the block file instead of writing it to an intermediate temporary file.
+							copy_source_path = block_file->file_path;
+							use_copy_source_range = true;
+							copy_source_offset = offset_in_block_file;
+							copy_source_size = cached_file_size;
 
 							// Create a pretty version of the location on cache which includes the address and size in the block file.
 							const size_t MAX_LOCATION_IN_FILE_CHARS = MAX_INT_32_CHARS * 2 + 2;
 							TCHAR location_in_file[MAX_LOCATION_IN_FILE_CHARS] = T("");
-							StringCchPrintf(location_in_file, MAX_LOCATION_IN_FILE_CHARS, T("@%08X") T("#%08X"), offset_in_block_file, read_cached_file_size);
+							StringCchPrintf(location_in_file, MAX_LOCATION_IN_FILE_CHARS, T("@%08X") T("#%08X"), offset_in_block_file, cached_file_size);
 
-							PathCombine(short_location_on_cache, exporter->browser_profile, block_file.filename);
+							PathCombine(short_location_on_cache, exporter->browser_profile, block_file->filename);
 							StringCchCat(short_location_on_cache, MAX_PATH_CHARS, location_in_file);
 
-							StringCchCopy(full_location_on_cache, MAX_PATH_CHARS, block_file.file_path);
-							StringCchCat(full_location_on_cache, MAX_PATH_CHARS, location_in_file);							
+							StringCchCopy(full_location_on_cache, MAX_PATH_CHARS, block_file->file_path);
+							StringCchCat(full_location_on_cache, MAX_PATH_CHARS, location_in_file);
 						}
 						else
 						{
-							log_error("Mozilla Cache Version 1: Failed to read the file for record %I32u in block file '%s' at the offset %I32u and with a total size of %I32u.", i, block_file.filename, offset_in_block_file, total_file_size);
+							log_error("Mozilla Cache Version 1: The file for record %I32u in block file '%s' starts past the end of the file (block %I32u).", i, block_file->filename, file_first_block);
 						}
 					}
-				}				
+				}
 			}
 			else
 			{
@@ -1069,7 +1546,7 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 			{last_modified_time}, {last_access_time}, {expiry_time}, {access_count},
 			{/* Response */}, {/* Server */}, {/* Cache Control */}, {/* Pragma */},
 			{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
-			{/* Decompressed File Size */}, {/* Location On Cache */}, {exporter->browser_name}, {cache_version},
+			{/* Decompressed File Size */}, {/* Location On Cache */}, {exporter->browser_name}, {cache_version}, {/* Integrity */}, {/* Frecency */},
 			{/* Missing File */}, {/* Location In Output */}, {/* Copy Error */}, {/* Exporter Warning */},
 			{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
 		};
@@ -1077,6 +1554,9 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 
 		Exporter_Params params = {};
 		params.copy_source_path = copy_source_path;
+		params.use_copy_source_range = use_copy_source_range;
+		params.copy_source_offset = copy_source_offset;
+		params.copy_source_size = copy_source_size;
 		params.url = url;
 		params.filename = NULL; // Comes from the URL.
 		params.request_origin = request_origin;
@@ -1087,15 +1567,22 @@ static void export_mozilla_cache_version_1(Exporter* exporter)
 		export_cache_entry(exporter, csv_row, &params);
 	}
 
+	if(exporter->recover_mozilla_entries)
+	{
+		recover_mozilla_cache_version_1_entries(exporter, block_file_array, header.major_version, header.minor_version, is_version_1_19_or_later);
+	}
+
 	unlock_arena(arena);
 
-	for(int i = 1; i <= MAX_NUM_BLOCK_FILES; ++i)
+	for(u32 i = 1; i <= MZ1_MAX_NUM_BLOCK_FILES; ++i)
 	{
-		Block_File* block_file = &block_file_array[i];
+		Mozilla_1_Block_File* block_file = &block_file_array[i];
+		if(block_file->mapped_file != NULL) safe_unmap_view_of_file(&block_file->mapped_file);
 		safe_close_handle(&block_file->file_handle);
 	}
 
-	safe_close_handle(&temporary_file_handle);
+	safe_unmap_view_of_file(&map_file);
+	safe_close_handle(&map_file_handle);
 
 	reset_temporary_exporter_members(exporter);
 }
@@ -1154,17 +1641,549 @@ _STATIC_ASSERT(sizeof(Mozilla_2_Index_Header) == 16);
 _STATIC_ASSERT(sizeof(Mozilla_2_Metadata_Header_Version_1_And_2) == 24);
 _STATIC_ASSERT(sizeof(Mozilla_2_Metadata_Header_Version_3) == 32);
 
-struct Find_Mozilla_2_Files_Params
+// @Format: The size of the SHA-1 hash of each entry's key. The entry's filename is this hash in hexadecimal.
+static const size_t MZ2_HASH_SIZE = 20;
+
+// @Format: See the flags in CacheIndexRecord in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheIndex.h
+enum Mozilla_2_Index_Record_Flag
 {
-	Exporter* exporter;
-	u32 index_version;
-	TCHAR temporary_file_path[MAX_PATH_CHARS];
-	HANDLE temporary_file_handle;
+	MZ2_INDEX_INITIALIZED = 0x80000000,
+	MZ2_INDEX_ANONYMOUS = 0x40000000,
+	MZ2_INDEX_REMOVED = 0x20000000,
+	MZ2_INDEX_DIRTY = 0x10000000,
+	MZ2_INDEX_FRESH = 0x08000000,
+	MZ2_INDEX_PINNED = 0x04000000,
+	MZ2_INDEX_HAS_ALT_DATA = 0x02000000,
+	MZ2_INDEX_FILE_SIZE_MASK = 0x00FFFFFF, // In kilobytes.
 };
 
-// Called every time a file is found in the Mozilla cache directory (version 2). Used to export every cache entry.
-//
-// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+// The values we keep from each record in the index file. This isn't the on-disk format since its size changes between versions.
+struct Mozilla_2_Index_Record
+{
+	u8 hash[MZ2_HASH_SIZE];
+	u32 frecency;
+	u64 origin_attributes_hash; // @Format: Set to zero in version 1, which used an app ID instead.
+	u32 flags;
+};
+
+// The records in the index file sorted by their hash. This may be used to find any entry's information without opening its file.
+struct Mozilla_2_Index
+{
+	u32 version;
+	u32 num_records;
+	Mozilla_2_Index_Record* records; // NULL if the index file could not be loaded.
+
+	u32 num_removed_records;
+	u32 num_dirty_records;
+	u64 total_size_in_kilobytes;
+	u32 max_frecency;
+};
+
+// Called by qsort() and bsearch() to sort and search the index records by their hashes.
+static int compare_mozilla_2_index_records(const void* record_pointer_1, const void* record_pointer_2)
+{
+	const Mozilla_2_Index_Record* record_1 = (const Mozilla_2_Index_Record*) record_pointer_1;
+	const Mozilla_2_Index_Record* record_2 = (const Mozilla_2_Index_Record*) record_pointer_2;
+
+	for(size_t i = 0; i < MZ2_HASH_SIZE; ++i)
+	{
+		if(record_1->hash[i] != record_2->hash[i]) return (record_1->hash[i] < record_2->hash[i]) ? (-1) : (1);
+	}
+
+	return 0;
+}
+
+// Loads every record from the Mozilla cache version 2 index file into the temporary memory arena. These are sorted by their hash,
+// which is also the order that the entry files are usually listed in on NTFS since their names are these hashes in hexadecimal.
+//
+// @Format: The index file is made up of the header, a list of records, and a four byte hash of the previous data. The size of each
+// record depends on the index version, though every one starts with the hash and frecency, and ends with the flags. Since this layout
+// has changed a few times, the record size is only accepted if the records fill the whole file exactly.
+//
+// See:
+// - CacheIndexHeader and CacheIndexRecord in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheIndex.h
+// - CacheIndexEntry::WriteToBuf() in the same file.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure whose index path points to the index file.
+// 2. result_index - The Mozilla_2_Index structure that receives the records. If the records can't be loaded, this structure's
+// 'records' member is set to NULL, though its version may still be set.
+//
+// @Returns: Nothing.
+static void load_mozilla_cache_version_2_index(Exporter* exporter, Mozilla_2_Index* result_index)
+{
+	ZeroMemory(result_index, sizeof(Mozilla_2_Index));
+
+	Arena* arena = &(exporter->temporary_arena);
+
+	HANDLE index_handle = create_handle(exporter->index_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+	u64 index_file_size = 0;
+	Mozilla_2_Index_Header index_header = {};
+
+	if(index_handle == INVALID_HANDLE_VALUE || !get_file_size(index_handle, &index_file_size)
+		|| !read_first_file_bytes(index_handle, &index_header, sizeof(index_header)))
+	{
+		log_warning("Mozilla Cache Version 2: Could not read the header from the index file.");
+		safe_close_handle(&index_handle);
+		return;
+	}
+
+	BIG_ENDIAN_TO_HOST(index_header.version);
+	BIG_ENDIAN_TO_HOST(index_header.last_write_time);
+	BIG_ENDIAN_TO_HOST(index_header.dirty_flag);
+	BIG_ENDIAN_TO_HOST(index_header.used_cache_size);
+
+	result_index->version = index_header.version;
+
+	if(index_header.version > MZ2_MAX_INDEX_VERSION)
+	{
+		log_warning("Mozilla Cache Version 2: Found the unsupported version %I32u in the index file '%s'.", index_header.version, exporter->index_path);
+		_ASSERT(false);
+	}
+
+	if(index_header.dirty_flag != 0)
+	{
+		log_warning("Mozilla Cache Version 2: The index file's dirty flag is set to 0x%08X.", index_header.dirty_flag);
+	}
+
+	// @Format: Version 1 didn't have the used cache size in the header. Version 1 stored an expiration time and app ID (36 bytes),
+	// versions 2 to 7 an origin attributes hash and either an expiration time or the start and stop times (40 bytes), and version 8
+	// onwards also added the content type (41 bytes).
+	const u32 HASH_OFFSET = 0;
+	const u32 FRECENCY_OFFSET = 20;
+	const u32 ORIGIN_ATTRIBUTES_HASH_OFFSET = 24;
+
+	u32 header_size = (u32) ( (index_header.version <= 1) ? (sizeof(index_header) - sizeof(index_header.used_cache_size)) : (sizeof(index_header)) );
+	u32 record_size = (index_header.version <= 1) ? (36) : ( (index_header.version <= 7) ? (40) : (41) );
+	u64 records_size = (index_file_size >= header_size + sizeof(u32)) ? (index_file_size - header_size - sizeof(u32)) : (0);
+
+	if(records_size % record_size != 0)
+	{
+		log_warning("Mozilla Cache Version 2: The size of the records in the index file (%I64u) is not a multiple of the record size (%I32u) for version %I32u. The index will not be used.", records_size, record_size, index_header.version);
+		safe_close_handle(&index_handle);
+		return;
+	}
+
+	u64 num_records = records_size / record_size;
+
+	// Leave enough memory to export each entry.
+	u64 max_num_records = (2 * get_arena_chunk_buffer_size(arena, 0)) / sizeof(Mozilla_2_Index_Record);
+	if(num_records > max_num_records)
+	{
+		log_warning("Mozilla Cache Version 2: Not enough memory to load the %I64u records in the index file since at most %I64u can be loaded. The index will not be used and every entry will be exported without its index flags.", num_records, max_num_records);
+		safe_close_handle(&index_handle);
+		return;
+	}
+
+	Mozilla_2_Index_Record* records = push_array_to_arena(arena, (size_t) num_records, Mozilla_2_Index_Record);
+	bool success = true;
+
+	lock_arena(arena);
+	{
+		u32 max_records_per_chunk = MAX(get_arena_file_buffer_size(arena, index_handle) / record_size, (u32) 1);
+		u8* chunk = push_array_to_arena(arena, max_records_per_chunk * record_size, u8);
+		u64 file_offset = header_size;
+
+		for(u32 i = 0; i < num_records;)
+		{
+			u32 num_chunk_records = (u32) MIN((u64) max_records_per_chunk, num_records - i);
+
+			if(!read_file_chunk(index_handle, chunk, num_chunk_records * record_size, file_offset))
+			{
+				log_error("Mozilla Cache Version 2: Failed to read %I32u records at the offset %I64u in the index file. The index will not be used.", num_chunk_records, file_offset);
+				success = false;
+				break;
+			}
+
+			for(u32 j = 0; j < num_chunk_records; ++j)
+			{
+				u8* record_data = chunk + j * record_size;
+				Mozilla_2_Index_Record* record = &records[i + j];
+
+				CopyMemory(record->hash, record_data + HASH_OFFSET, MZ2_HASH_SIZE);
+				CopyMemory(&record->frecency, record_data + FRECENCY_OFFSET, sizeof(record->frecency));
+				CopyMemory(&record->flags, record_data + record_size - sizeof(record->flags), sizeof(record->flags));
+				BIG_ENDIAN_TO_HOST(record->frecency);
+				BIG_ENDIAN_TO_HOST(record->flags);
+
+				record->origin_attributes_hash = 0;
+				if(index_header.version >= 2)
+				{
+					CopyMemory(&record->origin_attributes_hash, record_data + ORIGIN_ATTRIBUTES_HASH_OFFSET, sizeof(record->origin_attributes_hash));
+					BIG_ENDIAN_TO_HOST(record->origin_attributes_hash);
+				}
+
+				if(record->flags & MZ2_INDEX_REMOVED) ++(result_index->num_removed_records);
+				if(record->flags & MZ2_INDEX_DIRTY) ++(result_index->num_dirty_records);
+				result_index->total_size_in_kilobytes += record->flags & MZ2_INDEX_FILE_SIZE_MASK;
+				result_index->max_frecency = MAX(result_index->max_frecency, record->frecency);
+			}
+
+			file_offset += num_chunk_records * record_size;
+			i += num_chunk_records;
+		}
+
+		clear_arena(arena);
+	}
+	unlock_arena(arena);
+
+	safe_close_handle(&index_handle);
+
+	if(success)
+	{
+		qsort(records, (size_t) num_records, sizeof(Mozilla_2_Index_Record), compare_mozilla_2_index_records);
+		result_index->num_records = (u32) num_records;
+		result_index->records = records;
+
+		log_info("Mozilla Cache Version 2: The index file version %I32u has %I32u records (%I32u removed and %I32u dirty) with a total size of %I64u kilobytes and a maximum frecency of %I32u.",
+					result_index->version, result_index->num_records, result_index->num_removed_records, result_index->num_dirty_records,
+					result_index->total_size_in_kilobytes, result_index->max_frecency);
+	}
+}
+
+// Finds the index record of a cache entry file.
+//
+// @Parameters:
+// 1. index - The Mozilla_2_Index structure that contains the sorted records.
+// 2. cached_filename - The entry file's name, i.e., the entry's hash in hexadecimal.
+//
+// @Returns: The record if the index was loaded and it contains this entry. Otherwise, NULL. This function also returns NULL if
+// the filename isn't a valid hash.
+static Mozilla_2_Index_Record* find_mozilla_cache_version_2_index_record(Mozilla_2_Index* index, const TCHAR* cached_filename)
+{
+	if(index->records == NULL || string_length(cached_filename) != MZ2_HASH_SIZE * 2) return NULL;
+
+	Mozilla_2_Index_Record key = {};
+	for(size_t i = 0; i < MZ2_HASH_SIZE; ++i)
+	{
+		if(!convert_hexadecimal_string_to_byte(cached_filename + i * 2, &key.hash[i])) return NULL;
+	}
+
+	return (Mozilla_2_Index_Record*) bsearch(&key, index->records, index->num_records, sizeof(Mozilla_2_Index_Record), compare_mozilla_2_index_records);
+}
+
+struct Find_Mozilla_2_Files_Params
+{
+	Exporter* exporter;
+	Mozilla_2_Index* index;
+
+	u32 num_skipped_entries;
+	u32 num_removed_entries;
+	u32 num_dirty_entries;
+	u32 num_entries_missing_from_index;
+	u32 num_corrupt_entries;
+};
+
+// The size of each chunk in a cached file. Each one has its own hash stored in the metadata.
+// @Format: kChunkSize in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheFileChunk.h
+static const u32 MZ2_HASH_CHUNK_SIZE = 256 * 1024;
+
+// How many characters are used to describe the integrity of a cache entry. Longer lists of corrupt chunks are truncated.
+static const size_t MAX_MOZILLA_2_INTEGRITY_CHARS = 256;
+
+// How many bytes are read from the end of each cache entry file. This should be enough to contain the metadata in most cases,
+// meaning we only have to read the file once. Larger metadata is read a second time from its offset.
+// @Format: Firefox does something similar with kMinMetadataRead in CacheFileMetadata::ReadMetadata().
+static const u32 MZ2_METADATA_TAIL_READ_SIZE = 16 * 1024;
+
+// A view into part of a metadata key. This string is not null terminated.
+struct Mozilla_2_Key_View
+{
+	char* data;
+	u32 length;
+};
+
+// The values we want from a metadata key. Any view that wasn't found is set to NULL and zero.
+struct Mozilla_2_Key
+{
+	Mozilla_2_Key_View tags;
+	Mozilla_2_Key_View url;
+	Mozilla_2_Key_View partition_scheme;
+	Mozilla_2_Key_View partition_host;
+};
+
+// Converts a hexadecimal digit to its value.
+//
+// @Parameters:
+// 1. digit - The character to convert.
+//
+// @Returns: The digit's value between 0 and 15, or -1 if the character isn't a hexadecimal digit.
+static int get_hexadecimal_digit_value(char digit)
+{
+	if('0' <= digit && digit <= '9') return digit - '0';
+	if('a' <= digit && digit <= 'f') return digit - 'a' + 10;
+	if('A' <= digit && digit <= 'F') return digit - 'A' + 10;
+	return -1;
+}
+
+// Splits a metadata key into views for its tags, URL, and partition key (scheme and host) without allocating any memory.
+// The only modification done to the key is decoding the partition key's percent-encoded characters in place.
+//
+// @Format:
+// This key is a comma separated list of properties, where the first character specifies their type.
+// E.g. "O" = origin attributes, "a" = is anonymous, ":" = the URL (and the last value).
+// Any ":" character before this last value is replaced with the "+" character.
+// 
+// We only want the URL (which always appears at the end), and the partition key (which is part of the
+// origin attributes). These origin attributes start with a "^" character and are followed by a list
+// of URL parameters (e.g. "param1=value1&param2=value2"). The partition key is one of these key-value
+// pairs, and takes the form of "partitionKey=(scheme,host)" or "partitionKey=(scheme,host,port)".
+// These characters "()," are percent encoded.
+//
+// For example:
+// "a,~1614704371,:https://cdn.expl.com/path/file.ext"
+// "O^partitionKey=%28https%2Cexample.com%29,a,:https://cdn.expl.com/path/file.ext"
+//
+// See:
+// - KeyParser::ParseTags() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheFileUtils.cpp
+// - OriginAttributes::PopulateFromSuffix() in https://hg.mozilla.org/mozilla-central/file/tip/caps/OriginAttributes.cpp
+//
+// And also:
+// - GetOriginAttributesWithScheme() in https://hg.mozilla.org/mozilla-central/file/tip/toolkit/components/antitracking/StoragePrincipalHelper.cpp
+// - URLParams::Serialize() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/base/nsURLHelper.cpp
+//
+// @Parameters:
+// 1. key - The metadata key. This string must be null terminated.
+// 2. key_length - The length of the key, not including the null terminator.
+// 3. cached_filename - The name of the cache entry file. Only used for the log messages.
+// 4. result_key - The structure that receives the views into the key.
+//
+// @Returns: True if the key contains a URL. Otherwise, false.
+static bool tokenize_mozilla_cache_version_2_key(char* key, u32 key_length, const TCHAR* cached_filename, Mozilla_2_Key* result_key)
+{
+	ZeroMemory(result_key, sizeof(Mozilla_2_Key));
+
+	char* key_end = key + key_length;
+
+	char* url_separator = key;
+	while(url_separator < key_end && *url_separator != ':') ++url_separator;
+
+	if(url_separator + 1 >= key_end) return false;
+
+	result_key->tags.data = key;
+	result_key->tags.length = (u32) (url_separator - key);
+	result_key->url.data = url_separator + 1;
+	result_key->url.length = (u32) (key_end - result_key->url.data);
+
+	const char PARTITION_KEY_NAME[] = "partitionKey";
+	const u32 PARTITION_KEY_NAME_LENGTH = sizeof(PARTITION_KEY_NAME) - 1;
+
+	for(char* tag = key; tag < url_separator;)
+	{
+		char* tag_end = tag;
+		while(tag_end < url_separator && *tag_end != ',') ++tag_end;
+
+		if(tag_end - tag >= 2 && tag[0] == 'O' && tag[1] == '^')
+		{
+			for(char* pair = tag + 2; pair < tag_end;)
+			{
+				char* pair_end = pair;
+				while(pair_end < tag_end && *pair_end != '&') ++pair_end;
+
+				char* value = pair;
+				while(value < pair_end && *value != '=') ++value;
+
+				if(value == pair_end)
+				{
+					if(pair_end > pair) log_warning("Mozilla Cache Version 2: The key-value pair '%.*hs' in the file '%s' does not contain a value.", (int) (pair_end - pair), pair, cached_filename);
+				}
+				else if((u32) (value - pair) == PARTITION_KEY_NAME_LENGTH && memory_is_equal(pair, PARTITION_KEY_NAME, PARTITION_KEY_NAME_LENGTH))
+				{
+					++value;
+
+					// Decode the value in place since it can only get shorter. An invalid encoded character truncates the value.
+					char* decoded_end = value;
+					for(char* encoded = value; encoded < pair_end; ++encoded)
+					{
+						if(*encoded == '%')
+						{
+							int high = (encoded + 1 < pair_end) ? (get_hexadecimal_digit_value(encoded[1])) : (-1);
+							int low = (encoded + 2 < pair_end) ? (get_hexadecimal_digit_value(encoded[2])) : (-1);
+							if(high == -1 || low == -1) break;
+
+							*decoded_end = (char) ((high << 4) | low);
+							encoded += 2;
+						}
+						else
+						{
+							*decoded_end = *encoded;
+						}
+
+						++decoded_end;
+					}
+
+					// Find the first two non-empty tokens separated by the characters "()," (i.e. the scheme and host).
+					// We don't care about the port.
+					const int MAX_PARTITION_KEY_TOKENS = 2;
+					Mozilla_2_Key_View tokens[MAX_PARTITION_KEY_TOKENS] = {};
+					int num_tokens = 0;
+					for(char* token = value; token < decoded_end && num_tokens < MAX_PARTITION_KEY_TOKENS;)
+					{
+						char* token_end = token;
+						while(token_end < decoded_end && *token_end != '(' && *token_end != ')' && *token_end != ',') ++token_end;
+						
+						if(token_end > token)
+						{
+							tokens[num_tokens].data = token;
+							tokens[num_tokens].length = (u32) (token_end - token);
+							++num_tokens;
+						}
+
+						token = token_end + 1;
+					}
+
+					if(num_tokens == MAX_PARTITION_KEY_TOKENS)
+					{
+						result_key->partition_scheme = tokens[0];
+						result_key->partition_host = tokens[1];
+					}
+					else
+					{
+						log_warning("Mozilla Cache Version 2: The partition key '%.*hs' in the file '%s' does not contain a scheme and host.", (int) (decoded_end - value), value, cached_filename);
+					}
+
+					// We don't care about the other parameters.
+					break;
+				}
+
+				pair = pair_end + 1;
+			}
+
+			// We don't care about the other tags.
+			break;
+		}
+
+		tag = tag_end + 1;
+	}
+
+	return true;
+}
+
+// Checks the integrity of a cache entry (version 2) by comparing the hashes stored at the beginning of its metadata with
+// the ones computed from the file's contents. The metadata hash covers everything after itself until the metadata offset
+// at the end of the file, and each chunk hash covers MZ2_HASH_CHUNK_SIZE bytes of the cached file (except the last one,
+// which may be smaller).
+//
+// The chunks are read sequentially into a single buffer that is only used during this function.
+//
+// @Parameters:
+// 1. arena - The Arena structure where the chunk buffer is temporarily stored.
+// 2. full_location_on_cache - The path to the cache entry file.
+// 3. cached_filename - The name of this file. Only used for logging.
+// 4. metadata - The beginning of the metadata, which starts with the metadata hash followed by each chunk's hash.
+// This data must not have been modified yet.
+// 5. metadata_size - The size of the metadata in bytes, excluding the metadata offset at the end of the file.
+// 6. metadata_offset - The metadata offset, which is also the size of the cached file.
+// 7. num_hashes - The number of chunk hashes.
+// 8. result_integrity - The resulting string that describes the entry's integrity. This string must be able to hold
+// MAX_MOZILLA_2_INTEGRITY_CHARS characters. For example: "OK", "Corrupt Metadata", "Corrupt Chunks: 0, 3", or "Truncated".
+//
+// @Returns: True if every hash matched. Otherwise, false.
+static bool verify_mozilla_cache_version_2_entry(	Arena* arena, const TCHAR* full_location_on_cache, const TCHAR* cached_filename,
+													const void* metadata, u32 metadata_size, u32 metadata_offset, u32 num_hashes,
+													TCHAR* result_integrity)
+{
+	bool is_metadata_intact = true;
+	bool is_truncated = false;
+	u32 num_corrupt_chunks = 0;
+	TCHAR corrupt_chunks[MAX_MOZILLA_2_INTEGRITY_CHARS] = T("");
+
+	u32 stored_metadata_hash = 0;
+	CopyMemory(&stored_metadata_hash, metadata, sizeof(stored_metadata_hash));
+	BIG_ENDIAN_TO_HOST(stored_metadata_hash);
+
+	const void* hashed_metadata = advance_bytes(metadata, sizeof(stored_metadata_hash));
+	u32 hashed_metadata_size = metadata_size - (u32) sizeof(stored_metadata_hash);
+	is_metadata_intact = (get_mozilla_cache_hash(hashed_metadata, hashed_metadata_size) == stored_metadata_hash);
+
+	if(num_hashes > 0)
+	{
+		HANDLE file_handle = create_handle(full_location_on_cache, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+
+		if(file_handle != INVALID_HANDLE_VALUE)
+		{
+			lock_arena(arena);
+			void* chunk = push_arena(arena, MZ2_HASH_CHUNK_SIZE, u8);
+			const u16* stored_chunk_hashes = (const u16*) hashed_metadata;
+
+			for(u32 i = 0; i < num_hashes; ++i)
+			{
+				u32 chunk_offset = i * MZ2_HASH_CHUNK_SIZE;
+				u32 chunk_size = MIN(metadata_offset - chunk_offset, MZ2_HASH_CHUNK_SIZE);
+
+				if(chunk == NULL || !read_file_chunk(file_handle, chunk, chunk_size, chunk_offset))
+				{
+					log_error("Mozilla Cache Version 2: Failed to read chunk %I32u of %I32u in the file '%s'.", i + 1, num_hashes, cached_filename);
+					is_truncated = true;
+					break;
+				}
+
+				u16 stored_chunk_hash = 0;
+				CopyMemory(&stored_chunk_hash, stored_chunk_hashes + i, sizeof(stored_chunk_hash));
+				BIG_ENDIAN_TO_HOST(stored_chunk_hash);
+
+				u16 chunk_hash = (u16) (get_mozilla_cache_hash(chunk, chunk_size) & 0xFFFF);
+
+				if(chunk_hash != stored_chunk_hash)
+				{
+					TCHAR chunk_index[MAX_INT_32_CHARS] = T("");
+					convert_u32_to_string(i, chunk_index);
+
+					if(num_corrupt_chunks > 0) StringCchCat(corrupt_chunks, MAX_MOZILLA_2_INTEGRITY_CHARS, T(", "));
+					StringCchCat(corrupt_chunks, MAX_MOZILLA_2_INTEGRITY_CHARS, chunk_index);
+					++num_corrupt_chunks;
+				}
+			}
+
+			clear_arena(arena);
+			unlock_arena(arena);
+			safe_close_handle(&file_handle);
+		}
+		else
+		{
+			log_error("Mozilla Cache Version 2: Failed to open the file '%s' to verify its chunks with the error code %lu.", cached_filename, GetLastError());
+			is_truncated = true;
+		}
+	}
+
+	bool is_intact = is_metadata_intact && !is_truncated && (num_corrupt_chunks == 0);
+
+	if(is_intact)
+	{
+		StringCchCopy(result_integrity, MAX_MOZILLA_2_INTEGRITY_CHARS, T("OK"));
+	}
+	else
+	{
+		result_integrity[0] = T('\0');
+
+		#define APPEND_INTEGRITY_PART(part)\
+		do\
+		{\
+			if(!string_is_empty(result_integrity)) StringCchCat(result_integrity, MAX_MOZILLA_2_INTEGRITY_CHARS, T("; "));\
+			StringCchCat(result_integrity, MAX_MOZILLA_2_INTEGRITY_CHARS, part);\
+		} while(false, false)
+
+		if(!is_metadata_intact) APPEND_INTEGRITY_PART(T("Corrupt Metadata"));
+
+		if(num_corrupt_chunks > 0)
+		{
+			APPEND_INTEGRITY_PART(T("Corrupt Chunks: "));
+			StringCchCat(result_integrity, MAX_MOZILLA_2_INTEGRITY_CHARS, corrupt_chunks);
+		}
+
+		if(is_truncated) APPEND_INTEGRITY_PART(T("Truncated"));
+
+		#undef APPEND_INTEGRITY_PART
+
+		log_warning("Mozilla Cache Version 2: The file '%s' failed the integrity check with the result '%s'.", cached_filename, result_integrity);
+	}
+
+	return is_intact;
+}
+
+// Called every time a file is found in the Mozilla cache directory (version 2). Used to export every cache entry.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
 //
 // @Returns: True.
 static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
@@ -1178,6 +2197,33 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 	TCHAR* full_location_on_cache = callback_info->object_path;
 	u64 total_file_size = callback_info->object_size;
 
+	// Skip any entries that Firefox no longer considers valid before opening their files. If the -recover-mozilla option is used,
+	// these are exported instead since their data may be recoverable, and are marked in the exporter warning column. Entries that
+	// aren't in the index are always exported since the index may be outdated.
+	u32 index_flags = 0;
+	TCHAR frecency[MAX_INT_32_CHARS] = T("");
+	if(find_params->index->records != NULL)
+	{
+		Mozilla_2_Index_Record* record = find_mozilla_cache_version_2_index_record(find_params->index, cached_filename);
+		if(record == NULL)
+		{
+			++(find_params->num_entries_missing_from_index);
+		}
+		else
+		{
+			index_flags = record->flags;
+
+			if( (index_flags & (MZ2_INDEX_REMOVED | MZ2_INDEX_DIRTY)) && !exporter->recover_mozilla_entries )
+			{
+				++(find_params->num_skipped_entries);
+				return true;
+			}
+
+			// The frecency is taken from the index so that it's available for every metadata version.
+			convert_u32_to_string(record->frecency, frecency);
+		}
+	}
+
 	u32 metadata_offset = 0; // Also the cached file's size.
 
 	if(total_file_size < sizeof(metadata_offset))
@@ -1187,59 +2233,119 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 	}
 
 	// @Format: CacheFileMetadata::ReadMetadata() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheFileMetadata.cpp
-	if(!read_file_chunk(full_location_on_cache, &metadata_offset, sizeof(metadata_offset), total_file_size - sizeof(metadata_offset)))
+	// Read the end of the file once, which includes the metadata offset and (usually) the whole metadata.
+	u32 tail_size = (u32) MIN(total_file_size, (u64) MZ2_METADATA_TAIL_READ_SIZE);
+	u64 tail_offset = total_file_size - tail_size;
+	void* tail = push_arena(arena, tail_size, u8);
+
+	if(!read_file_chunk(full_location_on_cache, tail, tail_size, tail_offset))
 	{
 		log_error("Mozilla Cache Version 2: Failed to read the metadata offset in the file '%s'.", cached_filename);
+		clear_arena(arena);
 		return true;
 	}
 
+	CopyMemory(&metadata_offset, advance_bytes(tail, tail_size - sizeof(metadata_offset)), sizeof(metadata_offset));
 	BIG_ENDIAN_TO_HOST(metadata_offset);
 
+	// Files that were only partially written (e.g. if the browser crashed) usually fail the checks below. These are skipped
+	// unless we're verifying each entry's integrity, in which case the whole file is exported and marked as truncated.
+	bool verify_integrity = exporter->verify_mozilla_integrity;
+	bool is_truncated = false;
+
 	if(metadata_offset > total_file_size)
 	{
-		log_error("Mozilla Cache Version 2: The metadata offset 0x%08X goes past the end of the file '%s'. This cached file will not be exported.", metadata_offset, cached_filename);
-		return true;
+		if(!verify_integrity)
+		{
+			log_error("Mozilla Cache Version 2: The metadata offset 0x%08X goes past the end of the file '%s'. This cached file will not be exported.", metadata_offset, cached_filename);
+			clear_arena(arena);
+			return true;
+		}
+
+		log_warning("Mozilla Cache Version 2: The metadata offset 0x%08X goes past the end of the file '%s'. This cached file will be exported as truncated.", metadata_offset, cached_filename);
+		is_truncated = true;
 	}
 
 	// @Format: CacheFileMetadata::OnDataRead() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheFileMetadata.cpp
-	const u32 HASH_CHUNK_SIZE = 256 * 1024;
-	u32 num_hashes = (metadata_offset == 0) ? (0) : (((u32) metadata_offset - 1) / HASH_CHUNK_SIZE + 1);
-	u32 hash_size = sizeof(u32) + num_hashes * sizeof(u16);
-	
-	u32 remaining_metadata_size = (u32) total_file_size - metadata_offset;
-	u32 minimum_metadata_size = hash_size + sizeof(Mozilla_2_Metadata_Header_Version_1_And_2) + sizeof(metadata_offset);
+	u32 num_hashes = 0;
+	u32 hash_size = 0;
+	u32 remaining_metadata_size = 0;
 
-	if(remaining_metadata_size < minimum_metadata_size)
+	if(!is_truncated)
 	{
-		log_error("Mozilla Cache Version 2: The size of the metadata in file '%s' was %I32u when at least %I32u bytes were expected. This cached file will not be exported.", cached_filename, remaining_metadata_size, minimum_metadata_size);
-		return true;
+		num_hashes = (metadata_offset == 0) ? (0) : ((metadata_offset - 1) / MZ2_HASH_CHUNK_SIZE + 1);
+		hash_size = sizeof(u32) + num_hashes * sizeof(u16);
+		
+		remaining_metadata_size = (u32) total_file_size - metadata_offset;
+		u32 minimum_metadata_size = hash_size + sizeof(Mozilla_2_Metadata_Header_Version_1_And_2) + sizeof(metadata_offset);
+
+		if(remaining_metadata_size < minimum_metadata_size)
+		{
+			if(!verify_integrity)
+			{
+				log_error("Mozilla Cache Version 2: The size of the metadata in file '%s' was %I32u when at least %I32u bytes were expected. This cached file will not be exported.", cached_filename, remaining_metadata_size, minimum_metadata_size);
+				clear_arena(arena);
+				return true;
+			}
+
+			log_warning("Mozilla Cache Version 2: The size of the metadata in file '%s' was %I32u when at least %I32u bytes were expected. This cached file will be exported as truncated.", cached_filename, remaining_metadata_size, minimum_metadata_size);
+			is_truncated = true;
+		}
 	}
 	
-	void* metadata = push_arena(arena, remaining_metadata_size, u8);
+	void* metadata = NULL;
 
-	if(!read_file_chunk(full_location_on_cache, metadata, remaining_metadata_size, metadata_offset))
+	if(is_truncated)
+	{
+		// Skip reading the metadata.
+	}
+	else if(metadata_offset >= tail_offset)
 	{
-		log_error("Mozilla Cache Version 2: Failed to read the metadata in the file '%s'.", cached_filename);
-		metadata = NULL;
+		metadata = advance_bytes(tail, (u32) (metadata_offset - tail_offset));
 	}
+	else
+	{
+		// The metadata didn't fit in the data we read above.
+		metadata = push_arena(arena, remaining_metadata_size, u8);
 
-	TCHAR cached_file_size[MAX_INT_32_CHARS] = T("");
-	convert_u32_to_string(metadata_offset, cached_file_size);
+		if(!read_file_chunk(full_location_on_cache, metadata, remaining_metadata_size, metadata_offset))
+		{
+			log_error("Mozilla Cache Version 2: Failed to read the metadata in the file '%s'.", cached_filename);
+			metadata = NULL;
 
-	TCHAR access_count[MAX_INT_32_CHARS] = T("");
+			// We can't verify an entry without its metadata, so it's treated like any other file with an incomplete metadata
+			// block. Otherwise, it would be reported as intact.
+			if(verify_integrity)
+			{
+				log_warning("Mozilla Cache Version 2: The file '%s' will be exported as truncated since its metadata could not be read.", cached_filename);
+				is_truncated = true;
+			}
+		}
+	}
 
-	TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	// The integrity is only checked after the entry passes the -filter-entries option. Since the key is modified in place
+	// when parsing the metadata, we'll verify an unmodified copy of it.
+	void* metadata_to_verify = NULL;
+	u32 metadata_to_verify_size = 0;
 
-	const size_t MAX_CACHE_VERSION_CHARS = MAX_INT_32_CHARS + 3 + MAX_INT_32_CHARS;
-	TCHAR cache_version[MAX_CACHE_VERSION_CHARS] = T("");
+	if(verify_integrity && metadata != NULL)
+	{
+		metadata_to_verify_size = remaining_metadata_size - (u32) sizeof(metadata_offset);
+		metadata_to_verify = push_and_copy_to_arena(arena, metadata_to_verify_size, u8, metadata, metadata_to_verify_size);
+	}
+
+	// A truncated file is exported as a whole since we don't know where the cached file's contents end.
+	u64 cached_file_size_value = (is_truncated) ? (total_file_size) : (metadata_offset);
 
 	TCHAR* url = NULL;
 	TCHAR* request_origin = NULL;
 	TCHAR* partition_key = NULL;
 	Http_Headers headers = {};
 
+	// @Format: Version 3 includes every value from the previous versions.
+	Mozilla_2_Metadata_Header_Version_3 metadata_header = {};
+	bool is_version_supported = false;
+
 	if(metadata != NULL)
 	{
 		metadata = advance_bytes(metadata, hash_size);
@@ -1264,11 +2370,9 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 			remaining_metadata_size -= sizeof(variable);\
 		} while(false, false)
 
-		// @Format: Version 3 includes every value from the previous versions.
-		Mozilla_2_Metadata_Header_Version_3 metadata_header = {};
 		READ_INTEGER(metadata_header.version);
 
-		bool is_version_supported = true;
+		is_version_supported = true;
 		if(metadata_header.version <= 2)
 		{
 			READ_INTEGER(metadata_header.access_count);
@@ -1303,110 +2407,34 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 
 		if(is_version_supported)
 		{
-			convert_u32_to_string(metadata_header.access_count, access_count);
-
-			format_time64_t_date_time(metadata_header.last_access_time, last_access_time);
-			format_time64_t_date_time(metadata_header.last_modified_time, last_modified_time);
-			format_time64_t_date_time(metadata_header.expiry_time, expiry_time);
-
-			StringCchPrintf(cache_version, MAX_CACHE_VERSION_CHARS, T("2.i%I32u.e%I32u"), find_params->index_version, metadata_header.version);
-
 			u32 key_size = metadata_header.key_length + 1;
-			if(remaining_metadata_size >= key_size)
+			// Avoid wrapping around the key size since we'll write the key's null terminator.
+			if(metadata_header.key_length < remaining_metadata_size)
 			{
-				// @Format:
-				// Extract the URL and partition key (scheme + host) from the metadata key.
-				// This key is a comma separated list of properties, where the first character specifies their type.
-				// E.g. "O" = origin attributes, "a" = is anonymous, ":" = the URL (and the last value).
-				// Any ":" character before this last value is replaced with the "+" character.
-				// 
-				// We only want the URL (which always appears at the end), and the partition key (which is part of the
-				// origin attributes). These origin attributes start with a "^" character and are followed by a list
-				// of URL parameters (e.g. "param1=value1&param2=value2"). The partition key is one of these key-value
-				// pairs, and takes the form of "partitionKey=(scheme,host)" or "partitionKey=(scheme,host,port)".
-				// These characters "()," are percent encoded.
-				//
-				// For example:
-				// "a,~1614704371,:https://cdn.expl.com/path/file.ext"
-				// "O^partitionKey=%28https%2Cexample.com%29,a,:https://cdn.expl.com/path/file.ext"
-				//
-				// See:
-				// - KeyParser::ParseTags() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/cache2/CacheFileUtils.cpp
-				// - OriginAttributes::PopulateFromSuffix() in https://hg.mozilla.org/mozilla-central/file/tip/caps/OriginAttributes.cpp
-				//
-				// And also:
-				// - GetOriginAttributesWithScheme() in https://hg.mozilla.org/mozilla-central/file/tip/toolkit/components/antitracking/StoragePrincipalHelper.cpp
-				// - URLParams::Serialize() in https://hg.mozilla.org/mozilla-central/file/tip/netwerk/base/nsURLHelper.cpp
-				TCHAR* full_key = convert_ansi_string_to_tchar(arena, (char*) metadata);
-
-				String_Array<TCHAR>* split_key = split_string(arena, full_key, T(":"), 1);
+				// Extract the URL and partition key (scheme + host) from the metadata key. We'll only convert these
+				// values to TCHAR strings, instead of the whole key.
+				char* full_key = (char*) metadata;
+				full_key[metadata_header.key_length] = '\0';
 
-				if(split_key->num_strings == 2)
+				Mozilla_2_Key key = {};
+				if(tokenize_mozilla_cache_version_2_key(full_key, metadata_header.key_length, cached_filename, &key))
 				{
-					TCHAR* tags = split_key->strings[0];
-					url = split_key->strings[1];
-					url = decode_url(arena, url);
-
-					String_Array<TCHAR>* split_tags = split_string(arena, tags, T(","));
+					// The URL is the last value in the key, meaning it's null terminated.
+					url = convert_ansi_string_to_tchar(arena, key.url.data);
 
-					for(int i = 0; i < split_tags->num_strings; ++i)
+					if(key.partition_scheme.data != NULL)
 					{
-						TCHAR* tag = split_tags->strings[i];
-
-						if(string_begins_with(tag, T("O^")))
-						{
-							String_Array<TCHAR>* tag_params = split_string(arena, tag + 2, T("&"));
-
-							for(int j = 0; j < tag_params->num_strings; ++j)
-							{
-								TCHAR* pair = tag_params->strings[j];
-								String_Array<TCHAR>* split_pair = split_string(arena, pair, T("="), 1);
-
-								if(split_pair->num_strings == 2)
-								{
-									TCHAR* key = split_pair->strings[0];
-									TCHAR* value = split_pair->strings[1];
-
-									if(strings_are_equal(key, T("partitionKey")))
-									{
-										value = decode_url(arena, value);
-										String_Array<TCHAR>* url_parts = split_string(arena, value, T("(),"), 2);
-
-										// We split two times at most for the scheme, host, and port, but we only
-										// care about the first two.
-										if(url_parts->num_strings >= 2)
-										{
-											TCHAR* scheme = url_parts->strings[0];
-											TCHAR* host = url_parts->strings[1];
-
-											size_t num_partition_key_chars = string_length(scheme) + 3 + string_length(host) + 1;
-											partition_key = push_array_to_arena(arena, num_partition_key_chars, TCHAR);
-
-											StringCchPrintf(partition_key, num_partition_key_chars, T("%s://%s"), scheme, host);
-										}
-										else
-										{
-											log_warning("Mozilla Cache Version 2: The partition key '%s' in the file '%s' does not contain a scheme and host.", value, cached_filename);
-										}
-
-										// We don't care about the other parameters.
-										break;
-									}
-								}
-								else
-								{
-									log_warning("Mozilla Cache Version 2: The key-value pair '%s' in the file '%s' does not contain a value.", pair, cached_filename);
-								}
-							}
+						size_t num_partition_key_chars = key.partition_scheme.length + 3 + key.partition_host.length + 1;
+						partition_key = push_array_to_arena(arena, num_partition_key_chars, TCHAR);
 
-							// We don't care about the other tags.
-							break;
-						}
+						StringCchPrintf(partition_key, num_partition_key_chars, T("%.*hs://%.*hs"),
+										(int) key.partition_scheme.length, key.partition_scheme.data,
+										(int) key.partition_host.length, key.partition_host.data);
 					}
 				}
 				else
 				{
-					log_warning("Mozilla Cache Version 2: The key '%s' in the file '%s' does not contain the URL.", full_key, cached_filename);
+					log_warning("Mozilla Cache Version 2: The key '%hs' in the file '%s' does not contain the URL.", full_key, cached_filename);
 				}
 
 				metadata = advance_bytes(metadata, key_size);
@@ -1421,29 +2449,67 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 		}
 	}
 
-	// Use the request origin found in the metadata elements if there was one.
-	// Otherwise, use the partition key we extracted from the metadata key.
-	if(request_origin == NULL)
+	Filterable_Cache_Entry entry_to_filter = {};
+	entry_to_filter.url = url;
+	entry_to_filter.content_type = headers.content_type;
+	entry_to_filter.has_size = true;
+	entry_to_filter.size = cached_file_size_value;
+	entry_to_filter.last_modified_time = metadata_header.last_modified_time;
+
+	if(!cache_entry_passes_filter(exporter, &entry_to_filter)) return true;
+
+	TCHAR integrity[MAX_MOZILLA_2_INTEGRITY_CHARS] = T("");
+	bool is_intact = true;
+
+	if(is_truncated)
 	{
-		request_origin = partition_key;
+		StringCchCopy(integrity, MAX_MOZILLA_2_INTEGRITY_CHARS, T("Truncated"));
+		is_intact = false;
+	}
+	else if(metadata_to_verify != NULL)
+	{
+		is_intact = verify_mozilla_cache_version_2_entry(	arena, full_location_on_cache, cached_filename,
+															metadata_to_verify, metadata_to_verify_size,
+															metadata_offset, num_hashes, integrity);
 	}
 
-	// The file we'll copy will always be the intermediate temporary file that was previously created (unless we fail
-	// to extract some chunks from the cached file).
-	TCHAR* copy_source_path = NULL;
-	TCHAR* temporary_file_path = find_params->temporary_file_path;
-	HANDLE temporary_file_handle = find_params->temporary_file_handle;
+	if(exporter->skip_corrupt_mozilla_entries && !is_intact)
+	{
+		++(find_params->num_corrupt_entries);
+		clear_arena(arena);
+		return true;
+	}
+
+	TCHAR cached_file_size[MAX_INT_64_CHARS] = T("");
+	convert_u64_to_string(cached_file_size_value, cached_file_size);
+
+	TCHAR access_count[MAX_INT_32_CHARS] = T("");
+
+	TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	TCHAR expiry_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
 
-	// Again, the metadata offset is the cached file's size.
-	bool copy_success = empty_file(temporary_file_handle) && copy_file_chunks(arena, full_location_on_cache, metadata_offset, 0, temporary_file_handle);
+	const size_t MAX_CACHE_VERSION_CHARS = MAX_INT_32_CHARS + 3 + MAX_INT_32_CHARS;
+	TCHAR cache_version[MAX_CACHE_VERSION_CHARS] = T("");
 
-	if(copy_success)
+	if(is_version_supported)
 	{
-		copy_source_path = temporary_file_path;
+		convert_u32_to_string(metadata_header.access_count, access_count);
+
+		format_time64_t_date_time(metadata_header.last_access_time, last_access_time);
+		format_time64_t_date_time(metadata_header.last_modified_time, last_modified_time);
+		format_time64_t_date_time(metadata_header.expiry_time, expiry_time);
+
+		StringCchPrintf(cache_version, MAX_CACHE_VERSION_CHARS, T("2.i%I32u.e%I32u"), find_params->index->version, metadata_header.version);
 	}
-	else
+
+	if(url != NULL) url = decode_url(arena, url);
+
+	// Use the request origin found in the metadata elements if there was one.
+	// Otherwise, use the partition key we extracted from the metadata key.
+	if(request_origin == NULL)
 	{
-		log_error("Mozilla Cache Version 2: Failed to copy the cached file of size %I32u in the file '%s' to the temporary exporter directory.", metadata_offset, cached_filename);
+		request_origin = partition_key;
 	}
 
 	TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
@@ -1455,14 +2521,19 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 		{last_modified_time}, {last_access_time}, {expiry_time}, {access_count},
 		{/* Response */}, {/* Server */}, {/* Cache Control */}, {/* Pragma */},
 		{/* Content Type */}, {/* Content Length */}, {/* Content Range */}, {/* Content Encoding */},
-		{/* Decompressed File Size */}, {/* Location On Cache */}, {exporter->browser_name}, {cache_version},
+		{/* Decompressed File Size */}, {/* Location On Cache */}, {exporter->browser_name}, {cache_version}, {integrity}, {frecency},
 		{/* Missing File */}, {/* Location In Output */}, {/* Copy Error */}, {/* Exporter Warning */},
 		{/* Custom File Group */}, {/* Custom URL Group */}, {/* SHA-256 */}
 	};
 	_STATIC_ASSERT(_countof(csv_row) == CSV_NUM_COLUMNS);
 
 	Exporter_Params exporter_params = {};
-	exporter_params.copy_source_path = copy_source_path;
+	exporter_params.copy_source_path = full_location_on_cache;
+	// The cached file's contents are stored at the beginning of the file, and the metadata offset is also their size.
+	// We'll export this byte range directly instead of extracting it to an intermediate temporary file first.
+	exporter_params.use_copy_source_range = true;
+	exporter_params.copy_source_offset = 0;
+	exporter_params.copy_source_size = cached_file_size_value;
 	exporter_params.url = url;
 	exporter_params.filename = NULL; // Comes from the URL.
 	exporter_params.request_origin = request_origin;
@@ -1471,6 +2542,19 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_mozilla_cache_version_2_files_callback)
 	exporter_params.full_location_on_cache = full_location_on_cache;
 	exporter_params.file_info = NULL; // We don't want to use the file's real name on disk if we can't use the URL to determine the output filename.
 
+	// Only add these warnings now since the entry may still be skipped above.
+	if(index_flags & MZ2_INDEX_REMOVED)
+	{
+		add_exporter_warning_message(exporter, "The index file marks this entry as removed.");
+		++(find_params->num_removed_entries);
+	}
+
+	if(index_flags & MZ2_INDEX_DIRTY)
+	{
+		add_exporter_warning_message(exporter, "The index file marks this entry as dirty.");
+		++(find_params->num_dirty_entries);
+	}
+
 	export_cache_entry(exporter, csv_row, &exporter_params);
 
 	return true;
@@ -1504,54 +2588,42 @@ static void export_mozilla_cache_version_2(Exporter* exporter)
 
 	PathCombine(exporter->index_path, exporter->cache_path, T("..\\index"));
 
-	Mozilla_2_Index_Header index_header = {};
-	if(read_first_file_bytes(exporter->index_path, &index_header, sizeof(index_header)))
-	{
-		BIG_ENDIAN_TO_HOST(index_header.version);
-		BIG_ENDIAN_TO_HOST(index_header.last_write_time);
-		BIG_ENDIAN_TO_HOST(index_header.dirty_flag);
-		BIG_ENDIAN_TO_HOST(index_header.used_cache_size);
-
-		if(index_header.version > MZ2_MAX_INDEX_VERSION)
-		{
-			log_warning("Mozilla Cache Version 2: Found the unsupported version %I32u in the index file '%s'.", index_header.version, exporter->index_path);
-			_ASSERT(false);
-		}
-
-		if(index_header.dirty_flag != 0)
-		{
-			log_warning("Mozilla Cache Version 2: The index file's dirty flag is set to 0x%08X.", index_header.dirty_flag);
-		}
-	}
-	else
-	{
-		log_warning("Mozilla Cache Version 2: Could not read the header from the index file.");
-	}
+	// The index records are kept in memory while the entries are being exported.
+	Mozilla_2_Index index = {};
+	load_mozilla_cache_version_2_index(exporter, &index);
 
 	Find_Mozilla_2_Files_Params params = {};
 	params.exporter = exporter;
-	params.index_version = index_header.version;
-	params.temporary_file_path[0] = T('\0');
-	params.temporary_file_handle = INVALID_HANDLE_VALUE;
+	params.index = &index;
 
 	// E.g. "C:\Users\<Username>\AppData\Local\<Vendor and Browser>\Profiles\<Profile Name>\cache2\entries".
 	exporter->browser_name = find_path_component(arena, exporter->cache_path, -5);
 	exporter->browser_profile = find_path_component(arena, exporter->cache_path, -3);
 
 	lock_arena(arena);
+	traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, false, find_mozilla_cache_version_2_files_callback, &params);
+	unlock_arena(arena);
 
-	if(create_temporary_exporter_file(exporter, params.temporary_file_path, &params.temporary_file_handle))
+	if(index.records != NULL)
 	{
-		traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, false, find_mozilla_cache_version_2_files_callback, &params);
+		if(exporter->recover_mozilla_entries)
+		{
+			log_info("Mozilla Cache Version 2: Exported %I32u removed and %I32u dirty entries, and found %I32u entries that were missing from the index.", params.num_removed_entries, params.num_dirty_entries, params.num_entries_missing_from_index);
+		}
+		else
+		{
+			log_info("Mozilla Cache Version 2: Skipped %I32u removed or dirty entries and found %I32u entries that were missing from the index.", params.num_skipped_entries, params.num_entries_missing_from_index);
+		}
 	}
 	else
 	{
-		log_error("Mozilla Cache Version 2: Failed to create the intermediate file in the temporary exporter directory.");
+		log_warning("Mozilla Cache Version 2: Exported every entry without checking if they were removed since the index file could not be used.");
 	}
 
-	unlock_arena(arena);
-
-	safe_close_handle(&params.temporary_file_handle);
+	if(exporter->skip_corrupt_mozilla_entries)
+	{
+		log_info("Mozilla Cache Version 2: Skipped %I32u entries that failed the integrity check.", params.num_corrupt_entries);
+	}
 
 	reset_temporary_exporter_members(exporter);
 }
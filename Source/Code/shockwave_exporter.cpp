@@ -16,6 +16,9 @@
 	The names of these cached files start with "mp", followed by at least six more characters (e.g. mpb02684.w3d). The exporter
 	will also copy any Xtras (.x32 files) in the Temporary Files directory and its subdirectories.
 
+	The chunks in each cached Director movie or cast (including Afterburner compressed ones) may also be listed in a separate CSV
+	file, and their bitmaps and sounds may be extracted to the output directory. See: read_director_file().
+
 	There are some other locations in the AppData and Local Low AppData directories that should be checked for cached files
 	and Xtras:
 	- 98, ME 				<AppData or Local Low AppData>\<Macromedia or Adobe>\<Shockwave Version>\<Cache Type>
@@ -63,6 +66,23 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 
 static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 
+// The columns of the separate CSV file that lists the chunks in each cached Director file. The location on cache matches the one
+// in the main CSV file and identifies the cache entry.
+static Csv_Type CHUNK_CSV_COLUMN_TYPES[] =
+{
+	CSV_LOCATION_ON_CACHE, CSV_RESOURCE_ID, CSV_CHUNK_ID, CSV_COMPRESSED_SIZE, CSV_UNCOMPRESSED_SIZE, CSV_LOCATION_IN_OUTPUT
+};
+
+static const int CHUNK_CSV_NUM_COLUMNS = _countof(CHUNK_CSV_COLUMN_TYPES);
+
+// The separate CSV file that lists the chunks in each cached Director file. See: print_director_chunks().
+struct Director_Chunk_Csv
+{
+	HANDLE file_handle;
+	TCHAR file_path[MAX_PATH_CHARS];
+	bool listed_at_least_one_chunk;
+};
+
 // Since cached Shockwave files can be stored on disk without a file extension, we'll make it easier to tell what kind of file was
 // found by reading and interpreting their first bytes.
 
@@ -116,84 +136,976 @@ static const char SHOCKWAVE_AUDIO_SIGNATURE[] = "MACR";
 static const u32 SHOCKWAVE_AUDIO_SIGNATURE_SIZE = sizeof(SHOCKWAVE_AUDIO_SIGNATURE) - 1;
 static const u32 MIN_SHOCKWAVE_AUDIO_READ_SIZE = SHOCKWAVE_AUDIO_SIGNATURE_OFFSET + SHOCKWAVE_AUDIO_SIGNATURE_SIZE;
 
+static const u32 MAX_DIRECTOR_SIGNATURE_READ_SIZE = MAX(MIN_RIFX_CHUNK_READ_SIZE, MIN_SHOCKWAVE_AUDIO_READ_SIZE);
+
 // Determines the type of a Director file from its first bytes.
 //
 // @Parameters:
-// 1. file_path - The path of the file to check.
+// 1. file_buffer - The first bytes of the file to check.
+// 2. num_bytes_read - The number of bytes in this buffer. This may be less than MAX_DIRECTOR_SIGNATURE_READ_SIZE for small files.
 //
 // @Returns: The Director file type as a constant string. If this file doesn't match any known Director type, this function returns NULL.
-static TCHAR* get_director_file_type_from_file_signature(const TCHAR* file_path)
+static TCHAR* get_director_file_type_from_file_signature(const u8* file_buffer, u32 num_bytes_read)
 {
 	TCHAR* file_type = NULL;
 
-	const u32 MAX_READ_SIZE = MAX(MIN_RIFX_CHUNK_READ_SIZE, MIN_SHOCKWAVE_AUDIO_READ_SIZE);
-	u8 file_buffer[MAX_READ_SIZE] = {};
+	if(num_bytes_read >= MIN_RIFX_CHUNK_READ_SIZE)
+	{
+		u32 chunk_id = 0;
+		u32 chunk_format = 0;
+
+		CopyMemory(&chunk_id, &file_buffer[0], sizeof(chunk_id));
+		CopyMemory(&chunk_format, &file_buffer[8], sizeof(chunk_format));
+		
+		BIG_ENDIAN_TO_HOST(chunk_id);
+		BIG_ENDIAN_TO_HOST(chunk_format);
+
+		// This would work without swapping the byte order because we check both big and little endian format signatures.
+		// But it'll be useful for the other file types.
+		if(chunk_id == CHUNK_RIFX_BIG_ENDIAN || chunk_id == CHUNK_RIFX_LITTLE_ENDIAN)
+		{
+			switch(chunk_format)
+			{
+				case(FORMAT_DIRECTOR_MOVIE_OR_CAST_BIG_ENDIAN):
+				case(FORMAT_DIRECTOR_MOVIE_OR_CAST_LITTLE_ENDIAN):
+				{
+					file_type = T("Director Movie or Cast");
+				} break;
+
+				case(FORMAT_SHOCKWAVE_MOVIE_BIG_ENDIAN):
+				case(FORMAT_SHOCKWAVE_MOVIE_LITTLE_ENDIAN):
+				{
+					file_type = T("Shockwave Movie");
+				} break;
+
+				case(FORMAT_SHOCKWAVE_CAST_BIG_ENDIAN):
+				case(FORMAT_SHOCKWAVE_CAST_LITTLE_ENDIAN):
+				{
+					file_type = T("Shockwave Cast");
+				} break;
+			}				
+		}
+		else if(chunk_id == CHUNK_RIFF_BIG_ENDIAN && chunk_format == FORMAT_XTRA_PACKAGE_BIG_ENDIAN)
+		{
+			file_type = T("Xtra-Package");
+		}
+		// This isn't a RIFF or RIFX container, but we'll take advantage of this structure to check this file signature.
+		else if(chunk_id == SHOCKWAVE_3D_WORLD_SIGNATURE)
+		{
+			file_type = T("Shockwave 3D World");
+		}
+	}
+
+	if(file_type == NULL && num_bytes_read >= MIN_SHOCKWAVE_AUDIO_READ_SIZE)
+	{
+		if(memory_is_equal(	&file_buffer[SHOCKWAVE_AUDIO_SIGNATURE_OFFSET],
+							SHOCKWAVE_AUDIO_SIGNATURE, SHOCKWAVE_AUDIO_SIGNATURE_SIZE))
+		{
+			file_type = T("Shockwave Audio");
+		}
+	}
+
+	return file_type;
+}
+
+/*
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>> DIRECTOR CHUNKS
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>>
+*/
+
+// Director movies and casts are RIFX containers whose chunks are listed in a memory map. In uncompressed files (MV93), the "imap"
+// chunk points to the "mmap" chunk, which contains the ID, size, and offset of every chunk. In Afterburner files (FGDM and FGDC),
+// this map is replaced by the Zlib compressed "ABMP" chunk, and the chunks themselves are stored after the "FGEI" chunk. Some of
+// these are grouped together in the initial load segment (ILS), which is itself a compressed chunk.
+//
+// The ID of each chunk is stored in the file's byte order, meaning that reading it using that byte order always results in the
+// same value (e.g. "imap" is stored as "pami" in little endian files).
+//
+// @Docs: Based on the "DirectorFile" class from ProjectorRays - https://github.com/ProjectorRays/ProjectorRays
+
+enum Director_Chunk_Id
+{
+	DIRECTOR_CHUNK_IMAP = 0x696D6170, // "imap"
+	DIRECTOR_CHUNK_MMAP = 0x6D6D6170, // "mmap"
+	DIRECTOR_CHUNK_FREE = 0x66726565, // "free"
+	DIRECTOR_CHUNK_JUNK = 0x6A756E6B, // "junk"
+
+	DIRECTOR_CHUNK_FVER = 0x46766572, // "Fver"
+	DIRECTOR_CHUNK_FCDR = 0x46636472, // "Fcdr"
+	DIRECTOR_CHUNK_ABMP = 0x41424D50, // "ABMP"
+	DIRECTOR_CHUNK_FGEI = 0x46474549, // "FGEI"
+
+	// The chunks that are extracted from each file.
+	DIRECTOR_CHUNK_BITMAP = 0x42495444, // "BITD"
+	DIRECTOR_CHUNK_SOUND = 0x736E6420, // "snd "
+	DIRECTOR_CHUNK_MEDIA = 0x6564694D // "ediM"
+};
+
+// The resource ID of the initial load segment in Afterburner files.
+static const u32 AFTERBURNER_ILS_RESOURCE_ID = 2;
+
+// The compression type that identifies Zlib compressed chunks in Afterburner files. Any other type (e.g. no compression) is
+// treated as uncompressed data.
+static const u8 AFTERBURNER_ZLIB_COMPRESSION_GUID[] = {0xAC, 0x99, 0xE9, 0x04, 0x00, 0x70, 0x0B, 0x36, 0x00, 0x00, 0x08, 0x00, 0x07, 0x2C, 0x63, 0x26};
+static const u32 AFTERBURNER_GUID_SIZE = sizeof(AFTERBURNER_ZLIB_COMPRESSION_GUID);
+
+static const u32 MAX_DIRECTOR_VARINT_SIZE = 5;
+static const u32 MAX_DIRECTOR_CHUNKS = 0x10000;
+// The Fcdr chunk only contains a few compression types and their names, and the ABMP chunk is usually a few kilobytes long.
+static const u32 MAX_AFTERBURNER_COMPRESSION_TYPES_SIZE = 1024;
+static const u32 MAX_AFTERBURNER_MAP_SIZE = (u32) megabytes_to_bytes(1);
+// The initial load segment is decompressed into its own arena, so its sizes are limited before allocating it.
+static const u32 MAX_AFTERBURNER_ILS_SIZE = (u32) megabytes_to_bytes(64);
 
+struct Director_Chunk
+{
+	u32 resource_id;
+	u32 id;
+
+	// Where the chunk's data begins in the file, or in the initial load segment if 'is_in_initial_load_segment' is true.
+	u64 offset;
+	u32 compressed_size;
+	u32 uncompressed_size;
+	bool is_compressed;
+	bool is_in_initial_load_segment;
+
+	// Only used when extracting the chunks.
+	TCHAR* output_path;
+};
+
+struct Director_File
+{
+	bool is_big_endian;
+	bool is_afterburner;
+	u64 file_size;
+
+	u32 num_chunks;
+	Director_Chunk* chunks;
+};
+
+// Helper macro function used to convert an integer of any size from the file's byte order to the host's.
+#define DIRECTOR_TO_HOST(variable)\
+do\
+{\
+	if(is_big_endian)\
+	{\
+		BIG_ENDIAN_TO_HOST(variable);\
+	}\
+	else\
+	{\
+		LITTLE_ENDIAN_TO_HOST(variable);\
+	}\
+} while(false, false)
+
+// Checks if an arena has enough space to push a given number of bytes. This avoids running out of memory when a file specifies
+// a size that is too large.
+static bool director_arena_has_space(Arena* arena, u64 size)
+{
+	// Leave some room for the alignment.
+	const size_t ALIGNMENT_MARGIN = 64;
+	size_t remaining_size = arena->total_size - arena->used_size;
+	return remaining_size >= ALIGNMENT_MARGIN && size <= remaining_size - ALIGNMENT_MARGIN;
+}
+
+// Reads a variable length integer from an Afterburner file. These are stored in big endian order using seven bits per byte,
+// where the most significant bit is set if another byte follows.
+//
+// @Parameters:
+// 1. data - The address of the current position in the data. This position is advanced past the integer.
+// 2. data_end - The end of the data.
+// 3. result_value - The value of the integer.
+//
+// @Returns: True if the integer was read successfully. Otherwise, false.
+static bool read_director_varint(const u8** data, const u8* data_end, u32* result_value)
+{
+	u32 value = 0;
+	u8 byte = 0;
+	u32 num_bytes = 0;
+
+	do
+	{
+		if(*data >= data_end || num_bytes >= MAX_DIRECTOR_VARINT_SIZE) return false;
+
+		byte = **data;
+		value = (value << 7) | (byte & 0x7F);
+		++(*data);
+		++num_bytes;
+	} while((byte & 0x80) != 0);
+
+	*result_value = value;
+	return true;
+}
+
+// Reads the ID of an Afterburner chunk followed by a variable length integer (usually the chunk's size).
+//
+// @Parameters:
+// 1. file_handle - The handle to the Director file.
+// 2. is_big_endian - Whether the file uses big endian byte order.
+// 3. file_offset - The address of the chunk's offset. This offset is advanced past the integer.
+// 4. result_id - The chunk's ID.
+// 5. result_value - The integer that follows the ID.
+//
+// @Returns: True if the ID and integer were read successfully. Otherwise, false.
+static bool read_afterburner_chunk_header(HANDLE file_handle, bool is_big_endian, u64* file_offset, u32* result_id, u32* result_value)
+{
+	u8 header[sizeof(u32) + MAX_DIRECTOR_VARINT_SIZE] = {};
 	u32 num_bytes_read = 0;
-	if(read_first_file_bytes(file_path, file_buffer, MAX_READ_SIZE, true, &num_bytes_read))
+	if(!read_file_chunk(file_handle, header, sizeof(header), *file_offset, true, &num_bytes_read)) return false;
+	if(num_bytes_read < sizeof(u32)) return false;
+
+	u32 id = 0;
+	CopyMemory(&id, header, sizeof(id));
+	DIRECTOR_TO_HOST(id);
+
+	const u8* data = header + sizeof(u32);
+	if(!read_director_varint(&data, header + num_bytes_read, result_value)) return false;
+
+	*file_offset += (u64) (data - header);
+	*result_id = id;
+	return true;
+}
+
+// Reads an uncompressed Director file's memory map (the "imap" and "mmap" chunks).
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the chunks.
+// 2. file_handle - The handle to the Director file.
+// 3. file_size - The size of the Director file.
+// 4. director_file - The Director_File structure that receives the chunks. The 'is_big_endian' member must be set before calling
+// this function.
+//
+// @Returns: True if the memory map was read successfully. Otherwise, false.
+static bool read_rifx_memory_map(Arena* arena, HANDLE file_handle, u64 file_size, Director_File* director_file)
+{
+	bool is_big_endian = director_file->is_big_endian;
+
+	// @ByteOrder: Big or Little Endian, depending on the RIFX chunk's ID.
+
+	/*
+		struct Imap_Chunk
+		{
+			u32 id; // "imap"
+			u32 size;
+			u32 num_memory_maps;
+			u32 memory_map_offset;
+		};
+	*/
+
+	u32 imap_chunk[4] = {};
+	if(!read_file_chunk(file_handle, imap_chunk, sizeof(imap_chunk), MIN_RIFX_CHUNK_READ_SIZE)) return false;
+	for(int i = 0; i < _countof(imap_chunk); ++i) DIRECTOR_TO_HOST(imap_chunk[i]);
+
+	if(imap_chunk[0] != DIRECTOR_CHUNK_IMAP)
 	{
-		if(num_bytes_read >= MIN_RIFX_CHUNK_READ_SIZE)
+		log_warning("Read Rifx Memory Map: Found the chunk ID 0x%08X instead of the memory map's index.", imap_chunk[0]);
+		return false;
+	}
+
+	u32 mmap_offset = imap_chunk[3];
+
+	/*
+		struct Mmap_Chunk
 		{
-			u32 chunk_id = 0;
-			u32 chunk_format = 0;
+			u32 id; // "mmap"
+			u32 size;
+			u16 header_size;
+			u16 entry_size;
+			u32 max_num_entries;
+			u32 num_entries;
+			s32 junk_entry_index[2];
+			s32 free_entry_index;
+			Mmap_Entry entries[num_entries]; // Starts at 'header_size' bytes after the size.
+		};
 
-			CopyMemory(&chunk_id, &file_buffer[0], sizeof(chunk_id));
-			CopyMemory(&chunk_format, &file_buffer[8], sizeof(chunk_format));
-			
-			BIG_ENDIAN_TO_HOST(chunk_id);
-			BIG_ENDIAN_TO_HOST(chunk_format);
+		struct Mmap_Entry
+		{
+			u32 id;
+			u32 size;
+			u32 offset;
+			u16 flags;
+			u16 _reserved;
+			s32 next_free_entry_index;
+		};
+	*/
 
-			// This would work without swapping the byte order because we check both big and little endian format signatures.
-			// But it'll be useful for the other file types.
-			if(chunk_id == CHUNK_RIFX_BIG_ENDIAN || chunk_id == CHUNK_RIFX_LITTLE_ENDIAN)
-			{
-				switch(chunk_format)
+	const u32 MMAP_HEADER_SIZE = 24;
+	const u32 MMAP_ENTRY_SIZE = 20;
+
+	u8 mmap_chunk[8 + MMAP_HEADER_SIZE] = {};
+	if(!read_file_chunk(file_handle, mmap_chunk, sizeof(mmap_chunk), mmap_offset)) return false;
+
+	u32 mmap_id = 0;
+	u16 header_size = 0;
+	u16 entry_size = 0;
+	u32 num_entries = 0;
+
+	CopyMemory(&mmap_id, mmap_chunk, sizeof(mmap_id));
+	CopyMemory(&header_size, mmap_chunk + 8, sizeof(header_size));
+	CopyMemory(&entry_size, mmap_chunk + 10, sizeof(entry_size));
+	CopyMemory(&num_entries, mmap_chunk + 16, sizeof(num_entries));
+
+	DIRECTOR_TO_HOST(mmap_id);
+	DIRECTOR_TO_HOST(header_size);
+	DIRECTOR_TO_HOST(entry_size);
+	DIRECTOR_TO_HOST(num_entries);
+
+	if(mmap_id != DIRECTOR_CHUNK_MMAP || header_size < MMAP_HEADER_SIZE || entry_size < MMAP_ENTRY_SIZE || num_entries > MAX_DIRECTOR_CHUNKS)
+	{
+		log_warning("Read Rifx Memory Map: Found the invalid memory map 0x%08X at 0x%08X with %I32u entries of %hu bytes.", mmap_id, mmap_offset, num_entries, entry_size);
+		return false;
+	}
+
+	u64 entries_offset = (u64) mmap_offset + 8 + header_size;
+	u64 entries_size = (u64) num_entries * entry_size;
+	if(entries_offset + entries_size > file_size) return false;
+
+	if(!director_arena_has_space(arena, entries_size + num_entries * sizeof(Director_Chunk)))
+	{
+		log_warning("Read Rifx Memory Map: Not enough memory to read the %I32u entries in the memory map.", num_entries);
+		return false;
+	}
+
+	u8* entries = push_arena(arena, (size_t) entries_size, u8);
+	if(!read_file_chunk(file_handle, entries, (u32) entries_size, entries_offset)) return false;
+
+	director_file->num_chunks = 0;
+	director_file->chunks = push_array_to_arena(arena, num_entries, Director_Chunk);
+
+	for(u32 i = 0; i < num_entries; ++i)
+	{
+		u32 entry[3] = {};
+		CopyMemory(entry, entries + i * entry_size, sizeof(entry));
+		for(int j = 0; j < _countof(entry); ++j) DIRECTOR_TO_HOST(entry[j]);
+
+		u32 id = entry[0];
+		u32 size = entry[1];
+		u32 offset = entry[2];
+
+		if(id == DIRECTOR_CHUNK_FREE || id == DIRECTOR_CHUNK_JUNK) continue;
+
+		if((u64) offset + 8 + size > file_size)
+		{
+			log_warning("Read Rifx Memory Map: Skipping the chunk %I32u (0x%08X) since its offset 0x%08X and size %I32u go past the end of the file.", i, id, offset, size);
+			continue;
+		}
+
+		Director_Chunk* chunk = &(director_file->chunks[director_file->num_chunks]);
+		++(director_file->num_chunks);
+
+		chunk->resource_id = i;
+		chunk->id = id;
+		chunk->offset = (u64) offset + 8;
+		chunk->compressed_size = size;
+		chunk->uncompressed_size = size;
+		chunk->is_compressed = false;
+		chunk->is_in_initial_load_segment = false;
+		chunk->output_path = NULL;
+	}
+
+	return true;
+}
+
+// Reads an Afterburner file's memory map (the "Fver", "Fcdr", "ABMP", and "FGEI" chunks).
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the chunks. This arena is also used to decompress the memory map.
+// 2. file_handle - The handle to the Director file.
+// 3. file_size - The size of the Director file.
+// 4. director_file - The Director_File structure that receives the chunks. The 'is_big_endian' member must be set before calling
+// this function.
+//
+// @Returns: True if the memory map was read successfully. Otherwise, false.
+static bool read_afterburner_memory_map(Arena* arena, HANDLE file_handle, u64 file_size, Director_File* director_file)
+{
+	bool is_big_endian = director_file->is_big_endian;
+	u64 file_offset = MIN_RIFX_CHUNK_READ_SIZE;
+
+	u32 id = 0;
+	u32 size = 0;
+
+	// The version chunk is skipped since we don't need any of its values.
+	if(!read_afterburner_chunk_header(file_handle, is_big_endian, &file_offset, &id, &size) || id != DIRECTOR_CHUNK_FVER)
+	{
+		log_warning("Read Afterburner Memory Map: Could not find the version chunk.");
+		return false;
+	}
+	file_offset += size;
+
+	// The compression types chunk lists the GUID of every compression type used by the chunks. This list is followed by each
+	// type's name.
+	if(!read_afterburner_chunk_header(file_handle, is_big_endian, &file_offset, &id, &size) || id != DIRECTOR_CHUNK_FCDR
+		|| size > MAX_AFTERBURNER_MAP_SIZE || file_offset + size > file_size)
+	{
+		log_warning("Read Afterburner Memory Map: Could not find the compression types chunk.");
+		return false;
+	}
+
+	u16 num_compression_types = 0;
+	bool* is_zlib_compression_type = NULL;
+	{
+		if(!director_arena_has_space(arena, (u64) size + MAX_AFTERBURNER_COMPRESSION_TYPES_SIZE)) return false;
+
+		u8* compressed_types = push_arena(arena, size, u8);
+		if(!read_file_chunk(file_handle, compressed_types, size, file_offset)) return false;
+
+		u8 types[MAX_AFTERBURNER_COMPRESSION_TYPES_SIZE] = {};
+		u32 types_size = 0;
+		int error_code = 0;
+		if(!decompress_deflate_buffer(arena, compressed_types, size, types, sizeof(types), &types_size, &error_code, true)) return false;
+		if(types_size < sizeof(num_compression_types)) return false;
+
+		CopyMemory(&num_compression_types, types, sizeof(num_compression_types));
+		DIRECTOR_TO_HOST(num_compression_types);
+
+		if(sizeof(num_compression_types) + num_compression_types * AFTERBURNER_GUID_SIZE > types_size)
+		{
+			log_warning("Read Afterburner Memory Map: Found %hu compression types in %I32u bytes.", num_compression_types, types_size);
+			return false;
+		}
+
+		is_zlib_compression_type = push_array_to_arena(arena, MAX(num_compression_types, 1), bool);
+
+		for(u16 i = 0; i < num_compression_types; ++i)
+		{
+			/*
+				struct Guid
 				{
-					case(FORMAT_DIRECTOR_MOVIE_OR_CAST_BIG_ENDIAN):
-					case(FORMAT_DIRECTOR_MOVIE_OR_CAST_LITTLE_ENDIAN):
-					{
-						file_type = T("Director Movie or Cast");
-					} break;
+					u32 data_1;
+					u16 data_2;
+					u16 data_3;
+					u8 data_4[8];
+				};
+			*/
 
-					case(FORMAT_SHOCKWAVE_MOVIE_BIG_ENDIAN):
-					case(FORMAT_SHOCKWAVE_MOVIE_LITTLE_ENDIAN):
-					{
-						file_type = T("Shockwave Movie");
-					} break;
+			u8* guid_in_file = types + sizeof(num_compression_types) + i * AFTERBURNER_GUID_SIZE;
 
-					case(FORMAT_SHOCKWAVE_CAST_BIG_ENDIAN):
-					case(FORMAT_SHOCKWAVE_CAST_LITTLE_ENDIAN):
-					{
-						file_type = T("Shockwave Cast");
-					} break;
-				}				
-			}
-			else if(chunk_id == CHUNK_RIFF_BIG_ENDIAN && chunk_format == FORMAT_XTRA_PACKAGE_BIG_ENDIAN)
+			u32 data_1 = 0;
+			u16 data_2 = 0;
+			u16 data_3 = 0;
+			CopyMemory(&data_1, guid_in_file, sizeof(data_1));
+			CopyMemory(&data_2, guid_in_file + 4, sizeof(data_2));
+			CopyMemory(&data_3, guid_in_file + 6, sizeof(data_3));
+			DIRECTOR_TO_HOST(data_1);
+			DIRECTOR_TO_HOST(data_2);
+			DIRECTOR_TO_HOST(data_3);
+
+			// Store the GUID in big endian order so it can be compared to the constant.
+			BIG_ENDIAN_TO_HOST(data_1);
+			BIG_ENDIAN_TO_HOST(data_2);
+			BIG_ENDIAN_TO_HOST(data_3);
+
+			u8 guid[AFTERBURNER_GUID_SIZE] = {};
+			CopyMemory(guid, &data_1, sizeof(data_1));
+			CopyMemory(guid + 4, &data_2, sizeof(data_2));
+			CopyMemory(guid + 6, &data_3, sizeof(data_3));
+			CopyMemory(guid + 8, guid_in_file + 8, 8);
+
+			is_zlib_compression_type[i] = memory_is_equal(guid, AFTERBURNER_ZLIB_COMPRESSION_GUID, AFTERBURNER_GUID_SIZE);
+		}
+	}
+	file_offset += size;
+
+	/*
+		struct Abmp_Chunk
+		{
+			u32 id; // "ABMP"
+			varint size;
+			varint compression_type;
+			varint uncompressed_size;
+			u8 compressed_data[]; // Zlib.
+		};
+
+		struct Abmp_Data
+		{
+			varint _unknown_1;
+			varint _unknown_2;
+			varint num_resources;
+			Abmp_Resource resources[num_resources];
+		};
+
+		struct Abmp_Resource
+		{
+			varint resource_id;
+			varint offset; // Relative to the end of the FGEI chunk.
+			varint compressed_size;
+			varint uncompressed_size;
+			varint compression_type_index;
+			u32 id;
+		};
+	*/
+
+	if(!read_afterburner_chunk_header(file_handle, is_big_endian, &file_offset, &id, &size) || id != DIRECTOR_CHUNK_ABMP
+		|| size > MAX_AFTERBURNER_MAP_SIZE || file_offset + size > file_size)
+	{
+		log_warning("Read Afterburner Memory Map: Could not find the memory map chunk.");
+		return false;
+	}
+
+	u8* map = NULL;
+	u32 map_size = 0;
+	{
+		if(!director_arena_has_space(arena, size)) return false;
+
+		u8* compressed_map = push_arena(arena, size, u8);
+		if(!read_file_chunk(file_handle, compressed_map, size, file_offset)) return false;
+
+		const u8* data = compressed_map;
+		const u8* data_end = compressed_map + size;
+
+		u32 compression_type = 0;
+		u32 uncompressed_size = 0;
+		if(!read_director_varint(&data, data_end, &compression_type)) return false;
+		if(!read_director_varint(&data, data_end, &uncompressed_size)) return false;
+
+		if(uncompressed_size > MAX_AFTERBURNER_MAP_SIZE || !director_arena_has_space(arena, (u64) uncompressed_size * 2))
+		{
+			log_warning("Read Afterburner Memory Map: Not enough memory to decompress the memory map with %I32u bytes.", uncompressed_size);
+			return false;
+		}
+
+		map = push_arena(arena, uncompressed_size, u8);
+		int error_code = 0;
+		if(!decompress_deflate_buffer(arena, data, (u32) (data_end - data), map, uncompressed_size, &map_size, &error_code, true)) return false;
+	}
+	file_offset += size;
+
+	u32 ils_unknown = 0;
+	if(!read_afterburner_chunk_header(file_handle, is_big_endian, &file_offset, &id, &ils_unknown) || id != DIRECTOR_CHUNK_FGEI)
+	{
+		log_warning("Read Afterburner Memory Map: Could not find the initial load segment chunk.");
+		return false;
+	}
+
+	// The offset of each chunk is relative to the end of this last chunk header.
+	u64 chunks_offset = file_offset;
+
+	const u8* data = map;
+	const u8* data_end = map + map_size;
+
+	u32 unknown_1 = 0;
+	u32 unknown_2 = 0;
+	u32 num_resources = 0;
+	if(!read_director_varint(&data, data_end, &unknown_1)) return false;
+	if(!read_director_varint(&data, data_end, &unknown_2)) return false;
+	if(!read_director_varint(&data, data_end, &num_resources)) return false;
+
+	// Each resource takes at least nine bytes.
+	if(num_resources > MAX_DIRECTOR_CHUNKS || num_resources > map_size / 9
+		|| !director_arena_has_space(arena, (u64) num_resources * sizeof(Director_Chunk)))
+	{
+		log_warning("Read Afterburner Memory Map: Found the invalid number of resources %I32u in %I32u bytes.", num_resources, map_size);
+		return false;
+	}
+
+	director_file->num_chunks = 0;
+	director_file->chunks = push_array_to_arena(arena, num_resources, Director_Chunk);
+
+	for(u32 i = 0; i < num_resources; ++i)
+	{
+		u32 resource_id = 0;
+		u32 offset = 0;
+		u32 compressed_size = 0;
+		u32 uncompressed_size = 0;
+		u32 compression_type_index = 0;
+		u32 chunk_id = 0;
+
+		bool read_resource = read_director_varint(&data, data_end, &resource_id)
+							&& read_director_varint(&data, data_end, &offset)
+							&& read_director_varint(&data, data_end, &compressed_size)
+							&& read_director_varint(&data, data_end, &uncompressed_size)
+							&& read_director_varint(&data, data_end, &compression_type_index)
+							&& (size_t) (data_end - data) >= sizeof(chunk_id);
+
+		if(!read_resource)
+		{
+			log_warning("Read Afterburner Memory Map: Reached the end of the memory map after reading %I32u of %I32u resources.", i, num_resources);
+			break;
+		}
+
+		CopyMemory(&chunk_id, data, sizeof(chunk_id));
+		DIRECTOR_TO_HOST(chunk_id);
+		data += sizeof(chunk_id);
+
+		Director_Chunk* chunk = &(director_file->chunks[director_file->num_chunks]);
+		++(director_file->num_chunks);
+
+		chunk->resource_id = resource_id;
+		chunk->id = chunk_id;
+		chunk->offset = chunks_offset + offset;
+		chunk->compressed_size = compressed_size;
+		chunk->uncompressed_size = uncompressed_size;
+		chunk->is_compressed = (compression_type_index < num_compression_types) && is_zlib_compression_type[compression_type_index];
+		chunk->is_in_initial_load_segment = false;
+		chunk->output_path = NULL;
+	}
+
+	return true;
+}
+
+// Called by qsort() and bsearch() to sort and find the chunks by their resource IDs.
+static int compare_director_chunk_resource_ids(const void* chunk_pointer_1, const void* chunk_pointer_2)
+{
+	Director_Chunk* chunk_1 = (Director_Chunk*) chunk_pointer_1;
+	Director_Chunk* chunk_2 = (Director_Chunk*) chunk_pointer_2;
+	
+	if(chunk_1->resource_id < chunk_2->resource_id) return -1;
+	else if(chunk_1->resource_id > chunk_2->resource_id) return 1;
+	else return 0;
+}
+
+// Called by qsort() to sort the chunks that are extracted so that the file is read sequentially. Any chunks in the initial load
+// segment come first since this segment is already in memory.
+static int compare_director_chunk_offsets(const void* chunk_pointer_1, const void* chunk_pointer_2)
+{
+	Director_Chunk* chunk_1 = *((Director_Chunk**) chunk_pointer_1);
+	Director_Chunk* chunk_2 = *((Director_Chunk**) chunk_pointer_2);
+
+	if(chunk_1->is_in_initial_load_segment != chunk_2->is_in_initial_load_segment) return (chunk_1->is_in_initial_load_segment) ? (-1) : (1);
+	else if(chunk_1->offset < chunk_2->offset) return -1;
+	else if(chunk_1->offset > chunk_2->offset) return 1;
+	else return 0;
+}
+
+// Converts a chunk ID to a string (e.g. "BITD").
+//
+// @Parameters:
+// 1. id - The chunk ID.
+// 2. trim_spaces - Whether or not to remove any trailing spaces (e.g. "snd " becomes "snd").
+// 3. result_string - The buffer that receives the string. This buffer must be able to hold at least five characters.
+//
+// @Returns: Nothing.
+static void convert_director_chunk_id_to_string(u32 id, bool trim_spaces, TCHAR* result_string)
+{
+	for(int i = 0; i < 4; ++i)
+	{
+		u8 c = (u8) ( (id >> (24 - i * 8)) & 0xFF );
+		result_string[i] = (c >= 0x20 && c < 0x7F) ? ((TCHAR) c) : (T('?'));
+	}
+	result_string[4] = T('\0');
+
+	if(trim_spaces)
+	{
+		for(int i = 3; i >= 0 && result_string[i] == T(' '); --i) result_string[i] = T('\0');
+	}
+}
+
+// Finds the chunks that are stored in an Afterburner file's initial load segment, which is decompressed into a separate arena.
+// The chunks in this segment are stored one after the other, each one preceded by its resource ID.
+//
+// @Parameters:
+// 1. ils_arena - The Arena structure that receives the decompressed segment. This arena must be able to hold both the compressed
+// and decompressed data, whose sizes must have been checked against the file's size and MAX_AFTERBURNER_ILS_SIZE.
+// 2. file_handle - The handle to the Director file.
+// 3. director_file - The Director_File structure whose chunks were sorted by their resource IDs.
+// 4. result_ils - The address of the decompressed segment.
+//
+// @Returns: True if the segment was decompressed successfully. Otherwise, false.
+static bool read_afterburner_initial_load_segment(Arena* ils_arena, HANDLE file_handle, Director_File* director_file, u8** result_ils)
+{
+	Director_Chunk key = {};
+	key.resource_id = AFTERBURNER_ILS_RESOURCE_ID;
+	Director_Chunk* ils_chunk = (Director_Chunk*) bsearch(&key, director_file->chunks, director_file->num_chunks, sizeof(Director_Chunk), compare_director_chunk_resource_ids);
+	if(ils_chunk == NULL) return false;
+
+	u8* ils = push_arena(ils_arena, ils_chunk->uncompressed_size, u8);
+	if(ils == NULL) return false;
+	u32 ils_size = 0;
+
+	if(ils_chunk->is_compressed)
+	{
+		u8* compressed_ils = push_arena(ils_arena, ils_chunk->compressed_size, u8);
+		if(compressed_ils == NULL) return false;
+		if(!read_file_chunk(file_handle, compressed_ils, ils_chunk->compressed_size, ils_chunk->offset)) return false;
+
+		int error_code = 0;
+		if(!decompress_deflate_buffer(ils_arena, compressed_ils, ils_chunk->compressed_size, ils, ils_chunk->uncompressed_size, &ils_size, &error_code, true)) return false;
+	}
+	else
+	{
+		ils_size = MIN(ils_chunk->compressed_size, ils_chunk->uncompressed_size);
+		if(!read_file_chunk(file_handle, ils, ils_size, ils_chunk->offset)) return false;
+	}
+
+	const u8* data = ils;
+	const u8* data_end = ils + ils_size;
+
+	while(data < data_end)
+	{
+		key.resource_id = 0;
+		if(!read_director_varint(&data, data_end, &key.resource_id)) break;
+
+		Director_Chunk* chunk = (Director_Chunk*) bsearch(&key, director_file->chunks, director_file->num_chunks, sizeof(Director_Chunk), compare_director_chunk_resource_ids);
+		if(chunk == NULL || chunk->compressed_size > (u32) (data_end - data))
+		{
+			log_warning("Read Afterburner Initial Load Segment: Found the unknown or invalid resource %I32u at %Iu bytes in the segment.", key.resource_id, (size_t) (data - ils));
+			break;
+		}
+
+		chunk->is_in_initial_load_segment = true;
+		chunk->offset = (u64) (data - ils);
+		data += chunk->compressed_size;
+	}
+
+	*result_ils = ils;
+	return true;
+}
+
+// Extracts the bitmap, sound, and media chunks in a Director file. The data is written as is (after being decompressed in
+// Afterburner files), meaning the bitmaps and sounds are not converted to another format.
+//
+// @Parameters:
+// 1. arena - The Arena structure where any intermediary data is stored.
+// 2. file_path - The path to the Director file.
+// 3. file_handle - The handle to the Director file.
+// 4. director_file - The Director_File structure whose chunks were sorted by their resource IDs.
+// 5. output_directory_path - The directory where the chunks are extracted to. This directory is only created if the file has at
+// least one chunk to extract, and a different name is used if it already exists.
+//
+// @Returns: Nothing.
+static void extract_director_media(Arena* arena, const TCHAR* file_path, HANDLE file_handle, Director_File* director_file, const TCHAR* output_directory_path)
+{
+	u32 num_media_chunks = 0;
+	for(u32 i = 0; i < director_file->num_chunks; ++i)
+	{
+		u32 id = director_file->chunks[i].id;
+		if(id == DIRECTOR_CHUNK_BITMAP || id == DIRECTOR_CHUNK_SOUND || id == DIRECTOR_CHUNK_MEDIA) ++num_media_chunks;
+	}
+
+	if(num_media_chunks == 0) return;
+
+	TCHAR resolved_output_directory_path[MAX_PATH_CHARS] = T("");
+	if(!create_directories(output_directory_path, true, resolved_output_directory_path))
+	{
+		log_error("Extract Director Media: Failed to create the directory '%s' for the chunks in '%s'.", output_directory_path, file_path);
+		return;
+	}
+
+	// The initial load segment is decompressed into a separate arena since it may be too large for the temporary memory.
+	Arena ils_arena = NULL_ARENA;
+	u8* ils = NULL;
+	if(director_file->is_afterburner)
+	{
+		Director_Chunk key = {};
+		key.resource_id = AFTERBURNER_ILS_RESOURCE_ID;
+		Director_Chunk* ils_chunk = (Director_Chunk*) bsearch(&key, director_file->chunks, director_file->num_chunks, sizeof(Director_Chunk), compare_director_chunk_resource_ids);
+
+		// These sizes come from the file, so they're checked before allocating the arena.
+		bool is_ils_valid = (ils_chunk != NULL)
+							&& ils_chunk->offset + ils_chunk->compressed_size <= director_file->file_size
+							&& ils_chunk->compressed_size <= MAX_AFTERBURNER_ILS_SIZE
+							&& ils_chunk->uncompressed_size <= MAX_AFTERBURNER_ILS_SIZE;
+
+		// Leave some room for Zlib's internal state. This sum fits in a size_t since both sizes were limited above.
+		size_t ils_arena_size = 0;
+		if(is_ils_valid) ils_arena_size = (size_t) ils_chunk->compressed_size + ils_chunk->uncompressed_size + kilobytes_to_bytes(64);
+		
+		if(is_ils_valid && create_arena(&ils_arena, ils_arena_size))
+		{
+			if(!read_afterburner_initial_load_segment(&ils_arena, file_handle, director_file, &ils))
 			{
-				file_type = T("Xtra-Package");
+				log_warning("Extract Director Media: Failed to read the initial load segment in '%s'.", file_path);
+				ils = NULL;
 			}
-			// This isn't a RIFF or RIFX container, but we'll take advantage of this structure to check this file signature.
-			else if(chunk_id == SHOCKWAVE_3D_WORLD_SIGNATURE)
+		}
+		else
+		{
+			log_warning("Extract Director Media: Could not find, validate, or allocate the initial load segment in '%s'.", file_path);
+		}
+	}
+
+	Director_Chunk** media_chunks = push_array_to_arena(arena, num_media_chunks, Director_Chunk*);
+	if(media_chunks == NULL)
+	{
+		log_error("Extract Director Media: Not enough memory to extract the %I32u chunks in '%s'.", num_media_chunks, file_path);
+		destroy_arena(&ils_arena);
+		return;
+	}
+
+	num_media_chunks = 0;
+	for(u32 i = 0; i < director_file->num_chunks; ++i)
+	{
+		Director_Chunk* chunk = &(director_file->chunks[i]);
+		if(chunk->id == DIRECTOR_CHUNK_BITMAP || chunk->id == DIRECTOR_CHUNK_SOUND || chunk->id == DIRECTOR_CHUNK_MEDIA)
+		{
+			media_chunks[num_media_chunks] = chunk;
+			++num_media_chunks;
+		}
+	}
+
+	qsort(media_chunks, num_media_chunks, sizeof(Director_Chunk*), compare_director_chunk_offsets);
+
+	for(u32 i = 0; i < num_media_chunks; ++i)
+	{
+		Director_Chunk* chunk = media_chunks[i];
+		if(chunk->is_in_initial_load_segment && ils == NULL) continue;
+
+		if(!chunk->is_in_initial_load_segment && chunk->offset + chunk->compressed_size > director_file->file_size)
+		{
+			log_warning("Extract Director Media: Skipping the chunk %I32u since its offset 0x%08I64X and size %I32u go past the end of '%s'.", chunk->resource_id, chunk->offset, chunk->compressed_size, file_path);
+			continue;
+		}
+
+		// E.g. "12.BITD" or "13.snd".
+		TCHAR id_string[5] = T("");
+		convert_director_chunk_id_to_string(chunk->id, true, id_string);
+
+		TCHAR chunk_filename[MAX_PATH_CHARS] = T("");
+		StringCchPrintf(chunk_filename, MAX_PATH_CHARS, T("%I32u.%s"), chunk->resource_id, id_string);
+
+		TCHAR chunk_path[MAX_PATH_CHARS] = T("");
+		if(PathCombine(chunk_path, resolved_output_directory_path, chunk_filename) == NULL) continue;
+
+		bool extracted_chunk = false;
+		lock_arena(arena);
+
+		if(chunk->is_in_initial_load_segment)
+		{
+			HANDLE chunk_handle = create_handle(chunk_path, GENERIC_WRITE, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL);
+			if(chunk_handle != INVALID_HANDLE_VALUE)
 			{
-				file_type = T("Shockwave 3D World");
+				extracted_chunk = write_to_file(chunk_handle, ils + chunk->offset, chunk->compressed_size);
+				safe_close_handle(&chunk_handle);
 			}
 		}
-
-		if(file_type == NULL && num_bytes_read >= MIN_SHOCKWAVE_AUDIO_READ_SIZE)
+		else if(chunk->is_compressed && chunk->compressed_size > 0)
 		{
-			if(memory_is_equal(	&file_buffer[SHOCKWAVE_AUDIO_SIGNATURE_OFFSET],
-								SHOCKWAVE_AUDIO_SIGNATURE, SHOCKWAVE_AUDIO_SIGNATURE_SIZE))
+			HANDLE chunk_handle = create_handle(chunk_path, GENERIC_WRITE, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL);
+			if(chunk_handle != INVALID_HANDLE_VALUE)
 			{
-				file_type = T("Shockwave Audio");
+				int error_code = 0;
+				extracted_chunk = decompress_gzip_zlib_deflate_file(arena, file_path, chunk_handle, &error_code, chunk->offset, chunk->compressed_size);
+				safe_close_handle(&chunk_handle);
 			}
 		}
+		else
+		{
+			extracted_chunk = copy_file_chunks(arena, file_path, chunk->compressed_size, chunk->offset, chunk_path, true);
+		}
+
+		clear_arena(arena);
+		unlock_arena(arena);
+
+		if(extracted_chunk)
+		{
+			chunk->output_path = push_string_to_arena(arena, chunk_path);
+		}
+		else
+		{
+			log_error("Extract Director Media: Failed to extract the chunk %I32u (%s) from '%s' with the error code %lu.", chunk->resource_id, id_string, file_path, GetLastError());
+		}
 	}
-	else
+
+	destroy_arena(&ils_arena);
+}
+
+// Reads a Director movie or cast's memory map using the first bytes that were already read to determine the file's type. Afterburner
+// files are read sequentially, and only the memory map is decompressed into memory. See: extract_director_media().
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the chunks. This arena is also used to decompress the memory map.
+// 2. file_path - The path to the Director file.
+// 3. file_handle - The handle to the Director file.
+// 4. header - The first MIN_RIFX_CHUNK_READ_SIZE bytes of the file.
+// 5. result_file - The Director_File structure that receives the chunks, sorted by their resource IDs.
+//
+// @Returns: True if the file is a Director movie or cast and its memory map was read successfully. Otherwise, false.
+static bool read_director_file(Arena* arena, const TCHAR* file_path, HANDLE file_handle, const u8* header, Director_File* result_file)
+{
+	u64 file_size = 0;
+	if(!get_file_size(file_handle, &file_size)) return false;
+
+	u32 chunk_id = 0;
+	u32 chunk_format = 0;
+	CopyMemory(&chunk_id, &header[0], sizeof(chunk_id));
+	CopyMemory(&chunk_format, &header[8], sizeof(chunk_format));
+	BIG_ENDIAN_TO_HOST(chunk_id);
+	BIG_ENDIAN_TO_HOST(chunk_format);
+
+	if(chunk_id != CHUNK_RIFX_BIG_ENDIAN && chunk_id != CHUNK_RIFX_LITTLE_ENDIAN) return false;
+
+	Director_File director_file = {};
+	director_file.is_big_endian = (chunk_id == CHUNK_RIFX_BIG_ENDIAN);
+	director_file.file_size = file_size;
+
+	bool read_map = false;
+	switch(chunk_format)
 	{
-		log_warning("Get Director File Type From File Signature: Could not read the file signature.");
+		case(FORMAT_DIRECTOR_MOVIE_OR_CAST_BIG_ENDIAN):
+		case(FORMAT_DIRECTOR_MOVIE_OR_CAST_LITTLE_ENDIAN):
+		{
+			director_file.is_afterburner = false;
+			read_map = read_rifx_memory_map(arena, file_handle, file_size, &director_file);
+		} break;
+
+		case(FORMAT_SHOCKWAVE_MOVIE_BIG_ENDIAN):
+		case(FORMAT_SHOCKWAVE_MOVIE_LITTLE_ENDIAN):
+		case(FORMAT_SHOCKWAVE_CAST_BIG_ENDIAN):
+		case(FORMAT_SHOCKWAVE_CAST_LITTLE_ENDIAN):
+		{
+			director_file.is_afterburner = true;
+			read_map = read_afterburner_memory_map(arena, file_handle, file_size, &director_file);
+		} break;
+
+		default: return false;
 	}
 
-	return file_type;
+	if(!read_map)
+	{
+		log_warning("Read Director File: Failed to read the memory map in '%s'.", file_path);
+		return false;
+	}
+
+	qsort(director_file.chunks, director_file.num_chunks, sizeof(Director_Chunk), compare_director_chunk_resource_ids);
+
+	*result_file = director_file;
+	return true;
+}
+
+#undef DIRECTOR_TO_HOST
+
+// Writes one row per chunk in a Director file to the chunk CSV file.
+//
+// @Parameters:
+// 1. arena - The Arena structure where any intermediary strings are stored.
+// 2. chunk_csv - The Director_Chunk_Csv structure that contains the CSV file's handle.
+// 3. location_on_cache - The location of the Director file, which is shown in the main CSV file.
+// 4. director_file - The Director_File structure that contains the chunks.
+//
+// @Returns: Nothing.
+static void print_director_chunks(Arena* arena, Director_Chunk_Csv* chunk_csv, TCHAR* location_on_cache, Director_File* director_file)
+{
+	for(u32 i = 0; i < director_file->num_chunks; ++i)
+	{
+		Director_Chunk* chunk = &(director_file->chunks[i]);
+
+		TCHAR resource_id[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(chunk->resource_id, resource_id);
+
+		TCHAR chunk_id[5] = T("");
+		convert_director_chunk_id_to_string(chunk->id, false, chunk_id);
+
+		TCHAR compressed_size[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(chunk->compressed_size, compressed_size);
+
+		TCHAR uncompressed_size[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(chunk->uncompressed_size, uncompressed_size);
+
+		Csv_Entry csv_row[] =
+		{
+			{location_on_cache}, {resource_id}, {chunk_id}, {compressed_size}, {uncompressed_size}, {chunk->output_path}
+		};
+		_STATIC_ASSERT(_countof(csv_row) == CHUNK_CSV_NUM_COLUMNS);
+
+		lock_arena(arena);
+		csv_print_row(arena, chunk_csv->file_handle, csv_row, CHUNK_CSV_NUM_COLUMNS);
+		clear_arena(arena);
+		unlock_arena(arena);
+	}
+
+	if(director_file->num_chunks > 0) chunk_csv->listed_at_least_one_chunk = true;
 }
 
 struct Find_Shockwave_Files_Params
@@ -201,6 +1113,10 @@ struct Find_Shockwave_Files_Params
 	Exporter* exporter;
 	bool is_appdata_cache;
 	const TCHAR* location_identifier;
+	// The output subdirectory where the files are copied to (e.g. "Cache" or "Xtras").
+	const TCHAR* output_subdirectory;
+	// The chunk CSV file, or NULL if the Director files' chunks shouldn't be listed.
+	Director_Chunk_Csv* chunk_csv;
 };
 
 // Entry point for the Shockwave Player's cache exporter. This function will determine where to look for the cache before
@@ -232,11 +1148,51 @@ void export_default_or_specific_shockwave_cache(Exporter* exporter)
 		file_params.is_appdata_cache = false;
 		file_params.location_identifier = T("<Temporary>");
 
-		set_exporter_output_copy_subdirectory(exporter, T("Cache"));
-		traverse_directory_objects(exporter->cache_path, T("mp*"), TRAVERSE_FILES, false, find_shockwave_files_callback, &file_params);
+		Director_Chunk_Csv chunk_csv = {};
+		chunk_csv.file_handle = INVALID_HANDLE_VALUE;
+
+		if(exporter->create_csvs && exporter->list_director_chunks)
+		{
+			// E.g. "SW.csv" and "SW_Director_Chunks.csv".
+			StringCchCopy(chunk_csv.file_path, MAX_PATH_CHARS, exporter->output_copy_path);
+			StringCchCat(chunk_csv.file_path, MAX_PATH_CHARS, T("_Director_Chunks.csv"));
+
+			if(create_csv_file(chunk_csv.file_path, &(chunk_csv.file_handle)))
+			{
+				++(exporter->total_csv_files_created);
+				csv_print_header(arena, chunk_csv.file_handle, CHUNK_CSV_COLUMN_TYPES, CHUNK_CSV_NUM_COLUMNS);
+				clear_arena(arena);
+				file_params.chunk_csv = &chunk_csv;
+			}
+			else
+			{
+				log_error("Shockwave Player: Failed to create the chunk CSV file '%s'.", chunk_csv.file_path);
+				++(exporter->total_export_errors);
+			}
+		}
+
+		// The cached files and Xtras are found in a single traversal since the Temporary Files directory can be quite large.
+		Find_Shockwave_Files_Params cache_params = file_params;
+		cache_params.output_subdirectory = T("Cache");
+
+		Find_Shockwave_Files_Params xtra_params = file_params;
+		xtra_params.output_subdirectory = T("Xtras");
+
+		Traversal_Rule rules[2] = {};
 		
-		set_exporter_output_copy_subdirectory(exporter, T("Xtras"));
-		traverse_directory_objects(exporter->cache_path, T("*.x32"), TRAVERSE_FILES, true, find_shockwave_files_callback, &file_params);
+		rules[0].search_query = T("mp*");
+		rules[0].traversal_flags = TRAVERSE_FILES;
+		rules[0].traverse_subdirectories = false;
+		rules[0].callback_function = find_shockwave_files_callback;
+		rules[0].user_data = &cache_params;
+
+		rules[1].search_query = T("*.x32");
+		rules[1].traversal_flags = TRAVERSE_FILES;
+		rules[1].traverse_subdirectories = true;
+		rules[1].callback_function = find_shockwave_files_callback;
+		rules[1].user_data = &xtra_params;
+
+		traverse_directory_objects_with_rules(exporter->cache_path, rules, _countof(rules));
 
 		if(exporter->is_exporting_from_default_locations)
 		{
@@ -267,11 +1223,11 @@ void export_default_or_specific_shockwave_cache(Exporter* exporter)
 					{
 						Traversal_Object_Info directory_info = version_directories->object_info[k];
 						
-						set_exporter_output_copy_subdirectory(exporter, T("Cache"));
+						file_params.output_subdirectory = T("Cache");
 						PathCombine(exporter->cache_path, directory_info.object_path, T("DswMedia"));
 						traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_shockwave_files_callback, &file_params);
 
-						set_exporter_output_copy_subdirectory(exporter, T("Xtras"));
+						file_params.output_subdirectory = T("Xtras");
 						PathCombine(exporter->cache_path, directory_info.object_path, T("Xtras"));
 						traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_shockwave_files_callback, &file_params);
 					}
@@ -281,6 +1237,13 @@ void export_default_or_specific_shockwave_cache(Exporter* exporter)
 			}
 		}
 
+		safe_close_handle(&(chunk_csv.file_handle));
+		if(file_params.chunk_csv != NULL && !chunk_csv.listed_at_least_one_chunk)
+		{
+			log_info("Shockwave Player: Deleting the chunk CSV file '%s' since no Director chunks were listed.", chunk_csv.file_path);
+			DeleteFile(chunk_csv.file_path);
+		}
+
 		log_info("Shockwave Player: Finished exporting the cache.");	
 	}
 	terminate_cache_exporter(exporter);
@@ -298,36 +1261,79 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_shockwave_files_callback)
 	Exporter* exporter = file_params->exporter;
 	Arena* arena = &(exporter->temporary_arena);
 
+	set_exporter_output_copy_subdirectory(exporter, file_params->output_subdirectory);
+
 	TCHAR* filename = callback_info->object_name;
 
 	TCHAR full_location_on_cache[MAX_PATH_CHARS] = T("");
 	PathCombine(full_location_on_cache, callback_info->directory_path, filename);
 
 	bool is_xtra = filename_ends_with(filename, T(".x32"));
-	TCHAR* director_file_type = (is_xtra) ? (T("Xtra")) : (get_director_file_type_from_file_signature(full_location_on_cache));
 
-	TCHAR* xtra_description = NULL;
-	TCHAR* xtra_version = NULL;
-	TCHAR* xtra_copyright = NULL;
+	Director_Chunk_Csv* chunk_csv = file_params->chunk_csv;
+	bool extract_media = exporter->extract_director_media && exporter->copy_files;
+
+	// Each Director file is only opened once. Its first bytes determine the file type and, if the chunks are listed or extracted,
+	// the memory map is read right after them using the same handle. The media chunks are read in order of their offsets after the
+	// entry is exported so that they're only extracted if the entry was allowed by the group filter.
+	TCHAR* director_file_type = NULL;
+	HANDLE director_file_handle = INVALID_HANDLE_VALUE;
+	Director_File director_file = {};
+	bool read_director_map = false;
 
 	if(is_xtra)
 	{
-		if(!get_file_info(arena, full_location_on_cache, INFO_FILE_DESCRIPTION, &xtra_description))
+		director_file_type = T("Xtra");
+	}
+	else
+	{
+		director_file_handle = create_handle(full_location_on_cache, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL);
+
+		u8 file_buffer[MAX_DIRECTOR_SIGNATURE_READ_SIZE] = {};
+		u32 num_bytes_read = 0;
+
+		if(director_file_handle != INVALID_HANDLE_VALUE
+			&& read_first_file_bytes(director_file_handle, file_buffer, MAX_DIRECTOR_SIGNATURE_READ_SIZE, true, &num_bytes_read))
+		{
+			director_file_type = get_director_file_type_from_file_signature(file_buffer, num_bytes_read);
+
+			if((chunk_csv != NULL || extract_media) && num_bytes_read >= MIN_RIFX_CHUNK_READ_SIZE)
+			{
+				read_director_map = read_director_file(arena, full_location_on_cache, director_file_handle, file_buffer, &director_file);
+			}
+		}
+		else
+		{
+			log_warning("Shockwave Player: Could not read the file signature of '%s'.", filename);
+		}
+	}
+
+	File_Info xtra_info = {};
+
+	if(is_xtra)
+	{
+		get_file_info(arena, full_location_on_cache, &xtra_info);
+
+		if(xtra_info.strings[INFO_FILE_DESCRIPTION] == NULL)
 		{
 			log_warning("Shockwave Player: No file description found for the Xtra '%s'.", filename);
 		}
 
-		if(!get_file_info(arena, full_location_on_cache, INFO_PRODUCT_VERSION, &xtra_version))
+		if(xtra_info.strings[INFO_PRODUCT_VERSION] == NULL)
 		{
 			log_warning("Shockwave Player: No product version found for the Xtra '%s'.", filename);
 		}
 
-		if(!get_file_info(arena, full_location_on_cache, INFO_LEGAL_COPYRIGHT, &xtra_copyright))
+		if(xtra_info.strings[INFO_LEGAL_COPYRIGHT] == NULL)
 		{
 			log_warning("Shockwave Player: No copyright found for the Xtra '%s'.", filename);
 		}		
 	}
 
+	TCHAR* xtra_description = xtra_info.strings[INFO_FILE_DESCRIPTION];
+	TCHAR* xtra_version = xtra_info.strings[INFO_PRODUCT_VERSION];
+	TCHAR* xtra_copyright = xtra_info.strings[INFO_LEGAL_COPYRIGHT];
+
 	TCHAR short_location_on_cache[MAX_PATH_CHARS] = T("");
 
 	if(file_params->is_appdata_cache)
@@ -354,7 +1360,37 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_shockwave_files_callback)
 	exporter_params.short_location_on_cache = short_location_on_cache;
 	exporter_params.file_info = callback_info;
 
+	// Keep the memory map since export_cache_entry() clears the temporary arena back to its last lock.
+	lock_arena(arena);
+
 	export_cache_entry(exporter, csv_row, &exporter_params);
 
+	if(read_director_map && exporter->was_last_entry_exported)
+	{
+		if(extract_media)
+		{
+			// E.g. "SW\Cache\mpb02684.dcr_Media".
+			TCHAR output_directory_path[MAX_PATH_CHARS] = T("");
+			PathCombine(output_directory_path, exporter->output_copy_path, filename);
+			StringCchCat(output_directory_path, MAX_PATH_CHARS, T("_Media"));
+
+			extract_director_media(arena, full_location_on_cache, director_file_handle, &director_file, output_directory_path);
+		}
+
+		if(chunk_csv != NULL)
+		{
+			TCHAR* location_on_cache = (exporter->show_full_paths) ? (full_location_on_cache) : (short_location_on_cache);
+			print_director_chunks(arena, chunk_csv, location_on_cache, &director_file);
+		}
+	}
+
+	clear_arena(arena);
+	unlock_arena(arena);
+
+	// Free the memory map.
+	clear_arena(arena);
+
+	safe_close_handle(&director_file_handle);
+
 	return true;
 }
@@ -5,6 +5,9 @@
 	This file defines how the exporter processes the Unity Web Player's cache. This location includes cached AssetBundle files whose
 	assets (models, textures, audio, etc) can be extracted using other tools.
 
+	The assets in UnityWeb and UnityRaw bundles may also be listed in a separate CSV file and extracted directly to the output
+	directory. See: read_unity_bundle().
+
 	@SupportedFormats: Not yet determined.
 
 	@DefaultCacheLocations:
@@ -29,6 +32,9 @@
 
 	[UABE] "Unity Assets Bundle Extractor 2.2"
 	--> https://github.com/DerPopo/UABE
+
+	[AS] "AssetStudio v0.15.0"
+	--> https://github.com/Perfare/AssetStudio
 */
 
 static Csv_Type CSV_COLUMN_TYPES[] =
@@ -41,6 +47,40 @@ static Csv_Type CSV_COLUMN_TYPES[] =
 
 static const int CSV_NUM_COLUMNS = _countof(CSV_COLUMN_TYPES);
 
+// The columns of the separate CSV file that lists the assets in each cached bundle. The location on cache matches the one in the
+// main CSV file and identifies the cache entry.
+static Csv_Type ASSET_CSV_COLUMN_TYPES[] =
+{
+	CSV_LOCATION_ON_CACHE, CSV_MEMBER_NAME, CSV_UNCOMPRESSED_SIZE, CSV_LOCATION_IN_OUTPUT
+};
+
+static const int ASSET_CSV_NUM_COLUMNS = _countof(ASSET_CSV_COLUMN_TYPES);
+
+// The separate CSV file that lists the assets in each cached bundle. See: print_unity_bundle_assets().
+struct Unity_Asset_Csv
+{
+	HANDLE file_handle;
+	TCHAR file_path[MAX_PATH_CHARS];
+	bool listed_at_least_one_asset;
+};
+
+// The metadata that is shared by every cached file in the same directory. Since the files in a directory are visited one after
+// the other, the __info file is only read and parsed once per directory.
+struct Unity_Directory_Metadata
+{
+	TCHAR directory_path[MAX_PATH_CHARS];
+	TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS];
+};
+
+// The parameters passed to find_unity_cache_files_callback().
+struct Find_Unity_Cache_Files_Params
+{
+	Exporter* exporter;
+	Unity_Directory_Metadata metadata;
+	// The asset CSV file, or NULL if the bundles' assets shouldn't be listed.
+	Unity_Asset_Csv* asset_csv;
+};
+
 // Entry point for the Unity Web Player's cache exporter. This function will determine where to look for the cache before
 // processing its contents.
 //
@@ -67,13 +107,732 @@ void export_default_or_specific_unity_cache(Exporter* exporter)
 
 		log_info("Unity Web Player: Exporting the cache from '%s'.", exporter->cache_path);
 		
-		traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_unity_cache_files_callback, exporter);
+		Find_Unity_Cache_Files_Params params = {};
+		params.exporter = exporter;
+
+		Unity_Asset_Csv asset_csv = {};
+		asset_csv.file_handle = INVALID_HANDLE_VALUE;
+
+		if(exporter->create_csvs && exporter->list_unity_bundle_assets)
+		{
+			// E.g. "UN.csv" and "UN_Bundle_Assets.csv".
+			StringCchCopy(asset_csv.file_path, MAX_PATH_CHARS, exporter->output_copy_path);
+			StringCchCat(asset_csv.file_path, MAX_PATH_CHARS, T("_Bundle_Assets.csv"));
+
+			if(create_csv_file(asset_csv.file_path, &(asset_csv.file_handle)))
+			{
+				++(exporter->total_csv_files_created);
+				csv_print_header(&(exporter->temporary_arena), asset_csv.file_handle, ASSET_CSV_COLUMN_TYPES, ASSET_CSV_NUM_COLUMNS);
+				clear_arena(&(exporter->temporary_arena));
+				params.asset_csv = &asset_csv;
+			}
+			else
+			{
+				log_error("Unity Web Player: Failed to create the asset CSV file '%s'.", asset_csv.file_path);
+				++(exporter->total_export_errors);
+			}
+		}
+
+		traverse_directory_objects(exporter->cache_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, find_unity_cache_files_callback, &params);
 		
+		safe_close_handle(&(asset_csv.file_handle));
+		if(params.asset_csv != NULL && !asset_csv.listed_at_least_one_asset)
+		{
+			log_info("Unity Web Player: Deleting the asset CSV file '%s' since no bundle assets were listed.", asset_csv.file_path);
+			DeleteFile(asset_csv.file_path);
+		}
+
 		log_info("Unity Web Player: Finished exporting the cache.");
 	}
 	terminate_cache_exporter(exporter);
 }
 
+/*
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>> UNITY BUNDLES
+	>>>>>>>>>>>>>>>>>>>>
+	>>>>>>>>>>>>>>>>>>>>
+*/
+
+// The cached files are usually AssetBundles in the UnityWeb (LZMA compressed) or UnityRaw (uncompressed) formats. These start with a
+// header that is followed by the bundle's data. This data begins with a directory that lists the name, offset, and size of each asset.
+//
+// @Docs: Based on the "BundleFile" class from AssetStudio by Perfare - https://github.com/Perfare/AssetStudio
+
+static const char UNITY_WEB_SIGNATURE[] = "UnityWeb";
+static const char UNITY_RAW_SIGNATURE[] = "UnityRaw";
+
+// The header is small and only contains a few strings and integers, so we'll only read the first few bytes of each file.
+static const u32 MAX_UNITY_BUNDLE_HEADER_SIZE = 1024;
+// The directory is stored at the beginning of the data and is usually only a few hundred bytes long.
+static const u32 MAX_UNITY_BUNDLE_DIRECTORY_SIZE = 64 * 1024;
+static const u32 MAX_UNITY_BUNDLE_ASSETS = 0x10000;
+
+struct Unity_Bundle_Asset
+{
+	TCHAR* name;
+	u32 offset;
+	u32 size;
+
+	// Only used when extracting the assets.
+	bool skip_extraction;
+	TCHAR* output_path;
+};
+
+struct Unity_Bundle
+{
+	bool is_compressed;
+	u32 format_version;
+
+	// Where the data begins in the file. For UnityWeb bundles, this is where the LZMA stream begins.
+	u32 data_offset;
+	// Where the data ends in the file.
+	u64 data_end_offset;
+	
+	u32 num_assets;
+	Unity_Bundle_Asset* assets;
+};
+
+// Reads a UnityWeb or UnityRaw bundle's header.
+//
+// @Parameters:
+// 1. file_handle - The handle to the bundle file.
+// 2. file_size - The size of the bundle file.
+// 3. result_bundle - The Unity_Bundle structure that receives the location of the bundle's data.
+//
+// @Returns: True if the file is a UnityWeb or UnityRaw bundle with a valid header. Otherwise, false.
+static bool read_unity_bundle_header(HANDLE file_handle, u64 file_size, Unity_Bundle* result_bundle)
+{
+	u8 header[MAX_UNITY_BUNDLE_HEADER_SIZE] = {};
+	u32 num_bytes_read = 0;
+	if(!read_first_file_bytes(file_handle, header, MAX_UNITY_BUNDLE_HEADER_SIZE, true, &num_bytes_read)) return false;
+
+	const u8* file = header;
+	u32 remaining_file_size = num_bytes_read;
+	bool reached_end_of_file = false;
+
+	// @FormatVersion: Bundle format versions 1 to 3 (Unity 3 and 4).
+	// @ByteOrder: Big Endian.
+	// @CharacterEncoding: ASCII.
+
+	// Helper macro function used to read an integer of any size at the current header position.
+	#define READ_INTEGER(variable)\
+	do\
+	{\
+		if(remaining_file_size < sizeof(variable)) reached_end_of_file = true;\
+		if(reached_end_of_file) break;\
+		\
+		CopyMemory(&variable, file, sizeof(variable));\
+		BIG_ENDIAN_TO_HOST(variable);\
+		\
+		file += sizeof(variable);\
+		remaining_file_size -= sizeof(variable);\
+	} while(false, false)
+
+	// Helper macro function used to read a null terminated string at the current header position.
+	#define READ_STRING(variable)\
+	do\
+	{\
+		variable = NULL;\
+		if(reached_end_of_file) break;\
+		\
+		const u8* string_end = (const u8*) memchr(file, '\0', remaining_file_size);\
+		if(string_end == NULL) reached_end_of_file = true;\
+		if(reached_end_of_file) break;\
+		\
+		variable = (const char*) file;\
+		u32 string_size = (u32) (string_end - file) + 1;\
+		file += string_size;\
+		remaining_file_size -= string_size;\
+	} while(false, false)
+
+	const char* signature = NULL;
+	READ_STRING(signature);
+	if(reached_end_of_file) return false;
+
+	bool is_compressed = strings_are_equal(signature, UNITY_WEB_SIGNATURE);
+	if(!is_compressed && !strings_are_equal(signature, UNITY_RAW_SIGNATURE)) return false;
+
+	u32 format_version = 0;
+	READ_INTEGER(format_version);
+
+	const char* player_version = NULL;
+	READ_STRING(player_version);
+
+	const char* engine_version = NULL;
+	READ_STRING(engine_version);
+
+	player_version; engine_version;
+
+	if(format_version >= 4)
+	{
+		// Skip the 16 byte hash.
+		const u32 HASH_SIZE = 16;
+		if(remaining_file_size < HASH_SIZE) reached_end_of_file = true;
+		if(!reached_end_of_file)
+		{
+			file += HASH_SIZE;
+			remaining_file_size -= HASH_SIZE;
+		}
+
+		u32 crc = 0;
+		READ_INTEGER(crc);
+	}
+
+	u32 minimum_streamed_bytes = 0;
+	READ_INTEGER(minimum_streamed_bytes);
+
+	u32 header_size = 0;
+	READ_INTEGER(header_size);
+
+	u32 num_levels_before_streaming = 0;
+	READ_INTEGER(num_levels_before_streaming);
+
+	minimum_streamed_bytes; num_levels_before_streaming;
+
+	// The sizes are cumulative, meaning the last level covers the entire data.
+	s32 num_levels = 0;
+	READ_INTEGER(num_levels);
+
+	u32 compressed_size = 0;
+	for(s32 i = 0; i < num_levels && !reached_end_of_file; ++i)
+	{
+		u32 uncompressed_size = 0;
+		READ_INTEGER(compressed_size);
+		READ_INTEGER(uncompressed_size);
+		uncompressed_size;
+	}
+
+	#undef READ_INTEGER
+	#undef READ_STRING
+
+	if(reached_end_of_file)
+	{
+		log_warning("Read Unity Bundle Header: Reached the end of the header while reading a bundle with the format version %I32u.", format_version);
+		return false;
+	}
+
+	if(header_size < (u32) (file - header) || header_size > file_size)
+	{
+		log_warning("Read Unity Bundle Header: Found the invalid header size %I32u in a bundle with %I64u bytes.", header_size, file_size);
+		return false;
+	}
+
+	result_bundle->is_compressed = is_compressed;
+	result_bundle->format_version = format_version;
+	result_bundle->data_offset = header_size;
+	result_bundle->data_end_offset = file_size;
+	if(is_compressed && compressed_size > 0)
+	{
+		result_bundle->data_end_offset = MIN((u64) header_size + compressed_size, file_size);
+	}
+
+	return true;
+}
+
+enum Unity_Directory_Result
+{
+	UNITY_DIRECTORY_PARSED = 0,
+	UNITY_DIRECTORY_INCOMPLETE = 1,
+	UNITY_DIRECTORY_INVALID = 2
+};
+
+// Parses the directory at the beginning of a bundle's data. The data is first checked without allocating any memory so this
+// function may be called again once more data is available.
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the assets and their names.
+// 2. data - The beginning of the bundle's data.
+// 3. data_size - The size of the data buffer.
+// 4. total_data_size - The size of the bundle's data, or zero if it's unknown. Used to validate each asset's offset and size.
+// 5. bundle - The Unity_Bundle structure that receives the assets.
+//
+// @Returns: UNITY_DIRECTORY_PARSED if the directory was parsed successfully, UNITY_DIRECTORY_INCOMPLETE if more data is required,
+// or UNITY_DIRECTORY_INVALID if the data doesn't contain a valid directory.
+static Unity_Directory_Result parse_unity_bundle_directory(Arena* arena, const u8* data, u32 data_size, u64 total_data_size, Unity_Bundle* bundle)
+{
+	const u8* file = data;
+	u32 remaining_file_size = data_size;
+	bool reached_end_of_file = false;
+
+	// @ByteOrder: Big Endian.
+	// @CharacterEncoding: UTF-8.
+
+	// Helper macro function used to read an integer of any size at the current directory position.
+	#define READ_INTEGER(variable)\
+	do\
+	{\
+		if(remaining_file_size < sizeof(variable)) reached_end_of_file = true;\
+		if(reached_end_of_file) break;\
+		\
+		CopyMemory(&variable, file, sizeof(variable));\
+		BIG_ENDIAN_TO_HOST(variable);\
+		\
+		file += sizeof(variable);\
+		remaining_file_size -= sizeof(variable);\
+	} while(false, false)
+
+	// Helper macro function used to read a null terminated string at the current directory position.
+	#define READ_STRING(variable)\
+	do\
+	{\
+		variable = NULL;\
+		if(reached_end_of_file) break;\
+		\
+		const u8* string_end = (const u8*) memchr(file, '\0', remaining_file_size);\
+		if(string_end == NULL) reached_end_of_file = true;\
+		if(reached_end_of_file) break;\
+		\
+		variable = (const char*) file;\
+		u32 string_size = (u32) (string_end - file) + 1;\
+		file += string_size;\
+		remaining_file_size -= string_size;\
+	} while(false, false)
+
+	u32 num_assets = 0;
+	READ_INTEGER(num_assets);
+	if(reached_end_of_file) return UNITY_DIRECTORY_INCOMPLETE;
+	if(num_assets > MAX_UNITY_BUNDLE_ASSETS) return UNITY_DIRECTORY_INVALID;
+
+	const u8* first_asset = file;
+	u32 first_asset_remaining_size = remaining_file_size;
+
+	// Make sure we have the entire directory before allocating anything.
+	for(u32 i = 0; i < num_assets; ++i)
+	{
+		const char* name = NULL;
+		READ_STRING(name);
+		
+		u32 offset = 0;
+		READ_INTEGER(offset);
+		
+		u32 size = 0;
+		READ_INTEGER(size);
+
+		name;
+
+		if(reached_end_of_file) return UNITY_DIRECTORY_INCOMPLETE;
+		if(total_data_size > 0 && (u64) offset + size > total_data_size) return UNITY_DIRECTORY_INVALID;
+	}
+
+	file = first_asset;
+	remaining_file_size = first_asset_remaining_size;
+
+	bundle->num_assets = num_assets;
+	bundle->assets = push_array_to_arena(arena, num_assets, Unity_Bundle_Asset);
+
+	for(u32 i = 0; i < num_assets; ++i)
+	{
+		Unity_Bundle_Asset* asset = &(bundle->assets[i]);
+
+		const char* name = NULL;
+		READ_STRING(name);
+		READ_INTEGER(asset->offset);
+		READ_INTEGER(asset->size);
+
+		asset->name = convert_utf_8_string_to_tchar(arena, name);
+		if(asset->name == NULL) asset->name = T("");
+		asset->skip_extraction = false;
+		asset->output_path = NULL;
+	}
+
+	#undef READ_INTEGER
+	#undef READ_STRING
+
+	_ASSERT(!reached_end_of_file);
+
+	return UNITY_DIRECTORY_PARSED;
+}
+
+// Called by qsort() to sort the assets by their offsets.
+static int compare_unity_bundle_asset_offsets(const void* asset_pointer_1, const void* asset_pointer_2)
+{
+	Unity_Bundle_Asset* asset_1 = (Unity_Bundle_Asset*) asset_pointer_1;
+	Unity_Bundle_Asset* asset_2 = (Unity_Bundle_Asset*) asset_pointer_2;
+	
+	if(asset_1->offset < asset_2->offset) return -1;
+	else if(asset_1->offset > asset_2->offset) return 1;
+	else return 0;
+}
+
+// Prepares a bundle's assets to be extracted sequentially. The assets are sorted by their offsets, and any asset that overlaps
+// the previous one is skipped.
+//
+// @Parameters:
+// 1. bundle - The Unity_Bundle structure whose directory was parsed.
+//
+// @Returns: Nothing.
+static void sort_unity_bundle_assets_for_extraction(Unity_Bundle* bundle)
+{
+	qsort(bundle->assets, bundle->num_assets, sizeof(Unity_Bundle_Asset), compare_unity_bundle_asset_offsets);
+
+	u64 previous_end = 0;
+	for(u32 i = 0; i < bundle->num_assets; ++i)
+	{
+		Unity_Bundle_Asset* asset = &(bundle->assets[i]);
+		if(asset->offset < previous_end)
+		{
+			log_warning("Sort Unity Bundle Assets: Skipping the asset '%s' since it overlaps the previous one.", asset->name);
+			asset->skip_extraction = true;
+		}
+		else
+		{
+			previous_end = (u64) asset->offset + asset->size;
+		}
+	}
+}
+
+// Determines the path where an asset will be extracted to. Any path separators in the asset's name are replaced since
+// they're always extracted to the same directory.
+//
+// @Parameters:
+// 1. output_directory_path - The directory where the assets are extracted to.
+// 2. asset - The Unity_Bundle_Asset structure.
+// 3. asset_index - The asset's index. Used when it doesn't have a name.
+// 4. result_path - The buffer that receives the path. This buffer must be able to hold MAX_PATH_CHARS characters.
+//
+// @Returns: True if the path was built successfully. Otherwise, false.
+static bool get_unity_bundle_asset_output_path(const TCHAR* output_directory_path, Unity_Bundle_Asset* asset, u32 asset_index, TCHAR* result_path)
+{
+	TCHAR asset_filename[MAX_PATH_CHARS] = T("");
+	if(string_is_empty(asset->name))
+	{
+		StringCchPrintf(asset_filename, MAX_PATH_CHARS, T("Asset_%I32u"), asset_index);
+	}
+	else
+	{
+		StringCchCopy(asset_filename, MAX_PATH_CHARS, asset->name);
+	}
+
+	for(TCHAR* c = asset_filename; *c != T('\0'); ++c)
+	{
+		if(*c == T('/') || *c == T('\\')) *c = T('_');
+	}
+
+	correct_url_path_characters(asset_filename);
+	truncate_path_components(asset_filename);
+	correct_reserved_path_components(asset_filename);
+
+	return PathCombine(result_path, output_directory_path, asset_filename) != NULL;
+}
+
+// The state that is kept while decompressing a UnityWeb bundle. See: unity_bundle_output_callback().
+struct Unity_Bundle_Stream
+{
+	Arena* arena;
+	Unity_Bundle* bundle;
+	u64 total_data_size;
+
+	// The beginning of the decompressed data, which contains the directory.
+	u8* directory_data;
+	u32 directory_size;
+	Unity_Directory_Result directory_result;
+
+	// Only used when extracting the assets.
+	bool extract_assets;
+	const TCHAR* output_directory_path;
+	u64 data_position;
+	u32 next_asset_index;
+	HANDLE asset_handle;
+};
+
+// Writes a chunk of a bundle's data to every asset that overlaps it. The chunks must be passed in order and the assets must have
+// been sorted first. Each asset file is created when its first byte is found and closed when its last byte is written.
+//
+// @Parameters:
+// 1. stream - The Unity_Bundle_Stream structure that keeps track of the current position in the data.
+// 2. data - The chunk of data.
+// 3. data_size - The size of the chunk.
+//
+// @Returns: Nothing.
+static void write_unity_bundle_assets(Unity_Bundle_Stream* stream, const u8* data, u32 data_size)
+{
+	Unity_Bundle* bundle = stream->bundle;
+
+	u64 chunk_begin = stream->data_position;
+	u64 chunk_end = chunk_begin + data_size;
+	u64 position = chunk_begin;
+
+	while(stream->next_asset_index < bundle->num_assets)
+	{
+		Unity_Bundle_Asset* asset = &(bundle->assets[stream->next_asset_index]);
+
+		if(asset->skip_extraction)
+		{
+			++(stream->next_asset_index);
+			continue;
+		}
+
+		u64 asset_begin = asset->offset;
+		u64 asset_end = asset_begin + asset->size;
+
+		// Empty assets at the end of the chunk are created right away.
+		if(asset_begin > chunk_end || (asset_begin == chunk_end && asset->size > 0)) break;
+
+		if(stream->asset_handle == INVALID_HANDLE_VALUE)
+		{
+			TCHAR asset_path[MAX_PATH_CHARS] = T("");
+			if(get_unity_bundle_asset_output_path(stream->output_directory_path, asset, stream->next_asset_index, asset_path))
+			{
+				stream->asset_handle = create_handle(asset_path, GENERIC_WRITE, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL);
+			}
+
+			if(stream->asset_handle == INVALID_HANDLE_VALUE)
+			{
+				log_error("Write Unity Bundle Assets: Failed to create the file for the asset '%s' in '%s' with the error code %lu.", asset->name, stream->output_directory_path, GetLastError());
+				asset->skip_extraction = true;
+				++(stream->next_asset_index);
+				continue;
+			}
+
+			asset->output_path = push_string_to_arena(stream->arena, asset_path);
+		}
+
+		u64 write_begin = MAX(position, asset_begin);
+		u64 write_end = MIN(chunk_end, asset_end);
+		if(write_end > write_begin)
+		{
+			write_to_file(stream->asset_handle, data + (write_begin - chunk_begin), (u32) (write_end - write_begin));
+		}
+
+		if(asset_end > chunk_end) break;
+
+		safe_close_handle(&(stream->asset_handle));
+		++(stream->next_asset_index);
+		position = asset_end;
+	}
+
+	stream->data_position = chunk_end;
+}
+
+// Called every time a chunk of a UnityWeb bundle's data is decompressed. The data is accumulated until the directory can be parsed.
+// After that, the decoder is either stopped (if we only want to list the assets) or the data is written to each asset file.
+//
+// @Parameters: See the LZMA_OUTPUT_CALLBACK macro.
+//
+// @Returns: True if the decoder should continue. Otherwise, false.
+static LZMA_OUTPUT_CALLBACK(unity_bundle_output_callback)
+{
+	Unity_Bundle_Stream* stream = (Unity_Bundle_Stream*) user_data;
+
+	if(stream->directory_result == UNITY_DIRECTORY_INCOMPLETE)
+	{
+		u32 num_bytes_to_copy = MIN(data_size, MAX_UNITY_BUNDLE_DIRECTORY_SIZE - stream->directory_size);
+		CopyMemory(stream->directory_data + stream->directory_size, data, num_bytes_to_copy);
+		stream->directory_size += num_bytes_to_copy;
+		data += num_bytes_to_copy;
+		data_size -= num_bytes_to_copy;
+
+		stream->directory_result = parse_unity_bundle_directory(stream->arena, stream->directory_data, stream->directory_size, stream->total_data_size, stream->bundle);
+		
+		if(stream->directory_result == UNITY_DIRECTORY_INCOMPLETE && stream->directory_size == MAX_UNITY_BUNDLE_DIRECTORY_SIZE)
+		{
+			stream->directory_result = UNITY_DIRECTORY_INVALID;
+		}
+
+		if(stream->directory_result != UNITY_DIRECTORY_PARSED) return stream->directory_result == UNITY_DIRECTORY_INCOMPLETE;
+		if(!stream->extract_assets) return false;
+
+		sort_unity_bundle_assets_for_extraction(stream->bundle);
+		write_unity_bundle_assets(stream, stream->directory_data, stream->directory_size);
+	}
+
+	write_unity_bundle_assets(stream, data, data_size);
+	return true;
+}
+
+// Reads a cached UnityWeb or UnityRaw bundle's directory and optionally extracts its assets. For UnityWeb bundles, only the beginning
+// of the LZMA stream is decompressed when listing the assets, and the entire stream is decompressed once when extracting them.
+//
+// @Parameters:
+// 1. arena - The Arena structure that receives the assets. This arena is also used to decompress the directory.
+// 2. bundle_path - The path to the bundle file.
+// 3. output_directory_path - The directory where the assets are extracted to. This directory is only created if the file is a bundle,
+// and a different name is used if it already exists. This parameter may be NULL if the assets shouldn't be extracted.
+// 4. result_bundle - The Unity_Bundle structure that receives the assets.
+//
+// @Returns: True if the file is a bundle and its directory was read successfully. Otherwise, false. The assets are listed even if
+// they couldn't all be extracted.
+static bool read_unity_bundle(Arena* arena, const TCHAR* bundle_path, const TCHAR* output_directory_path, Unity_Bundle* result_bundle)
+{
+	bool success = false;
+	HANDLE bundle_handle = create_handle(bundle_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL);
+	
+	if(bundle_handle == INVALID_HANDLE_VALUE)
+	{
+		log_error("Read Unity Bundle: Failed to open the bundle '%s' with the error code %lu.", bundle_path, GetLastError());
+		goto clean_up;
+	}
+
+	{
+		u64 file_size = 0;
+		if(!get_file_size(bundle_handle, &file_size)) goto clean_up;
+		
+		Unity_Bundle bundle = {};
+		if(!read_unity_bundle_header(bundle_handle, file_size, &bundle)) goto clean_up;
+
+		TCHAR resolved_output_directory_path[MAX_PATH_CHARS] = T("");
+		bool extract_assets = (output_directory_path != NULL);
+		if(extract_assets && !create_directories(output_directory_path, true, resolved_output_directory_path))
+		{
+			log_error("Read Unity Bundle: Failed to create the directory '%s' for the assets in the bundle '%s'.", output_directory_path, bundle_path);
+			extract_assets = false;
+		}
+
+		if(bundle.is_compressed)
+		{
+
+			// When listing the assets, the window only needs to hold the directory since any match that goes past it would
+			// mean that we've already decompressed the entire directory.
+			Lzma_Properties properties = {};
+			u32 max_window_size = (extract_assets) ? (0xFFFFFFFF) : (MAX_UNITY_BUNDLE_DIRECTORY_SIZE);
+			if(!read_lzma_properties(bundle_handle, bundle.data_offset, max_window_size, &properties)) goto clean_up;
+
+			Unity_Bundle_Stream stream = {};
+			stream.arena = arena;
+			stream.bundle = &bundle;
+			stream.total_data_size = (properties.uncompressed_size != LZMA_UNKNOWN_SIZE) ? (properties.uncompressed_size) : (0);
+			stream.directory_data = push_arena(arena, MAX_UNITY_BUNDLE_DIRECTORY_SIZE, u8);
+			stream.directory_size = 0;
+			stream.directory_result = UNITY_DIRECTORY_INCOMPLETE;
+			stream.extract_assets = extract_assets;
+			stream.output_directory_path = resolved_output_directory_path;
+			stream.asset_handle = INVALID_HANDLE_VALUE;
+
+			// The dictionary used by UnityWeb bundles is usually too large for the temporary memory so we'll allocate it separately
+			// when extracting the assets.
+			Arena decoder_arena = NULL_ARENA;
+			Arena* lzma_arena = arena;
+			if(extract_assets)
+			{
+				if(!create_arena(&decoder_arena, properties.required_memory_size))
+				{
+					log_error("Read Unity Bundle: Failed to allocate %Iu bytes to decompress the bundle '%s'.", properties.required_memory_size, bundle_path);
+					goto clean_up;
+				}
+				lzma_arena = &decoder_arena;
+			}
+
+			Lzma_Input input = {};
+			input.file_handle = bundle_handle;
+			input.file_offset = (u64) bundle.data_offset + LZMA_HEADER_SIZE;
+			input.file_end_offset = bundle.data_end_offset;
+
+			Lzma_Decoder* decoder = create_lzma_decoder(lzma_arena, &properties, &input, unity_bundle_output_callback, &stream);
+			
+			bool decoded_stream = (decoder != NULL) && decode_lzma_stream(decoder);
+			
+			// Write any empty assets at the end of the data.
+			if(decoded_stream && extract_assets && stream.directory_result == UNITY_DIRECTORY_PARSED)
+			{
+				write_unity_bundle_assets(&stream, NULL, 0);
+			}
+
+			if(stream.asset_handle != INVALID_HANDLE_VALUE)
+			{
+				log_warning("Read Unity Bundle: The last asset in the bundle '%s' was only partially extracted.", bundle_path);
+				safe_close_handle(&(stream.asset_handle));
+			}
+
+			if(extract_assets) destroy_arena(&decoder_arena);
+
+			if(!decoded_stream)
+			{
+				log_warning("Read Unity Bundle: Failed to decompress the bundle '%s'.", bundle_path);
+			}
+
+			if(stream.directory_result != UNITY_DIRECTORY_PARSED)
+			{
+				log_warning("Read Unity Bundle: Could not find a valid directory in the bundle '%s'.", bundle_path);
+				goto clean_up;
+			}
+		}
+		else
+		{
+			u64 total_data_size = file_size - bundle.data_offset;
+			if(total_data_size == 0) goto clean_up;
+
+			u32 directory_size = (u32) MIN(total_data_size, (u64) MAX_UNITY_BUNDLE_DIRECTORY_SIZE);
+			u8* directory_data = push_arena(arena, directory_size, u8);
+			
+			if(!read_file_chunk(bundle_handle, directory_data, directory_size, bundle.data_offset)) goto clean_up;
+
+			if(parse_unity_bundle_directory(arena, directory_data, directory_size, total_data_size, &bundle) != UNITY_DIRECTORY_PARSED)
+			{
+				log_warning("Read Unity Bundle: Could not find a valid directory in the bundle '%s'.", bundle_path);
+				goto clean_up;
+			}
+
+			if(extract_assets)
+			{
+				for(u32 i = 0; i < bundle.num_assets; ++i)
+				{
+					Unity_Bundle_Asset* asset = &(bundle.assets[i]);
+
+					// Clear the file buffer that is used to copy each asset so we don't run out of memory in large bundles.
+					lock_arena(arena);
+					TCHAR asset_path[MAX_PATH_CHARS] = T("");
+					bool copied_asset = get_unity_bundle_asset_output_path(resolved_output_directory_path, asset, i, asset_path)
+										&& copy_file_chunks(arena, bundle_path, asset->size, (u64) bundle.data_offset + asset->offset, asset_path, true);
+					clear_arena(arena);
+					unlock_arena(arena);
+
+					if(copied_asset)
+					{
+						asset->output_path = push_string_to_arena(arena, asset_path);
+					}
+					else
+					{
+						log_error("Read Unity Bundle: Failed to extract the asset '%s' from the bundle '%s'.", asset->name, bundle_path);
+					}
+				}
+			}
+		}
+
+		*result_bundle = bundle;
+		success = true;
+	}
+
+	clean_up:;
+
+	safe_close_handle(&bundle_handle);
+	return success;
+}
+
+// Writes one row per asset in a cached bundle to the asset CSV file.
+//
+// @Parameters:
+// 1. arena - The Arena structure where any intermediary strings are stored.
+// 2. asset_csv - The Unity_Asset_Csv structure that contains the CSV file's handle.
+// 3. location_on_cache - The location of the bundle, which is shown in the main CSV file.
+// 4. bundle - The Unity_Bundle structure that contains the assets.
+//
+// @Returns: Nothing.
+static void print_unity_bundle_assets(Arena* arena, Unity_Asset_Csv* asset_csv, TCHAR* location_on_cache, Unity_Bundle* bundle)
+{
+	for(u32 i = 0; i < bundle->num_assets; ++i)
+	{
+		Unity_Bundle_Asset* asset = &(bundle->assets[i]);
+
+		TCHAR size[MAX_INT_32_CHARS] = T("");
+		convert_u32_to_string(asset->size, size);
+
+		Csv_Entry csv_row[] =
+		{
+			{location_on_cache}, {asset->name}, {size}, {asset->output_path}
+		};
+		_STATIC_ASSERT(_countof(csv_row) == ASSET_CSV_NUM_COLUMNS);
+
+		lock_arena(arena);
+		csv_print_row(arena, asset_csv->file_handle, csv_row, ASSET_CSV_NUM_COLUMNS);
+		clear_arena(arena);
+		unlock_arena(arena);
+	}
+
+	if(bundle->num_assets > 0) asset_csv->listed_at_least_one_asset = true;
+}
+
 // Called every time a file is found in the Unity Web Player's cache. Used to export every cache entry.
 //
 // @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
@@ -81,8 +840,10 @@ void export_default_or_specific_unity_cache(Exporter* exporter)
 // @Returns: True.
 static TRAVERSE_DIRECTORY_CALLBACK(find_unity_cache_files_callback)
 {
-	Exporter* exporter = (Exporter*) callback_info->user_data;
+	Find_Unity_Cache_Files_Params* find_params = (Find_Unity_Cache_Files_Params*) callback_info->user_data;
+	Exporter* exporter = find_params->exporter;
 	Arena* arena = &(exporter->temporary_arena);
+	Unity_Directory_Metadata* metadata = &(find_params->metadata);
 
 	TCHAR* filename = callback_info->object_name;
 
@@ -94,14 +855,16 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_unity_cache_files_callback)
 
 	TCHAR* full_location_on_cache = callback_info->object_path;
 	TCHAR* short_location_on_cache = skip_to_last_path_components(full_location_on_cache, 3);
+
+	if(!strings_are_equal(metadata->directory_path, callback_info->directory_path))
 	{
+		StringCchCopy(metadata->directory_path, MAX_PATH_CHARS, callback_info->directory_path);
+		metadata->last_modified_time[0] = T('\0');
+
 		TCHAR copy_subdirectory[MAX_PATH_CHARS] = T("");
 		PathCombine(copy_subdirectory, short_location_on_cache, T(".."));
 		set_exporter_output_copy_subdirectory(exporter, copy_subdirectory);
-	}
 
-	TCHAR last_modified_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	{
 		TCHAR metadata_file_path[MAX_PATH_CHARS] = T("");
 		PathCombine(metadata_file_path, callback_info->directory_path, T("__info"));
 
@@ -139,19 +902,19 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_unity_cache_files_callback)
 			u64 last_modified_time_value = 0;
 			if(convert_string_to_u64(last_modified_time_in_file, &last_modified_time_value))
 			{
-				format_time64_t_date_time(last_modified_time_value, last_modified_time);
+				format_time64_t_date_time(last_modified_time_value, metadata->last_modified_time);
 			}
 		}
 		else
 		{
-			log_warning("Unity Web Player: Could not retrieve additional metadata.");
+			log_warning("Unity Web Player: Could not retrieve additional metadata from '%s'.", metadata_file_path);
 		}
 	}
 
 	Csv_Entry csv_row[] =
 	{
 		{/* Filename */}, {/* File Extension */}, {/* File Size */},
-		{last_modified_time}, {/* Creation Time */}, {/* Last Write Time */}, {/* Last Access Time */},
+		{metadata->last_modified_time}, {/* Creation Time */}, {/* Last Write Time */}, {/* Last Access Time */},
 		{/* Location On Cache */}, {/* Location In Output */}, {/* Copy Error */},
 		{/* Custom File Group */}, {/* SHA-256 */}
 	};
@@ -164,5 +927,33 @@ static TRAVERSE_DIRECTORY_CALLBACK(find_unity_cache_files_callback)
 
 	export_cache_entry(exporter, csv_row, &params);
 
+	// Inspect the bundle after exporting the cache entry so that the assets are only listed or extracted if the entry was allowed
+	// by the group filter.
+	Unity_Asset_Csv* asset_csv = find_params->asset_csv;
+	bool extract_assets = exporter->extract_unity_bundle_assets && exporter->copy_files;
+	
+	if((asset_csv != NULL || extract_assets) && exporter->was_last_entry_exported)
+	{
+		lock_arena(arena);
+
+		// E.g. "UN\<Directory>\CAB-4ebad34d111aff249881a8de4b590a07_Assets".
+		TCHAR output_directory_path[MAX_PATH_CHARS] = T("");
+		if(extract_assets)
+		{
+			PathCombine(output_directory_path, exporter->output_copy_path, filename);
+			StringCchCat(output_directory_path, MAX_PATH_CHARS, T("_Assets"));
+		}
+
+		Unity_Bundle bundle = {};
+		if(read_unity_bundle(arena, full_location_on_cache, (extract_assets) ? (output_directory_path) : (NULL), &bundle) && asset_csv != NULL)
+		{
+			TCHAR* location_on_cache = (exporter->show_full_paths) ? (full_location_on_cache) : (short_location_on_cache);
+			print_unity_bundle_assets(arena, asset_csv, location_on_cache, &bundle);
+		}
+
+		clear_arena(arena);
+		unlock_arena(arena);
+	}
+
 	return true;
 }
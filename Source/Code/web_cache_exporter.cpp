@@ -92,6 +92,9 @@
 
 static const TCHAR* LOG_FILE_NAME = T("WCE.log");
 static const TCHAR* DEFAULT_EXPORT_DIRECTORY_NAME = T("ExportedCache");
+static const TCHAR* DEFAULT_MERGE_DIRECTORY_NAME = T("MergedCache");
+// E.g. "Shard_2_of_4".
+static const TCHAR* SHARD_DIRECTORY_NAME_FORMAT = T("Shard_%d_of_%d");
 static const char* COMMAND_LINE_HELP_MESSAGE = 	"Usage: WCE.exe [Optional Arguments] <Export Argument>\n"
 												"\n"
 												"Below are some commonly used arguments. To see the full list of arguments, check the readme.txt file.\n"
@@ -135,6 +138,14 @@ static const char* COMMAND_LINE_HELP_MESSAGE = 	"Usage: WCE.exe [Optional Argume
 												"WCE.exe -overwrite -files-only -export-shockwave"
 												;
 
+// The maximum number of jobs (e.g. profiles) that are exported at the same time, regardless of their drives. This value is limited
+// by the number of threads that can be waited on at once (plus one event used by the export service).
+static const int MAX_PARALLEL_EXPORT_JOBS = 16;
+_STATIC_ASSERT(MAX_PARALLEL_EXPORT_JOBS + 1 <= MAXIMUM_WAIT_OBJECTS);
+
+// The maximum number of shards that the cache entries can be split into with the -shard option.
+static const int MAX_NUM_SHARDS = 1000;
+
 // Maps a cache exporter's short name to its cache type enum.
 //
 // @Parameters:
@@ -274,6 +285,15 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 				i += 1;
 			}
 		}
+		else if(IS_OPTION("-filter-entries", "-fe"))
+		{
+			exporter->filter_entries = true;
+			if(i+1 < num_arguments)
+			{
+				StringCchCopy(exporter->entry_filter_expression, MAX_ENTRY_FILTER_EXPRESSION_CHARS, arguments[i+1]);
+				i += 1;
+			}
+		}
 		else if(IS_OPTION("-temporary-directory", "-td"))
 		{
 			exporter->use_custom_temporary_directory = true;
@@ -284,6 +304,19 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 				i += 1;
 			}
 		}
+		else if(IS_OPTION("-snapshot-filesystem", "-sfs"))
+		{
+			exporter->use_filesystem_snapshot = true;
+		}
+		else if(IS_OPTION("-parallel-profiles", "-pp"))
+		{
+			exporter->export_profiles_in_parallel = true;
+			if(i+1 < num_arguments)
+			{
+				exporter->max_parallel_profiles_per_drive = _ttoi(arguments[i+1]);
+				i += 1;
+			}
+		}
 		else if(IS_OPTION("-hint-ie", "-hie"))
 		{
 			exporter->use_ie_hint = true;
@@ -293,6 +326,160 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 				i += 1;
 			}
 		}
+		else if(IS_OPTION("-recover-ie", "-rie"))
+		{
+			exporter->recover_ie_entries = true;
+		}
+		else if(IS_OPTION("-lookup-ie", "-lie"))
+		{
+			exporter->use_ie_url_lookup = true;
+			if(i+1 < num_arguments)
+			{
+				StringCchCopy(exporter->ie_url_lookup_file_path, MAX_PATH_CHARS, arguments[i+1]);
+				i += 1;
+			}
+		}
+		else if(IS_OPTION("-recover-mozilla", "-rmz"))
+		{
+			exporter->recover_mozilla_entries = true;
+		}
+		else if(IS_OPTION("-verify-mozilla", "-vmz"))
+		{
+			exporter->verify_mozilla_integrity = true;
+		}
+		else if(IS_OPTION("-skip-corrupt-mozilla", "-scmz"))
+		{
+			// Implies that each entry is verified.
+			exporter->verify_mozilla_integrity = true;
+			exporter->skip_corrupt_mozilla_entries = true;
+		}
+		else if(IS_OPTION("-list-director-chunks", "-ldc"))
+		{
+			exporter->list_director_chunks = true;
+		}
+		else if(IS_OPTION("-extract-director-media", "-edm"))
+		{
+			// Implies that the chunks are listed.
+			exporter->list_director_chunks = true;
+			exporter->extract_director_media = true;
+		}
+		else if(IS_OPTION("-list-java-archives", "-lja"))
+		{
+			exporter->list_java_archive_members = true;
+		}
+		else if(IS_OPTION("-list-unity-assets", "-lua"))
+		{
+			exporter->list_unity_bundle_assets = true;
+		}
+		else if(IS_OPTION("-extract-unity-assets", "-eua"))
+		{
+			// Implies that the assets are listed.
+			exporter->list_unity_bundle_assets = true;
+			exporter->extract_unity_bundle_assets = true;
+		}
+		else if(IS_OPTION("-find-duplicates", "-fd"))
+		{
+			exporter->find_duplicate_files = true;
+		}
+		else if(IS_OPTION("-shard", "-sh"))
+		{
+			exporter->use_shard = true;
+			if(i+1 < num_arguments)
+			{
+				// E.g. "2/4" is the second of four shards.
+				String_Array<TCHAR>* split_shard = copy_and_split_string(temporary_arena, arguments[i+1], T("/"));
+				if(split_shard->num_strings == 2)
+				{
+					exporter->shard_index = _ttoi(split_shard->strings[0]);
+					exporter->num_shards = _ttoi(split_shard->strings[1]);
+				}
+				i += 1;
+			}
+		}
+		else if(IS_OPTION("-batch-manifest", "-bm"))
+		{
+			// Each job sets its own cache type, but every option that applies to all cache types is allowed here.
+			exporter->command_line_cache_type = CACHE_ALL;
+			exporter->use_batch_manifest = true;
+
+			if(i+1 < num_arguments)
+			{
+				StringCchCopy(exporter->batch_manifest_file_path, MAX_PATH_CHARS, arguments[i+1]);
+			}
+
+			if(i+2 < num_arguments && !string_is_empty(arguments[i+2]))
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, arguments[i+2]);
+			}
+			else
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, DEFAULT_EXPORT_DIRECTORY_NAME);
+			}
+
+			if(i+3 < num_arguments)
+			{
+				exporter->max_parallel_batch_jobs_per_drive = _ttoi(arguments[i+3]);
+			}
+			else
+			{
+				exporter->max_parallel_batch_jobs_per_drive = 1;
+			}
+
+			exporter->is_exporting_from_default_locations = true;
+			seen_export_option = true;
+			break;
+		}
+		else if(IS_OPTION("-service", "-svc"))
+		{
+			// Like the -batch-manifest option, each job sets its own cache type.
+			exporter->command_line_cache_type = CACHE_ALL;
+			exporter->use_export_service = true;
+
+			if(i+1 < num_arguments)
+			{
+				StringCchCopy(exporter->export_service_pipe_name, MAX_PATH_CHARS, arguments[i+1]);
+			}
+
+			if(i+2 < num_arguments && !string_is_empty(arguments[i+2]))
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, arguments[i+2]);
+			}
+			else
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, DEFAULT_EXPORT_DIRECTORY_NAME);
+			}
+
+			exporter->max_parallel_batch_jobs_per_drive = (i+3 < num_arguments) ? (_ttoi(arguments[i+3])) : (1);
+			exporter->num_export_service_workers = (i+4 < num_arguments) ? (_ttoi(arguments[i+4])) : (4);
+
+			exporter->is_exporting_from_default_locations = true;
+			seen_export_option = true;
+			break;
+		}
+		else if(IS_OPTION("-merge-shards", "-ms"))
+		{
+			// No cache type is exported when merging the output of previous runs.
+			exporter->command_line_cache_type = CACHE_UNKNOWN;
+			exporter->merge_shards = true;
+
+			if(i+1 < num_arguments)
+			{
+				StringCchCopy(exporter->shards_path, MAX_PATH_CHARS, arguments[i+1]);
+			}
+
+			if(i+2 < num_arguments && !string_is_empty(arguments[i+2]))
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, arguments[i+2]);
+			}
+			else
+			{
+				StringCchCopy(exporter->output_path, MAX_PATH_CHARS, DEFAULT_MERGE_DIRECTORY_NAME);
+			}
+
+			exporter->is_exporting_from_default_locations = false;
+			seen_export_option = true;
+			break;
+		}
 		else if(IS_OPTION("-explore-files", "-ef"))
 		{
 			exporter->command_line_cache_type = CACHE_EXPLORE;
@@ -445,6 +632,147 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 		}
 	}
 
+	if(exporter->use_batch_manifest)
+	{
+		if(string_is_empty(exporter->batch_manifest_file_path))
+		{
+			console_print("The -batch-manifest option requires a non-empty path as its first argument.");
+			log_error("Argument Parsing: The -batch-manifest option was used but the supplied path was empty.");
+			success = false;
+		}
+		else if(!does_file_exist(exporter->batch_manifest_file_path))
+		{
+			console_print("The batch manifest file in the -batch-manifest option doesn't exist.");
+			log_error("Argument Parsing: The -batch-manifest option supplied a batch manifest file path that doesn't exist: '%s'.", exporter->batch_manifest_file_path);
+			success = false;
+		}
+		else if(exporter->max_parallel_batch_jobs_per_drive <= 0)
+		{
+			console_print("The -batch-manifest option requires a positive number of jobs per drive as its third argument.");
+			log_error("Argument Parsing: The -batch-manifest option was used with the invalid number of jobs %d.", exporter->max_parallel_batch_jobs_per_drive);
+			success = false;
+		}
+		else if(exporter->use_filesystem_snapshot)
+		{
+			console_print("The -batch-manifest and -snapshot-filesystem options cannot be used at the same time.");
+			log_error("Argument Parsing: The -batch-manifest and -snapshot-filesystem options were used at the same time.");
+			success = false;
+		}
+	}
+
+	if(exporter->use_export_service)
+	{
+		#ifdef WCE_9X
+			console_print("The -service option is not supported in the Windows 98 and ME builds.");
+			log_error("Argument Parsing: The -service option was used in the Windows 98 and ME builds.");
+			success = false;
+		#else
+			if(string_is_empty(exporter->export_service_pipe_name) || _tcschr(exporter->export_service_pipe_name, T('\\')) != NULL)
+			{
+				console_print("The -service option requires a non-empty pipe name without backslashes as its first argument.");
+				log_error("Argument Parsing: The -service option was used with the invalid pipe name '%s'.", exporter->export_service_pipe_name);
+				success = false;
+			}
+			else if(exporter->max_parallel_batch_jobs_per_drive <= 0)
+			{
+				console_print("The -service option requires a positive number of jobs per drive as its third argument.");
+				log_error("Argument Parsing: The -service option was used with the invalid number of jobs %d.", exporter->max_parallel_batch_jobs_per_drive);
+				success = false;
+			}
+			else if(exporter->num_export_service_workers <= 0 || exporter->num_export_service_workers > MAX_PARALLEL_EXPORT_JOBS)
+			{
+				console_print("The -service option requires between 1 and %d workers as its fourth argument.", MAX_PARALLEL_EXPORT_JOBS);
+				log_error("Argument Parsing: The -service option was used with the invalid number of workers %d.", exporter->num_export_service_workers);
+				success = false;
+			}
+			else if(exporter->use_filesystem_snapshot)
+			{
+				console_print("The -service and -snapshot-filesystem options cannot be used at the same time.");
+				log_error("Argument Parsing: The -service and -snapshot-filesystem options were used at the same time.");
+				success = false;
+			}
+		#endif
+	}
+
+	if(exporter->use_shard)
+	{
+		if(exporter->num_shards <= 0 || exporter->num_shards > MAX_NUM_SHARDS || exporter->shard_index <= 0 || exporter->shard_index > exporter->num_shards)
+		{
+			console_print("The -shard option requires an argument like 2/4, where the first number is between 1 and the number of shards (up to %d).", MAX_NUM_SHARDS);
+			log_error("Argument Parsing: The -shard option was used with the invalid shard %d of %d.", exporter->shard_index, exporter->num_shards);
+			success = false;
+		}
+		else if(exporter->use_batch_manifest || exporter->use_export_service || exporter->merge_shards)
+		{
+			console_print("The -shard option cannot be used with the -batch-manifest, -service, or -merge-shards options.");
+			log_error("Argument Parsing: The -shard option was used with the -batch-manifest, -service, or -merge-shards options.");
+			success = false;
+		}
+		else
+		{
+			// Each shard writes its CSV files and copies its cached files to a separate subdirectory so that multiple
+			// processes or computers can share the same output path. These are later combined using -merge-shards.
+			TCHAR shard_directory_name[MAX_PATH_CHARS] = T("");
+			StringCchPrintf(shard_directory_name, MAX_PATH_CHARS, SHARD_DIRECTORY_NAME_FORMAT, exporter->shard_index, exporter->num_shards);
+			PathAppend(exporter->output_path, shard_directory_name);
+		}
+	}
+
+	if(exporter->merge_shards)
+	{
+		if(string_is_empty(exporter->shards_path))
+		{
+			console_print("The -merge-shards option requires a non-empty path as its first argument.");
+			log_error("Argument Parsing: The -merge-shards option was used but the supplied path was empty.");
+			success = false;
+		}
+		else if(!does_directory_exist(exporter->shards_path))
+		{
+			console_print("The shards directory in the -merge-shards option doesn't exist.");
+			log_error("Argument Parsing: The -merge-shards option supplied a shards directory path that doesn't exist: '%s'.", exporter->shards_path);
+			success = false;
+		}
+		else
+		{
+			get_full_path_name(exporter->shards_path);
+			get_full_path_name(exporter->output_path);
+
+			// Don't delete the shards that we're about to merge.
+			if(exporter->overwrite_previous_output && filenames_are_equal(exporter->shards_path, exporter->output_path))
+			{
+				console_print("The -overwrite option cannot be used when the -merge-shards output path is the same as the shards directory.");
+				log_error("Argument Parsing: The -overwrite option was used with the -merge-shards option whose output path is the shards directory '%s'.", exporter->shards_path);
+				success = false;
+			}
+		}
+	}
+
+	if(exporter->filter_entries)
+	{
+		Cache_Type cache_type = exporter->command_line_cache_type;
+		Entry_Filter* entry_filter = NULL;
+
+		if(cache_type != CACHE_INTERNET_EXPLORER && cache_type != CACHE_MOZILLA && cache_type != CACHE_JAVA && cache_type != CACHE_ALL)
+		{
+			console_print("The -filter-entries option can only be used when exporting the Internet Explorer, Mozilla, or Java Plugin caches, or every cache type.");
+			log_error("Argument Parsing: The -filter-entries option was used with the unsupported cache type %d.", cache_type);
+			success = false;
+		}
+		else if(string_is_empty(exporter->entry_filter_expression))
+		{
+			console_print("The -filter-entries option requires a non-empty expression as its argument.");
+			log_error("Argument Parsing: The -filter-entries option was used but the supplied expression was empty.");
+			success = false;
+		}
+		// The expression is compiled again into the permanent memory arena after parsing every argument.
+		else if(!compile_entry_filter(temporary_arena, exporter->entry_filter_expression, &entry_filter))
+		{
+			console_print("The expression in the -filter-entries option is not valid. Check the log file for more details.");
+			log_error("Argument Parsing: The -filter-entries option supplied an invalid expression: '%s'.", exporter->entry_filter_expression);
+			success = false;
+		}
+	}
+
 	if(exporter->use_custom_temporary_directory && string_is_empty(exporter->exporter_temporary_path))
 	{
 		console_print("The -temporary-directory option requires a non-empty path as its argument.");
@@ -452,6 +780,42 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 		success = false;
 	}
 
+	if(exporter->use_filesystem_snapshot && exporter->command_line_cache_type != CACHE_ALL)
+	{
+		console_print("The -snapshot-filesystem option can only be used when exporting every cache type.");
+		log_error("Argument Parsing: The -snapshot-filesystem option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+		success = false;
+	}
+
+	if(exporter->export_profiles_in_parallel)
+	{
+		if(exporter->command_line_cache_type != CACHE_ALL || !exporter->load_external_locations)
+		{
+			console_print("The -parallel-profiles option can only be used when exporting every cache type from an external locations file.");
+			log_error("Argument Parsing: The -parallel-profiles option was used with the unsupported cache type %d or without an external locations file.", exporter->command_line_cache_type);
+			success = false;
+		}
+		else if(exporter->use_filesystem_snapshot)
+		{
+			console_print("The -parallel-profiles and -snapshot-filesystem options cannot be used at the same time.");
+			log_error("Argument Parsing: The -parallel-profiles and -snapshot-filesystem options were used at the same time.");
+			success = false;
+		}
+		else if(exporter->max_parallel_profiles_per_drive <= 0)
+		{
+			console_print("The -parallel-profiles option requires a positive number of profiles per drive as its argument.");
+			log_error("Argument Parsing: The -parallel-profiles option was used with the invalid number of profiles %d.", exporter->max_parallel_profiles_per_drive);
+			success = false;
+		}
+	}
+
+	if(exporter->find_duplicate_files && exporter->command_line_cache_type != CACHE_EXPLORE && !exporter->use_batch_manifest && !exporter->use_export_service)
+	{
+		console_print("The -find-duplicates option can only be used when exploring files, with a batch manifest file, or as a service.");
+		log_error("Argument Parsing: The -find-duplicates option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+		success = false;
+	}
+
 	if(exporter->use_ie_hint)
 	{
 		if(exporter->command_line_cache_type != CACHE_INTERNET_EXPLORER)
@@ -468,38 +832,126 @@ static bool parse_exporter_arguments(int num_arguments, TCHAR** arguments, Expor
 		}
 	}
 
-	return success;
-}
-
-// Retrieves the size of the temporary memory in bytes, based on the current Windows version. This size is twice as large for the
-// Windows 2000 through 10 builds in order to store UTF-16 strings.
-//
-// @Parameters:
-// 1. exporter - The Exporter structure that contains the current Windows version. The 'os_version' member must be set before calling
-// this function.
-//
-// @Returns: The number of bytes to allocate for the temporary memory.
-static size_t get_temporary_exporter_memory_size_for_os_version(Exporter* exporter)
-{
-	OSVERSIONINFO os_version = exporter->os_version;
-	size_t size_for_os_version = 0;
-
-	// Windows 98 (4.10)
-	if(os_version.dwMajorVersion <= 4 && os_version.dwMinorVersion <= 10)
+	if(exporter->recover_ie_entries)
 	{
-		size_for_os_version = kilobytes_to_bytes(512 + 256); // x1 for char
-		
+		if(exporter->command_line_cache_type != CACHE_INTERNET_EXPLORER && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -recover-ie option can only be used when exporting the Internet Explorer cache or every cache type.");
+			log_error("Argument Parsing: The -recover-ie option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+		else if(exporter->use_ie_url_lookup)
+		{
+			console_print("The options -recover-ie and -lookup-ie can't be used at the same time.");
+			log_error("Argument Parsing: The options '-recover-ie' and '-lookup-ie' were used at the same time.");
+			success = false;
+		}
 	}
-	// Windows 2000 (5.0) and ME (4.90)
-	else if( 	(os_version.dwMajorVersion <= 5 && os_version.dwMinorVersion <= 0)
-			|| 	(os_version.dwMajorVersion <= 4 && os_version.dwMinorVersion <= 90))
+
+	if(exporter->use_ie_url_lookup)
 	{
-		size_for_os_version = megabytes_to_bytes(1); // x1 for char (ME) and x2 for wchar_t (2000)
+		if(exporter->command_line_cache_type != CACHE_INTERNET_EXPLORER && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -lookup-ie option can only be used when exporting the Internet Explorer cache or every cache type.");
+			log_error("Argument Parsing: The -lookup-ie option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+		else if(string_is_empty(exporter->ie_url_lookup_file_path))
+		{
+			console_print("The -lookup-ie option requires a non-empty path as its argument.");
+			log_error("Argument Parsing: The -lookup-ie option was used but the supplied path was empty.");
+			success = false;
+		}
+		else if(!does_file_exist(exporter->ie_url_lookup_file_path))
+		{
+			console_print("The URL list file in the -lookup-ie option doesn't exist.");
+			log_error("Argument Parsing: The -lookup-ie option supplied a URL list file path that doesn't exist: '%s'.", exporter->ie_url_lookup_file_path);
+			success = false;
+		}
 	}
-	// Windows XP (5.1)
-	else if(os_version.dwMajorVersion <= 5 && os_version.dwMinorVersion <= 1)
+
+	if(exporter->recover_mozilla_entries)
 	{
-		size_for_os_version = megabytes_to_bytes(2); // x2 for wchar_t
+		if(exporter->command_line_cache_type != CACHE_MOZILLA && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -recover-mozilla option can only be used when exporting the Mozilla cache or every cache type.");
+			log_error("Argument Parsing: The -recover-mozilla option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+	}
+
+	if(exporter->verify_mozilla_integrity)
+	{
+		if(exporter->command_line_cache_type != CACHE_MOZILLA && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -verify-mozilla and -skip-corrupt-mozilla options can only be used when exporting the Mozilla cache or every cache type.");
+			log_error("Argument Parsing: The -verify-mozilla or -skip-corrupt-mozilla option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+	}
+
+	if(exporter->list_director_chunks)
+	{
+		if(exporter->command_line_cache_type != CACHE_SHOCKWAVE && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -list-director-chunks and -extract-director-media options can only be used when exporting the Shockwave Player cache or every cache type.");
+			log_error("Argument Parsing: The -list-director-chunks or -extract-director-media option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+	}
+
+	if(exporter->list_java_archive_members)
+	{
+		if(exporter->command_line_cache_type != CACHE_JAVA && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -list-java-archives option can only be used when exporting the Java Plugin cache or every cache type.");
+			log_error("Argument Parsing: The -list-java-archives option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+	}
+
+	if(exporter->list_unity_bundle_assets)
+	{
+		if(exporter->command_line_cache_type != CACHE_UNITY && exporter->command_line_cache_type != CACHE_ALL)
+		{
+			console_print("The -list-unity-assets and -extract-unity-assets options can only be used when exporting the Unity Web Player cache or every cache type.");
+			log_error("Argument Parsing: The -list-unity-assets or -extract-unity-assets option was used with the unsupported cache type %d.", exporter->command_line_cache_type);
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+// Retrieves the size of the temporary memory in bytes, based on the current Windows version. This size is twice as large for the
+// Windows 2000 through 10 builds in order to store UTF-16 strings.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the current Windows version. The 'os_version' member must be set before calling
+// this function.
+//
+// @Returns: The number of bytes to allocate for the temporary memory.
+static size_t get_temporary_exporter_memory_size_for_os_version(Exporter* exporter)
+{
+	OSVERSIONINFO os_version = exporter->os_version;
+	size_t size_for_os_version = 0;
+
+	// Windows 98 (4.10)
+	if(os_version.dwMajorVersion <= 4 && os_version.dwMinorVersion <= 10)
+	{
+		size_for_os_version = kilobytes_to_bytes(512 + 256); // x1 for char
+		
+	}
+	// Windows 2000 (5.0) and ME (4.90)
+	else if( 	(os_version.dwMajorVersion <= 5 && os_version.dwMinorVersion <= 0)
+			|| 	(os_version.dwMajorVersion <= 4 && os_version.dwMinorVersion <= 90))
+	{
+		size_for_os_version = megabytes_to_bytes(1); // x1 for char (ME) and x2 for wchar_t (2000)
+	}
+	// Windows XP (5.1)
+	else if(os_version.dwMajorVersion <= 5 && os_version.dwMinorVersion <= 1)
+	{
+		size_for_os_version = megabytes_to_bytes(2); // x2 for wchar_t
 	}
 	// Windows Vista (6.0) and 7 (6.1).
 	else if(os_version.dwMajorVersion >= 6 && os_version.dwMinorVersion <= 1)
@@ -548,6 +1000,7 @@ static void clean_up_exporter(Exporter* exporter)
 		}
 	#endif
 
+	destroy_arena( &(exporter->snapshot_arena) );
 	destroy_arena( &(exporter->permanent_arena) );
 	destroy_arena( &(exporter->secondary_temporary_arena) );
 	destroy_arena( &(exporter->temporary_arena) );
@@ -581,6 +1034,14 @@ static void clear_temporary_windows_directory(Exporter* exporter);
 static size_t get_total_external_locations_size(Exporter* exporter, int* result_num_profiles);
 static void load_external_locations(Exporter* exporter, int num_profiles);
 static void export_all_default_or_specific_cache_locations(Exporter* exporter);
+static size_t get_total_batch_manifest_size(Exporter* exporter, int* result_num_jobs);
+static void load_batch_manifest(Exporter* exporter, int num_jobs);
+static void export_command_line_cache_type(Exporter* exporter);
+static void export_batch_manifest_jobs(Exporter* exporter);
+static void merge_shard_outputs(Exporter* exporter);
+#ifndef WCE_9X
+	static void run_export_service(Exporter* exporter);
+#endif
 
 // Used to control if the logging and console print functions should be called when using the log_print()
 // and console_print() macros.
@@ -620,7 +1081,10 @@ int _tmain(int num_arguments, TCHAR** arguments)
 		}
 		// Don't check for these arguments past the main export options. This is a little silly since we're repeating
 		// these options here and in parse_exporter_arguments(), but it works for now.
-		else if(IS_OPTION("-explore-files", "-ef")
+		else if(IS_OPTION("-batch-manifest", "-bm")
+				|| IS_OPTION("-service", "-svc")
+				|| IS_OPTION("-merge-shards", "-ms")
+				|| IS_OPTION("-explore-files", "-ef")
 				|| IS_OPTION("-find-and-export-all", "-faea")
 				|| string_begins_with(option, T("-export"))
 				|| (string_begins_with(option, T("-e")) && string_length(option) <= 4))
@@ -746,6 +1210,8 @@ int _tmain(int num_arguments, TCHAR** arguments)
 
 		int num_groups = 0;
 		int num_profiles = 0;
+		int num_lookup_urls = 0;
+		int num_batch_jobs = 0;
 		
 		size_t permanent_memory_size = get_total_group_files_size(&exporter, &num_groups);
 		if(exporter.load_external_locations)
@@ -753,6 +1219,21 @@ int _tmain(int num_arguments, TCHAR** arguments)
 			permanent_memory_size += get_total_external_locations_size(&exporter, &num_profiles);
 		}
 
+		if(exporter.use_batch_manifest)
+		{
+			permanent_memory_size += get_total_batch_manifest_size(&exporter, &num_batch_jobs);
+		}
+
+		if(exporter.use_ie_url_lookup)
+		{
+			permanent_memory_size += get_internet_explorer_url_lookup_file_size(&exporter, &num_lookup_urls);
+		}
+
+		if(exporter.filter_entries)
+		{
+			permanent_memory_size += get_entry_filter_size(&exporter);
+		}
+
 		log_info("Startup: Allocating %Iu bytes for the permanent memory arena.", permanent_memory_size);
 
 		if(!create_arena(permanent_arena, permanent_memory_size))
@@ -772,6 +1253,24 @@ int _tmain(int num_arguments, TCHAR** arguments)
 			load_external_locations(&exporter, num_profiles);			
 		}
 
+		if(exporter.use_batch_manifest)
+		{
+			log_info("Startup: Loading %d jobs from the batch manifest file '%s'.", num_batch_jobs, exporter.batch_manifest_file_path);
+			load_batch_manifest(&exporter, num_batch_jobs);
+		}
+
+		if(exporter.use_ie_url_lookup)
+		{
+			log_info("Startup: Loading %d URLs from the Internet Explorer lookup file '%s'.", num_lookup_urls, exporter.ie_url_lookup_file_path);
+			load_internet_explorer_url_lookup_file(&exporter, num_lookup_urls);
+		}
+
+		if(exporter.filter_entries)
+		{
+			log_info("Startup: Loading the entry filter '%s'.", exporter.entry_filter_expression);
+			load_entry_filter(&exporter);
+		}
+
 		log_info("Startup: The permanent memory arena is at %.2f%% used capacity before being locked.", get_used_arena_capacity(permanent_arena));
 
 		// This memory lasts throughout the program's lifetime.
@@ -780,6 +1279,20 @@ int _tmain(int num_arguments, TCHAR** arguments)
 		unlock_arena(temporary_arena);
 	}
 
+	if(exporter.use_filesystem_snapshot)
+	{
+		// Enough for a few hundred thousand files and directories.
+		size_t snapshot_memory_size = megabytes_to_bytes(16) * sizeof(TCHAR);
+		log_info("Startup: Allocating %Iu bytes for the filesystem snapshot memory arena.", snapshot_memory_size);
+
+		// The snapshot is only an optimization, so we'll query the filesystem directly if this memory isn't available.
+		if(!create_arena(&(exporter.snapshot_arena), snapshot_memory_size))
+		{
+			log_warning("Startup: Could not allocate %Iu bytes for the filesystem snapshot. The -snapshot-filesystem option will be ignored.", snapshot_memory_size);
+			exporter.use_filesystem_snapshot = false;
+		}
+	}
+
 	#ifndef WCE_9X
 		if( (exporter.command_line_cache_type == CACHE_INTERNET_EXPLORER) || (exporter.command_line_cache_type == CACHE_ALL) )
 		{
@@ -907,16 +1420,49 @@ int _tmain(int num_arguments, TCHAR** arguments)
 	log_print(LOG_NONE, "- Should Group By Request Origin: %s", YN(group_by_request_origin));
 	log_print(LOG_NONE, "- Should Decompress Files: %s", YN(decompress_files));
 	log_print(LOG_NONE, "- Should Clear Temporary Windows Directory: %s", YN(clear_temporary_windows_directory));
+	log_print(LOG_NONE, "- Should Use Filesystem Snapshot: %s", YN(use_filesystem_snapshot));
+	log_print(LOG_NONE, "- Should Find Duplicate Files: %s", YN(find_duplicate_files));
+	log_print(LOG_NONE, "- Should Export Profiles In Parallel: %s", YN(export_profiles_in_parallel));
+	log_print(LOG_NONE, "- Maximum Parallel Profiles Per Drive: %d", exporter.max_parallel_profiles_per_drive);
 	log_print(LOG_NONE, "------------------------------------------------------------");
 	log_print(LOG_NONE, "- Should Filter By Groups: %s", YN(filter_by_groups));
 	log_print(LOG_NONE, "- Number Of Group Files Enabled For Filtering: %d", (exporter.group_files_for_filtering != NULL) ? (exporter.group_files_for_filtering->num_strings) : (-1));
+	log_print(LOG_NONE, "- Should Filter Entries: %s", YN(filter_entries));
+	log_print(LOG_NONE, "- Entry Filter Expression: '%s'", exporter.entry_filter_expression);
 	log_print(LOG_NONE, "------------------------------------------------------------");
 	log_print(LOG_NONE, "- Should Use Internet Explorer's Hint: %s", YN(use_ie_hint));
 	log_print(LOG_NONE, "- Internet Explorer Hint Path: '%s'", exporter.ie_hint_path);
+	log_print(LOG_NONE, "- Should Recover Internet Explorer Entries: %s", YN(recover_ie_entries));
+	log_print(LOG_NONE, "- Should Look Up Internet Explorer URLs: %s", YN(use_ie_url_lookup));
+	log_print(LOG_NONE, "- Internet Explorer URL Lookup Path: '%s'", exporter.ie_url_lookup_file_path);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should Recover Mozilla Entries: %s", YN(recover_mozilla_entries));
+	log_print(LOG_NONE, "- Should Verify Mozilla Entries: %s", YN(verify_mozilla_integrity));
+	log_print(LOG_NONE, "- Should Skip Corrupt Mozilla Entries: %s", YN(skip_corrupt_mozilla_entries));
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should List Director Chunks: %s", YN(list_director_chunks));
+	log_print(LOG_NONE, "- Should Extract Director Media: %s", YN(extract_director_media));
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should List Java Archive Members: %s", YN(list_java_archive_members));
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should List Unity Bundle Assets: %s", YN(list_unity_bundle_assets));
+	log_print(LOG_NONE, "- Should Extract Unity Bundle Assets: %s", YN(extract_unity_bundle_assets));
 	log_print(LOG_NONE, "------------------------------------------------------------");
 	log_print(LOG_NONE, "- Should Load External Locations: %s", YN(load_external_locations));
 	log_print(LOG_NONE, "- External Locations Path: '%s'", exporter.external_locations_file_path);
 	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should Use Batch Manifest: %s", YN(use_batch_manifest));
+	log_print(LOG_NONE, "- Batch Manifest Path: '%s'", exporter.batch_manifest_file_path);
+	log_print(LOG_NONE, "- Maximum Parallel Batch Jobs Per Drive: %d", exporter.max_parallel_batch_jobs_per_drive);
+	log_print(LOG_NONE, "- Should Run As Service: %s", YN(use_export_service));
+	log_print(LOG_NONE, "- Service Pipe Name: '%s'", exporter.export_service_pipe_name);
+	log_print(LOG_NONE, "- Number Of Service Workers: %d", exporter.num_export_service_workers);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Should Export One Shard: %s", YN(use_shard));
+	log_print(LOG_NONE, "- Shard: %d of %d", exporter.shard_index, exporter.num_shards);
+	log_print(LOG_NONE, "- Should Merge Shards: %s", YN(merge_shards));
+	log_print(LOG_NONE, "- Shards Path: '%s'", exporter.shards_path);
+	log_print(LOG_NONE, "------------------------------------------------------------");
 	log_print(LOG_NONE, "- Cache Path: '%s'", exporter.cache_path);
 	log_print(LOG_NONE, "- Output Path: '%s'", exporter.output_path);
 	log_print(LOG_NONE, "- Is Exporting From Default Locations: %s", YN(is_exporting_from_default_locations));
@@ -951,60 +1497,23 @@ int _tmain(int num_arguments, TCHAR** arguments)
 	clear_arena(temporary_arena);
 	exporter.group_files_for_filtering = NULL;
 
-	switch(exporter.command_line_cache_type)
+	if(exporter.merge_shards)
 	{
-		case(CACHE_INTERNET_EXPLORER):
-		{
-			export_default_or_specific_internet_explorer_cache(&exporter);
-		} break;
-
-		case(CACHE_MOZILLA):
-		{
-			export_default_or_specific_mozilla_cache(&exporter);
-		} break;
-
-		case(CACHE_FLASH):
-		{
-			export_default_or_specific_flash_cache(&exporter);
-		} break;
-
-		case(CACHE_SHOCKWAVE):
-		{
-			export_default_or_specific_shockwave_cache(&exporter);
-		} break;
-
-		case(CACHE_JAVA):
-		{
-			export_default_or_specific_java_cache(&exporter);
-		} break;
-
-		case(CACHE_UNITY):
-		{
-			export_default_or_specific_unity_cache(&exporter);
-		} break;
-
-		case(CACHE_ALL):
-		{
-			_ASSERT(exporter.is_exporting_from_default_locations);
-			_ASSERT(string_is_empty(exporter.cache_path));
-
-			export_all_default_or_specific_cache_locations(&exporter);
-
-		} break;
-
-		case(CACHE_EXPLORE):
-		{
-			_ASSERT(!exporter.is_exporting_from_default_locations);
-			_ASSERT(!string_is_empty(exporter.cache_path));
-
-			export_explored_files(&exporter);
-		} break;
-
-		default:
-		{
-			log_error("Startup: Attempted to export the cache from '%s' using the unhandled cache type %d.", exporter.cache_path, exporter.command_line_cache_type);
-			_ASSERT(false);
-		} break;
+		merge_shard_outputs(&exporter);
+	}
+	else if(exporter.use_batch_manifest)
+	{
+		export_batch_manifest_jobs(&exporter);
+	}
+	#ifndef WCE_9X
+	else if(exporter.use_export_service)
+	{
+		run_export_service(&exporter);
+	}
+	#endif
+	else
+	{
+		export_command_line_cache_type(&exporter);
 	}
 
 	console_print("Finished running:\n- Created %d CSV files.\n- Processed %d cached files.\n- Copied %d cached files.\n- Assigned %d filenames.", exporter.total_csv_files_created, exporter.total_processed_files, exporter.total_copied_files, exporter.total_assigned_filenames);
@@ -1089,6 +1598,7 @@ void initialize_cache_exporter(Exporter* exporter, Cache_Type cache_type, Csv_Ty
 		if(exporter->csv_file_handle == INVALID_HANDLE_VALUE)
 		{
 			log_error("Initialize Cache Exporter: Failed to create the CSV file '%s' after %d retry attempts.", exporter->output_csv_path, MAX_RETRY_ATTEMPTS);
+			++(exporter->total_export_errors);
 		}
 	}
 
@@ -1177,20 +1687,25 @@ void tchar_add_exporter_warning_message(Exporter* exporter, const TCHAR* string_
 // @Parameters:
 // 1. exporter - The Exporter structure that contains the current cache exporter's parameters.
 // 2. source_file_path - The path to the file to decompress.
-// 3. content_encoding - The value of the Content-Encoding HTTP header that specifies how the file was compressed.
-// 4. result_decompressed_file_path - The path to the newly created decompressed file.
-// 5. result_decompressed_file_handle - The handle to the newly created decompressed file.
-// 6. result_decompressed_file_size - The size of the newly created decompressed file.
+// 3. source_file_offset - Where the compressed data starts in the file.
+// 4. source_file_size - The size of the compressed data. This may be READ_UNTIL_END_OF_FILE.
+// 5. content_encoding - The value of the Content-Encoding HTTP header that specifies how the file was compressed.
+// 6. result_decompressed_file_path - The path to the newly created decompressed file.
+// 7. result_decompressed_file_handle - The handle to the newly created decompressed file.
+// 8. result_decompressed_file_size - The size of the newly created decompressed file.
 // 
 // @Returns: True if the file was decompressed successfully. Otherwise, false. Not being able to decompress a file
 // isn't always an important error since some files are either: 1) empty; 2) not compressed despite having the
 // Content-Encoding header set; 3) contain an unsupported or invalid value in the Content-Encoding header.
-static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_file_path, const TCHAR* content_encoding,
+static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_file_path, u64 source_file_offset, u64 source_file_size,
+									 const TCHAR* content_encoding,
 									 TCHAR* result_decompressed_file_path, HANDLE* result_decompressed_file_handle,
 									 u64* result_decompressed_file_size)
 {
+	if(source_file_size == 0) return false;
+
 	u64 file_size = 0;
-	if(get_file_size(source_file_path, &file_size) && file_size == 0) return false;
+	if(source_file_size == READ_UNTIL_END_OF_FILE && get_file_size(source_file_path, &file_size) && file_size == 0) return false;
 
 	TCHAR current_file_path[MAX_PATH_CHARS] = T("");
 	HANDLE current_file_handle = INVALID_HANDLE_VALUE;
@@ -1210,6 +1725,10 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 	StringCchCopy(previous_file_path, MAX_PATH_CHARS, source_file_path);
 	HANDLE previous_file_handle = INVALID_HANDLE_VALUE;
 
+	// Only the original file may be limited to a byte range. Every intermediate temporary file is read from start to finish.
+	u64 previous_file_offset = source_file_offset;
+	u64 previous_file_size = source_file_size;
+
 	// The Content-Encoding HTTP header contains a list of comma-separated encodings in the order they were applied. As such, we'll iterate
 	// over each one backwards and attempt to decompress them one by one. If we can't decompress a supported format or find an invalid one,
 	// then the entire operation stops and the decompression fails.
@@ -1245,7 +1764,7 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 		else if(strings_are_equal(encoding, T("gzip"), true) || strings_are_equal(encoding, T("deflate"), true) || strings_are_equal(encoding, T("x-gzip"), true))
 		{
 			int error_code = 0;
-			success = decompress_gzip_zlib_deflate_file(temporary_arena, previous_file_path, current_file_handle, &error_code);
+			success = decompress_gzip_zlib_deflate_file(temporary_arena, previous_file_path, current_file_handle, &error_code, previous_file_offset, previous_file_size);
 			if(!success) add_exporter_warning_message(exporter, "Failed to decompress the file using Gzip/Zlib/DEFLATE with the error code %d.", error_code);
 			
 			*previous_file_path = T('\0');
@@ -1254,7 +1773,7 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 		else if(strings_are_equal(encoding, T("br"), true))
 		{
 			int error_code = 0;
-			success = decompress_brotli_file(temporary_arena, previous_file_path, current_file_handle, &error_code);
+			success = decompress_brotli_file(temporary_arena, previous_file_path, current_file_handle, &error_code, previous_file_offset, previous_file_size);
 			if(!success) add_exporter_warning_message(exporter, "Failed to decompress the file using Brotli with the error code %d.", error_code);
 			
 			*previous_file_path = T('\0');
@@ -1263,7 +1782,7 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 		else if(strings_are_equal(encoding, T("compress"), true) || strings_are_equal(encoding, T("x-compress"), true))
 		{
 			int error_code = 0;
-			success = decompress_compress_file(temporary_arena, previous_file_path, current_file_handle, &error_code);
+			success = decompress_compress_file(temporary_arena, previous_file_path, current_file_handle, &error_code, previous_file_offset, previous_file_size);
 			if(!success) add_exporter_warning_message(exporter, "Failed to decompress the file using Compress with the error code %d.", error_code);
 			
 			*previous_file_path = T('\0');
@@ -1284,6 +1803,8 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 			{
 				StringCchCopy(previous_file_path, MAX_PATH_CHARS, current_file_path);
 				previous_file_handle = current_file_handle;
+				previous_file_offset = 0;
+				previous_file_size = READ_UNTIL_END_OF_FILE;
 
 				if(!create_temporary_exporter_file(exporter, current_file_path, &current_file_handle))
 				{
@@ -1317,18 +1838,21 @@ static bool decompress_exporter_file(Exporter* exporter, const TCHAR* source_fil
 	return success;
 }
 
-// Copies an existing file to a new location while taking into account a few quirks, such as copying a temporary file that's being
-// used by the exporter process.
+// Copies an existing file (or a byte range inside it) to a new location while taking into account a few quirks, such as copying a
+// temporary file that's being used by the exporter process.
 //
 // @GetLastError
 //
 // @Parameters:
 // 1. exporter - The Exporter structure that contains the current cache exporter's parameters.
 // 2. source_file_path - The absolute path to the source file to copy.
-// 3. destination_file_path - The absolute path to the destination file to create.
+// 3. source_file_offset - Where the data to copy starts in the source file.
+// 4. source_file_size - The size of the data to copy. If this is READ_UNTIL_END_OF_FILE and the offset is zero, the whole file is copied.
+// 5. destination_file_path - The absolute path to the destination file to create.
 // 
 // @Returns: True if the file was copied successfully. Otherwise, false and the error code can be retrieved using GetLastError().
-static bool copy_exporter_file(Exporter* exporter, const TCHAR* source_file_path, const TCHAR* destination_file_path)
+static bool copy_exporter_file(	Exporter* exporter, const TCHAR* source_file_path, u64 source_file_offset, u64 source_file_size,
+								const TCHAR* destination_file_path)
 {
 	// @Note: Any function used to copy the file here must set the last Windows error code properly so that we can perform the correct
 	// checks using GetLastError() in copy_exporter_file_using_url_directory_structure(). This applies to CopyFile(), create_empty_file(),
@@ -1338,24 +1862,34 @@ static bool copy_exporter_file(Exporter* exporter, const TCHAR* source_file_path
 	#if defined(WCE_DEBUG) && defined(WCE_EMPTY_EXPORT)
 		copy_success = create_empty_file(destination_file_path, false);
 	#else
-		copy_success = CopyFile(source_file_path, destination_file_path, TRUE) != FALSE;
-
-		// For older Windows versions when we're copying temporary files that are currently being used by the exporter's process.
-		if(!copy_success && GetLastError() == ERROR_SHARING_VIOLATION)
+		// Copy the byte range directly from the original file. This avoids having to first extract it to an intermediate
+		// temporary file, which would then be copied a second time.
+		if(source_file_offset != 0 || source_file_size != READ_UNTIL_END_OF_FILE)
+		{
+			Arena* temporary_arena = &(exporter->temporary_arena);
+			copy_success = copy_file_chunks(temporary_arena, source_file_path, source_file_size, source_file_offset, destination_file_path, false);
+		}
+		else
 		{
-			log_warning("Copy Exporter File: Attempting to copy the file '%s' to '%s' chunk by chunk due to a sharing violation.", source_file_path, destination_file_path);
+			copy_success = CopyFile(source_file_path, destination_file_path, TRUE) != FALSE;
 
-			u64 file_size = 0;
-			if(get_file_size(source_file_path, &file_size))
-			{
-				Arena* temporary_arena = &(exporter->temporary_arena);
-				copy_success = copy_file_chunks(temporary_arena, source_file_path, file_size, 0, destination_file_path, false);
-			}
-			else
+			// For older Windows versions when we're copying temporary files that are currently being used by the exporter's process.
+			if(!copy_success && GetLastError() == ERROR_SHARING_VIOLATION)
 			{
-				// Propagate a generic error code for a failure case where we can't attempt to copy the whole file in chunks because we couldn't
-				// determine its size. What matters here is that we specify an error code for every case that this function returns false.
-				SetLastError(CUSTOM_ERROR_FAILED_TO_GET_FILE_SIZE);
+				log_warning("Copy Exporter File: Attempting to copy the file '%s' to '%s' chunk by chunk due to a sharing violation.", source_file_path, destination_file_path);
+
+				u64 file_size = 0;
+				if(get_file_size(source_file_path, &file_size))
+				{
+					Arena* temporary_arena = &(exporter->temporary_arena);
+					copy_success = copy_file_chunks(temporary_arena, source_file_path, file_size, 0, destination_file_path, false);
+				}
+				else
+				{
+					// Propagate a generic error code for a failure case where we can't attempt to copy the whole file in chunks because we couldn't
+					// determine its size. What matters here is that we specify an error code for every case that this function returns false.
+					SetLastError(CUSTOM_ERROR_FAILED_TO_GET_FILE_SIZE);
+				}
 			}
 		}
 	#endif
@@ -1395,22 +1929,24 @@ static bool copy_exporter_file(Exporter* exporter, const TCHAR* source_file_path
 // that will influence how the file is copied.
 //
 // 2. full_source_path - The absolute path to the source file to copy.
-// 3. url - The URL whose host and path components are converted into a Windows path. If this string is NULL, only the base directory
+// 3. source_file_offset - Where the data to copy starts in the source file.
+// 4. source_file_size - The size of the data to copy. This may be READ_UNTIL_END_OF_FILE. See copy_exporter_file().
+// 5. url - The URL whose host and path components are converted into a Windows path. If this string is NULL, only the base directory
 // and filename will be used.
-// 4. filename - The filename to add to the end of the path.
-// 5. default_file_extension - The file extension to add to the end of the filename in case it doesn't have one already. This extension
+// 6. filename - The filename to add to the end of the path.
+// 7. default_file_extension - The file extension to add to the end of the filename in case it doesn't have one already. This extension
 // should be determined using the matched file groups and must not begin with a period.
 //
-// 6. result_destination_path - The final destination path after resolving any naming collisions. This string is only set if this function
+// 8. result_destination_path - The final destination path after resolving any naming collisions. This string is only set if this function
 // returns true. Otherwise, this string will be empty.
-// 7. result_error_code - A string containing the Windows system error code generated after attempting to copy the file. This string can
+// 9. result_error_code - A string containing the Windows system error code generated after attempting to copy the file. This string can
 // only be set if this function returns false. Otherwise, this string will be empty. Note that, if the function terminates before attempting
 // to copy the file due to an error early on, this string will also be empty.
 //
 // @Returns: True if the file was copied successfully. Otherwise, false. This function fails if the source file path is empty.
 static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter,
-																const TCHAR* full_source_path, const TCHAR* url,
-																const TCHAR* filename, const TCHAR* default_file_extension,
+																const TCHAR* full_source_path, u64 source_file_offset, u64 source_file_size,
+																const TCHAR* url, const TCHAR* filename, const TCHAR* default_file_extension,
 																TCHAR* result_destination_path, TCHAR* result_error_code)
 {
 	*result_destination_path = T('\0');
@@ -1535,7 +2071,7 @@ static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter
 	TCHAR full_unique_destination_path[MAX_PATH_CHARS] = T("");
 	StringCchCopy(full_unique_destination_path, MAX_PATH_CHARS, full_destination_path);
 
-	bool copy_success = copy_exporter_file(exporter, full_source_path, full_unique_destination_path);
+	bool copy_success = copy_exporter_file(exporter, full_source_path, source_file_offset, source_file_size, full_unique_destination_path);
 
 	// Copy the file to the target directory, while resolving any file naming collisions.
 	// - If a file with the same name already exists (ERROR_FILE_EXISTS), then the current name will be changed (e.g. "File.ext" -> "File~1.ext").
@@ -1571,7 +2107,7 @@ static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter
 		}
 		
 		// Try again with a new name.
-		copy_success = copy_exporter_file(exporter, full_source_path, full_unique_destination_path);
+		copy_success = copy_exporter_file(exporter, full_source_path, source_file_offset, source_file_size, full_unique_destination_path);
 	}
 	
 	#undef NAMING_COLLISION
@@ -1603,6 +2139,69 @@ static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter
 	return copy_success;
 }
 
+// Checks if a cache entry belongs to the current shard when the -shard option is used. Each entry is assigned to a shard by hashing
+// a key that doesn't change between runs or computers, meaning that running every shard separately exports each entry exactly once.
+// This key is the entry's record identifier if the exporter set one, or its location on cache otherwise. If the exporter didn't set
+// a short location (e.g. when exploring files), then the path relative to the cache directory is used instead.
+//
+// Note that the characters in the location are hashed one by one after converting any ASCII uppercase letters to lowercase and any
+// forward slashes to backslashes. This means that paths with non-ASCII characters may be assigned to different shards in the ANSI
+// and Unicode builds, so every shard should be exported using the same build.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the shard index, the number of shards, and the cache path.
+// 2. params - The Exporter_Params structure that contains the entry's key. See: export_cache_entry().
+//
+// @Returns: True if the entry belongs to the current shard or if the -shard option wasn't used. Otherwise, false.
+bool is_cache_entry_in_exporter_shard(Exporter* exporter, Exporter_Params* params)
+{
+	if(!exporter->use_shard) return true;
+
+	// The 32-bit FNV-1a hash.
+	const u32 FNV_OFFSET_BASIS = 2166136261U;
+	const u32 FNV_PRIME = 16777619U;
+	u32 hash = FNV_OFFSET_BASIS;
+
+	if(params->has_record_id)
+	{
+		for(int i = 0; i < (int) sizeof(params->record_id); ++i)
+		{
+			hash ^= (u8) (params->record_id >> (i * 8));
+			hash *= FNV_PRIME;
+		}
+	}
+	else
+	{
+		const TCHAR* key = params->short_location_on_cache;
+		if(key == NULL || string_is_empty(key))
+		{
+			key = params->full_location_on_cache;
+			if(key == NULL || string_is_empty(key)) key = params->copy_source_path;
+
+			// Skip the cache directory so that the same entry is assigned to the same shard even if this directory is
+			// located somewhere else on a different computer.
+			size_t cache_path_length = string_length(exporter->cache_path);
+			if(key != NULL && cache_path_length > 0 && filename_begins_with(key, exporter->cache_path))
+			{
+				key += cache_path_length;
+				while(*key == T('\\') || *key == T('/')) ++key;
+			}
+		}
+
+		for(; key != NULL && *key != T('\0'); ++key)
+		{
+			TCHAR c = *key;
+			if(T('A') <= c && c <= T('Z')) c = (TCHAR) (c - T('A') + T('a'));
+			else if(c == T('/')) c = T('\\');
+
+			hash ^= (u32) c;
+			hash *= FNV_PRIME;
+		}
+	}
+
+	return (int) (hash % (u32) exporter->num_shards) == exporter->shard_index - 1;
+}
+
 // Exports a cache entry by copying its file to the output location using the original website's directory structure, and by adding a
 // new row to the CSV file. This function will also match the cache entry to any loaded group files.
 //
@@ -1620,6 +2219,10 @@ static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter
 // - The 'copy_source_path' should be defined in most cases, but may be NULL if an exporter has to manipulate the cached data using temporary files.
 // It's possible that this manipulation may fail (e.g. extracting the payload from a file), leading to a situation where we don't want to copy anything.
 //
+// - The 'use_copy_source_range', 'copy_source_offset', and 'copy_source_size' may be set if the cached data is stored at a given offset inside
+// 'copy_source_path'. In this case, only this byte range is copied, decompressed, hashed, and matched to the file groups. Exporters should prefer
+// this over extracting the cached data to a temporary file since it avoids copying the same data twice.
+//
 // - The 'url' may be NULL if the cached file has no URL information associated with it.
 // - The 'filename' may be NULL if either 'url' or 'file_info' were set and contain a non-empty string. Otherwise, this function assigns the cached
 // file a unique name.
@@ -1632,6 +2235,9 @@ static bool copy_exporter_file_using_url_directory_structure(	Exporter* exporter
 // then this should be set to NULL. If it is using them but you don't want to potentially replace the output filename with the file's real name on
 // disk, then you may also set it to NULL. For example, if both 'filename' and 'file_info' are NULL, and a name can't be determined from the URL,
 // then the exporter will just generate a unique one.
+//
+// - The 'exported_entry_callback' may be set to fill any columns whose values are expensive to compute. It's only called for entries that
+// pass the group filter.
 // 
 // @Returns: Nothing.
 void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_Params* params)
@@ -1639,10 +2245,35 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 	#define IS_STRING_EMPTY(string) ( ((string) == NULL) || string_is_empty(string) )
 
 	exporter->exported_at_least_one_file = true;
+	exporter->was_last_entry_exported = false;
 
 	Arena* temporary_arena = &(exporter->temporary_arena);
 
+	// Skip the remaining entries as quickly as possible if the export service cancelled the current job.
+	if(exporter->job_cancel_flag != NULL && *(exporter->job_cancel_flag) != 0)
+	{
+		clear_arena(temporary_arena);
+		exporter->warning_message[0] = T('\0');
+		return;
+	}
+
+	// Skip the entries that belong to other shards before touching the cached file.
+	if(!is_cache_entry_in_exporter_shard(exporter, params))
+	{
+		clear_arena(temporary_arena);
+		exporter->warning_message[0] = T('\0');
+		return;
+	}
+
 	TCHAR* entry_source_path = params->copy_source_path;
+	u64 entry_source_offset = 0;
+	u64 entry_source_size = READ_UNTIL_END_OF_FILE;
+	if(params->use_copy_source_range)
+	{
+		entry_source_offset = params->copy_source_offset;
+		entry_source_size = params->copy_source_size;
+	}
+
 	TCHAR* entry_url = params->url;
 	TCHAR* entry_filename = params->filename;
 
@@ -1691,43 +2322,22 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 
 	++(exporter->total_processed_files);
 
-	// The 'original_file_path' is the path to the original cached file on disk, while 'entry_source_path' points to
-	// whatever file we want to copy and use to determine the file groups. In most cases these are the same, though
-	// when a file is compressed we want to export the decompressed version instead.
-	bool file_exists = does_file_exist(entry_source_path);
-	TCHAR* original_file_path = entry_source_path;
-	
-	// Decompress the file according to its Content-Encoding HTTP header (if it exists).
-	TCHAR decompressed_file_path[MAX_PATH_CHARS] = T("");
-	HANDLE decompressed_file_handle = INVALID_HANDLE_VALUE;
-	TCHAR decompressed_file_size[MAX_INT_64_CHARS] = T("");
-
-	if(exporter->decompress_files && file_exists && entry_headers.content_encoding != NULL)
-	{
-		u64 decompressed_file_size_value = 0;
-		if(decompress_exporter_file(exporter, entry_source_path, entry_headers.content_encoding,
-									decompressed_file_path, &decompressed_file_handle, &decompressed_file_size_value))
-		{
-			entry_source_path = decompressed_file_path;
-			convert_u64_to_string(decompressed_file_size_value, decompressed_file_size);
-		}
-	}
-
 	Matchable_Cache_Entry entry_to_match = {};
-	entry_to_match.full_file_path = entry_source_path;
 
 	int file_group_index = -1;
 	int url_group_index = -1;
 
-	TCHAR file_size[MAX_INT_64_CHARS] = T("");
-	TCHAR creation_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	TCHAR last_write_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
-	
+	bool probe_swf_file = false;
+	int swf_version_index = -1;
+	int stage_dimensions_index = -1;
+	int frame_rate_index = -1;
+	int frame_count_index = -1;
+
+	// Fill the columns that only depend on the cache entry's metadata first so we can skip any entries that would be filtered out
+	// before doing any expensive work that depends on the cached file (decompressing, hashing, copying, etc).
 	for(int i = 0; i < exporter->num_csv_columns; ++i)
 	{
 		TCHAR* value = column_values[i].value;
-		bool use_value_from_file_info = (value == NULL && entry_file_info != NULL);
 
 		switch(exporter->csv_column_types[i])
 		{
@@ -1735,43 +2345,249 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 				@CustomGroups: Used to fill the custom group columns.
 				@FileInfo: Uses the values from the 'file_info' parameter if it exists, and if the column value in question is not NULL.
 				@ExporterParams: Uses the values from the 'params' parameter, except 'file_info'.
+				@FirstFileBytes: Filled after matching the groups using the first bytes of the file (e.g. the SWF header).
 			*/
 
-			// @FileInfo @ExporterParams
-			case(CSV_FILENAME):
+			// @CustomGroups @FileInfo
+			case(CSV_FILE_EXTENSION):
 			{
-				if(value == NULL) value = entry_filename;
+				if(value == NULL) value = skip_to_file_extension(entry_filename);
+				entry_to_match.file_extension_to_match = value;
 			} break;
 
-			// @ExporterParams
-			case(CSV_URL):
+			// @CustomGroups @ExporterParams
+			case(CSV_CONTENT_TYPE):
 			{
-				if(value == NULL) value = entry_url;
+				if(value == NULL) value = entry_headers.content_type;
+				entry_to_match.mime_type_to_match = value;
 			} break;
 
-			case(CSV_REQUEST_ORIGIN):
+			// @CustomGroups
+			case(CSV_CUSTOM_FILE_GROUP):
 			{
-				if(value == NULL) value = entry_request_origin;
+				_ASSERT(value == NULL);
+				file_group_index = i;
 			} break;
 
-			// @CustomGroups @FileInfo
-			case(CSV_FILE_EXTENSION):
+			// @CustomGroups
+			case(CSV_CUSTOM_URL_GROUP):
 			{
-				if(value == NULL) value = skip_to_file_extension(entry_filename);
-				entry_to_match.file_extension_to_match = value;
+				_ASSERT(value == NULL);
+				url_group_index = i;
 			} break;
 
-			// @FileInfo
-			case(CSV_FILE_SIZE):
+			// @FirstFileBytes
+			case(CSV_SWF_VERSION):
 			{
-				if(IS_STRING_EMPTY(value))
-				{
-					u64 file_size_value = 0;
-					if(use_value_from_file_info)
-					{
-						file_size_value = entry_file_info->object_size;
-					}
-					else
+				_ASSERT(value == NULL);
+				probe_swf_file = true;
+				swf_version_index = i;
+			} break;
+
+			// @FirstFileBytes
+			case(CSV_STAGE_DIMENSIONS):
+			{
+				_ASSERT(value == NULL);
+				probe_swf_file = true;
+				stage_dimensions_index = i;
+			} break;
+
+			// @FirstFileBytes
+			case(CSV_FRAME_RATE):
+			{
+				_ASSERT(value == NULL);
+				probe_swf_file = true;
+				frame_rate_index = i;
+			} break;
+
+			// @FirstFileBytes
+			case(CSV_FRAME_COUNT):
+			{
+				_ASSERT(value == NULL);
+				probe_swf_file = true;
+				frame_count_index = i;
+			} break;
+		}
+
+		column_values[i].value = value;
+	}
+
+	entry_to_match.match_file_group = (file_group_index != -1);
+	entry_to_match.match_url_group = (url_group_index != -1);
+
+	// Add the request origin to the beginning of the URL if needed. This new URL is only used to match the groups and to create
+	// the output directory structure, meaning the URL column still shows the original value.
+	TCHAR* url_to_export = entry_url;
+	if(exporter->group_by_request_origin && entry_url != NULL && entry_request_origin != NULL)
+	{
+		TCHAR* url_without_scheme = skip_url_scheme(entry_url);
+
+		const TCHAR* GENERIC_SCHEME = T("http://");
+		size_t new_url_size = string_size(GENERIC_SCHEME) + string_size(entry_request_origin) + string_size(url_without_scheme);
+		TCHAR* new_url = push_arena(temporary_arena, new_url_size, TCHAR);
+
+		// Add a generic scheme if the request origin doesn't have one.
+		Url_Parts parts = {};
+		partition_url(temporary_arena, entry_request_origin, &parts);
+
+		if(parts.scheme == NULL)
+		{
+			StringCbCopy(new_url, new_url_size, GENERIC_SCHEME);
+			StringCbCat(new_url, new_url_size, entry_request_origin);
+			StringCbCat(new_url, new_url_size, T("/"));
+			StringCbCat(new_url, new_url_size, url_without_scheme);
+
+		}
+		else
+		{
+			StringCbCopy(new_url, new_url_size, entry_request_origin);
+			StringCbCat(new_url, new_url_size, T("/"));
+			StringCbCat(new_url, new_url_size, url_without_scheme);
+		}
+
+		url_to_export = new_url;
+	}
+
+	entry_to_match.url_to_match = url_to_export;
+
+	// Skip the entries that the group filter would never allow before touching the cached file. Only the file signatures
+	// require reading it, and any groups that use them are only decided by the full match below.
+	bool filter_entry_by_groups = exporter->filter_by_groups && !exporter->ignore_filter_for_cache_type[exporter->current_cache_type];
+	if(filter_entry_by_groups && !can_cache_entry_pass_group_filter(exporter, &entry_to_match))
+	{
+		clear_arena(temporary_arena);
+		exporter->warning_message[0] = T('\0');
+		return;
+	}
+
+	// The 'original_file_path' is the path to the original cached file on disk, while 'entry_source_path' points to
+	// whatever file we want to copy and use to determine the file groups. In most cases these are the same, though
+	// when a file is compressed we want to export the decompressed version instead.
+	bool file_exists = does_file_exist(entry_source_path);
+	TCHAR* original_file_path = entry_source_path;
+	
+	// Decompress the file according to its Content-Encoding HTTP header (if it exists).
+	TCHAR decompressed_file_path[MAX_PATH_CHARS] = T("");
+	HANDLE decompressed_file_handle = INVALID_HANDLE_VALUE;
+	TCHAR decompressed_file_size[MAX_INT_64_CHARS] = T("");
+
+	if(exporter->decompress_files && file_exists && entry_headers.content_encoding != NULL)
+	{
+		u64 decompressed_file_size_value = 0;
+		if(decompress_exporter_file(exporter, entry_source_path, entry_source_offset, entry_source_size, entry_headers.content_encoding,
+									decompressed_file_path, &decompressed_file_handle, &decompressed_file_size_value))
+		{
+			entry_source_path = decompressed_file_path;
+			entry_source_offset = 0;
+			entry_source_size = READ_UNTIL_END_OF_FILE;
+			convert_u64_to_string(decompressed_file_size_value, decompressed_file_size);
+		}
+	}
+
+	// Read the first bytes of the file once so they can be shared by the file signature matching and the SWF header probing.
+	u32 max_first_file_bytes_size = 0;
+	if(probe_swf_file)
+	{
+		max_first_file_bytes_size = MAX(max_first_file_bytes_size, MAX_SWF_PROBE_SIZE);
+	}
+	if(entry_to_match.match_file_group && exporter->custom_groups != NULL)
+	{
+		max_first_file_bytes_size = MAX(max_first_file_bytes_size, (u32) exporter->custom_groups->max_file_signature_size);
+	}
+	if(entry_source_size != READ_UNTIL_END_OF_FILE)
+	{
+		max_first_file_bytes_size = (u32) MIN(max_first_file_bytes_size, entry_source_size);
+	}
+
+	u8* first_file_bytes = NULL;
+	u32 num_first_file_bytes = 0;
+	if(file_exists && max_first_file_bytes_size > 0)
+	{
+		first_file_bytes = push_array_to_arena(temporary_arena, max_first_file_bytes_size, u8);
+		if(!read_file_chunk(entry_source_path, first_file_bytes, max_first_file_bytes_size, entry_source_offset, true, &num_first_file_bytes))
+		{
+			first_file_bytes = NULL;
+			num_first_file_bytes = 0;
+		}
+	}
+
+	entry_to_match.file_signature = first_file_bytes;
+	entry_to_match.file_signature_size = num_first_file_bytes;
+
+	// Files can match groups even if they don't exist on disk.
+	bool matched_group = match_cache_entry_to_groups(exporter, &entry_to_match);
+
+	if(filter_entry_by_groups && !(matched_group && entry_to_match.match_is_enabled_for_filtering))
+	{
+		safe_close_handle(&decompressed_file_handle);
+		clear_arena(temporary_arena);
+		exporter->warning_message[0] = T('\0');
+		return;
+	}
+
+	if(matched_group)
+	{
+		if(file_group_index != -1)
+		{
+			column_values[file_group_index].value = entry_to_match.matched_file_group_name;
+		}
+
+		if(url_group_index != -1)
+		{
+			column_values[url_group_index].value = entry_to_match.matched_url_group_name;
+		}
+	}
+
+	if(params->exported_entry_callback != NULL)
+	{
+		params->exported_entry_callback(exporter, column_values, params->exported_entry_user_data);
+	}
+
+	// Fill the remaining columns now that we know the entry will be exported.
+	TCHAR file_size[MAX_INT_64_CHARS] = T("");
+	TCHAR creation_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	TCHAR last_write_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	TCHAR last_access_time[MAX_FORMATTED_DATE_TIME_CHARS] = T("");
+	
+	for(int i = 0; i < exporter->num_csv_columns; ++i)
+	{
+		TCHAR* value = column_values[i].value;
+		bool use_value_from_file_info = (value == NULL && entry_file_info != NULL);
+
+		switch(exporter->csv_column_types[i])
+		{
+			// @FileInfo @ExporterParams
+			case(CSV_FILENAME):
+			{
+				if(value == NULL) value = entry_filename;
+			} break;
+
+			// @ExporterParams
+			case(CSV_URL):
+			{
+				if(value == NULL) value = entry_url;
+			} break;
+
+			case(CSV_REQUEST_ORIGIN):
+			{
+				if(value == NULL) value = entry_request_origin;
+			} break;
+
+			// @FileInfo
+			case(CSV_FILE_SIZE):
+			{
+				if(IS_STRING_EMPTY(value))
+				{
+					u64 file_size_value = 0;
+					if(use_value_from_file_info)
+					{
+						file_size_value = entry_file_info->object_size;
+					}
+					else if(params->use_copy_source_range)
+					{
+						file_size_value = params->copy_source_size;
+					}
+					else
 					{
 						get_file_size(original_file_path, &file_size_value);
 					}
@@ -1835,13 +2651,6 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 				if(value == NULL) value = entry_headers.pragma;
 			} break;
 
-			// @CustomGroups @ExporterParams
-			case(CSV_CONTENT_TYPE):
-			{
-				if(value == NULL) value = entry_headers.content_type;
-				entry_to_match.mime_type_to_match = value;
-			} break;
-
 			// @ExporterParams
 			case(CSV_CONTENT_LENGTH):
 			{
@@ -1894,27 +2703,13 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 				value = exporter->warning_message;
 			} break;
 
-			// @CustomGroups
-			case(CSV_CUSTOM_FILE_GROUP):
-			{
-				_ASSERT(value == NULL);
-				file_group_index = i;
-			} break;
-
-			// @CustomGroups
-			case(CSV_CUSTOM_URL_GROUP):
-			{
-				_ASSERT(value == NULL);
-				url_group_index = i;
-			} break;
-
 			// @ExporterParams
 			case(CSV_SHA_256):
 			{
-				_ASSERT(value == NULL);
-				if(file_exists)
+				_ASSERT(value == NULL || params->has_precomputed_sha_256);
+				if(file_exists && !params->has_precomputed_sha_256)
 				{
-					value = generate_sha_256_from_file(temporary_arena, entry_source_path);
+					value = generate_sha_256_from_file(temporary_arena, entry_source_path, entry_source_offset, entry_source_size);
 				}
 			} break;
 		}
@@ -1922,74 +2717,55 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 		column_values[i].value = value;
 	}
 
-	entry_to_match.match_file_group = (file_group_index != -1);
-	entry_to_match.match_url_group = (url_group_index != -1);
-
-	// Add the request origin to the beginning of the URL if needed.
-	if(exporter->group_by_request_origin && entry_url != NULL && entry_request_origin != NULL)
+	Swf_Header swf_header = {};
+	if(probe_swf_file && probe_swf_header(temporary_arena, first_file_bytes, num_first_file_bytes, &swf_header))
 	{
-		entry_url = skip_url_scheme(entry_url);
-
-		const TCHAR* GENERIC_SCHEME = T("http://");
-		size_t new_url_size = string_size(GENERIC_SCHEME) + string_size(entry_request_origin) + string_size(entry_url);
-		TCHAR* new_url = push_arena(temporary_arena, new_url_size, TCHAR);
-
-		// Add a generic scheme if the request origin doesn't have one.
-		Url_Parts parts = {};
-		partition_url(temporary_arena, entry_request_origin, &parts);
-
-		if(parts.scheme == NULL)
+		if(swf_version_index != -1)
 		{
-			StringCbCopy(new_url, new_url_size, GENERIC_SCHEME);
-			StringCbCat(new_url, new_url_size, entry_request_origin);
-			StringCbCat(new_url, new_url_size, T("/"));
-			StringCbCat(new_url, new_url_size, entry_url);
-
+			TCHAR* swf_version = push_array_to_arena(temporary_arena, MAX_INT_32_CHARS, TCHAR);
+			convert_u32_to_string(swf_header.version, swf_version);
+			column_values[swf_version_index].value = swf_version;
 		}
-		else
+
+		if(stage_dimensions_index != -1)
 		{
-			StringCbCopy(new_url, new_url_size, entry_request_origin);
-			StringCbCat(new_url, new_url_size, T("/"));
-			StringCbCat(new_url, new_url_size, entry_url);
+			const size_t MAX_STAGE_DIMENSIONS_CHARS = MAX_INT_32_CHARS * 2 + 1;
+			TCHAR* stage_dimensions = push_array_to_arena(temporary_arena, MAX_STAGE_DIMENSIONS_CHARS, TCHAR);
+			StringCchPrintf(stage_dimensions, MAX_STAGE_DIMENSIONS_CHARS, T("%I32dx%I32d"), swf_header.stage_width / 20, swf_header.stage_height / 20);
+			column_values[stage_dimensions_index].value = stage_dimensions;
 		}
 
-		entry_url = new_url;
-	}
-
-	entry_to_match.url_to_match = entry_url;
-
-	// Files can match groups even if they don't exist on disk.
-	bool matched_group = match_cache_entry_to_groups(exporter, &entry_to_match);
-	if(matched_group)
-	{
-		if(file_group_index != -1)
+		if(frame_rate_index != -1)
 		{
-			column_values[file_group_index].value = entry_to_match.matched_file_group_name;
+			const size_t MAX_FRAME_RATE_CHARS = 16;
+			TCHAR* frame_rate = push_array_to_arena(temporary_arena, MAX_FRAME_RATE_CHARS, TCHAR);
+			StringCchPrintf(frame_rate, MAX_FRAME_RATE_CHARS, T("%.2f"), swf_header.frame_rate / 256.0);
+			column_values[frame_rate_index].value = frame_rate;
 		}
 
-		if(url_group_index != -1)
+		if(frame_count_index != -1)
 		{
-			column_values[url_group_index].value = entry_to_match.matched_url_group_name;
+			TCHAR* frame_count = push_array_to_arena(temporary_arena, MAX_INT_32_CHARS, TCHAR);
+			convert_u32_to_string(swf_header.frame_count, frame_count);
+			column_values[frame_count_index].value = frame_count;
 		}
 	}
 
-	bool match_allows_for_exporting_entry = true;
-	if(exporter->filter_by_groups)
-	{
-		match_allows_for_exporting_entry = (matched_group && entry_to_match.match_is_enabled_for_filtering) || exporter->ignore_filter_for_cache_type[exporter->current_cache_type];
-	}
-
 	TCHAR copy_destination_path[MAX_PATH_CHARS] = T("");
 	TCHAR copy_error_code[MAX_INT_32_CHARS] = T("");
-	if(file_exists && exporter->copy_files && match_allows_for_exporting_entry)
+	if(file_exists && exporter->copy_files)
 	{
 		if(copy_exporter_file_using_url_directory_structure(exporter,
-															entry_source_path, entry_url,
-															entry_filename, entry_to_match.matched_default_file_extension,
+															entry_source_path, entry_source_offset, entry_source_size,
+															url_to_export, entry_filename, entry_to_match.matched_default_file_extension,
 															copy_destination_path, copy_error_code))
 		{
 			++(exporter->total_copied_files);
 		}
+		else
+		{
+			++(exporter->total_export_errors);
+		}
 	}
 
 	// For any values that can only be added to the CSV row after copying the file.
@@ -2015,11 +2791,13 @@ void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_P
 		column_values[i].value = value;
 	}
 
-	if(exporter->create_csvs && match_allows_for_exporting_entry)
+	if(exporter->create_csvs)
 	{
 		csv_print_row(temporary_arena, exporter->csv_file_handle, column_values, exporter->num_csv_columns);
 	}
 
+	exporter->was_last_entry_exported = true;
+
 	safe_close_handle(&decompressed_file_handle);
 
 	clear_arena(temporary_arena);
@@ -2456,7 +3234,8 @@ static void load_external_locations(Exporter* exporter, int num_profiles)
 	exporter->external_locations = external_locations;
 }
 
-// A helper function used by export_all_default_or_specific_cache_locations() that exports every supported cache type.
+// A helper function used by export_all_default_or_specific_cache_locations() that exports every supported cache type. If the -lookup-ie
+// option was used, only the Internet Explorer cache is checked.
 //
 // @Parameters:
 // 1. exporter - The Exporter structure which contains information on how every cache type should be exported.
@@ -2464,104 +3243,587 @@ static void load_external_locations(Exporter* exporter, int num_profiles)
 // @Returns: Nothing.
 static void export_all_cache_locations(Exporter* exporter)
 {
+	if(exporter->use_filesystem_snapshot)
+	{
+		// Every exporter looks for its files in these locations. The directories we write to are excluded since the
+		// snapshot isn't updated while exporting.
+		const TCHAR* root_paths[] =
+		{
+			exporter->appdata_path, exporter->local_appdata_path, exporter->local_low_appdata_path,
+			exporter->windows_temporary_path, exporter->wininet_cache_path
+		};
+		const TCHAR* excluded_paths[] = {exporter->exporter_temporary_path, exporter->output_path};
+
+		log_info("All Locations: Taking a snapshot of the default cache locations.");
+		take_filesystem_snapshot(&(exporter->snapshot_arena), root_paths, _countof(root_paths), excluded_paths, _countof(excluded_paths));
+		log_newline();
+	}
+
 	export_default_or_specific_internet_explorer_cache(exporter);
 	log_newline();
 
-	export_default_or_specific_mozilla_cache(exporter);
-	log_newline();
+	// Looking up URLs is only supported by the Internet Explorer cache, and the point of this mode is to skip full exports.
+	if(!exporter->use_ie_url_lookup)
+	{
+		export_default_or_specific_mozilla_cache(exporter);
+		log_newline();
 
-	export_default_or_specific_flash_cache(exporter);
-	log_newline();
+		export_default_or_specific_flash_cache(exporter);
+		log_newline();
 
-	export_default_or_specific_shockwave_cache(exporter);
-	log_newline();
+		export_default_or_specific_shockwave_cache(exporter);
+		log_newline();
+
+		export_default_or_specific_java_cache(exporter);
+		log_newline();
+
+		export_default_or_specific_unity_cache(exporter);
+	}
+
+	if(exporter->use_filesystem_snapshot)
+	{
+		discard_filesystem_snapshot();
+		clear_arena(&(exporter->snapshot_arena));
+	}
+}
+
+// Logs a profile's locations and copies them to the exporter. Every path type must appear in the external locations file, but empty
+// paths are allowed (using an empty string or "<None>").
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that receives the profile's locations.
+// 2. profile - The Profile structure from the external locations file.
+// 3. profile_index - The profile's index in the external locations file.
+//
+// @Returns: True if every location was copied successfully. Otherwise, false and this profile should be skipped.
+static bool copy_profile_locations(Exporter* exporter, Profile* profile, int profile_index)
+{
+	#define STRING_OR_DEFAULT(str) (str != NULL) ? (str) : (T(""))
 
-	export_default_or_specific_java_cache(exporter);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_info("Exporting from the profile '%s' (%I32u).", profile->name, profile_index);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Drive Path: '%s'", STRING_OR_DEFAULT(profile->drive_path));
+	log_print(LOG_NONE, "- Windows Directory Path: '%s'", STRING_OR_DEFAULT(profile->windows_path));
+	log_print(LOG_NONE, "- Windows Temporary Path: '%s'", STRING_OR_DEFAULT(profile->windows_temporary_path));
+	log_print(LOG_NONE, "- User Profile Path: '%s'", STRING_OR_DEFAULT(profile->user_profile_path));
+	log_print(LOG_NONE, "- Roaming AppData Path: '%s'", STRING_OR_DEFAULT(profile->appdata_path));
+	log_print(LOG_NONE, "- Local AppData Path: '%s'", STRING_OR_DEFAULT(profile->local_appdata_path));
+	log_print(LOG_NONE, "- LocalLow AppData Path: '%s'", STRING_OR_DEFAULT(profile->local_low_appdata_path));
+	log_print(LOG_NONE, "- WinINet Cache Path: '%s'", STRING_OR_DEFAULT(profile->wininet_cache_path));
+	log_print(LOG_NONE, "------------------------------------------------------------");
 	log_newline();
 
-	export_default_or_specific_unity_cache(exporter);
+	#undef STRING_OR_DEFAULT
+
+	bool are_all_locations_valid = true;
+	// Helper macro function used to check if all paths don't exceed MAX_PATH_CHARS characters and if all
+	// types were specified. Empty paths are allowed (using an empty string or "<None>"), but every path
+	// type keyword must always appear.
+	#define CHECK_AND_COPY_LOCATION(member_name, location_name)\
+	do\
+	{\
+		if(profile->member_name == NULL)\
+		{\
+			are_all_locations_valid = false;\
+			console_print("This profile will be skipped since the %hs path was not found in the list.", location_name);\
+			log_warning("All Locations: The profile '%s' (%I32u) will be skipped since the %hs path was not found in the list.", profile->name, profile_index, location_name);\
+		}\
+		else if(FAILED(StringCchCopy(exporter->member_name, MAX_PATH_CHARS, profile->member_name)))\
+		{\
+			are_all_locations_valid = false;\
+			console_print("This profile will be skipped since the %hs path is too long.", location_name);\
+			log_warning("All Locations: The profile '%s' (%I32u) will be skipped since the %hs path is too long.", profile->name, profile_index, location_name);\
+		}\
+	} while(false, false)
+
+	CHECK_AND_COPY_LOCATION(drive_path, 				"Drive");
+	CHECK_AND_COPY_LOCATION(windows_path, 				"Windows");
+	CHECK_AND_COPY_LOCATION(windows_temporary_path, 	"Temporary");
+	CHECK_AND_COPY_LOCATION(user_profile_path, 			"User Profile");
+	CHECK_AND_COPY_LOCATION(appdata_path, 				"AppData");
+	CHECK_AND_COPY_LOCATION(local_appdata_path, 		"Local AppData");
+	CHECK_AND_COPY_LOCATION(local_low_appdata_path, 	"Local Low AppData");
+	CHECK_AND_COPY_LOCATION(wininet_cache_path, 		"Internet Cache");
+
+	#undef CHECK_AND_COPY_LOCATION
+
+	return are_all_locations_valid;
 }
 
-// Entry point for a cache exporter that handles every supported cache type. This function exports from a given number of locations if
-// the external locations file was previously loaded. Otherwise, it exports from each cache type's default location.
+// Exports every profile in the external locations file one after the other.
 //
 // @Parameters:
 // 1. exporter - The Exporter structure which contains information on how every cache type should be exported.
 //
 // @Returns: Nothing.
-static void export_all_default_or_specific_cache_locations(Exporter* exporter)
+static void export_profiles_sequentially(Exporter* exporter)
 {
-	if(exporter->load_external_locations)
-	{
-		External_Locations* external_locations = exporter->external_locations;
-		_ASSERT(external_locations != NULL);
+	External_Locations* external_locations = exporter->external_locations;
 
-		console_print("Exporting the cache from the default locations in %d profiles...", external_locations->num_profiles);
-		log_info("All Locations: Exporting the cache from the default locations in %d profiles.", external_locations->num_profiles);
-		log_newline();
+	for(int i = 0; i < external_locations->num_profiles; ++i)
+	{
+		Profile* profile = &(external_locations->profiles[i]);
+		exporter->current_profile_name = profile->name;
+		console_print("- [%d of %d] Exporting from the profile '%s'...", i+1, external_locations->num_profiles, profile->name);
 
-		for(int i = 0; i < external_locations->num_profiles; ++i)
+		if(copy_profile_locations(exporter, profile, i))
 		{
-			Profile profile = external_locations->profiles[i];
-			exporter->current_profile_name = profile.name;
-			console_print("- [%d of %d] Exporting from the profile '%s'...", i+1, external_locations->num_profiles, profile.name);
-			
-			#define STRING_OR_DEFAULT(str) (str != NULL) ? (str) : (T(""))
-
-			log_print(LOG_NONE, "------------------------------------------------------------");
-			log_info("Exporting from the profile '%s' (%I32u).", profile.name, i);
-			log_print(LOG_NONE, "------------------------------------------------------------");
-			log_print(LOG_NONE, "- Drive Path: '%s'", STRING_OR_DEFAULT(profile.drive_path));
-			log_print(LOG_NONE, "- Windows Directory Path: '%s'", STRING_OR_DEFAULT(profile.windows_path));
-			log_print(LOG_NONE, "- Windows Temporary Path: '%s'", STRING_OR_DEFAULT(profile.windows_temporary_path));
-			log_print(LOG_NONE, "- User Profile Path: '%s'", STRING_OR_DEFAULT(profile.user_profile_path));
-			log_print(LOG_NONE, "- Roaming AppData Path: '%s'", STRING_OR_DEFAULT(profile.appdata_path));
-			log_print(LOG_NONE, "- Local AppData Path: '%s'", STRING_OR_DEFAULT(profile.local_appdata_path));
-			log_print(LOG_NONE, "- LocalLow AppData Path: '%s'", STRING_OR_DEFAULT(profile.local_low_appdata_path));
-			log_print(LOG_NONE, "- WinINet Cache Path: '%s'", STRING_OR_DEFAULT(profile.wininet_cache_path));
-			log_print(LOG_NONE, "------------------------------------------------------------");
-			log_newline();
+			export_all_cache_locations(exporter);
+		}
 
-			#undef STRING_OR_DEFAULT
-
-			bool are_all_locations_valid = true;
-			// Helper macro function used to check if all paths don't exceed MAX_PATH_CHARS characters and if all
-			// types were specified. Empty paths are allowed (using an empty string or "<None>"), but every path
-			// type keyword must always appear.
-			#define CHECK_AND_COPY_LOCATION(member_name, location_name)\
-			do\
-			{\
-				if(profile.member_name == NULL)\
-				{\
-					are_all_locations_valid = false;\
-					console_print("This profile will be skipped since the %hs path was not found in the list.", location_name);\
-					log_warning("All Locations: The profile '%s' (%I32u) will be skipped since the %hs path was not found in the list.", profile.name, i, location_name);\
-				}\
-				else if(FAILED(StringCchCopy(exporter->member_name, MAX_PATH_CHARS, profile.member_name)))\
-				{\
-					are_all_locations_valid = false;\
-					console_print("This profile will be skipped since the %hs path is too long.", location_name);\
-					log_warning("All Locations: The profile '%s' (%I32u) will be skipped since the %hs path is too long.", profile.name, i, location_name);\
-				}\
-			} while(false, false)
-
-			CHECK_AND_COPY_LOCATION(drive_path, 				"Drive");
-			CHECK_AND_COPY_LOCATION(windows_path, 				"Windows");
-			CHECK_AND_COPY_LOCATION(windows_temporary_path, 	"Temporary");
-			CHECK_AND_COPY_LOCATION(user_profile_path, 			"User Profile");
-			CHECK_AND_COPY_LOCATION(appdata_path, 				"AppData");
-			CHECK_AND_COPY_LOCATION(local_appdata_path, 		"Local AppData");
-			CHECK_AND_COPY_LOCATION(local_low_appdata_path, 	"Local Low AppData");
-			CHECK_AND_COPY_LOCATION(wininet_cache_path, 		"Internet Cache");
-
-			#undef CHECK_AND_COPY_LOCATION
-
-			if(are_all_locations_valid)
-			{
-				export_all_cache_locations(exporter);
+		log_newline();
+	}
+}
+
+// The functions that define how each job is exported by export_jobs_in_parallel(). Every function except for EXPORT_JOB is called
+// from the main thread.
+//
+// GET_EXPORT_JOB_DRIVE_ROOT determines the root of the drive that a job reads from. PREPARE_EXPORT_JOB sets up a worker's exporter
+// and returns false if the job should be skipped. EXPORT_JOB exports the job using the worker's exporter. FINISH_EXPORT_JOB is called
+// before the worker's totals are added to the main exporter.
+#define GET_EXPORT_JOB_DRIVE_ROOT(function_name) void function_name(Exporter* exporter, int job_index, TCHAR* result_path)
+typedef GET_EXPORT_JOB_DRIVE_ROOT(Get_Export_Job_Drive_Root);
+#define PREPARE_EXPORT_JOB(function_name) bool function_name(Exporter* exporter, Exporter* worker_exporter, int job_index)
+typedef PREPARE_EXPORT_JOB(Prepare_Export_Job);
+#define EXPORT_JOB(function_name) void function_name(Exporter* worker_exporter)
+typedef EXPORT_JOB(Export_Job);
+#define FINISH_EXPORT_JOB(function_name) void function_name(Exporter* exporter, Exporter* worker_exporter, int job_index)
+typedef FINISH_EXPORT_JOB(Finish_Export_Job);
+
+struct Export_Job_Functions
+{
+	Get_Export_Job_Drive_Root* get_drive_root;
+	Prepare_Export_Job* prepare_job;
+	Export_Job* export_job;
+	Finish_Export_Job* finish_job;
+};
+
+// A thread that exports one job at a time using its own copy of the main exporter. See: export_jobs_in_parallel().
+struct Export_Worker
+{
+	// A copy of the main exporter with its own temporary memory arena and temporary directory. Any data that was loaded into
+	// the main exporter's permanent memory arena (e.g. the group files) is shared between every worker.
+	Exporter exporter;
+
+	// The thread that is exporting the current job, or NULL if the worker is idle.
+	HANDLE thread_handle;
+	int job_index;
+	Export_Job* export_job;
+
+	// The root of the drive that the current job reads from (e.g. "C:\" or "\\Server\Share").
+	TCHAR drive_root_path[MAX_PATH_CHARS];
+};
+
+// Determines the root of the drive where a path is located. Jobs on the same drive are limited since they compete for the
+// same device.
+//
+// @Parameters:
+// 1. path - The path. This may be empty or "<None>".
+// 2. result_path - The buffer that receives the drive's root path. This buffer must be able to hold MAX_PATH_CHARS characters.
+// This path is empty if the path is empty.
+//
+// @Returns: True if the path wasn't empty. Otherwise, false.
+static bool get_drive_root_path(const TCHAR* path, TCHAR* result_path)
+{
+	*result_path = T('\0');
+
+	if(path == NULL || string_is_empty(path) || strings_are_equal(path, PATH_NOT_FOUND)) return false;
+
+	StringCchCopy(result_path, MAX_PATH_CHARS, path);
+	get_full_path_name(result_path);
+	PathStripToRoot(result_path);
+
+	return true;
+}
+
+// The entry point for each worker thread.
+//
+// @Parameters:
+// 1. argument - The Export_Worker structure whose exporter was set up for the current job.
+//
+// @Returns: Zero.
+static unsigned __stdcall export_worker_thread(void* argument)
+{
+	Export_Worker* worker = (Export_Worker*) argument;
+	worker->export_job(&(worker->exporter));
+	return 0;
+}
+
+// Finishes a job by adding the number of exported files from a worker's exporter to the main exporter's totals. The worker's
+// counters are then reset so it can export the next job. This function must only be called from the main thread.
+//
+// @Parameters:
+// 1. exporter - The main Exporter structure.
+// 2. worker - The Export_Worker structure that finished exporting a job.
+// 3. functions - The functions that define how each job is exported.
+//
+// @Returns: Nothing.
+static void finish_export_worker(Exporter* exporter, Export_Worker* worker, Export_Job_Functions* functions)
+{
+	Exporter* worker_exporter = &(worker->exporter);
+
+	if(functions->finish_job != NULL) functions->finish_job(exporter, worker_exporter, worker->job_index);
+
+	exporter->total_csv_files_created += worker_exporter->total_csv_files_created;
+	exporter->total_processed_files += worker_exporter->total_processed_files;
+	exporter->total_copied_files += worker_exporter->total_copied_files;
+	exporter->total_export_errors += worker_exporter->total_export_errors;
+	exporter->total_assigned_filenames += worker_exporter->total_assigned_filenames;
+
+	worker_exporter->total_csv_files_created = 0;
+	worker_exporter->total_processed_files = 0;
+	worker_exporter->total_copied_files = 0;
+	worker_exporter->total_export_errors = 0;
+	worker_exporter->total_assigned_filenames = 0;
+
+	if(worker->thread_handle != NULL)
+	{
+		CloseHandle(worker->thread_handle);
+		worker->thread_handle = NULL;
+	}
+}
+
+// Sets up a worker's exporter as a copy of the main exporter that doesn't own any of its memory arenas.
+//
+// @Parameters:
+// 1. exporter - The main Exporter structure.
+// 2. worker - The Export_Worker structure to set up.
+//
+// @Returns: Nothing.
+static void copy_exporter_to_worker(Exporter* exporter, Export_Worker* worker)
+{
+	Exporter* worker_exporter = &(worker->exporter);
+
+	*worker_exporter = *exporter;
+	worker_exporter->permanent_arena = NULL_ARENA;
+	worker_exporter->secondary_temporary_arena = NULL_ARENA;
+	worker_exporter->snapshot_arena = NULL_ARENA;
+	worker_exporter->temporary_arena = NULL_ARENA;
+	worker_exporter->total_csv_files_created = 0;
+	worker_exporter->total_processed_files = 0;
+	worker_exporter->total_copied_files = 0;
+	worker_exporter->total_export_errors = 0;
+	worker_exporter->total_assigned_filenames = 0;
+
+	worker->thread_handle = NULL;
+	worker->job_index = -1;
+	worker->export_job = NULL;
+}
+
+// Creates a number of workers that export jobs using copies of the main exporter. Each worker has its own temporary memory arena
+// and temporary directory. If a worker can't be created, the remaining ones are skipped.
+//
+// @Parameters:
+// 1. exporter - The main Exporter structure.
+// 2. workers - The array of Export_Worker structures to set up.
+// 3. num_workers - The number of elements in this array.
+// 4. ese_critical_section - The critical section that is used to export one ESE database at a time.
+//
+// @Returns: The number of workers that were created. These are always the first elements in the array and must be destroyed
+// with destroy_export_workers().
+static int create_export_workers(Exporter* exporter, Export_Worker* workers, int num_workers, CRITICAL_SECTION* ese_critical_section)
+{
+	int num_ready_workers = 0;
+
+	for(int i = 0; i < num_workers; ++i)
+	{
+		Export_Worker* worker = &workers[num_ready_workers];
+		Exporter* worker_exporter = &(worker->exporter);
+
+		copy_exporter_to_worker(exporter, worker);
+		worker_exporter->ese_critical_section = ese_critical_section;
+
+		if(!create_arena(&(worker_exporter->temporary_arena), exporter->temporary_arena.total_size))
+		{
+			log_warning("Export Jobs: Failed to allocate %Iu bytes for the worker %d. Only %d workers will be used.", exporter->temporary_arena.total_size, i, num_ready_workers);
+			break;
+		}
+
+		// Each worker clears its own temporary directory, so these can't be shared.
+		worker_exporter->was_temporary_exporter_directory_created = exporter->was_temporary_exporter_directory_created
+																	&& create_temporary_directory(exporter->exporter_temporary_path, worker_exporter->exporter_temporary_path);
+
+		++num_ready_workers;
+	}
+
+	return num_ready_workers;
+}
+
+// Deletes the temporary directories and frees the memory of the workers created by create_export_workers(). Every worker must
+// be idle before calling this function.
+//
+// @Parameters:
+// 1. workers - The array of Export_Worker structures.
+// 2. num_workers - The number of workers that were created.
+//
+// @Returns: Nothing.
+static void destroy_export_workers(Export_Worker* workers, int num_workers)
+{
+	for(int i = 0; i < num_workers; ++i)
+	{
+		Exporter* worker_exporter = &(workers[i].exporter);
+
+		if(worker_exporter->was_temporary_exporter_directory_created && !delete_directory_and_contents(worker_exporter->exporter_temporary_path))
+		{
+			log_error("Export Jobs: Failed to delete the temporary directory of the worker %d in '%s'.", i, worker_exporter->exporter_temporary_path);
+		}
+
+		destroy_arena(&(worker_exporter->temporary_arena));
+	}
+}
+
+// Exports a number of jobs (e.g. profiles) at the same time. Each job is exported by a worker thread with its own copy of the
+// exporter, and the number of jobs that are exported from the same drive at once is limited. Jobs are started in order, except
+// when their drive is busy.
+//
+// Only one ESE database is exported at a time since the ESE library's database page size is shared by the whole process.
+//
+// If the workers can't be created, each job is exported one after the other using the main exporter's memory.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how every job should be exported.
+// 2. num_jobs - The number of jobs.
+// 3. max_jobs_per_drive - The maximum number of jobs that are exported from the same drive at once.
+// 4. functions - The functions that define how each job is exported.
+//
+// @Returns: Nothing.
+static void export_jobs_in_parallel(Exporter* exporter, int num_jobs, int max_jobs_per_drive, Export_Job_Functions* functions)
+{
+	if(num_jobs == 0) return;
+
+	int num_workers = MIN(num_jobs, MAX_PARALLEL_EXPORT_JOBS);
+
+	Arena worker_arena = {};
+	size_t worker_arena_size = num_workers * sizeof(Export_Worker) + num_jobs * sizeof(bool) + 2 * MAX_SCALAR_ALIGNMENT_SIZE;
+	Export_Worker* workers = NULL;
+	bool* was_job_started = NULL;
+	int num_ready_workers = 0;
+
+	if(create_arena(&worker_arena, worker_arena_size))
+	{
+		workers = push_array_to_arena(&worker_arena, num_workers, Export_Worker);
+		was_job_started = push_array_to_arena(&worker_arena, num_jobs, bool);
+		ZeroMemory(was_job_started, num_jobs * sizeof(bool));
+	}
+	else
+	{
+		log_warning("Export Jobs: Failed to allocate %Iu bytes for %d workers.", worker_arena_size, num_workers);
+		num_workers = 0;
+	}
+
+	CRITICAL_SECTION ese_critical_section;
+	InitializeCriticalSection(&ese_critical_section);
+
+	if(num_workers > 0) num_ready_workers = create_export_workers(exporter, workers, num_workers, &ese_critical_section);
+
+	if(num_ready_workers > 0)
+	{
+		log_info("Export Jobs: Exporting up to %d jobs at the same time, with at most %d per drive.", num_ready_workers, max_jobs_per_drive);
+	}
+	else
+	{
+		log_warning("Export Jobs: Failed to create any workers. The jobs will be exported one at a time.");
+
+		// The main exporter is idle while the jobs are exported, so its memory and temporary directory can be used directly.
+		Export_Worker main_worker;
+		copy_exporter_to_worker(exporter, &main_worker);
+		main_worker.exporter.temporary_arena = exporter->temporary_arena;
+
+		for(int i = 0; i < num_jobs; ++i)
+		{
+			main_worker.job_index = i;
+			if(functions->prepare_job(exporter, &(main_worker.exporter), i))
+			{
+				functions->export_job(&(main_worker.exporter));
+				finish_export_worker(exporter, &main_worker, functions);
 			}
+		}
+	}
 
-			log_newline();
+	log_newline();
+
+	int num_finished_jobs = 0;
+	while(num_ready_workers > 0 && num_finished_jobs < num_jobs)
+	{
+		// Start the next jobs in order, skipping the ones whose drive is already being read by the maximum number of workers.
+		for(int i = 0; i < num_jobs; ++i)
+		{
+			if(was_job_started[i]) continue;
+
+			Export_Worker* idle_worker = NULL;
+			for(int j = 0; j < num_ready_workers; ++j)
+			{
+				if(workers[j].thread_handle == NULL)
+				{
+					idle_worker = &workers[j];
+					break;
+				}
+			}
+
+			if(idle_worker == NULL) break;
+
+			TCHAR drive_root_path[MAX_PATH_CHARS] = T("");
+			functions->get_drive_root(exporter, i, drive_root_path);
+
+			int num_workers_on_drive = 0;
+			for(int j = 0; j < num_ready_workers; ++j)
+			{
+				if(workers[j].thread_handle != NULL && strings_are_equal(workers[j].drive_root_path, drive_root_path, true))
+				{
+					++num_workers_on_drive;
+				}
+			}
+
+			if(num_workers_on_drive >= max_jobs_per_drive) continue;
+
+			was_job_started[i] = true;
+
+			idle_worker->job_index = i;
+			idle_worker->export_job = functions->export_job;
+			StringCchCopy(idle_worker->drive_root_path, MAX_PATH_CHARS, drive_root_path);
+
+			if(!functions->prepare_job(exporter, &(idle_worker->exporter), i))
+			{
+				++num_finished_jobs;
+				continue;
+			}
+
+			idle_worker->thread_handle = (HANDLE) _beginthreadex(NULL, 0, export_worker_thread, idle_worker, 0, NULL);
+			if(idle_worker->thread_handle == NULL)
+			{
+				log_error("Export Jobs: Failed to create the thread for the job %d with the error code %lu. This job will be exported by the main thread.", i, GetLastError());
+				functions->export_job(&(idle_worker->exporter));
+				finish_export_worker(exporter, idle_worker, functions);
+				++num_finished_jobs;
+			}
+		}
+
+		HANDLE running_thread_handles[MAX_PARALLEL_EXPORT_JOBS] = {};
+		Export_Worker* running_workers[MAX_PARALLEL_EXPORT_JOBS] = {};
+		DWORD num_running_workers = 0;
+
+		for(int i = 0; i < num_ready_workers; ++i)
+		{
+			if(workers[i].thread_handle != NULL)
+			{
+				running_thread_handles[num_running_workers] = workers[i].thread_handle;
+				running_workers[num_running_workers] = &workers[i];
+				++num_running_workers;
+			}
+		}
+
+		// Every remaining job was skipped or exported by the main thread.
+		if(num_running_workers == 0) continue;
+
+		DWORD wait_result = WaitForMultipleObjects(num_running_workers, running_thread_handles, FALSE, INFINITE);
+		DWORD finished_index = 0;
+
+		if(wait_result < WAIT_OBJECT_0 + num_running_workers)
+		{
+			finished_index = wait_result - WAIT_OBJECT_0;
+		}
+		else
+		{
+			log_error("Export Jobs: Failed to wait for %I32u workers with the error code %lu.", num_running_workers, GetLastError());
+			WaitForSingleObject(running_thread_handles[0], INFINITE);
+		}
+
+		finish_export_worker(exporter, running_workers[finished_index], functions);
+		++num_finished_jobs;
+	}
+
+	destroy_export_workers(workers, num_ready_workers);
+
+	DeleteCriticalSection(&ese_critical_section);
+	destroy_arena(&worker_arena);
+}
+
+// Determines the root of the drive where a profile is located. See: export_jobs_in_parallel().
+static GET_EXPORT_JOB_DRIVE_ROOT(get_profile_drive_root)
+{
+	Profile* profile = &(exporter->external_locations->profiles[job_index]);
+
+	const TCHAR* location_paths[] =
+	{
+		profile->drive_path, profile->windows_path, profile->windows_temporary_path, profile->user_profile_path,
+		profile->appdata_path, profile->local_appdata_path, profile->local_low_appdata_path, profile->wininet_cache_path
+	};
+
+	for(int i = 0; i < _countof(location_paths); ++i)
+	{
+		if(get_drive_root_path(location_paths[i], result_path)) break;
+	}
+}
+
+// Copies a profile's locations to a worker's exporter. See: export_jobs_in_parallel().
+static PREPARE_EXPORT_JOB(prepare_profile_job)
+{
+	External_Locations* external_locations = exporter->external_locations;
+	Profile* profile = &(external_locations->profiles[job_index]);
+
+	worker_exporter->current_profile_name = profile->name;
+	console_print("- [%d of %d] Exporting from the profile '%s'...", job_index+1, external_locations->num_profiles, profile->name);
+
+	return copy_profile_locations(worker_exporter, profile, job_index);
+}
+
+// Exports every cache type from a profile. See: export_jobs_in_parallel().
+static EXPORT_JOB(export_profile_job)
+{
+	export_all_cache_locations(worker_exporter);
+}
+
+// Reports that a profile was exported. See: export_jobs_in_parallel().
+static FINISH_EXPORT_JOB(finish_profile_job)
+{
+	console_print("- Finished exporting from the profile '%s'.", worker_exporter->current_profile_name);
+	log_info("All Locations: Finished exporting from the profile '%s' (%I32u).", worker_exporter->current_profile_name, job_index);
+}
+
+// Exports multiple profiles in the external locations file at the same time. The number of profiles that are exported from the
+// same drive at once is limited by the -parallel-profiles option.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how every cache type should be exported.
+//
+// @Returns: Nothing.
+static void export_profiles_in_parallel(Exporter* exporter)
+{
+	Export_Job_Functions functions = {};
+	functions.get_drive_root = get_profile_drive_root;
+	functions.prepare_job = prepare_profile_job;
+	functions.export_job = export_profile_job;
+	functions.finish_job = finish_profile_job;
+
+	export_jobs_in_parallel(exporter, exporter->external_locations->num_profiles, exporter->max_parallel_profiles_per_drive, &functions);
+}
+
+// Entry point for a cache exporter that handles every supported cache type. This function exports from a given number of locations if
+// the external locations file was previously loaded. Otherwise, it exports from each cache type's default location.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how every cache type should be exported.
+//
+// @Returns: Nothing.
+static void export_all_default_or_specific_cache_locations(Exporter* exporter)
+{
+	if(exporter->load_external_locations)
+	{
+		External_Locations* external_locations = exporter->external_locations;
+		_ASSERT(external_locations != NULL);
+
+		console_print("Exporting the cache from the default locations in %d profiles...", external_locations->num_profiles);
+		log_info("All Locations: Exporting the cache from the default locations in %d profiles.", external_locations->num_profiles);
+		log_newline();
+
+		if(exporter->export_profiles_in_parallel)
+		{
+			export_profiles_in_parallel(exporter);
+		}
+		else
+		{
+			export_profiles_sequentially(exporter);
 		}
 	}
 	else
@@ -2571,6 +3833,2457 @@ static void export_all_default_or_specific_cache_locations(Exporter* exporter)
 	}
 }
 
+// Exports the cache using the type and locations specified in the command line arguments.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains information on how the cache should be exported.
+//
+// @Returns: Nothing.
+static void export_command_line_cache_type(Exporter* exporter)
+{
+	switch(exporter->command_line_cache_type)
+	{
+		case(CACHE_INTERNET_EXPLORER):
+		{
+			export_default_or_specific_internet_explorer_cache(exporter);
+		} break;
+
+		case(CACHE_MOZILLA):
+		{
+			export_default_or_specific_mozilla_cache(exporter);
+		} break;
+
+		case(CACHE_FLASH):
+		{
+			export_default_or_specific_flash_cache(exporter);
+		} break;
+
+		case(CACHE_SHOCKWAVE):
+		{
+			export_default_or_specific_shockwave_cache(exporter);
+		} break;
+
+		case(CACHE_JAVA):
+		{
+			export_default_or_specific_java_cache(exporter);
+		} break;
+
+		case(CACHE_UNITY):
+		{
+			export_default_or_specific_unity_cache(exporter);
+		} break;
+
+		case(CACHE_ALL):
+		{
+			_ASSERT(exporter->is_exporting_from_default_locations);
+			_ASSERT(string_is_empty(exporter->cache_path));
+
+			export_all_default_or_specific_cache_locations(exporter);
+
+		} break;
+
+		case(CACHE_EXPLORE):
+		{
+			_ASSERT(!exporter->is_exporting_from_default_locations);
+			_ASSERT(!string_is_empty(exporter->cache_path));
+
+			export_explored_files(exporter);
+		} break;
+
+		default:
+		{
+			log_error("Export Command Line Cache Type: Attempted to export the cache from '%s' using the unhandled cache type %d.", exporter->cache_path, exporter->command_line_cache_type);
+			_ASSERT(false);
+		} break;
+	}
+
+}
+
+/*
+	The following defines the necessary functions used to load and export the batch manifest file. Batch manifest files are text
+	files that define zero or more jobs, each one specifying a cache type to export and, optionally, its cache and output paths.
+	This allows you to export thousands of cache locations in a single process, avoiding the startup work (e.g. loading the group
+	files) that would otherwise be repeated for each location.
+
+	For example:
+
+	; Comments start with a semicolon.
+	BEGIN_JOB Computer A
+		TYPE IE
+		CACHE C:\Old Drives\Computer A\Users\Name\AppData\Local\Microsoft\Windows\INetCache
+		OUTPUT C:\Exported\Computer A
+	END
+
+	BEGIN_JOB Local Flash
+		TYPE FL
+	END
+
+	The TYPE keyword uses the same short names as the -ignore-filter-for option (IE, MZ, FL, SW, JV, UN, or EXPLORE). If the cache
+	path is omitted or "<None>", the cache is exported from its default location. The EXPLORE type requires a cache path. If the
+	output path is omitted, the job is exported to a subdirectory in the -batch-manifest option's output path with the same name as
+	the job.
+*/
+
+// Various keywords for the batch manifest file syntax. The comment and delimiter characters are the same as the ones used by the
+// external locations file.
+static const char* BEGIN_JOB = "BEGIN_JOB";
+static const char* END_JOB = "END";
+static const char* JOB_TYPE = "TYPE";
+static const char* JOB_CACHE = "CACHE";
+static const char* JOB_OUTPUT = "OUTPUT";
+
+// The name of the CSV file that summarizes every batch job. This file is created in the -batch-manifest option's output path.
+static const TCHAR* BATCH_SUMMARY_CSV_FILE_NAME = T("Batch_Summary.csv");
+
+static Csv_Type BATCH_SUMMARY_CSV_COLUMN_TYPES[] =
+{
+	CSV_JOB_NAME, CSV_CACHE_TYPE, CSV_CACHE_PATH, CSV_OUTPUT_PATH, CSV_JOB_STATUS, CSV_ELAPSED_TIME,
+	CSV_CSV_FILES_CREATED, CSV_PROCESSED_FILES, CSV_COPIED_FILES
+};
+
+static const int BATCH_SUMMARY_CSV_NUM_COLUMNS = _countof(BATCH_SUMMARY_CSV_COLUMN_TYPES);
+
+// Retrieves the number of jobs and how many bytes are (roughly) required to store them from the batch manifest file.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the path to the batch manifest file.
+// 2. result_num_jobs - The number of jobs found.
+//
+// @Returns: The total size in bytes required to store the jobs found.
+static size_t get_total_batch_manifest_size(Exporter* exporter, int* result_num_jobs)
+{
+	Arena* temporary_arena = &(exporter->temporary_arena);
+	lock_arena(temporary_arena);
+
+	u64 file_size = 0;
+	char* file = (char*) read_entire_file(temporary_arena, exporter->batch_manifest_file_path, &file_size, true);
+
+	size_t total_jobs_size = 0;
+	int num_jobs = 0;
+
+	if(file != NULL)
+	{
+		String_Array<char>* split_lines = split_string(temporary_arena, file, LINE_DELIMITERS);
+		
+		for(int i = 0; i < split_lines->num_strings; ++i)
+		{
+			char* line = split_lines->strings[i];
+			line = skip_leading_whitespace(line);
+
+			if(*line == COMMENT || string_is_empty(line))
+			{
+				// Skip comments and empty lines.
+			}
+			else
+			{
+				// See get_total_external_locations_size().
+				total_jobs_size += string_size(line);
+
+				String_Array<char>* split_tokens = split_string(temporary_arena, line, TOKEN_DELIMITERS, 1);
+				
+				if(split_tokens->num_strings == 2)
+				{
+					char* type = split_tokens->strings[0];
+					char* name = split_tokens->strings[1];
+
+					if(strings_are_equal(type, BEGIN_JOB) && !string_is_empty(name))
+					{
+						++num_jobs;
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		log_error("Get Total Batch Manifest Size: Failed to load the batch manifest file '%s'.", exporter->batch_manifest_file_path);
+	}
+
+	clear_arena(temporary_arena);
+	unlock_arena(temporary_arena);
+
+	*result_num_jobs = num_jobs;
+
+	// Total Size = Size for the Batch_Job array + Size for the string data + Size for the absolute output paths.
+	return 	sizeof(Batch_Manifest) + MAX(num_jobs - 1, 0) * sizeof(Batch_Job)
+			+ total_jobs_size * sizeof(TCHAR) + num_jobs * MAX_PATH_CHARS * sizeof(TCHAR);
+}
+
+// Checks if a batch job specified its cache path. Empty paths and "<None>" mean that the cache is exported from its default location.
+static bool batch_job_has_cache_path(Batch_Job* job)
+{
+	return (job->cache_path != NULL) && !string_is_empty(job->cache_path) && !strings_are_equal(job->cache_path, PATH_NOT_FOUND);
+}
+
+// Determines where a batch job is exported to. This is either the path in the batch manifest file or a subdirectory with the job's
+// name in the -batch-manifest option's output path.
+//
+// @Parameters:
+// 1. exporter - The main Exporter structure.
+// 2. job - The Batch_Job structure.
+// 3. result_path - The buffer that receives the output path. This buffer must be able to hold MAX_PATH_CHARS characters.
+//
+// @Returns: True if the path was determined successfully. Otherwise, false.
+static bool get_batch_job_output_path(Exporter* exporter, Batch_Job* job, TCHAR* result_path)
+{
+	if(job->output_path != NULL && !string_is_empty(job->output_path))
+	{
+		return SUCCEEDED(StringCchCopy(result_path, MAX_PATH_CHARS, job->output_path));
+	}
+	else
+	{
+		return PathCombine(result_path, exporter->output_path, job->name) != NULL;
+	}
+}
+
+// Loads the batch manifest file on disk. This function must be called after get_total_batch_manifest_size() and with a memory arena
+// that is capable of holding the number of bytes it returned.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the path to the batch manifest file, and the permanent memory arena where the
+// job data will be stored. After loading this data, this structure's 'batch_manifest' member will modified.
+// 2. num_jobs - The number of jobs found by an earlier call to get_total_batch_manifest_size().
+//
+// @Returns: Nothing.
+static void load_batch_manifest(Exporter* exporter, int num_jobs)
+{
+	if(num_jobs == 0)
+	{
+		log_warning("Load Batch Manifest: Attempted to load zero jobs. No jobs will be exported.");
+		return;
+	}
+
+	Arena* permanent_arena = &(exporter->permanent_arena);
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	lock_arena(temporary_arena);
+
+	// The number of jobs is always greater than zero here.
+	size_t batch_manifest_size = sizeof(Batch_Manifest) + sizeof(Batch_Job) * (num_jobs - 1);
+	Batch_Manifest* batch_manifest = push_arena(permanent_arena, batch_manifest_size, Batch_Manifest);
+	
+	u64 file_size = 0;
+	char* file = (char*) read_entire_file(temporary_arena, exporter->batch_manifest_file_path, &file_size, true);
+
+	int num_processed_jobs = 0;
+
+	if(file != NULL)
+	{
+		// Keep track of which job we're loading data to.
+		bool seen_begin_job = false;
+		bool is_invalid = false;
+		Batch_Job* job = NULL;
+
+		String_Array<char>* split_lines = split_string(temporary_arena, file, LINE_DELIMITERS);
+		
+		for(int i = 0; i < split_lines->num_strings; ++i)
+		{
+			char* line = split_lines->strings[i];
+			line = skip_leading_whitespace(line);
+
+			if(*line == COMMENT || string_is_empty(line))
+			{
+				// Skip comments and empty lines.
+			}
+			// Begin a new job or skip it if the keyword is incorrect.
+			else if(!seen_begin_job)
+			{
+				seen_begin_job = true;
+				is_invalid = true;
+
+				String_Array<char>* split_tokens = split_string(temporary_arena, line, TOKEN_DELIMITERS, 1);
+
+				if(split_tokens->num_strings == 2)
+				{
+					char* type = split_tokens->strings[0];
+					char* name = split_tokens->strings[1];
+
+					if(strings_are_equal(type, BEGIN_JOB) && !string_is_empty(name))
+					{
+						job = &(batch_manifest->jobs[num_processed_jobs]);
+						++num_processed_jobs;
+
+						is_invalid = false;
+						job->name = convert_utf_8_string_to_tchar(permanent_arena, temporary_arena, name);
+						job->cache_type = CACHE_UNKNOWN;
+						job->cache_path = NULL;
+						job->output_path = NULL;
+						job->full_output_path = NULL;
+						job->has_duplicate_output = false;
+						job->status = T("Not Exported");
+						log_info("Load Batch Manifest: Loading the job '%s'.", job->name);
+					}
+					else
+					{
+						log_error("Load Batch Manifest: Skipping invalid job of type '%hs' and name '%hs'.", type, name);
+					}
+				}
+				else
+				{
+					log_error("Load Batch Manifest: Found %d tokens while looking for a new job when two were expected.", split_tokens->num_strings);
+				}
+			}
+			// While processing the current job.
+			else if(seen_begin_job)
+			{
+				// End the current job (regardless if it was valid or not).
+				if(strings_are_equal(line, END_JOB))
+				{
+					seen_begin_job = false;
+					is_invalid = false;
+				}
+				// Skip invalid jobs (unknown keyword or missing a name).
+				else if(is_invalid)
+				{
+					// Do nothing until we reach the END keyword.
+				}
+				// Load the values in the current job.
+				else
+				{
+					String_Array<char>* split_tokens = split_string(temporary_arena, line, TOKEN_DELIMITERS, 1);
+
+					if(split_tokens->num_strings == 2)
+					{
+						char* key = split_tokens->strings[0];
+						char* value = split_tokens->strings[1];
+
+						if(strings_are_equal(key, JOB_TYPE))
+						{
+							TCHAR* type_name = convert_utf_8_string_to_tchar(temporary_arena, value);
+							Cache_Type type = (type_name != NULL) ? (get_cache_type_from_short_name(type_name)) : (CACHE_UNKNOWN);
+
+							// Each job exports a single cache type.
+							if(type == CACHE_ALL) type = CACHE_UNKNOWN;
+							job->cache_type = type;
+
+							if(type == CACHE_UNKNOWN)
+							{
+								log_error("Load Batch Manifest: Unknown cache type '%hs' in the job '%s'.", value, job->name);
+							}
+						}
+						else if(strings_are_equal(key, JOB_CACHE))
+						{
+							job->cache_path = convert_utf_8_string_to_tchar(permanent_arena, temporary_arena, value);
+						}
+						else if(strings_are_equal(key, JOB_OUTPUT))
+						{
+							job->output_path = convert_utf_8_string_to_tchar(permanent_arena, temporary_arena, value);
+						}
+						else
+						{
+							log_error("Load Batch Manifest: Unknown keyword '%hs' in the job '%s'.", key, job->name);
+						}
+					}
+					else
+					{
+						log_error("Load Batch Manifest: Found %d tokens while loading the job '%s' when two were expected.", split_tokens->num_strings, job->name);
+					}
+				}
+			}
+			else
+			{
+				_ASSERT(false);
+			}
+		}
+
+		if(seen_begin_job)
+		{
+			log_warning("Load Batch Manifest: Found unterminated job.");
+		}
+	}
+	else
+	{
+		log_error("Load Batch Manifest: Failed to load the batch manifest file '%s'.", exporter->batch_manifest_file_path);
+	}
+
+	clear_arena(temporary_arena);
+	unlock_arena(temporary_arena);
+
+	batch_manifest->num_jobs = num_processed_jobs;
+	if(num_processed_jobs != num_jobs)
+	{
+		log_error("Load Batch Manifest: Loaded %d jobs when %d were expected.", num_processed_jobs, num_jobs);
+	}
+
+	exporter->batch_manifest = batch_manifest;
+
+	// Jobs that are exported at the same time would write to the same CSV file if they used the same output path and cache type.
+	// Only the first one is kept.
+	for(int i = 0; i < num_processed_jobs; ++i)
+	{
+		Batch_Job* job = &(batch_manifest->jobs[i]);
+
+		TCHAR full_output_path[MAX_PATH_CHARS] = T("");
+		if(get_batch_job_output_path(exporter, job, full_output_path) && get_full_path_name(full_output_path))
+		{
+			job->full_output_path = push_string_to_arena(permanent_arena, full_output_path);
+		}
+
+		if(job->full_output_path == NULL || job->cache_type == CACHE_UNKNOWN) continue;
+
+		for(int j = 0; j < i; ++j)
+		{
+			Batch_Job* previous_job = &(batch_manifest->jobs[j]);
+
+			if(		!previous_job->has_duplicate_output && previous_job->cache_type == job->cache_type
+				&& 	previous_job->full_output_path != NULL && strings_are_equal(previous_job->full_output_path, job->full_output_path, true))
+			{
+				job->has_duplicate_output = true;
+				log_error("Load Batch Manifest: The job '%s' uses the same output path and cache type as the job '%s' and will be skipped.", job->name, previous_job->name);
+				break;
+			}
+		}
+	}
+}
+
+// Determines the root of the drive that a batch job reads from. Jobs that use the default locations read from the system drive.
+// See: export_jobs_in_parallel().
+static GET_EXPORT_JOB_DRIVE_ROOT(get_batch_job_drive_root)
+{
+	Batch_Job* job = &(exporter->batch_manifest->jobs[job_index]);
+	const TCHAR* path = (batch_job_has_cache_path(job)) ? (job->cache_path) : (exporter->drive_path);
+	get_drive_root_path(path, result_path);
+}
+
+// Copies a batch job's cache type and paths to a worker's exporter. If the job is invalid, its status is set to the reason why it
+// was skipped.
+//
+// @Parameters:
+// 1. exporter - The main Exporter structure which contains the batch manifest.
+// 2. worker_exporter - The Exporter structure that receives the job's cache type and paths.
+// 3. job_index - The job's index in the batch manifest.
+//
+// @Returns: True if the job can be exported. Otherwise, false and this job should be skipped.
+static bool copy_batch_job_to_exporter(Exporter* exporter, Exporter* worker_exporter, int job_index)
+{
+	Batch_Job* job = &(exporter->batch_manifest->jobs[job_index]);
+
+	bool has_cache_path = batch_job_has_cache_path(job);
+
+	if(job->cache_type == CACHE_UNKNOWN)
+	{
+		job->status = T("Invalid Cache Type");
+	}
+	else if(job->has_duplicate_output)
+	{
+		job->status = T("Duplicate Output Path");
+	}
+	else if((job->cache_type == CACHE_EXPLORE && !has_cache_path) || (has_cache_path && !does_directory_exist(job->cache_path)))
+	{
+		job->status = T("Missing Cache Path");
+	}
+	else if(	(has_cache_path && FAILED(StringCchCopy(worker_exporter->cache_path, MAX_PATH_CHARS, job->cache_path)))
+			|| 	!get_batch_job_output_path(exporter, job, worker_exporter->output_path))
+	{
+		job->status = T("Path Too Long");
+	}
+	else
+	{
+		job->status = NULL;
+	}
+
+	if(job->status != NULL)
+	{
+		console_print("This job will be skipped: %s.", job->status);
+		log_warning("Batch Manifest: The job '%s' (%d) will be skipped: %s.", job->name, job_index, job->status);
+		return false;
+	}
+
+	if(!has_cache_path) worker_exporter->cache_path[0] = T('\0');
+
+	worker_exporter->command_line_cache_type = job->cache_type;
+	worker_exporter->is_exporting_from_default_locations = !has_cache_path;
+	worker_exporter->batch_job_start_time = GetTickCount();
+
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_info("Exporting the job '%s' (%d).", job->name, job_index);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_print(LOG_NONE, "- Cache Type: %s", CACHE_TYPE_TO_FULL_NAME[job->cache_type]);
+	log_print(LOG_NONE, "- Cache Path: '%s'", worker_exporter->cache_path);
+	log_print(LOG_NONE, "- Output Path: '%s'", worker_exporter->output_path);
+	log_print(LOG_NONE, "------------------------------------------------------------");
+	log_newline();
+
+	return true;
+}
+
+// Copies a batch job to a worker's exporter. See: export_jobs_in_parallel().
+static PREPARE_EXPORT_JOB(prepare_batch_job)
+{
+	Batch_Manifest* batch_manifest = exporter->batch_manifest;
+	Batch_Job* job = &(batch_manifest->jobs[job_index]);
+
+	console_print("- [%d of %d] Exporting the job '%s'...", job_index+1, batch_manifest->num_jobs, job->name);
+
+	return copy_batch_job_to_exporter(exporter, worker_exporter, job_index);
+}
+
+// Exports a batch job's cache type. See: export_jobs_in_parallel().
+static EXPORT_JOB(export_batch_job)
+{
+	export_command_line_cache_type(worker_exporter);
+}
+
+// Records how long a batch job took and how many files it exported. The job's status reports whether any CSV file couldn't be
+// created or any cached file couldn't be copied, or if nothing was found in the cache locations. See: export_jobs_in_parallel().
+static FINISH_EXPORT_JOB(finish_batch_job)
+{
+	Batch_Job* job = &(exporter->batch_manifest->jobs[job_index]);
+
+	if(worker_exporter->total_export_errors > 0)
+	{
+		job->status = T("Exported With Errors");
+	}
+	else if(worker_exporter->total_csv_files_created == 0 && worker_exporter->total_processed_files == 0)
+	{
+		job->status = T("Nothing Exported");
+	}
+	else
+	{
+		job->status = T("Exported");
+	}
+
+	job->elapsed_time = GetTickCount() - worker_exporter->batch_job_start_time;
+	job->num_csv_files_created = worker_exporter->total_csv_files_created;
+	job->num_processed_files = worker_exporter->total_processed_files;
+	job->num_copied_files = worker_exporter->total_copied_files;
+
+	console_print("- Finished exporting the job '%s' in %.2f seconds: %s.", job->name, job->elapsed_time / 1000.0, job->status);
+	log_info("Batch Manifest: Finished exporting the job '%s' (%d) in %lu milliseconds with the status '%s'. Processed %d files and copied %d.",
+				job->name, job_index, job->elapsed_time, job->status, job->num_processed_files, job->num_copied_files);
+}
+
+// Creates a CSV file in the -batch-manifest option's output path that lists the status of every batch job.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains the batch manifest.
+//
+// @Returns: Nothing.
+static void create_batch_summary_csv(Exporter* exporter)
+{
+	Arena* temporary_arena = &(exporter->temporary_arena);
+	Batch_Manifest* batch_manifest = exporter->batch_manifest;
+
+	TCHAR csv_path[MAX_PATH_CHARS] = T("");
+	StringCchCopy(csv_path, MAX_PATH_CHARS, exporter->output_path);
+	get_full_path_name(csv_path);
+
+	HANDLE csv_file_handle = INVALID_HANDLE_VALUE;
+	if(!PathAppend(csv_path, BATCH_SUMMARY_CSV_FILE_NAME) || !create_csv_file(csv_path, &csv_file_handle))
+	{
+		log_error("Batch Manifest: Failed to create the summary CSV file '%s'.", csv_path);
+		return;
+	}
+
+	++(exporter->total_csv_files_created);
+	csv_print_header(temporary_arena, csv_file_handle, BATCH_SUMMARY_CSV_COLUMN_TYPES, BATCH_SUMMARY_CSV_NUM_COLUMNS);
+	clear_arena(temporary_arena);
+
+	for(int i = 0; i < batch_manifest->num_jobs; ++i)
+	{
+		Batch_Job* job = &(batch_manifest->jobs[i]);
+
+		TCHAR* cache_type = (job->cache_type != CACHE_UNKNOWN) ? ((TCHAR*) CACHE_TYPE_TO_FULL_NAME[job->cache_type]) : (NULL);
+		TCHAR* cache_path = (batch_job_has_cache_path(job)) ? (job->cache_path) : (T("<Default>"));
+
+		TCHAR* output_path = job->full_output_path;
+
+		TCHAR elapsed_time[MAX_INT_32_CHARS + 4] = T("");
+		StringCchPrintf(elapsed_time, _countof(elapsed_time), T("%.3f"), job->elapsed_time / 1000.0);
+
+		TCHAR num_csv_files_created[MAX_INT_32_CHARS] = T("");
+		convert_s32_to_string(job->num_csv_files_created, num_csv_files_created);
+
+		TCHAR num_processed_files[MAX_INT_32_CHARS] = T("");
+		convert_s32_to_string(job->num_processed_files, num_processed_files);
+
+		TCHAR num_copied_files[MAX_INT_32_CHARS] = T("");
+		convert_s32_to_string(job->num_copied_files, num_copied_files);
+
+		Csv_Entry csv_row[] =
+		{
+			{job->name}, {cache_type}, {cache_path}, {output_path}, {(TCHAR*) job->status}, {elapsed_time},
+			{num_csv_files_created}, {num_processed_files}, {num_copied_files}
+		};
+		_STATIC_ASSERT(_countof(csv_row) == BATCH_SUMMARY_CSV_NUM_COLUMNS);
+
+		csv_print_row(temporary_arena, csv_file_handle, csv_row, BATCH_SUMMARY_CSV_NUM_COLUMNS);
+		clear_arena(temporary_arena);
+	}
+
+	safe_close_handle(&csv_file_handle);
+	log_info("Batch Manifest: Created the summary CSV file '%s'.", csv_path);
+}
+
+// Exports every job in the batch manifest file. Jobs are exported at the same time using the same workers as the -parallel-profiles
+// option, and the number of jobs that read from the same drive at once is limited by the -batch-manifest option's third argument.
+// A summary CSV file is created after every job finishes.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains the batch manifest and information on how every job should be exported.
+//
+// @Returns: Nothing.
+static void export_batch_manifest_jobs(Exporter* exporter)
+{
+	Batch_Manifest* batch_manifest = exporter->batch_manifest;
+	if(batch_manifest == NULL || batch_manifest->num_jobs == 0)
+	{
+		console_print("The batch manifest file doesn't contain any valid jobs.");
+		log_warning("Batch Manifest: No jobs were loaded from '%s'.", exporter->batch_manifest_file_path);
+		return;
+	}
+
+	if(exporter->overwrite_previous_output)
+	{
+		// The default output paths are inside the main output directory, which was already deleted.
+		for(int i = 0; i < batch_manifest->num_jobs; ++i)
+		{
+			Batch_Job* job = &(batch_manifest->jobs[i]);
+			if(job->output_path == NULL || string_is_empty(job->output_path)) continue;
+
+			bool was_deleted = false;
+			for(int j = 0; j < i; ++j)
+			{
+				TCHAR* previous_output_path = batch_manifest->jobs[j].output_path;
+				if(previous_output_path != NULL && strings_are_equal(previous_output_path, job->output_path, true))
+				{
+					was_deleted = true;
+					break;
+				}
+			}
+
+			if(!was_deleted && delete_directory_and_contents(job->output_path))
+			{
+				log_info("Batch Manifest: Deleted the previous output directory '%s' of the job '%s'.", job->output_path, job->name);
+			}
+		}
+	}
+
+	console_print("Exporting %d jobs from the batch manifest file...", batch_manifest->num_jobs);
+	log_info("Batch Manifest: Exporting %d jobs from '%s'.", batch_manifest->num_jobs, exporter->batch_manifest_file_path);
+	log_newline();
+
+	Export_Job_Functions functions = {};
+	functions.get_drive_root = get_batch_job_drive_root;
+	functions.prepare_job = prepare_batch_job;
+	functions.export_job = export_batch_job;
+	functions.finish_job = finish_batch_job;
+
+	DWORD start_time = GetTickCount();
+	export_jobs_in_parallel(exporter, batch_manifest->num_jobs, exporter->max_parallel_batch_jobs_per_drive, &functions);
+	DWORD elapsed_time = GetTickCount() - start_time;
+
+	int num_exported_jobs = 0;
+	for(int i = 0; i < batch_manifest->num_jobs; ++i)
+	{
+		if(strings_are_equal(batch_manifest->jobs[i].status, T("Exported"))) ++num_exported_jobs;
+	}
+
+	if(exporter->create_csvs) create_batch_summary_csv(exporter);
+
+	console_print("Exported %d of %d jobs in %.2f seconds.", num_exported_jobs, batch_manifest->num_jobs, elapsed_time / 1000.0);
+	log_info("Batch Manifest: Exported %d of %d jobs in %lu milliseconds.", num_exported_jobs, batch_manifest->num_jobs, elapsed_time);
+}
+
+#ifndef WCE_9X
+
+/*
+	The following defines the export service, which receives batch jobs from a local named pipe until it's told to stop. This avoids
+	repeating the startup work for each job when the caches are submitted as they become available. The service uses the same
+	workers as the -batch-manifest option, and the group files and ESE functions are only loaded once.
+
+	Clients connect to "\\.\pipe\<Pipe Name>" and send UTF-8 lines that use the same syntax as the batch manifest file, with one
+	extra job keyword and two extra commands:
+
+	BEGIN_JOB <Job Name>
+		TYPE <IE, MZ, FL, SW, JV, UN, or EXPLORE>
+		CACHE <Optional Cache Path>
+		OUTPUT <Optional Output Path>
+		PRIORITY <Optional Priority>
+	END
+	CANCEL <Job Name>
+	SHUTDOWN
+
+	Jobs with a higher priority are started first (the default is zero), and jobs with the same priority are started in the order
+	they were received. Cancelling a queued job removes it from the queue, while a running job skips its remaining cache entries
+	and finishes with the "Cancelled" status. The SHUTDOWN command stops receiving jobs and waits for the current ones to finish.
+
+	The service replies with UTF-8 lines whose fields are separated by tabs:
+
+	READY
+	QUEUED		<Job Name>
+	STARTED		<Job Name>
+	PROGRESS	<Job Name>	<Processed Files>	<Copied Files>
+	FINISHED	<Job Name>	<Status>	<Elapsed Milliseconds>	<Processed Files>	<Copied Files>
+	CANCELLED	<Job Name>
+	ERROR		<Message>
+	STOPPING
+	STOPPED
+
+	Only one client may be connected at a time. Every job event is sent to the client that is currently connected. The pipe rejects
+	remote clients and any local ones run by a different user. See: create_export_service_pipe().
+*/
+
+// Various keywords for the export service. The remaining ones are the same as the batch manifest file.
+static const char* SERVICE_JOB_PRIORITY = "PRIORITY";
+static const char* SERVICE_CANCEL = "CANCEL";
+static const char* SERVICE_SHUTDOWN = "SHUTDOWN";
+
+// The maximum number of jobs that can be queued or running at the same time.
+static const int MAX_SERVICE_JOBS = 512;
+// The maximum size of a line received from a client, including the newline character.
+static const size_t MAX_SERVICE_LINE_SIZE = 4096;
+// The maximum number of characters in an event sent to a client, including the newline character.
+static const size_t MAX_SERVICE_EVENT_CHARS = 1024;
+// How often the progress of each running job is sent to the client.
+static const DWORD SERVICE_PROGRESS_INTERVAL_IN_MILLISECONDS = 1000;
+// How long to wait for the client to read an event before discarding it.
+static const DWORD SERVICE_WRITE_TIMEOUT_IN_MILLISECONDS = 5000;
+
+// These flags may not be defined for the Windows version we're targeting. FILE_FLAG_FIRST_PIPE_INSTANCE is supported starting in
+// Windows 2000 SP2 and PIPE_REJECT_REMOTE_CLIENTS starting in Windows Vista. See: create_export_service_pipe().
+#ifndef FILE_FLAG_FIRST_PIPE_INSTANCE
+	#define FILE_FLAG_FIRST_PIPE_INSTANCE 0x00080000
+#endif
+
+#ifndef PIPE_REJECT_REMOTE_CLIENTS
+	#define PIPE_REJECT_REMOTE_CLIENTS 0x00000008
+#endif
+
+enum Service_Job_State
+{
+	SERVICE_JOB_FREE = 0,
+	SERVICE_JOB_QUEUED = 1,
+	SERVICE_JOB_RUNNING = 2,
+};
+
+// A job received by the export service. Each job is stored in a slot whose strings are used by the Batch_Job with the same index
+// in the exporter's batch manifest. This allows the service to reuse the -batch-manifest option's functions.
+struct Service_Job
+{
+	Service_Job_State state;
+	Cache_Type cache_type;
+	int priority;
+	u32 sequence_number;
+
+	// Set to one when a running job is cancelled. See: Exporter::job_cancel_flag.
+	volatile LONG cancel_flag;
+
+	// The last values sent in a PROGRESS event.
+	int last_num_processed_files;
+	int last_num_copied_files;
+
+	TCHAR name[MAX_PATH_CHARS];
+	TCHAR cache_path[MAX_PATH_CHARS];
+	TCHAR output_path[MAX_PATH_CHARS];
+	TCHAR full_output_path[MAX_PATH_CHARS];
+	TCHAR drive_root_path[MAX_PATH_CHARS];
+};
+
+struct Export_Service
+{
+	Exporter* exporter;
+	Service_Job* jobs;
+
+	HANDLE pipe_handle;
+
+	// Used by both threads to send one event at a time.
+	CRITICAL_SECTION write_critical_section;
+	HANDLE write_event;
+
+	// Signaled by the pipe thread when a job is queued or when the service should stop.
+	HANDLE wake_event;
+
+	// Protects the job slots and the following members.
+	CRITICAL_SECTION job_critical_section;
+	u32 next_sequence_number;
+	bool is_stopping;
+
+	// The job that is currently being received by the pipe thread and the memory used to parse each line.
+	bool is_receiving_job;
+	bool is_received_job_invalid;
+	Service_Job received_job;
+	Arena pipe_arena;
+};
+
+// Sends an event to the client that is currently connected to the export service. This function may be called from any thread.
+// Nothing is sent if no client is connected.
+//
+// @Parameters:
+// 1. service - The Export_Service structure.
+// 2. format - The format string for the event. A newline character is added to the end.
+// 3. ... - Zero or more arguments to be inserted in the format string.
+//
+// @Returns: Nothing.
+static void send_export_service_event(Export_Service* service, const TCHAR* format, ...)
+{
+	TCHAR event[MAX_SERVICE_EVENT_CHARS] = T("");
+
+	va_list arguments;
+	va_start(arguments, format);
+	StringCchVPrintf(event, MAX_SERVICE_EVENT_CHARS - 1, format, arguments);
+	va_end(arguments);
+
+	StringCchCat(event, MAX_SERVICE_EVENT_CHARS, T("\n"));
+
+	// Each UTF-16 code unit takes at most three bytes in UTF-8.
+	char utf_8_event[MAX_SERVICE_EVENT_CHARS * 3] = "";
+	int utf_8_event_size = WideCharToMultiByte(CP_UTF8, 0, event, -1, utf_8_event, (int) sizeof(utf_8_event), NULL, NULL);
+	if(utf_8_event_size <= 1) return;
+
+	EnterCriticalSection(&(service->write_critical_section));
+	{
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = service->write_event;
+
+		DWORD num_bytes_written = 0;
+		if(!WriteFile(service->pipe_handle, utf_8_event, (DWORD) (utf_8_event_size - 1), NULL, &overlapped) && GetLastError() == ERROR_IO_PENDING)
+		{
+			// Don't let a client that stopped reading block the service.
+			if(WaitForSingleObject(service->write_event, SERVICE_WRITE_TIMEOUT_IN_MILLISECONDS) != WAIT_OBJECT_0)
+			{
+				CancelIo(service->pipe_handle);
+				log_warning("Export Service: Discarded an event since the client took too long to read it.");
+			}
+
+			GetOverlappedResult(service->pipe_handle, &overlapped, &num_bytes_written, TRUE);
+		}
+	}
+	LeaveCriticalSection(&(service->write_critical_section));
+}
+
+// Adds the job that was received by the pipe thread to the export service's queue.
+//
+// @Parameters:
+// 1. service - The Export_Service structure.
+//
+// @Returns: Nothing.
+static void queue_export_service_job(Export_Service* service)
+{
+	Service_Job* received_job = &(service->received_job);
+
+	if(received_job->cache_type == CACHE_UNKNOWN)
+	{
+		send_export_service_event(service, T("ERROR\tThe job '%s' is missing its cache type."), received_job->name);
+		return;
+	}
+
+	// See: load_batch_manifest().
+	Batch_Job output_job = {};
+	output_job.name = received_job->name;
+	output_job.output_path = received_job->output_path;
+	if(!get_batch_job_output_path(service->exporter, &output_job, received_job->full_output_path) || !get_full_path_name(received_job->full_output_path))
+	{
+		received_job->full_output_path[0] = T('\0');
+	}
+
+	const TCHAR* error_message = NULL;
+	int job_index = -1;
+
+	EnterCriticalSection(&(service->job_critical_section));
+	{
+		for(int i = 0; i < MAX_SERVICE_JOBS; ++i)
+		{
+			Service_Job* job = &(service->jobs[i]);
+
+			if(job->state == SERVICE_JOB_FREE)
+			{
+				if(job_index == -1) job_index = i;
+			}
+			else if(strings_are_equal(job->name, received_job->name))
+			{
+				error_message = T("A job with the same name is already queued or running");
+				break;
+			}
+			else if(	job->cache_type == received_job->cache_type && !string_is_empty(job->full_output_path)
+					&& 	strings_are_equal(job->full_output_path, received_job->full_output_path, true))
+			{
+				error_message = T("A job with the same output path and cache type is already queued or running");
+				break;
+			}
+		}
+
+		if(service->is_stopping)
+		{
+			error_message = T("The service is stopping");
+		}
+		else if(error_message == NULL && job_index == -1)
+		{
+			error_message = T("The job queue is full");
+		}
+
+		if(error_message == NULL)
+		{
+			Service_Job* job = &(service->jobs[job_index]);
+			CopyMemory(job, received_job, sizeof(Service_Job));
+
+			job->state = SERVICE_JOB_QUEUED;
+			job->sequence_number = service->next_sequence_number;
+			job->cancel_flag = 0;
+			job->last_num_processed_files = 0;
+			job->last_num_copied_files = 0;
+			++(service->next_sequence_number);
+
+			// Empty paths use the same defaults as the batch manifest file.
+			Batch_Job* batch_job = &(service->exporter->batch_manifest->jobs[job_index]);
+			batch_job->name = job->name;
+			batch_job->cache_type = job->cache_type;
+			batch_job->cache_path = job->cache_path;
+			batch_job->output_path = job->output_path;
+			batch_job->full_output_path = (string_is_empty(job->full_output_path)) ? (NULL) : (job->full_output_path);
+			batch_job->has_duplicate_output = false;
+			batch_job->status = T("Queued");
+			batch_job->elapsed_time = 0;
+			batch_job->num_csv_files_created = 0;
+			batch_job->num_processed_files = 0;
+			batch_job->num_copied_files = 0;
+
+			get_batch_job_drive_root(service->exporter, job_index, job->drive_root_path);
+		}
+	}
+	LeaveCriticalSection(&(service->job_critical_section));
+
+	if(error_message == NULL)
+	{
+		log_info("Export Service: Queued the job '%s' with the priority %d.", received_job->name, received_job->priority);
+		SetEvent(service->wake_event);
+		send_export_service_event(service, T("QUEUED\t%s"), received_job->name);
+	}
+	else
+	{
+		log_warning("Export Service: Rejected the job '%s': %s.", received_job->name, error_message);
+		send_export_service_event(service, T("ERROR\t%s: '%s'."), error_message, received_job->name);
+	}
+}
+
+// Cancels a queued or running job in the export service.
+//
+// @Parameters:
+// 1. service - The Export_Service structure.
+// 2. name - The name of the job to cancel.
+//
+// @Returns: Nothing.
+static void cancel_export_service_job(Export_Service* service, const TCHAR* name)
+{
+	Service_Job_State state = SERVICE_JOB_FREE;
+
+	EnterCriticalSection(&(service->job_critical_section));
+	{
+		for(int i = 0; i < MAX_SERVICE_JOBS; ++i)
+		{
+			Service_Job* job = &(service->jobs[i]);
+
+			if(job->state != SERVICE_JOB_FREE && strings_are_equal(job->name, name))
+			{
+				state = job->state;
+
+				if(job->state == SERVICE_JOB_QUEUED)
+				{
+					job->state = SERVICE_JOB_FREE;
+					service->exporter->batch_manifest->jobs[i].status = T("Cancelled");
+				}
+				else
+				{
+					// The worker checks this flag before exporting each cache entry.
+					InterlockedExchange(&(job->cancel_flag), 1);
+				}
+
+				break;
+			}
+		}
+	}
+	LeaveCriticalSection(&(service->job_critical_section));
+
+	if(state == SERVICE_JOB_QUEUED)
+	{
+		log_info("Export Service: Cancelled the queued job '%s'.", name);
+		send_export_service_event(service, T("CANCELLED\t%s"), name);
+	}
+	else if(state == SERVICE_JOB_RUNNING)
+	{
+		log_info("Export Service: Cancelling the running job '%s'.", name);
+	}
+	else
+	{
+		send_export_service_event(service, T("ERROR\tThe job '%s' is not queued or running."), name);
+	}
+}
+
+// Handles a line received from the export service's client.
+//
+// @Parameters:
+// 1. service - The Export_Service structure.
+// 2. line - The UTF-8 line without the newline character.
+//
+// @Returns: True if the service should stop receiving lines. Otherwise, false.
+static bool handle_export_service_line(Export_Service* service, char* line)
+{
+	Arena* pipe_arena = &(service->pipe_arena);
+
+	line = skip_leading_whitespace(line);
+	if(*line == COMMENT || string_is_empty(line)) return false;
+
+	String_Array<char>* split_tokens = split_string(pipe_arena, line, TOKEN_DELIMITERS, 1);
+	char* key = split_tokens->strings[0];
+	TCHAR* value = (split_tokens->num_strings == 2) ? (convert_utf_8_string_to_tchar(pipe_arena, split_tokens->strings[1])) : (NULL);
+
+	TCHAR empty_value[] = T("");
+	if(value == NULL) value = empty_value;
+
+	bool should_stop = false;
+	Service_Job* received_job = &(service->received_job);
+
+	if(service->is_receiving_job)
+	{
+		if(strings_are_equal(key, END_JOB))
+		{
+			service->is_receiving_job = false;
+			if(!service->is_received_job_invalid) queue_export_service_job(service);
+		}
+		else if(service->is_received_job_invalid)
+		{
+			// Do nothing until we reach the END keyword.
+		}
+		else if(strings_are_equal(key, JOB_TYPE))
+		{
+			Cache_Type type = get_cache_type_from_short_name(value);
+			if(type == CACHE_ALL) type = CACHE_UNKNOWN;
+			received_job->cache_type = type;
+
+			if(type == CACHE_UNKNOWN)
+			{
+				service->is_received_job_invalid = true;
+				send_export_service_event(service, T("ERROR\tUnknown cache type '%s' in the job '%s'."), value, received_job->name);
+			}
+		}
+		else if(strings_are_equal(key, JOB_CACHE) || strings_are_equal(key, JOB_OUTPUT))
+		{
+			TCHAR* path = (strings_are_equal(key, JOB_CACHE)) ? (received_job->cache_path) : (received_job->output_path);
+
+			if(FAILED(StringCchCopy(path, MAX_PATH_CHARS, value)))
+			{
+				service->is_received_job_invalid = true;
+				send_export_service_event(service, T("ERROR\tThe path '%s' in the job '%s' is too long."), value, received_job->name);
+			}
+		}
+		else if(strings_are_equal(key, SERVICE_JOB_PRIORITY))
+		{
+			received_job->priority = _ttoi(value);
+		}
+		else
+		{
+			service->is_received_job_invalid = true;
+			send_export_service_event(service, T("ERROR\tUnknown keyword in the job '%s'."), received_job->name);
+		}
+	}
+	else if(strings_are_equal(key, BEGIN_JOB))
+	{
+		ZeroMemory(received_job, sizeof(Service_Job));
+		received_job->cache_type = CACHE_UNKNOWN;
+
+		service->is_receiving_job = true;
+		service->is_received_job_invalid = string_is_empty(value) || FAILED(StringCchCopy(received_job->name, MAX_PATH_CHARS, value));
+
+		if(service->is_received_job_invalid)
+		{
+			send_export_service_event(service, T("ERROR\tThe job name is empty or too long."));
+		}
+	}
+	else if(strings_are_equal(key, SERVICE_CANCEL))
+	{
+		cancel_export_service_job(service, value);
+	}
+	else if(strings_are_equal(key, SERVICE_SHUTDOWN))
+	{
+		EnterCriticalSection(&(service->job_critical_section));
+		service->is_stopping = true;
+		LeaveCriticalSection(&(service->job_critical_section));
+
+		SetEvent(service->wake_event);
+		send_export_service_event(service, T("STOPPING"));
+		should_stop = true;
+	}
+	else
+	{
+		send_export_service_event(service, T("ERROR\tUnknown command."));
+	}
+
+	clear_arena(pipe_arena);
+
+	return should_stop;
+}
+
+// The entry point for the thread that receives lines from the export service's clients. Clients are accepted one after the other
+// until one of them sends the SHUTDOWN command.
+//
+// @Parameters:
+// 1. argument - The Export_Service structure.
+//
+// @Returns: Zero.
+static unsigned __stdcall export_service_pipe_thread(void* argument)
+{
+	Export_Service* service = (Export_Service*) argument;
+
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+	char line_buffer[MAX_SERVICE_LINE_SIZE] = "";
+	bool should_stop = (overlapped.hEvent == NULL);
+
+	if(should_stop)
+	{
+		log_error("Export Service: Failed to create the pipe thread's event with the error code %lu.", GetLastError());
+	}
+
+	while(!should_stop)
+	{
+		DWORD num_bytes_transferred = 0;
+
+		// Wait for the next client. A client may have connected between the pipe being created and this call.
+		bool is_connected = ConnectNamedPipe(service->pipe_handle, &overlapped) != FALSE;
+		if(!is_connected)
+		{
+			DWORD error_code = GetLastError();
+			if(error_code == ERROR_IO_PENDING)
+			{
+				is_connected = GetOverlappedResult(service->pipe_handle, &overlapped, &num_bytes_transferred, TRUE) != FALSE;
+			}
+			else
+			{
+				is_connected = (error_code == ERROR_PIPE_CONNECTED);
+			}
+		}
+
+		if(!is_connected)
+		{
+			console_print("Stopping the service since the named pipe can no longer accept clients.");
+			log_error("Export Service: Failed to wait for a client with the error code %lu.", GetLastError());
+
+			EnterCriticalSection(&(service->job_critical_section));
+			service->is_stopping = true;
+			LeaveCriticalSection(&(service->job_critical_section));
+
+			SetEvent(service->wake_event);
+			break;
+		}
+
+		console_print("A client connected to the service.");
+		log_info("Export Service: A client connected to the named pipe.");
+		send_export_service_event(service, T("READY"));
+
+		service->is_receiving_job = false;
+		size_t num_buffered_bytes = 0;
+
+		while(!should_stop)
+		{
+			DWORD num_bytes_to_read = (DWORD) (MAX_SERVICE_LINE_SIZE - 1 - num_buffered_bytes);
+			if(!ReadFile(service->pipe_handle, line_buffer + num_buffered_bytes, num_bytes_to_read, NULL, &overlapped)
+				&& GetLastError() != ERROR_IO_PENDING)
+			{
+				break;
+			}
+
+			// This fails when the client disconnects.
+			if(!GetOverlappedResult(service->pipe_handle, &overlapped, &num_bytes_transferred, TRUE)) break;
+
+			num_buffered_bytes += num_bytes_transferred;
+			line_buffer[num_buffered_bytes] = '\0';
+
+			char* line = line_buffer;
+			char* newline = NULL;
+			while(!should_stop && (newline = strchr(line, '\n')) != NULL)
+			{
+				*newline = '\0';
+				if(newline > line && *(newline - 1) == '\r') *(newline - 1) = '\0';
+
+				should_stop = handle_export_service_line(service, line);
+				line = newline + 1;
+			}
+
+			// Keep any incomplete line for the next read.
+			num_buffered_bytes -= (size_t) (line - line_buffer);
+			MoveMemory(line_buffer, line, num_buffered_bytes);
+
+			if(num_buffered_bytes >= MAX_SERVICE_LINE_SIZE - 1)
+			{
+				send_export_service_event(service, T("ERROR\tThe line is longer than %Iu bytes."), MAX_SERVICE_LINE_SIZE - 1);
+				num_buffered_bytes = 0;
+			}
+		}
+
+		// Keep the last client connected after it stops the service so it receives the remaining events.
+		if(!should_stop)
+		{
+			console_print("The client disconnected from the service.");
+			log_info("Export Service: The client disconnected from the named pipe.");
+
+			EnterCriticalSection(&(service->write_critical_section));
+			DisconnectNamedPipe(service->pipe_handle);
+			LeaveCriticalSection(&(service->write_critical_section));
+		}
+	}
+
+	if(overlapped.hEvent != NULL) CloseHandle(overlapped.hEvent);
+
+	return 0;
+}
+
+// Starts the queued jobs with the highest priority on any idle workers, skipping the ones whose drive is already being read by the
+// maximum number of workers. This function must be called from the main thread without holding the job critical section, which
+// is only entered to choose and free each job so that no events are sent while the pipe thread is waiting for it.
+//
+// @Parameters:
+// 1. service - The Export_Service structure.
+// 2. workers - The array of Export_Worker structures.
+// 3. num_workers - The number of workers.
+// 4. functions - The functions that define how each job is exported.
+//
+// @Returns: Nothing.
+static void start_export_service_jobs(Export_Service* service, Export_Worker* workers, int num_workers, Export_Job_Functions* functions)
+{
+	Exporter* exporter = service->exporter;
+
+	while(true, true)
+	{
+		Export_Worker* idle_worker = NULL;
+		for(int i = 0; i < num_workers; ++i)
+		{
+			if(workers[i].thread_handle == NULL)
+			{
+				idle_worker = &workers[i];
+				break;
+			}
+		}
+
+		if(idle_worker == NULL) break;
+
+		int next_job_index = -1;
+
+		EnterCriticalSection(&(service->job_critical_section));
+		{
+			for(int i = 0; i < MAX_SERVICE_JOBS; ++i)
+			{
+				Service_Job* job = &(service->jobs[i]);
+				if(job->state != SERVICE_JOB_QUEUED) continue;
+
+				if(next_job_index != -1)
+				{
+					Service_Job* next_job = &(service->jobs[next_job_index]);
+					if(job->priority < next_job->priority) continue;
+					if(job->priority == next_job->priority && job->sequence_number > next_job->sequence_number) continue;
+				}
+
+				int num_workers_on_drive = 0;
+				for(int j = 0; j < num_workers; ++j)
+				{
+					if(workers[j].thread_handle != NULL && strings_are_equal(workers[j].drive_root_path, job->drive_root_path, true))
+					{
+						++num_workers_on_drive;
+					}
+				}
+
+				if(num_workers_on_drive < exporter->max_parallel_batch_jobs_per_drive) next_job_index = i;
+			}
+
+			// Running jobs aren't modified by the pipe thread (other than their cancel flag), and their slot can't be reused
+			// until they're freed below or after they finish.
+			if(next_job_index != -1) service->jobs[next_job_index].state = SERVICE_JOB_RUNNING;
+		}
+		LeaveCriticalSection(&(service->job_critical_section));
+
+		if(next_job_index == -1) break;
+
+		Service_Job* job = &(service->jobs[next_job_index]);
+		Batch_Job* batch_job = &(exporter->batch_manifest->jobs[next_job_index]);
+		Exporter* worker_exporter = &(idle_worker->exporter);
+
+		idle_worker->job_index = next_job_index;
+		idle_worker->export_job = functions->export_job;
+		StringCchCopy(idle_worker->drive_root_path, MAX_PATH_CHARS, job->drive_root_path);
+		worker_exporter->job_cancel_flag = &(job->cancel_flag);
+
+		console_print("- Exporting the job '%s'...", job->name);
+
+		bool was_started = copy_batch_job_to_exporter(exporter, worker_exporter, next_job_index);
+
+		if(was_started)
+		{
+			idle_worker->thread_handle = (HANDLE) _beginthreadex(NULL, 0, export_worker_thread, idle_worker, 0, NULL);
+			if(idle_worker->thread_handle == NULL)
+			{
+				log_error("Export Service: Failed to create the thread for the job '%s' with the error code %lu.", job->name, GetLastError());
+				batch_job->status = T("Failed To Start");
+				was_started = false;
+			}
+		}
+
+		if(was_started)
+		{
+			send_export_service_event(service, T("STARTED\t%s"), job->name);
+		}
+		else
+		{
+			worker_exporter->job_cancel_flag = NULL;
+			send_export_service_event(service, T("FINISHED\t%s\t%s\t0\t0\t0"), job->name, batch_job->status);
+
+			EnterCriticalSection(&(service->job_critical_section));
+			job->state = SERVICE_JOB_FREE;
+			LeaveCriticalSection(&(service->job_critical_section));
+		}
+	}
+}
+
+// Creates the export service's named pipe so that it may only be used by the current user on the local computer. Since jobs may
+// read from any cache path and write to any output path, remote clients are rejected in three ways:
+//
+// 1. The pipe's DACL denies access to the NETWORK group and only allows access to the current user.
+// 2. The PIPE_REJECT_REMOTE_CLIENTS flag is used in Windows Vista and later. Older versions fail with ERROR_INVALID_PARAMETER,
+// in which case the pipe is created again without this flag.
+// 3. The FILE_FLAG_FIRST_PIPE_INSTANCE flag makes this function fail if another process already created a pipe with the same
+// name, meaning it can't receive our clients. Only one instance is created, so only one client may be connected at a time.
+//
+// @Parameters:
+// 1. pipe_path - The path to the named pipe (e.g. "\\.\pipe\WCE").
+//
+// @Returns: The pipe's handle if it was created successfully. Otherwise, INVALID_HANDLE_VALUE.
+static HANDLE create_export_service_pipe(const TCHAR* pipe_path)
+{
+	HANDLE pipe_handle = INVALID_HANDLE_VALUE;
+
+	// Large enough for the TOKEN_USER structure and the largest possible SID (SECURITY_MAX_SID_SIZE).
+	DWORD token_user_buffer[64] = {};
+	HANDLE token_handle = NULL;
+	DWORD token_user_size = 0;
+
+	if(!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token_handle)
+	|| !GetTokenInformation(token_handle, TokenUser, token_user_buffer, sizeof(token_user_buffer), &token_user_size))
+	{
+		log_error("Create Export Service Pipe: Failed to get the current user's SID with the error code %lu.", GetLastError());
+		if(token_handle != NULL) CloseHandle(token_handle);
+		return INVALID_HANDLE_VALUE;
+	}
+
+	CloseHandle(token_handle);
+
+	PSID user_sid = ((TOKEN_USER*) token_user_buffer)->User.Sid;
+	PSID network_sid = NULL;
+	SID_IDENTIFIER_AUTHORITY nt_authority = SECURITY_NT_AUTHORITY;
+
+	if(!AllocateAndInitializeSid(&nt_authority, 1, SECURITY_NETWORK_RID, 0, 0, 0, 0, 0, 0, 0, &network_sid))
+	{
+		log_error("Create Export Service Pipe: Failed to create the NETWORK group's SID with the error code %lu.", GetLastError());
+		return INVALID_HANDLE_VALUE;
+	}
+
+	DWORD acl_buffer[256] = {};
+	ACL* acl = (ACL*) acl_buffer;
+	DWORD acl_size = 	sizeof(ACL) + sizeof(ACCESS_DENIED_ACE) + sizeof(ACCESS_ALLOWED_ACE) - 2 * sizeof(DWORD)
+					+ 	GetLengthSid(network_sid) + GetLengthSid(user_sid);
+
+	SECURITY_DESCRIPTOR security_descriptor = {};
+	SECURITY_ATTRIBUTES security_attributes = {};
+	security_attributes.nLength = sizeof(SECURITY_ATTRIBUTES);
+	security_attributes.lpSecurityDescriptor = &security_descriptor;
+	security_attributes.bInheritHandle = FALSE;
+
+	// The deny entry must come first since the entries are checked in order.
+	if(		acl_size <= sizeof(acl_buffer)
+		&&	InitializeAcl(acl, acl_size, ACL_REVISION)
+		&& 	AddAccessDeniedAce(acl, ACL_REVISION, GENERIC_ALL, network_sid)
+		&& 	AddAccessAllowedAce(acl, ACL_REVISION, GENERIC_ALL, user_sid)
+		&& 	InitializeSecurityDescriptor(&security_descriptor, SECURITY_DESCRIPTOR_REVISION)
+		&& 	SetSecurityDescriptorDacl(&security_descriptor, TRUE, acl, FALSE))
+	{
+		DWORD open_mode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE;
+		DWORD pipe_mode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT;
+
+		pipe_handle = CreateNamedPipe(	pipe_path, open_mode, pipe_mode | PIPE_REJECT_REMOTE_CLIENTS,
+										1, (DWORD) MAX_SERVICE_LINE_SIZE, (DWORD) MAX_SERVICE_LINE_SIZE, 0, &security_attributes);
+
+		if(pipe_handle == INVALID_HANDLE_VALUE && GetLastError() == ERROR_INVALID_PARAMETER)
+		{
+			log_warning("Create Export Service Pipe: Creating the named pipe '%s' without the PIPE_REJECT_REMOTE_CLIENTS flag since it's not supported. Remote clients are still denied by the pipe's DACL.", pipe_path);
+			pipe_handle = CreateNamedPipe(	pipe_path, open_mode, pipe_mode,
+											1, (DWORD) MAX_SERVICE_LINE_SIZE, (DWORD) MAX_SERVICE_LINE_SIZE, 0, &security_attributes);
+		}
+
+		if(pipe_handle == INVALID_HANDLE_VALUE)
+		{
+			DWORD error_code = GetLastError();
+			if(error_code == ERROR_ACCESS_DENIED)
+			{
+				log_error("Create Export Service Pipe: Failed to create the named pipe '%s' since another process already created it.", pipe_path);
+			}
+			else
+			{
+				log_error("Create Export Service Pipe: Failed to create the named pipe '%s' with the error code %lu.", pipe_path, error_code);
+			}
+		}
+	}
+	else
+	{
+		log_error("Create Export Service Pipe: Failed to create the security descriptor for the named pipe '%s' with the error code %lu.", pipe_path, GetLastError());
+	}
+
+	FreeSid(network_sid);
+
+	return pipe_handle;
+}
+
+// Runs the export service until a client sends the SHUTDOWN command and every job finishes. See the comment at the beginning of
+// this section for the named pipe's protocol.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure which contains the pipe name and information on how every job should be exported.
+//
+// @Returns: Nothing.
+static void run_export_service(Exporter* exporter)
+{
+	int num_workers = exporter->num_export_service_workers;
+
+	Arena service_arena = {};
+	size_t batch_manifest_size = sizeof(Batch_Manifest) + (MAX_SERVICE_JOBS - 1) * sizeof(Batch_Job);
+	size_t service_arena_size = 	sizeof(Export_Service) + MAX_SERVICE_JOBS * sizeof(Service_Job) + batch_manifest_size
+								+ 	num_workers * sizeof(Export_Worker) + 4 * MAX_SCALAR_ALIGNMENT_SIZE;
+
+	if(!create_arena(&service_arena, service_arena_size))
+	{
+		console_print("Could not allocate enough memory to run the service.");
+		log_error("Export Service: Failed to allocate %Iu bytes for the service.", service_arena_size);
+		return;
+	}
+
+	// The arena's memory is already cleared to zero.
+	Export_Service* service = push_arena(&service_arena, sizeof(Export_Service), Export_Service);
+	service->jobs = push_array_to_arena(&service_arena, MAX_SERVICE_JOBS, Service_Job);
+	Batch_Manifest* batch_manifest = push_arena(&service_arena, batch_manifest_size, Batch_Manifest);
+	Export_Worker* workers = push_array_to_arena(&service_arena, num_workers, Export_Worker);
+
+	batch_manifest->num_jobs = MAX_SERVICE_JOBS;
+	exporter->batch_manifest = batch_manifest;
+	service->exporter = exporter;
+
+	TCHAR pipe_path[MAX_PATH_CHARS] = T("");
+	StringCchPrintf(pipe_path, MAX_PATH_CHARS, T("\\\\.\\pipe\\%s"), exporter->export_service_pipe_name);
+
+	service->pipe_handle = create_export_service_pipe(pipe_path);
+	service->write_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	service->wake_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	bool was_pipe_arena_created = create_arena(&(service->pipe_arena), kilobytes_to_bytes(64));
+
+	if(service->pipe_handle == INVALID_HANDLE_VALUE || service->write_event == NULL || service->wake_event == NULL || !was_pipe_arena_created)
+	{
+		console_print("Could not create the named pipe '%s'.", pipe_path);
+		log_error("Export Service: Failed to create the named pipe '%s' and its events with the error code %lu.", pipe_path, GetLastError());
+	}
+	else
+	{
+		InitializeCriticalSection(&(service->write_critical_section));
+		InitializeCriticalSection(&(service->job_critical_section));
+
+		CRITICAL_SECTION ese_critical_section;
+		InitializeCriticalSection(&ese_critical_section);
+
+		Export_Job_Functions functions = {};
+		functions.get_drive_root = get_batch_job_drive_root;
+		functions.prepare_job = prepare_batch_job;
+		functions.export_job = export_batch_job;
+		functions.finish_job = finish_batch_job;
+
+		int num_ready_workers = create_export_workers(exporter, workers, num_workers, &ese_critical_section);
+		HANDLE pipe_thread_handle = NULL;
+
+		if(num_ready_workers > 0)
+		{
+			pipe_thread_handle = (HANDLE) _beginthreadex(NULL, 0, export_service_pipe_thread, service, 0, NULL);
+		}
+
+		if(pipe_thread_handle != NULL)
+		{
+			console_print("Waiting for jobs on '%s' with %d workers...", pipe_path, num_ready_workers);
+			log_info("Export Service: Waiting for jobs on '%s' with %d workers and at most %d jobs per drive.", pipe_path, num_ready_workers, exporter->max_parallel_batch_jobs_per_drive);
+			log_newline();
+
+			while(true, true)
+			{
+				start_export_service_jobs(service, workers, num_ready_workers, &functions);
+
+				EnterCriticalSection(&(service->job_critical_section));
+
+				bool has_pending_jobs = false;
+				for(int i = 0; i < MAX_SERVICE_JOBS; ++i)
+				{
+					if(service->jobs[i].state != SERVICE_JOB_FREE)
+					{
+						has_pending_jobs = true;
+						break;
+					}
+				}
+
+				bool should_stop = service->is_stopping && !has_pending_jobs;
+
+				LeaveCriticalSection(&(service->job_critical_section));
+
+				if(should_stop) break;
+
+				HANDLE wait_handles[MAX_PARALLEL_EXPORT_JOBS + 1] = {};
+				Export_Worker* running_workers[MAX_PARALLEL_EXPORT_JOBS] = {};
+				DWORD num_running_workers = 0;
+
+				wait_handles[0] = service->wake_event;
+				for(int i = 0; i < num_ready_workers; ++i)
+				{
+					if(workers[i].thread_handle != NULL)
+					{
+						wait_handles[num_running_workers + 1] = workers[i].thread_handle;
+						running_workers[num_running_workers] = &workers[i];
+						++num_running_workers;
+					}
+				}
+
+				DWORD wait_result = WaitForMultipleObjects(num_running_workers + 1, wait_handles, FALSE, SERVICE_PROGRESS_INTERVAL_IN_MILLISECONDS);
+
+				if(wait_result == WAIT_TIMEOUT)
+				{
+					// The worker's counters may be read while they're being incremented, but they're only used to report the progress.
+					for(DWORD i = 0; i < num_running_workers; ++i)
+					{
+						Export_Worker* worker = running_workers[i];
+						Service_Job* job = &(service->jobs[worker->job_index]);
+						int num_processed_files = worker->exporter.total_processed_files;
+						int num_copied_files = worker->exporter.total_copied_files;
+
+						if(num_processed_files != job->last_num_processed_files || num_copied_files != job->last_num_copied_files)
+						{
+							job->last_num_processed_files = num_processed_files;
+							job->last_num_copied_files = num_copied_files;
+							send_export_service_event(service, T("PROGRESS\t%s\t%d\t%d"), job->name, num_processed_files, num_copied_files);
+						}
+					}
+				}
+				else if(WAIT_OBJECT_0 + 1 <= wait_result && wait_result < WAIT_OBJECT_0 + 1 + num_running_workers)
+				{
+					Export_Worker* worker = running_workers[wait_result - WAIT_OBJECT_0 - 1];
+					int job_index = worker->job_index;
+					Service_Job* job = &(service->jobs[job_index]);
+					Batch_Job* batch_job = &(batch_manifest->jobs[job_index]);
+
+					finish_export_worker(exporter, worker, &functions);
+					worker->exporter.job_cancel_flag = NULL;
+					if(job->cancel_flag != 0) batch_job->status = T("Cancelled");
+
+					send_export_service_event(service, T("FINISHED\t%s\t%s\t%lu\t%d\t%d"), job->name, batch_job->status,
+												batch_job->elapsed_time, batch_job->num_processed_files, batch_job->num_copied_files);
+
+					EnterCriticalSection(&(service->job_critical_section));
+					job->state = SERVICE_JOB_FREE;
+					LeaveCriticalSection(&(service->job_critical_section));
+				}
+				else if(wait_result == WAIT_FAILED)
+				{
+					log_error("Export Service: Failed to wait for %I32u workers with the error code %lu.", num_running_workers, GetLastError());
+					Sleep(SERVICE_PROGRESS_INTERVAL_IN_MILLISECONDS);
+				}
+			}
+
+			WaitForSingleObject(pipe_thread_handle, INFINITE);
+			CloseHandle(pipe_thread_handle);
+
+			send_export_service_event(service, T("STOPPED"));
+			FlushFileBuffers(service->pipe_handle);
+			DisconnectNamedPipe(service->pipe_handle);
+
+			console_print("The service was stopped.");
+			log_info("Export Service: The service was stopped.");
+		}
+		else
+		{
+			console_print("Could not start the service's threads.");
+			log_error("Export Service: Failed to create %d workers or the pipe thread with the error code %lu.", num_workers, GetLastError());
+		}
+
+		destroy_export_workers(workers, num_ready_workers);
+
+		DeleteCriticalSection(&ese_critical_section);
+		DeleteCriticalSection(&(service->job_critical_section));
+		DeleteCriticalSection(&(service->write_critical_section));
+	}
+
+	if(service->pipe_handle != INVALID_HANDLE_VALUE && service->pipe_handle != NULL) CloseHandle(service->pipe_handle);
+	if(service->write_event != NULL) CloseHandle(service->write_event);
+	if(service->wake_event != NULL) CloseHandle(service->wake_event);
+
+	destroy_arena(&(service->pipe_arena));
+	exporter->batch_manifest = NULL;
+	destroy_arena(&service_arena);
+}
+
+#endif
+
+/*
+	The following defines the functions used to merge the output of multiple shards. When the -shard option is used, each shard only
+	exports the cache entries that are assigned to it (see is_cache_entry_in_exporter_shard()), and writes its CSV files and cached
+	files to a "Shard_<Index>_of_<Count>" subdirectory in the output path. These shards may be exported by different processes or
+	computers, and then copied to the same directory before being merged with the -merge-shards option.
+
+	The shards are merged in order (i.e. the first shard, then the second one, and so on):
+
+	- The cached files are copied to the same relative path in the merged output. Any naming collisions with the files from previous
+	shards are resolved in the same way as copy_exporter_file_using_url_directory_structure() (e.g. "File.ext" -> "File~1.ext").
+	- The CSV files with the same relative path are concatenated, and the header is only written once. The Location In Output column
+	is updated for any renamed files, and for any full paths (i.e. when the -show-full-paths option was used by the shard).
+
+	Neither the order that the files are found in a shard's directory nor the order that a shard exported its cache entries should
+	change the merged output. Because of this, the cached files in each shard are copied in the order of their relative paths, and
+	the rows in each shard's CSV files are appended in the order of their Location On Cache or Location On Disk column. Rows with
+	the same location are compared byte by byte. If there isn't enough memory to sort a shard's files or rows, they're merged in the
+	order they were found and a warning is logged.
+*/
+
+// The maximum number of columns in a CSV file whose Location In Output column can be updated. Rows with more columns are copied
+// as is.
+static const int MAX_MERGED_CSV_COLUMNS = 64;
+// How many bytes of unchanged rows are kept before writing them to the merged CSV file.
+static const size_t MAX_PENDING_CSV_BYTES = 1024 * 1024;
+
+// A cached file that was renamed when copied to the merged output due to a naming collision with a file from a previous shard.
+struct Shard_Rename
+{
+	// Relative to the shard's directory.
+	TCHAR* old_path;
+	// Relative to the merged output directory.
+	TCHAR* new_path;
+	Shard_Rename* next;
+};
+
+// A CSV file in a shard's directory that is merged after copying every cached file in the same shard.
+struct Shard_Csv_File
+{
+	// Relative to the shard's directory.
+	TCHAR* relative_path;
+	Shard_Csv_File* next;
+};
+
+// A cached file in a shard's directory that is copied after finding every file in the same shard.
+struct Shard_Cached_File
+{
+	// Relative to the shard's directory.
+	TCHAR* relative_path;
+	Shard_Cached_File* next;
+};
+
+// The start and end of a field in a UTF-8 CSV row. See: split_csv_row().
+struct Csv_Field
+{
+	char* begin;
+	char* end;
+};
+
+// A row in a shard's CSV file and the field used to sort it. See: merge_shard_csv_file().
+struct Shard_Csv_Row
+{
+	Csv_Field row;
+	Csv_Field key;
+};
+
+struct Shard_Merge
+{
+	Exporter* exporter;
+
+	// The path to each shard's directory, indexed by the shard index minus one. A path is NULL if its shard is missing.
+	int num_shards;
+	TCHAR* shard_paths[MAX_NUM_SHARDS];
+	bool found_mismatched_shards;
+
+	// The memory arena where the current shard's renamed files and CSV files are stored. This arena is cleared after each shard.
+	Arena shard_arena;
+	bool ran_out_of_shard_memory;
+
+	// The current shard's directory and its name as a path component (e.g. "\Shard_2_of_4\").
+	TCHAR* current_shard_path;
+	TCHAR current_shard_component[MAX_PATH_CHARS];
+
+	Shard_Rename* renames;
+	int num_renames;
+	// The current shard's renamed files sorted by their old paths.
+	Shard_Rename** sorted_renames;
+
+	Shard_Csv_File* csv_files;
+
+	Shard_Cached_File* cached_files;
+	int num_cached_files;
+	bool copied_files_out_of_order;
+
+	int total_renamed_files;
+};
+
+// Called every time a directory is found in the shards directory. Used to find each shard's directory by its name.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True.
+static TRAVERSE_DIRECTORY_CALLBACK(find_shard_directories_callback)
+{
+	Shard_Merge* merge = (Shard_Merge*) callback_info->user_data;
+	Arena* temporary_arena = &(merge->exporter->temporary_arena);
+
+	// The search query only matches names like "Shard_2_of_4", so we just have to make sure that the numbers are valid.
+	TCHAR* name = callback_info->object_name;
+	TCHAR* index_in_name = _tcschr(name, T('_'));
+	TCHAR* count_in_name = _tcsstr(name, T("_of_"));
+
+	int shard_index = (index_in_name != NULL) ? (_ttoi(index_in_name + 1)) : (0);
+	int num_shards = (count_in_name != NULL) ? (_ttoi(count_in_name + 4)) : (0);
+
+	TCHAR expected_name[MAX_PATH_CHARS] = T("");
+	StringCchPrintf(expected_name, MAX_PATH_CHARS, SHARD_DIRECTORY_NAME_FORMAT, shard_index, num_shards);
+
+	if(num_shards <= 0 || num_shards > MAX_NUM_SHARDS || shard_index <= 0 || shard_index > num_shards || !filenames_are_equal(name, expected_name))
+	{
+		log_warning("Find Shard Directories: Skipping the directory '%s' since its name doesn't identify a valid shard.", name);
+	}
+	else if(merge->num_shards != 0 && merge->num_shards != num_shards)
+	{
+		log_error("Find Shard Directories: The directory '%s' belongs to an export with %d shards while a previous one belongs to an export with %d shards.", name, num_shards, merge->num_shards);
+		merge->found_mismatched_shards = true;
+	}
+	else
+	{
+		merge->num_shards = num_shards;
+		merge->shard_paths[shard_index - 1] = push_string_to_arena(temporary_arena, callback_info->object_path);
+	}
+
+	return true;
+}
+
+// Checks if a file in a shard's directory is a CSV file created by the exporter, as opposed to a cached file that was copied.
+// These CSV files are either in the shard's directory (e.g. "IE.csv") or in a profile's subdirectory when using an external
+// locations file (e.g. "Profile\IE.csv"). The cached files are always inside a directory named after their cache type.
+//
+// @Parameters:
+// 1. relative_path - The file's path relative to the shard's directory.
+//
+// @Returns: True if the file is a CSV file created by the exporter. Otherwise, false.
+static bool is_shard_csv_file(const TCHAR* relative_path)
+{
+	if(!filename_ends_with(relative_path, T(".csv"))) return false;
+
+	int num_components = count_path_components(relative_path);
+	if(num_components == 1) return true;
+	if(num_components != 2) return false;
+
+	TCHAR parent_directory_name[MAX_PATH_CHARS] = T("");
+	StringCchCopy(parent_directory_name, MAX_PATH_CHARS, relative_path);
+	PathRemoveFileSpec(parent_directory_name);
+
+	for(int i = 0; i < NUM_CACHE_TYPES; ++i)
+	{
+		if(filenames_are_equal(parent_directory_name, CACHE_TYPE_TO_SHORT_NAME[i])) return false;
+	}
+
+	return true;
+}
+
+// Copies a cached file from the current shard to the same relative path in the merged output, and keeps track of it if it was
+// renamed due to a naming collision with a file from a previous shard.
+//
+// @Parameters:
+// 1. merge - The Shard_Merge structure that contains the current shard's directory.
+// 2. relative_path - The file's path relative to the shard's directory.
+//
+// @Returns: Nothing.
+static void copy_shard_cached_file(Shard_Merge* merge, const TCHAR* relative_path)
+{
+	Exporter* exporter = merge->exporter;
+	Arena* temporary_arena = &(exporter->temporary_arena);
+	Arena* shard_arena = &(merge->shard_arena);
+
+	++(exporter->total_processed_files);
+
+	TCHAR source_path[MAX_PATH_CHARS] = T("");
+	if(PathCombine(source_path, merge->current_shard_path, relative_path) == NULL)
+	{
+		log_error("Copy Shard Cached File: Failed to build the source path for the file '%s'.", relative_path);
+		return;
+	}
+
+	// Copy the file to the same relative directory in the merged output. Since we don't pass a URL, the copy function only
+	// creates this directory and resolves any naming collisions with the files from previous shards.
+	TCHAR relative_directory_path[MAX_PATH_CHARS] = T("");
+	StringCchCopy(relative_directory_path, MAX_PATH_CHARS, relative_path);
+	PathRemoveFileSpec(relative_directory_path);
+
+	PathCombine(exporter->output_copy_path, exporter->output_path, relative_directory_path);
+	exporter->num_output_components = count_path_components(relative_directory_path);
+
+	TCHAR new_relative_path[MAX_PATH_CHARS] = T("");
+	TCHAR copy_error_code[MAX_INT_32_CHARS] = T("");
+	if(copy_exporter_file_using_url_directory_structure(exporter, source_path, 0, READ_UNTIL_END_OF_FILE,
+														NULL, PathFindFileName(relative_path), NULL,
+														new_relative_path, copy_error_code))
+	{
+		++(exporter->total_copied_files);
+
+		if(!filenames_are_equal(relative_path, new_relative_path))
+		{
+			log_info("Copy Shard Cached File: Renamed the file '%s' to '%s' due to a naming collision.", relative_path, new_relative_path);
+			++(merge->total_renamed_files);
+
+			Shard_Rename* rename = push_arena(shard_arena, sizeof(Shard_Rename), Shard_Rename);
+			TCHAR* old_path = (rename != NULL) ? (push_string_to_arena(shard_arena, relative_path)) : (NULL);
+			TCHAR* new_path = (old_path != NULL) ? (push_string_to_arena(shard_arena, new_relative_path)) : (NULL);
+
+			if(new_path != NULL)
+			{
+				rename->old_path = old_path;
+				rename->new_path = new_path;
+				rename->next = merge->renames;
+				merge->renames = rename;
+				++(merge->num_renames);
+			}
+			else if(!merge->ran_out_of_shard_memory)
+			{
+				merge->ran_out_of_shard_memory = true;
+				console_print("Warning: Ran out of memory while merging the cached files. Some renamed files will not be updated in the CSV files.");
+				log_error("Copy Shard Cached File: Ran out of memory while adding the renamed file '%s'. Any remaining renamed files in this shard will not be updated in the CSV files.", relative_path);
+			}
+		}
+	}
+	else
+	{
+		log_error("Copy Shard Cached File: Failed to copy the file '%s' with the error code %s.", source_path, copy_error_code);
+	}
+
+	clear_arena(temporary_arena);
+}
+
+// Called every time a file is found in a shard's directory. Used to find the cached files that are copied to the merged output
+// and the CSV files that are merged after every cached file in the shard is copied.
+//
+// @Parameters: See the TRAVERSE_DIRECTORY_CALLBACK macro.
+//
+// @Returns: True.
+static TRAVERSE_DIRECTORY_CALLBACK(merge_shard_file_callback)
+{
+	Shard_Merge* merge = (Shard_Merge*) callback_info->user_data;
+	Arena* shard_arena = &(merge->shard_arena);
+
+	TCHAR* relative_path = callback_info->object_path + string_length(merge->current_shard_path);
+	while(*relative_path == T('\\')) ++relative_path;
+
+	if(is_shard_csv_file(relative_path))
+	{
+		Shard_Csv_File* csv_file = push_arena(shard_arena, sizeof(Shard_Csv_File), Shard_Csv_File);
+		TCHAR* csv_relative_path = (csv_file != NULL) ? (push_string_to_arena(shard_arena, relative_path)) : (NULL);
+
+		if(csv_relative_path != NULL)
+		{
+			csv_file->relative_path = csv_relative_path;
+			csv_file->next = merge->csv_files;
+			merge->csv_files = csv_file;
+		}
+		else
+		{
+			console_print("Warning: Ran out of memory while merging the CSV files. Some of them will be skipped.");
+			log_error("Merge Shard File: Ran out of memory while adding the CSV file '%s'. This file will not be merged.", callback_info->object_path);
+		}
+	}
+	else
+	{
+		// The cached files are copied after being sorted. See: merge_shard_outputs().
+		Shard_Cached_File* cached_file = push_arena(shard_arena, sizeof(Shard_Cached_File), Shard_Cached_File);
+		TCHAR* cached_relative_path = (cached_file != NULL) ? (push_string_to_arena(shard_arena, relative_path)) : (NULL);
+
+		if(cached_relative_path != NULL)
+		{
+			cached_file->relative_path = cached_relative_path;
+			cached_file->next = merge->cached_files;
+			merge->cached_files = cached_file;
+			++(merge->num_cached_files);
+		}
+		else
+		{
+			if(!merge->copied_files_out_of_order)
+			{
+				merge->copied_files_out_of_order = true;
+				log_warning("Merge Shard File: Ran out of memory while adding the cached file '%s'. The remaining files in this shard will be copied in the order they're found.", callback_info->object_path);
+			}
+
+			copy_shard_cached_file(merge, relative_path);
+		}
+	}
+
+	return true;
+}
+
+// Called by qsort() to sort the cached files in a shard by their relative paths. Paths that only differ in case are compared
+// using their exact characters so that the order never depends on how they were found.
+//
+// @Parameters:
+// 1. file_1 - The first cached file.
+// 2. file_2 - The second cached file.
+//
+// @Returns: A negative integer, zero, or a positive integer if the first path is less than, equal to, or greater than the second one.
+static int compare_shard_cached_files(const void* file_1, const void* file_2)
+{
+	Shard_Cached_File* cached_file_1 = *((Shard_Cached_File**) file_1);
+	Shard_Cached_File* cached_file_2 = *((Shard_Cached_File**) file_2);
+
+	int result = _tcsicmp(cached_file_1->relative_path, cached_file_2->relative_path);
+	if(result == 0) result = _tcscmp(cached_file_1->relative_path, cached_file_2->relative_path);
+	return result;
+}
+
+// Called by qsort() and bsearch() to sort and search the renamed files by their old paths.
+//
+// @Parameters:
+// 1. rename_1 - The first renamed file.
+// 2. rename_2 - The second renamed file.
+//
+// @Returns: A negative integer, zero, or a positive integer if the first old path is less than, equal to, or greater than the second one.
+static int compare_shard_renames(const void* rename_1, const void* rename_2)
+{
+	Shard_Rename* shard_rename_1 = *((Shard_Rename**) rename_1);
+	Shard_Rename* shard_rename_2 = *((Shard_Rename**) rename_2);
+	return _tcsicmp(shard_rename_1->old_path, shard_rename_2->old_path);
+}
+
+// Splits a UTF-8 CSV row into its fields. Quoted fields may contain commas, newlines, and escaped quotation marks.
+//
+// @Parameters:
+// 1. row - The beginning of the row.
+// 2. file_end - The end of the CSV file.
+// 3. fields - The array that receives the start and end of each field. Fields past the array's end are counted but not stored.
+// 4. max_fields - The number of elements in this array.
+// 5. result_num_fields - The number of fields in the row.
+//
+// @Returns: The beginning of the next row, or the end of the file if this was the last row.
+static char* split_csv_row(char* row, char* file_end, Csv_Field* fields, int max_fields, int* result_num_fields)
+{
+	int num_fields = 0;
+	char* current = row;
+
+	while(true, true)
+	{
+		char* field_begin = current;
+		bool is_quoted = false;
+
+		// An escaped quotation mark toggles this flag twice, meaning it doesn't need to be handled separately.
+		while(current < file_end)
+		{
+			char c = *current;
+			if(c == '\"') is_quoted = !is_quoted;
+			else if(!is_quoted && (c == ',' || c == '\r' || c == '\n')) break;
+			++current;
+		}
+
+		if(num_fields < max_fields)
+		{
+			fields[num_fields].begin = field_begin;
+			fields[num_fields].end = current;
+		}
+		++num_fields;
+
+		if(current < file_end && *current == ',')
+		{
+			++current;
+		}
+		else
+		{
+			if(current < file_end && *current == '\r') ++current;
+			if(current < file_end && *current == '\n') ++current;
+			break;
+		}
+	}
+
+	*result_num_fields = num_fields;
+	return current;
+}
+
+// Converts a UTF-8 CSV field into a TCHAR string, removing its quotation marks if it was escaped.
+//
+// @Parameters:
+// 1. arena - The Arena structure where the converted string is stored.
+// 2. field - The field to convert.
+//
+// @Returns: The converted string. This function returns an empty string if the conversion fails.
+static TCHAR* convert_csv_field_to_tchar(Arena* arena, Csv_Field field)
+{
+	char* begin = field.begin;
+	char* end = field.end;
+
+	bool is_quoted = (end - begin >= 2) && (*begin == '\"') && (*(end - 1) == '\"');
+	if(is_quoted)
+	{
+		++begin;
+		--end;
+	}
+
+	char* value = push_array_to_arena(arena, (size_t) (end - begin) + 1, char);
+	if(value == NULL) return T("");
+
+	char* value_end = value;
+	for(char* c = begin; c < end; ++c)
+	{
+		*value_end = *c;
+		++value_end;
+
+		// Skip the second quotation mark in an escaped one.
+		if(is_quoted && *c == '\"' && c + 1 < end && *(c + 1) == '\"') ++c;
+	}
+	*value_end = '\0';
+
+	TCHAR* result = convert_utf_8_string_to_tchar(arena, value);
+	return (result != NULL) ? (result) : (T(""));
+}
+
+// Determines the value of the Location In Output column in the merged CSV file. Relative paths are only changed if the file was
+// renamed, while full paths always point to the merged output directory.
+//
+// @Parameters:
+// 1. merge - The Shard_Merge structure that contains the current shard's renamed files.
+// 2. location_in_output - The column's value in the shard's CSV file.
+//
+// @Returns: The new value, or NULL if the value doesn't need to change.
+static TCHAR* get_merged_location_in_output(Shard_Merge* merge, TCHAR* location_in_output)
+{
+	Exporter* exporter = merge->exporter;
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	if(string_is_empty(location_in_output)) return NULL;
+
+	bool is_full_path = (PathIsRelative(location_in_output) == FALSE);
+	TCHAR* relative_path = location_in_output;
+
+	if(is_full_path)
+	{
+		// The shard may have been exported on a different computer, so we'll look for its name instead of its full path.
+		TCHAR* shard_component = _tcsstr(location_in_output, merge->current_shard_component);
+		if(shard_component == NULL) return NULL;
+		relative_path = shard_component + string_length(merge->current_shard_component);
+	}
+
+	if(merge->num_renames > 0)
+	{
+		Shard_Rename key = {};
+		key.old_path = relative_path;
+		Shard_Rename* key_pointer = &key;
+
+		Shard_Rename** rename = (Shard_Rename**) bsearch(&key_pointer, merge->sorted_renames, merge->num_renames, sizeof(Shard_Rename*), compare_shard_renames);
+		if(rename != NULL)
+		{
+			relative_path = (*rename)->new_path;
+		}
+		else if(!is_full_path)
+		{
+			return NULL;
+		}
+	}
+	else if(!is_full_path)
+	{
+		return NULL;
+	}
+
+	TCHAR* result = push_array_to_arena(temporary_arena, MAX_PATH_CHARS, TCHAR);
+	if(result == NULL) return NULL;
+
+	if(is_full_path)
+	{
+		if(PathCombine(result, exporter->output_path, relative_path) == NULL) return NULL;
+	}
+	else
+	{
+		StringCchCopy(result, MAX_PATH_CHARS, relative_path);
+	}
+
+	return result;
+}
+
+// Compares two fields in a UTF-8 CSV file byte by byte. A field that is a prefix of the other one is sorted first.
+static int compare_csv_fields(Csv_Field field_1, Csv_Field field_2)
+{
+	size_t size_1 = (size_t) (field_1.end - field_1.begin);
+	size_t size_2 = (size_t) (field_2.end - field_2.begin);
+
+	int result = memcmp(field_1.begin, field_2.begin, MIN(size_1, size_2));
+	if(result == 0 && size_1 != size_2) result = (size_1 < size_2) ? (-1) : (1);
+	return result;
+}
+
+// Called by qsort() to sort the rows in a shard's CSV file by their keys. Rows with the same key are sorted by their contents and
+// then by their position in the file.
+//
+// @Parameters:
+// 1. row_1 - The first row.
+// 2. row_2 - The second row.
+//
+// @Returns: A negative integer, zero, or a positive integer if the first row is less than, equal to, or greater than the second one.
+static int compare_shard_csv_rows(const void* row_1, const void* row_2)
+{
+	Shard_Csv_Row* csv_row_1 = (Shard_Csv_Row*) row_1;
+	Shard_Csv_Row* csv_row_2 = (Shard_Csv_Row*) row_2;
+
+	int result = compare_csv_fields(csv_row_1->key, csv_row_2->key);
+	if(result == 0) result = compare_csv_fields(csv_row_1->row, csv_row_2->row);
+	if(result == 0) result = (csv_row_1->row.begin < csv_row_2->row.begin) ? (-1) : ((csv_row_1->row.begin > csv_row_2->row.begin) ? (1) : (0));
+	return result;
+}
+
+// Finds a column in the header of a UTF-8 CSV file.
+//
+// @Parameters:
+// 1. fields - The header's fields.
+// 2. num_fields - The number of fields in this array.
+// 3. type - The column to find.
+//
+// @Returns: The column's index, or -1 if it wasn't found.
+static int find_csv_header_field(Csv_Field* fields, int num_fields, Csv_Type type)
+{
+	const char* column_name = CSV_TYPE_TO_UTF_8_STRING[type];
+	size_t column_name_length = string_length(column_name);
+
+	for(int i = 0; i < num_fields; ++i)
+	{
+		size_t field_length = (size_t) (fields[i].end - fields[i].begin);
+		if(field_length == column_name_length && memory_is_equal(fields[i].begin, column_name, field_length))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// Appends the rows of a CSV file in the current shard to the CSV file with the same relative path in the merged output. The header
+// is only written if the merged CSV file is empty. The rows are appended in the order of their Location On Cache or Location On Disk
+// column, or in the order of their contents if neither column exists. Rows whose Location In Output column changed are rewritten,
+// while the remaining ones are copied as is.
+//
+// @Parameters:
+// 1. merge - The Shard_Merge structure that contains the current shard's directory and renamed files.
+// 2. relative_path - The CSV file's path relative to the shard's directory.
+//
+// @Returns: Nothing.
+static void merge_shard_csv_file(Shard_Merge* merge, const TCHAR* relative_path)
+{
+	Exporter* exporter = merge->exporter;
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	TCHAR source_path[MAX_PATH_CHARS] = T("");
+	TCHAR destination_path[MAX_PATH_CHARS] = T("");
+	if(PathCombine(source_path, merge->current_shard_path, relative_path) == NULL || PathCombine(destination_path, exporter->output_path, relative_path) == NULL)
+	{
+		log_error("Merge Shard Csv File: Failed to build the source or destination paths for the CSV file '%s'.", relative_path);
+		return;
+	}
+
+	HANDLE source_handle = create_handle(source_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL);
+	u64 source_size = 0;
+	char* source_file = (char*) memory_map_entire_file(source_handle, &source_size);
+
+	if(source_file == NULL)
+	{
+		if(source_size > 0) log_error("Merge Shard Csv File: Failed to map the CSV file '%s' into memory.", source_path);
+		safe_close_handle(&source_handle);
+		return;
+	}
+
+	HANDLE destination_handle = INVALID_HANDLE_VALUE;
+	u64 destination_size = 0;
+	if(create_csv_file(destination_path, &destination_handle) && get_file_size(destination_handle, &destination_size))
+	{
+		if(destination_size == 0) ++(exporter->total_csv_files_created);
+
+		char* file_end = source_file + (size_t) source_size;
+
+		Csv_Field fields[MAX_MERGED_CSV_COLUMNS] = {};
+		int num_header_fields = 0;
+		char* row = split_csv_row(source_file, file_end, fields, MAX_MERGED_CSV_COLUMNS, &num_header_fields);
+		num_header_fields = MIN(num_header_fields, MAX_MERGED_CSV_COLUMNS);
+
+		int location_index = find_csv_header_field(fields, num_header_fields, CSV_LOCATION_IN_OUTPUT);
+		int key_index = find_csv_header_field(fields, num_header_fields, CSV_LOCATION_ON_CACHE);
+		if(key_index == -1) key_index = find_csv_header_field(fields, num_header_fields, CSV_LOCATION_ON_DISK);
+
+		// Only the header from the first shard with this CSV file is written.
+		if(destination_size == 0) write_to_file(destination_handle, source_file, (u32) (row - source_file));
+
+		// Sort the rows so that the merged CSV file doesn't depend on the order that the shard exported its cache entries.
+		Arena* shard_arena = &(merge->shard_arena);
+		lock_arena(shard_arena);
+
+		int num_rows = 0;
+		for(char* next_row = row; next_row < file_end; ++num_rows)
+		{
+			int num_fields = 0;
+			next_row = split_csv_row(next_row, file_end, NULL, 0, &num_fields);
+		}
+
+		Shard_Csv_Row* sorted_rows = (num_rows > 0) ? (push_array_to_arena(shard_arena, num_rows, Shard_Csv_Row)) : (NULL);
+		if(sorted_rows != NULL)
+		{
+			char* next_row = row;
+			for(int i = 0; i < num_rows; ++i)
+			{
+				int num_fields = 0;
+				Shard_Csv_Row* csv_row = &(sorted_rows[i]);
+				csv_row->row.begin = next_row;
+				next_row = split_csv_row(next_row, file_end, fields, MAX_MERGED_CSV_COLUMNS, &num_fields);
+				csv_row->row.end = next_row;
+
+				bool has_key = (key_index != -1) && (key_index < num_fields) && (num_fields <= MAX_MERGED_CSV_COLUMNS);
+				csv_row->key = (has_key) ? (fields[key_index]) : (csv_row->row);
+			}
+
+			qsort(sorted_rows, num_rows, sizeof(Shard_Csv_Row), compare_shard_csv_rows);
+		}
+		else if(num_rows > 0)
+		{
+			log_warning("Merge Shard Csv File: Ran out of memory while sorting %d rows in the CSV file '%s'. These will be merged in the order they were exported.", num_rows, source_path);
+		}
+
+		// Consecutive rows that are copied as is are written at the same time.
+		char* pending_begin = NULL;
+		char* pending_end = NULL;
+
+		#define WRITE_PENDING_ROWS()\
+		do\
+		{\
+			size_t num_pending_bytes = (size_t) (pending_end - pending_begin);\
+			if(num_pending_bytes > 0) write_to_file(destination_handle, pending_begin, (u32) num_pending_bytes);\
+			pending_begin = NULL;\
+			pending_end = NULL;\
+		} while(false, false)
+
+		for(int i = 0; (sorted_rows != NULL) ? (i < num_rows) : (row < file_end); ++i)
+		{
+			char* row_begin = (sorted_rows != NULL) ? (sorted_rows[i].row.begin) : (row);
+
+			int num_fields = 0;
+			char* row_end = split_csv_row(row_begin, file_end, fields, MAX_MERGED_CSV_COLUMNS, &num_fields);
+			row = row_end;
+
+			bool was_rewritten = false;
+
+			if(location_index != -1 && location_index < num_fields && num_fields <= MAX_MERGED_CSV_COLUMNS
+				&& fields[location_index].begin < fields[location_index].end)
+			{
+				TCHAR* location_in_output = convert_csv_field_to_tchar(temporary_arena, fields[location_index]);
+				TCHAR* merged_location_in_output = get_merged_location_in_output(merge, location_in_output);
+
+				if(merged_location_in_output != NULL)
+				{
+					Csv_Entry* csv_row = push_array_to_arena(temporary_arena, num_fields, Csv_Entry);
+					if(csv_row != NULL)
+					{
+						WRITE_PENDING_ROWS();
+
+						for(int j = 0; j < num_fields; ++j)
+						{
+							csv_row[j].value = (j == location_index) ? (merged_location_in_output) : (convert_csv_field_to_tchar(temporary_arena, fields[j]));
+							csv_row[j].utf_16_value = NULL;
+						}
+
+						csv_print_row(temporary_arena, destination_handle, csv_row, num_fields);
+						was_rewritten = true;
+					}
+				}
+			}
+
+			clear_arena(temporary_arena);
+
+			if(!was_rewritten)
+			{
+				if(pending_end != row_begin) WRITE_PENDING_ROWS();
+				if(pending_begin == NULL) pending_begin = row_begin;
+				pending_end = row_end;
+
+				// The last row may not end in a newline, meaning we have to add one if other rows are written after it.
+				if(row_begin < row_end && *(row_end - 1) != '\n')
+				{
+					WRITE_PENDING_ROWS();
+					write_to_file(destination_handle, "\r\n", 2);
+				}
+				else if((size_t) (pending_end - pending_begin) >= MAX_PENDING_CSV_BYTES)
+				{
+					WRITE_PENDING_ROWS();
+				}
+			}
+		}
+
+		WRITE_PENDING_ROWS();
+
+		clear_arena(shard_arena);
+		unlock_arena(shard_arena);
+
+		#undef WRITE_PENDING_ROWS
+	}
+	else
+	{
+		log_error("Merge Shard Csv File: Failed to open the merged CSV file '%s'.", destination_path);
+	}
+
+	safe_close_handle(&destination_handle);
+	safe_unmap_view_of_file((void**) &source_file);
+	safe_close_handle(&source_handle);
+}
+
+// Merges the output of every shard in the -merge-shards option's shards directory into its output directory. See the comment
+// above for more details.
+//
+// @Parameters:
+// 1. exporter - The Exporter structure that contains the shards and output paths.
+//
+// @Returns: Nothing.
+static void merge_shard_outputs(Exporter* exporter)
+{
+	Arena* temporary_arena = &(exporter->temporary_arena);
+
+	Shard_Merge* merge = push_arena(temporary_arena, sizeof(Shard_Merge), Shard_Merge);
+	if(merge == NULL)
+	{
+		log_error("Merge Shard Outputs: Could not allocate enough memory to merge the shards.");
+		return;
+	}
+
+	ZeroMemory(merge, sizeof(Shard_Merge));
+	merge->exporter = exporter;
+
+	console_print("Merging the shards in '%s'...", exporter->shards_path);
+	log_info("Merge Shard Outputs: Looking for shards in '%s'.", exporter->shards_path);
+
+	traverse_directory_objects(exporter->shards_path, T("Shard_*_of_*"), TRAVERSE_DIRECTORIES, false, find_shard_directories_callback, merge);
+
+	if(merge->found_mismatched_shards)
+	{
+		console_print("The shards directory contains shards from exports with a different number of shards. These must be merged separately.");
+		log_error("Merge Shard Outputs: Found shards from exports with a different number of shards in '%s'.", exporter->shards_path);
+		clear_arena(temporary_arena);
+		return;
+	}
+
+	if(merge->num_shards == 0)
+	{
+		console_print("Could not find any shards in '%s'.", exporter->shards_path);
+		log_warning("Merge Shard Outputs: Could not find any shards in '%s'.", exporter->shards_path);
+		clear_arena(temporary_arena);
+		return;
+	}
+
+	size_t shard_memory_size = megabytes_to_bytes(16) * sizeof(TCHAR);
+	log_info("Merge Shard Outputs: Allocating %Iu bytes for the shard memory arena.", shard_memory_size);
+
+	if(!create_arena(&(merge->shard_arena), shard_memory_size))
+	{
+		console_print("Could not allocate enough memory to merge the shards.");
+		log_error("Merge Shard Outputs: Could not allocate %Iu bytes to merge the shards.", shard_memory_size);
+		clear_arena(temporary_arena);
+		return;
+	}
+
+	// The copy function needs to return paths relative to the merged output so that we can find the renamed files in the CSV files.
+	// Full paths in these files are still updated to point to this output. See: get_merged_location_in_output().
+	exporter->show_full_paths = false;
+
+	lock_arena(temporary_arena);
+
+	int num_merged_shards = 0;
+	for(int i = 0; i < merge->num_shards; ++i)
+	{
+		TCHAR* shard_path = merge->shard_paths[i];
+		if(shard_path == NULL)
+		{
+			console_print("Warning: Shard %d of %d is missing from the shards directory.", i + 1, merge->num_shards);
+			log_warning("Merge Shard Outputs: Shard %d of %d is missing from '%s'.", i + 1, merge->num_shards, exporter->shards_path);
+			continue;
+		}
+
+		console_print("Merging shard %d of %d...", i + 1, merge->num_shards);
+		log_info("Merge Shard Outputs: Merging shard %d of %d from '%s'.", i + 1, merge->num_shards, shard_path);
+
+		merge->current_shard_path = shard_path;
+		StringCchPrintf(merge->current_shard_component, MAX_PATH_CHARS, T("\\%s\\"), PathFindFileName(shard_path));
+		merge->renames = NULL;
+		merge->num_renames = 0;
+		merge->sorted_renames = NULL;
+		merge->csv_files = NULL;
+		merge->cached_files = NULL;
+		merge->num_cached_files = 0;
+		merge->copied_files_out_of_order = false;
+		merge->ran_out_of_shard_memory = false;
+
+		traverse_directory_objects(shard_path, ALL_OBJECTS_SEARCH_QUERY, TRAVERSE_FILES, true, merge_shard_file_callback, merge);
+
+		// Copy the cached files in the order of their relative paths so that any naming collisions are always resolved in the same
+		// way, regardless of the order that the files were found in.
+		if(merge->num_cached_files > 0)
+		{
+			Shard_Cached_File** sorted_files = push_array_to_arena(&(merge->shard_arena), merge->num_cached_files, Shard_Cached_File*);
+			if(sorted_files != NULL)
+			{
+				Shard_Cached_File* cached_file = merge->cached_files;
+				for(int j = 0; j < merge->num_cached_files; ++j)
+				{
+					sorted_files[j] = cached_file;
+					cached_file = cached_file->next;
+				}
+
+				qsort(sorted_files, merge->num_cached_files, sizeof(Shard_Cached_File*), compare_shard_cached_files);
+
+				for(int j = 0; j < merge->num_cached_files; ++j)
+				{
+					copy_shard_cached_file(merge, sorted_files[j]->relative_path);
+				}
+			}
+			else
+			{
+				log_warning("Merge Shard Outputs: Ran out of memory while sorting %d cached files. These will be copied in the reverse order that they were found.", merge->num_cached_files);
+
+				for(Shard_Cached_File* cached_file = merge->cached_files; cached_file != NULL; cached_file = cached_file->next)
+				{
+					copy_shard_cached_file(merge, cached_file->relative_path);
+				}
+			}
+		}
+
+		if(merge->num_renames > 0)
+		{
+			merge->sorted_renames = push_array_to_arena(&(merge->shard_arena), merge->num_renames, Shard_Rename*);
+			if(merge->sorted_renames != NULL)
+			{
+				Shard_Rename* rename = merge->renames;
+				for(int j = 0; j < merge->num_renames; ++j)
+				{
+					merge->sorted_renames[j] = rename;
+					rename = rename->next;
+				}
+
+				qsort(merge->sorted_renames, merge->num_renames, sizeof(Shard_Rename*), compare_shard_renames);
+			}
+			else
+			{
+				log_error("Merge Shard Outputs: Ran out of memory while sorting %d renamed files. These will not be updated in the CSV files.", merge->num_renames);
+				merge->num_renames = 0;
+			}
+		}
+
+		for(Shard_Csv_File* csv_file = merge->csv_files; csv_file != NULL; csv_file = csv_file->next)
+		{
+			merge_shard_csv_file(merge, csv_file->relative_path);
+		}
+
+		clear_arena(&(merge->shard_arena));
+		++num_merged_shards;
+	}
+
+	console_print("Merged %d of %d shards and renamed %d files due to naming collisions.", num_merged_shards, merge->num_shards, merge->total_renamed_files);
+	log_info("Merge Shard Outputs: Merged %d of %d shards and renamed %d files due to naming collisions.", num_merged_shards, merge->num_shards, merge->total_renamed_files);
+
+	destroy_arena(&(merge->shard_arena));
+	unlock_arena(temporary_arena);
+	clear_arena(temporary_arena);
+}
+
 // Resolves an absolute path from a different computer using the information from the current profile in the external locations file.
 // This function must only be called when the external locations file was passed to the exporter.
 //
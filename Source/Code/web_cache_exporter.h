@@ -87,6 +87,7 @@
 #include <crtdbg.h> // For _ASSERT() and _STATIC_ASSERT().
 #include <stdarg.h> // For va_list, va_start, and va_end.
 #include <time.h> // For _gmtime64_s() and _tcsftime().
+#include <process.h> // For _beginthreadex().
 
 // A handy shorthand for the TEXT() macro. See the comment at the top of "web_cache_exporter.cpp" for more details.
 #define T(char_or_string) TEXT(char_or_string)
@@ -189,6 +190,9 @@ _STATIC_ASSERT(_countof(IS_CACHE_TYPE_PLUGIN) == NUM_CACHE_TYPES);
 struct Exporter;
 #include "custom_groups.h"
 
+// The list of URLs to look up in Internet Explorer's index files. See: load_internet_explorer_url_lookup_file().
+struct Ie_Url_Lookup;
+
 // A structure that represents a user profile and that contains the locations of any system directories used by each cache exporter.
 // See: load_external_locations().
 struct Profile
@@ -213,7 +217,36 @@ struct External_Locations
 	Profile profiles[ANYSIZE_ARRAY];
 };
 
+// A single export in the batch manifest file. The last members are set after the job is exported.
+// See: load_batch_manifest().
+struct Batch_Job
+{
+	TCHAR* name;
+	Cache_Type cache_type;
+	TCHAR* cache_path;
+	TCHAR* output_path;
+	// The absolute output path used to find other jobs that would write to the same CSV file. This member is NULL if the path is
+	// too long.
+	TCHAR* full_output_path;
+	bool has_duplicate_output;
+
+	const TCHAR* status;
+	DWORD elapsed_time;
+	int num_csv_files_created;
+	int num_processed_files;
+	int num_copied_files;
+};
+
+// An array of exports to perform in the same process.
+// See: load_batch_manifest().
+struct Batch_Manifest
+{
+	int num_jobs;
+	Batch_Job jobs[ANYSIZE_ARRAY];
+};
+
 const size_t MAX_EXPORTER_WARNING_CHARS = 1000;
+const size_t MAX_ENTRY_FILTER_EXPRESSION_CHARS = 1000;
 
 // A structure that represents a cache exporter. 
 struct Exporter
@@ -234,18 +267,98 @@ struct Exporter
 	String_Array<TCHAR>* group_files_for_filtering;
 	
 	bool ignore_filter_for_cache_type[NUM_CACHE_TYPES];
+
+	// Whether or not to skip any cache entries that don't match a filter expression. Each cache exporter evaluates this filter using
+	// the raw values from the cache's metadata. See: cache_entry_passes_filter().
+	bool filter_entries;
+	TCHAR entry_filter_expression[MAX_ENTRY_FILTER_EXPRESSION_CHARS];
 	
 	bool use_custom_temporary_directory;
 
+	// Whether or not to enumerate the default cache locations once before exporting every cache type so that each exporter
+	// finds its files in memory. See: take_filesystem_snapshot().
+	bool use_filesystem_snapshot;
+
+	// Whether or not to mark the explored files whose contents are identical to a previously explored file.
+	// See: export_explored_files().
+	bool find_duplicate_files;
+
 	bool use_ie_hint;
 	TCHAR ie_hint_path[MAX_PATH_CHARS];
 
+	// Whether or not to only export the Internet Explorer cache entries whose URLs appear in a given text file, along with the
+	// path to this file and its loaded data that is stored in the permanent memory arena.
+	bool use_ie_url_lookup;
+	TCHAR ie_url_lookup_file_path[MAX_PATH_CHARS];
+	Ie_Url_Lookup* ie_url_lookup;
+
+	// Whether or not to look for deallocated Internet Explorer cache entries that still exist in the index file.
+	bool recover_ie_entries;
+
+	// Whether or not to look for Mozilla cache entries (version 1) that still exist in the unreferenced blocks of the block files.
+	bool recover_mozilla_entries;
+
+	// Whether or not to check the Mozilla cache entries (version 2) against their stored hashes, and whether or not to skip
+	// the ones that fail this check.
+	bool verify_mozilla_integrity;
+	bool skip_corrupt_mozilla_entries;
+
+	// Whether or not to list the members of each cached Java archive in a separate CSV file.
+	bool list_java_archive_members;
+
+	// Whether or not to list the assets in each cached Unity bundle in a separate CSV file, and whether or not to extract them
+	// to the output directory.
+	bool list_unity_bundle_assets;
+	bool extract_unity_bundle_assets;
+
+	// Whether or not to list the chunks in each cached Director file in a separate CSV file, and whether or not to extract
+	// their bitmaps and sounds to the output directory.
+	bool list_director_chunks;
+	bool extract_director_media;
+
 	// Whether or not the path to the external locations file was specified in the CACHE_ALL export option,
 	// along with the path itself.
 	bool load_external_locations;
 	TCHAR external_locations_file_path[MAX_PATH_CHARS];
 	// The name of the profile whose cache is current being exported. 
 	TCHAR* current_profile_name;
+
+	// Whether or not to export multiple profiles from the external locations file at the same time, along with the maximum
+	// number of profiles that are exported from the same drive at once. See: export_profiles_in_parallel().
+	bool export_profiles_in_parallel;
+	int max_parallel_profiles_per_drive;
+	// Used to export one ESE database at a time when exporting profiles or batch jobs in parallel since the ESE library's database
+	// page size is a global setting. This member is NULL when only one job is exported at a time.
+	CRITICAL_SECTION* ese_critical_section;
+
+	// Whether or not to perform every export in a batch manifest file, along with the path to this file and the maximum number
+	// of jobs that are exported from the same drive at once. See: export_batch_manifest_jobs().
+	bool use_batch_manifest;
+	TCHAR batch_manifest_file_path[MAX_PATH_CHARS];
+	int max_parallel_batch_jobs_per_drive;
+	Batch_Manifest* batch_manifest;
+	// The tick count when the current batch job was started.
+	DWORD batch_job_start_time;
+
+	// Whether or not to run as a service that receives batch jobs from a named pipe, along with the pipe's name and the number
+	// of workers that export these jobs. See: run_export_service().
+	bool use_export_service;
+	TCHAR export_service_pipe_name[MAX_PATH_CHARS];
+	int num_export_service_workers;
+	// Set by the export service when the current job is cancelled. Any remaining cache entries are skipped when this value is
+	// nonzero. This member is NULL when the current job can't be cancelled.
+	volatile LONG* job_cancel_flag;
+
+	// Whether or not to only export the cache entries that belong to one shard out of a given number of shards, along with
+	// the one-based shard index and the number of shards. See: is_cache_entry_in_exporter_shard().
+	bool use_shard;
+	int shard_index;
+	int num_shards;
+
+	// Whether or not to merge the output of multiple shards into a single output directory, along with the path to the
+	// directory that contains each shard's output. See: merge_shard_outputs().
+	bool merge_shards;
+	TCHAR shards_path[MAX_PATH_CHARS];
 	
 	// The export command line arguments.
 	Cache_Type command_line_cache_type;
@@ -266,10 +379,15 @@ struct Exporter
 	Arena temporary_arena;
 	// A smaller temporary memory arena used specifically when loading group files in the Windows 98 and ME builds.
 	Arena secondary_temporary_arena;
+	// The memory arena where the filesystem snapshot is stored when the -snapshot-filesystem option is used.
+	Arena snapshot_arena;
 
 	// The loaded group file data that is stored in the permanent memory arena.
 	Custom_Groups* custom_groups;
 
+	// The compiled entry filter that is stored in the permanent memory arena.
+	Entry_Filter* entry_filter;
+
 	// The loaded external locations file data that is stored in the permanent memory arena.
 	External_Locations* external_locations;
 
@@ -325,6 +443,8 @@ struct Exporter
 	HANDLE csv_file_handle;
 	// Whether we tried to export at least one file since the exporter was initialized.
 	bool exported_at_least_one_file;
+	// Whether the last cache entry passed to export_cache_entry() was allowed by the group filter.
+	bool was_last_entry_exported;
 
 	// The types of each column as an array of length 'num_csv_columns'.
 	Csv_Type* csv_column_types;
@@ -349,16 +469,28 @@ struct Exporter
 	int total_csv_files_created;
 	int total_processed_files;
 	int total_copied_files;
+	// Used to count how many CSV files couldn't be created and how many cached files couldn't be copied.
+	int total_export_errors;
 
 	int num_assigned_filenames;
 	int total_assigned_filenames;
 };
 
+// Called by export_cache_entry() after an entry passes the group filter and before its CSV row is written. Used to fill any columns
+// that require reading the cached file (e.g. when finding duplicate files) only for the entries that are exported.
+#define EXPORTED_ENTRY_CALLBACK(function_name) void function_name(Exporter* exporter, Csv_Entry* column_values, void* user_data)
+typedef EXPORTED_ENTRY_CALLBACK(Exported_Entry_Callback);
+
 // The basic parameters used to build the output locations and fill certain CSV columns for each cache exporter.
 // See: export_cache_entry().
 struct Exporter_Params
 {
 	TCHAR* copy_source_path;
+	// Whether the cached data is only a byte range of the 'copy_source_path' file.
+	bool use_copy_source_range;
+	u64 copy_source_offset;
+	u64 copy_source_size;
+
 	TCHAR* url;
 	TCHAR* filename;
 
@@ -369,6 +501,19 @@ struct Exporter_Params
 	TCHAR* full_location_on_cache;
 
 	Traversal_Object_Info* file_info;
+
+	// Whether the SHA-256 column was already filled by the cache exporter, meaning the file isn't hashed again. The column's
+	// value may be NULL if the exporter skipped the hash on purpose (e.g. when finding duplicate files).
+	bool has_precomputed_sha_256;
+
+	// An optional function that fills the remaining columns once the entry is known to be exported. See: EXPORTED_ENTRY_CALLBACK.
+	Exported_Entry_Callback* exported_entry_callback;
+	void* exported_entry_user_data;
+
+	// An optional identifier that doesn't change between runs (e.g. the block where an index.dat entry starts). If it's set,
+	// the -shard option uses it instead of the location on cache to assign the entry to a shard.
+	bool has_record_id;
+	u64 record_id;
 };
 
 void initialize_cache_exporter(Exporter* exporter, Cache_Type cache_type, Csv_Type* column_types, int num_columns);
@@ -378,6 +523,8 @@ void set_exporter_output_copy_subdirectory(Exporter* exporter, const TCHAR* subd
 void tchar_add_exporter_warning_message(Exporter* exporter, const TCHAR* string_format, ...);
 #define add_exporter_warning_message(exporter, string_format, ...) tchar_add_exporter_warning_message(exporter, T(string_format), __VA_ARGS__)
 
+bool is_cache_entry_in_exporter_shard(Exporter* exporter, Exporter_Params* params);
+
 void export_cache_entry(Exporter* exporter, Csv_Entry* column_values, Exporter_Params* params);
 
 void reset_temporary_exporter_members(Exporter* exporter);